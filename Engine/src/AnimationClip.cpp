@@ -0,0 +1,710 @@
+#include "AnimationClip.h"
+#include "Log.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    const char MAGIC[4] = { 'W', 'A', 'N', 'M' };
+    const uint32_t VERSION = 1;
+
+    // Frames are stored as uint16
+    const size_t MAX_FRAMES = 65536;
+    // Longest run of frames one pair of keys may cover. Bounds the reduction cost on long, smooth tracks.
+    const uint32_t MAX_SEGMENT = 255;
+    // keyLookup has one entry per 16 frames
+    const uint32_t LOOKUP_SHIFT = 4;
+
+    const float QUANTIZE_16 = 65535.0f;
+    const float QUANTIZE_15 = 32767.0f;
+    const float DEQUANTIZE_16 = 1.0f / QUANTIZE_16;
+    const float DEQUANTIZE_15 = 1.0f / QUANTIZE_15;
+    const float INV_SQRT2 = 0.70710678f;
+
+    struct ClipHeader
+    {
+        char magic[4];
+        uint32_t version;
+        double duration;
+        double ticksPerSecond;
+        uint32_t channelCount;
+        uint32_t timeCount;
+        uint32_t lookupCount;
+        uint32_t valueCount;
+        uint32_t floatCount;
+        uint32_t nameBytes;
+    };
+
+    void QuantizeVector(const glm::vec3& value, const glm::vec3& minimum, const glm::vec3& extent, uint16_t* out)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            float normalized = extent[i] > 0.0f ? (value[i] - minimum[i]) / extent[i] : 0.0f;
+            out[i] = (uint16_t)std::lround(glm::clamp(normalized, 0.0f, 1.0f) * QUANTIZE_16);
+        }
+    }
+
+    glm::vec3 DequantizeVector(const uint16_t* in, const float* minimum, const float* extent)
+    {
+        return glm::vec3(
+            minimum[0] + extent[0] * (in[0] * DEQUANTIZE_16),
+            minimum[1] + extent[1] * (in[1] * DEQUANTIZE_16),
+            minimum[2] + extent[2] * (in[2] * DEQUANTIZE_16));
+    }
+
+    // Smallest three: the largest component is dropped (and made positive, q and -q are the
+    // same rotation), the other three fit in [-1/sqrt2, 1/sqrt2]. Its index goes in the top
+    // bits of the first two values.
+    void PackRotation(const glm::quat& rotation, uint16_t* out)
+    {
+        float components[4] = { rotation.x, rotation.y, rotation.z, rotation.w };
+
+        int largest = 0;
+        for (int i = 1; i < 4; ++i)
+        {
+            if (std::abs(components[i]) > std::abs(components[largest])) largest = i;
+        }
+
+        float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+        int written = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            if (i == largest) continue;
+
+            float normalized = components[i] * sign * INV_SQRT2 + 0.5f;
+            out[written++] = (uint16_t)std::lround(glm::clamp(normalized, 0.0f, 1.0f) * QUANTIZE_15);
+        }
+
+        out[0] |= (uint16_t)((largest & 1) << 15);
+        out[1] |= (uint16_t)((largest >> 1) << 15);
+    }
+
+    glm::quat UnpackRotation(const uint16_t* in)
+    {
+        const float scale = 2.0f * INV_SQRT2 * DEQUANTIZE_15;
+        float a = (in[0] & 0x7FFF) * scale - INV_SQRT2;
+        float b = (in[1] & 0x7FFF) * scale - INV_SQRT2;
+        float c = (in[2] & 0x7FFF) * scale - INV_SQRT2;
+        float largest = std::sqrt(std::max(0.0f, 1.0f - a * a - b * b - c * c));
+
+        // The stored three keep their x, y, z, w order
+        switch ((in[0] >> 15) | ((in[1] >> 15) << 1))
+        {
+        case 0: return glm::quat(c, largest, a, b);
+        case 1: return glm::quat(c, a, largest, b);
+        case 2: return glm::quat(c, a, b, largest);
+        default: return glm::quat(largest, a, b, c);
+        }
+    }
+
+    // Same interpolation at import (to measure the error) and at runtime
+    glm::quat InterpolateRotation(const glm::quat& from, const glm::quat& to, float factor)
+    {
+        float toWeight = glm::dot(from, to) < 0.0f ? -factor : factor;
+        float fromWeight = 1.0f - factor;
+
+        glm::quat result(
+            from.w * fromWeight + to.w * toWeight,
+            from.x * fromWeight + to.x * toWeight,
+            from.y * fromWeight + to.y * toWeight,
+            from.z * fromWeight + to.z * toWeight);
+
+        float inverseLength = 1.0f / std::sqrt(glm::dot(result, result));
+        return glm::quat(result.w * inverseLength, result.x * inverseLength, result.y * inverseLength, result.z * inverseLength);
+    }
+
+    // Angle of the rotation between a and b. acos(dot) has no float precision left below ~1e-3 rad,
+    // the chord between the two quaternions keeps it.
+    float RotationError(const glm::quat& a, const glm::quat& b)
+    {
+        float chord = glm::length(glm::dot(a, b) < 0.0f ? a + b : a - b);
+        return 4.0f * std::asin(std::min(1.0f, 0.5f * chord));
+    }
+
+    // The sampling ComponentAnimation did on the raw per-tick keys, for the report
+    template<typename T, typename Interpolate>
+    T SampleRawKeys(const std::vector<T>& keys, float time, Interpolate interpolate)
+    {
+        int frameIndex = (int)time;
+        int numKeys = (int)keys.size();
+
+        if (frameIndex >= numKeys - 1) return keys.back();
+        if (frameIndex < 0) return keys[0];
+
+        return interpolate(keys[frameIndex], keys[frameIndex + 1], time - (float)frameIndex);
+    }
+
+    template<typename T>
+    void AppendBytes(std::vector<unsigned char>& outData, const T* source, size_t count)
+    {
+        if (count == 0) return;
+
+        const unsigned char* begin = reinterpret_cast<const unsigned char*>(source);
+        outData.insert(outData.end(), begin, begin + count * sizeof(T));
+    }
+}
+
+AnimationClip AnimationClip::Compress(const Animation& source, const Settings& settings)
+{
+    AnimationClip clip;
+    clip.duration = source.duration;
+    clip.ticksPerSecond = source.ticksPerSecond;
+    clip.channelNames.reserve(source.channels.size());
+    clip.tracks.resize(source.channels.size() * TRACKS_PER_CHANNEL);
+
+    for (size_t c = 0; c < source.channels.size(); ++c)
+    {
+        const Channel& channel = source.channels[c];
+        clip.channelNames.push_back(channel.name);
+
+        if (channel.positionKeys.size() > MAX_FRAMES || channel.rotationKeys.size() > MAX_FRAMES || channel.scaleKeys.size() > MAX_FRAMES)
+        {
+            LOG_CONSOLE("[AnimationClip] WARNING: Channel %s has more than %zu frames, the rest is dropped", channel.name.c_str(), MAX_FRAMES);
+        }
+
+        Track* channelTracks = &clip.tracks[c * TRACKS_PER_CHANNEL];
+        clip.CompressVectorTrack(channel.positionKeys, glm::vec3(0.0f), settings.positionError, channelTracks[TRACK_POSITION]);
+        clip.CompressRotationTrack(channel.rotationKeys, settings.rotationError, channelTracks[TRACK_ROTATION]);
+        clip.CompressVectorTrack(channel.scaleKeys, glm::vec3(1.0f), settings.scaleError, channelTracks[TRACK_SCALE]);
+    }
+
+    return clip;
+}
+
+void AnimationClip::CompressVectorTrack(const std::vector<glm::vec3>& sourceKeys, const glm::vec3& defaultValue, float maxError, Track& outTrack)
+{
+    size_t count = std::min(sourceKeys.size(), MAX_FRAMES);
+    if (count == 0) return;
+
+    const glm::vec3* keys = sourceKeys.data();
+
+    bool constant = true;
+    glm::vec3 minimum = keys[0];
+    glm::vec3 maximum = keys[0];
+    for (size_t i = 1; i < count; ++i)
+    {
+        constant = constant && glm::distance(keys[i], keys[0]) <= maxError;
+        minimum = glm::min(minimum, keys[i]);
+        maximum = glm::max(maximum, keys[i]);
+    }
+
+    if (constant)
+    {
+        if (glm::distance(keys[0], defaultValue) > maxError)
+        {
+            outTrack.keyCount = 1;
+            for (int i = 0; i < 3; ++i) outTrack.base[i] = keys[0][i];
+        }
+        return;
+    }
+
+    // Rounding moves each axis up to half a 16 bit step. When that alone takes more than half
+    // the bound there is little left for key reduction, so wide tracks (root motion) stay floats.
+    glm::vec3 extent = maximum - minimum;
+    bool quantize = glm::length(extent) * 0.5f * DEQUANTIZE_16 <= 0.5f * maxError;
+
+    std::vector<uint16_t> quantized;
+    std::vector<glm::vec3> decoded(keys, keys + count);
+    if (quantize)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            outTrack.base[i] = minimum[i];
+            outTrack.extent[i] = extent[i];
+        }
+
+        quantized.resize(count * 3);
+        for (size_t i = 0; i < count; ++i)
+        {
+            QuantizeVector(keys[i], minimum, extent, &quantized[i * 3]);
+            decoded[i] = DequantizeVector(&quantized[i * 3], outTrack.base, outTrack.extent);
+        }
+    }
+
+    // Greedy reduction: each key reaches as far as interpolating to it keeps every skipped frame in bounds
+    auto segmentFits = [&](size_t first, size_t last)
+        {
+            for (size_t i = first + 1; i < last; ++i)
+            {
+                float factor = (float)(i - first) / (float)(last - first);
+                if (glm::distance(glm::mix(decoded[first], decoded[last], factor), keys[i]) > maxError) return false;
+            }
+            return true;
+        };
+
+    outTrack.encoding = quantize ? ENCODING_QUANTIZED : ENCODING_FLOAT;
+    outTrack.firstKey = (uint32_t)times.size();
+    outTrack.firstValue = (uint32_t)(quantize ? values.size() : floatValues.size());
+
+    auto keepKey = [&](size_t frame)
+        {
+            times.push_back((uint16_t)frame);
+            if (quantize)
+            {
+                values.insert(values.end(), &quantized[frame * 3], &quantized[frame * 3 + 3]);
+            }
+            else
+            {
+                for (int i = 0; i < 3; ++i) floatValues.push_back(keys[frame][i]);
+            }
+        };
+
+    size_t start = 0;
+    keepKey(0);
+
+    while (start < count - 1)
+    {
+        size_t end = start + 1;
+        while (end + 1 < count && end + 1 - start <= MAX_SEGMENT && segmentFits(start, end + 1)) ++end;
+
+        keepKey(end);
+        start = end;
+    }
+
+    outTrack.keyCount = (uint32_t)times.size() - outTrack.firstKey;
+    BuildKeyLookup(outTrack);
+}
+
+void AnimationClip::CompressRotationTrack(const std::vector<glm::quat>& sourceKeys, float maxError, Track& outTrack)
+{
+    size_t count = std::min(sourceKeys.size(), MAX_FRAMES);
+    if (count == 0) return;
+
+    std::vector<glm::quat> keys(sourceKeys.begin(), sourceKeys.begin() + count);
+
+    bool constant = true;
+    for (size_t i = 0; i < count; ++i)
+    {
+        keys[i] = glm::normalize(keys[i]);
+        constant = constant && RotationError(keys[i], keys[0]) <= maxError;
+    }
+
+    if (constant)
+    {
+        if (RotationError(keys[0], glm::quat(1.0f, 0.0f, 0.0f, 0.0f)) > maxError)
+        {
+            outTrack.keyCount = 1;
+            outTrack.base[0] = keys[0].x;
+            outTrack.base[1] = keys[0].y;
+            outTrack.base[2] = keys[0].z;
+            outTrack.base[3] = keys[0].w;
+        }
+        return;
+    }
+
+    std::vector<uint16_t> quantized(count * 3);
+    std::vector<glm::quat> decoded(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        PackRotation(keys[i], &quantized[i * 3]);
+        decoded[i] = UnpackRotation(&quantized[i * 3]);
+    }
+
+    auto segmentFits = [&](size_t first, size_t last)
+        {
+            for (size_t i = first + 1; i < last; ++i)
+            {
+                float factor = (float)(i - first) / (float)(last - first);
+                if (RotationError(InterpolateRotation(decoded[first], decoded[last], factor), keys[i]) > maxError) return false;
+            }
+            return true;
+        };
+
+    outTrack.firstKey = (uint32_t)times.size();
+    outTrack.firstValue = (uint32_t)values.size();
+
+    auto keepKey = [&](size_t frame)
+        {
+            times.push_back((uint16_t)frame);
+            values.insert(values.end(), &quantized[frame * 3], &quantized[frame * 3 + 3]);
+        };
+
+    size_t start = 0;
+    keepKey(0);
+
+    while (start < count - 1)
+    {
+        size_t end = start + 1;
+        while (end + 1 < count && end + 1 - start <= MAX_SEGMENT && segmentFits(start, end + 1)) ++end;
+
+        keepKey(end);
+        start = end;
+    }
+
+    outTrack.keyCount = (uint32_t)times.size() - outTrack.firstKey;
+    BuildKeyLookup(outTrack);
+}
+
+void AnimationClip::BuildKeyLookup(Track& track)
+{
+    const uint16_t* trackTimes = times.data() + track.firstKey;
+    uint32_t blocks = ((uint32_t)trackTimes[track.keyCount - 1] >> LOOKUP_SHIFT) + 1;
+
+    track.firstBlock = (uint32_t)keyLookup.size();
+
+    uint32_t key = 0;
+    for (uint32_t block = 0; block < blocks; ++block)
+    {
+        uint32_t blockStart = block << LOOKUP_SHIFT;
+        while (key + 1 < track.keyCount && trackTimes[key + 1] <= blockStart) ++key;
+        keyLookup.push_back((uint16_t)key);
+    }
+}
+
+int AnimationClip::FindChannel(const std::string& name) const
+{
+    for (size_t i = 0; i < channelNames.size(); ++i)
+    {
+        if (channelNames[i] == name) return (int)i;
+    }
+    return -1;
+}
+
+void AnimationClip::Sample(size_t channel, float time, glm::vec3& outPosition, glm::quat& outRotation, glm::vec3& outScale) const
+{
+    const Track* channelTracks = &tracks[channel * TRACKS_PER_CHANNEL];
+
+    outPosition = SampleVector(channelTracks[TRACK_POSITION], time, glm::vec3(0.0f));
+    outRotation = SampleRotation(channelTracks[TRACK_ROTATION], time);
+    outScale = SampleVector(channelTracks[TRACK_SCALE], time, glm::vec3(1.0f));
+}
+
+void AnimationClip::FindKeys(const Track& track, float time, uint32_t& outKey0, uint32_t& outKey1, float& outFactor) const
+{
+    const uint16_t* trackTimes = times.data() + track.firstKey;
+    uint32_t last = track.keyCount - 1;
+
+    outFactor = 0.0f;
+    if (time <= trackTimes[0])
+    {
+        outKey0 = outKey1 = 0;
+        return;
+    }
+    if (time >= trackTimes[last])
+    {
+        outKey0 = outKey1 = last;
+        return;
+    }
+
+    // Key frames are whole ticks: the first key after floor(time) ends the segment. The lookup
+    // starts at most 16 frames before it, and time < last key time keeps the walk in the track.
+    uint32_t frame = (uint32_t)time;
+    uint32_t key = keyLookup[track.firstBlock + (frame >> LOOKUP_SHIFT)];
+    while (trackTimes[key + 1] <= frame) ++key;
+
+    outKey0 = key;
+    outKey1 = key + 1;
+    outFactor = (time - trackTimes[outKey0]) / (float)(trackTimes[outKey1] - trackTimes[outKey0]);
+}
+
+glm::vec3 AnimationClip::SampleVector(const Track& track, float time, const glm::vec3& defaultValue) const
+{
+    if (track.keyCount == 0) return defaultValue;
+    if (track.keyCount == 1) return glm::vec3(track.base[0], track.base[1], track.base[2]);
+
+    uint32_t key0, key1;
+    float factor;
+    FindKeys(track, time, key0, key1, factor);
+
+    glm::vec3 value0 = GetVectorKey(track, key0);
+    if (key0 == key1) return value0;
+
+    return glm::mix(value0, GetVectorKey(track, key1), factor);
+}
+
+glm::vec3 AnimationClip::GetVectorKey(const Track& track, uint32_t key) const
+{
+    size_t index = (size_t)track.firstValue + (size_t)key * 3;
+    if (track.encoding == ENCODING_FLOAT)
+    {
+        return glm::vec3(floatValues[index], floatValues[index + 1], floatValues[index + 2]);
+    }
+    return DequantizeVector(values.data() + index, track.base, track.extent);
+}
+
+glm::quat AnimationClip::SampleRotation(const Track& track, float time) const
+{
+    if (track.keyCount == 0) return glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    if (track.keyCount == 1) return glm::quat(track.base[3], track.base[0], track.base[1], track.base[2]);
+
+    uint32_t key0, key1;
+    float factor;
+    FindKeys(track, time, key0, key1, factor);
+
+    const uint16_t* trackValues = values.data() + track.firstValue;
+    glm::quat value0 = UnpackRotation(trackValues + key0 * 3);
+    if (key0 == key1) return value0;
+
+    return InterpolateRotation(value0, UnpackRotation(trackValues + key1 * 3), factor);
+}
+
+size_t AnimationClip::GetMemoryBytes() const
+{
+    size_t bytes = tracks.size() * sizeof(Track) + (times.size() + keyLookup.size() + values.size()) * sizeof(uint16_t) +
+        floatValues.size() * sizeof(float);
+    for (const std::string& name : channelNames)
+    {
+        bytes += sizeof(std::string) + name.capacity();
+    }
+    return bytes;
+}
+
+void AnimationClip::Clear()
+{
+    duration = 0.0;
+    ticksPerSecond = 0.0;
+    channelNames.clear();
+    tracks.clear();
+    times.clear();
+    keyLookup.clear();
+    values.clear();
+    floatValues.clear();
+}
+
+void AnimationClip::Write(std::vector<unsigned char>& outData) const
+{
+    std::vector<unsigned char> names;
+    for (const std::string& name : channelNames)
+    {
+        uint32_t length = (uint32_t)name.size();
+        AppendBytes(names, &length, 1);
+        AppendBytes(names, name.data(), name.size());
+    }
+
+    ClipHeader header = {};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.duration = duration;
+    header.ticksPerSecond = ticksPerSecond;
+    header.channelCount = (uint32_t)channelNames.size();
+    header.timeCount = (uint32_t)times.size();
+    header.lookupCount = (uint32_t)keyLookup.size();
+    header.valueCount = (uint32_t)values.size();
+    header.floatCount = (uint32_t)floatValues.size();
+    header.nameBytes = (uint32_t)names.size();
+
+    outData.clear();
+    AppendBytes(outData, &header, 1);
+    AppendBytes(outData, names.data(), names.size());
+    AppendBytes(outData, tracks.data(), tracks.size());
+    AppendBytes(outData, times.data(), times.size());
+    AppendBytes(outData, keyLookup.data(), keyLookup.size());
+    AppendBytes(outData, values.data(), values.size());
+    AppendBytes(outData, floatValues.data(), floatValues.size());
+}
+
+bool AnimationClip::IsClipData(const unsigned char* data, size_t size)
+{
+    return data && size >= sizeof(ClipHeader) && memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool AnimationClip::Read(const unsigned char* data, size_t size)
+{
+    Clear();
+
+    if (!IsClipData(data, size)) return false;
+
+    ClipHeader header;
+    memcpy(&header, data, sizeof(ClipHeader));
+    if (header.version != VERSION)
+    {
+        LOG_CONSOLE("[AnimationClip] ERROR: Unsupported clip version %u", header.version);
+        return false;
+    }
+
+    uint64_t trackCount = (uint64_t)header.channelCount * TRACKS_PER_CHANNEL;
+    uint64_t expected = sizeof(ClipHeader) + (uint64_t)header.nameBytes + trackCount * sizeof(Track) +
+        ((uint64_t)header.timeCount + header.lookupCount + header.valueCount) * sizeof(uint16_t) +
+        (uint64_t)header.floatCount * sizeof(float);
+    if (expected != size)
+    {
+        LOG_CONSOLE("[AnimationClip] ERROR: Corrupt clip data");
+        return false;
+    }
+
+    size_t offset = sizeof(ClipHeader);
+    size_t namesEnd = offset + header.nameBytes;
+    channelNames.resize(header.channelCount);
+    for (std::string& name : channelNames)
+    {
+        uint32_t length = 0;
+        bool fits = namesEnd - offset >= sizeof(uint32_t);
+        if (fits)
+        {
+            memcpy(&length, data + offset, sizeof(uint32_t));
+            offset += sizeof(uint32_t);
+            fits = namesEnd - offset >= length;
+        }
+
+        if (!fits)
+        {
+            LOG_CONSOLE("[AnimationClip] ERROR: Corrupt channel names in clip");
+            Clear();
+            return false;
+        }
+
+        name.assign(reinterpret_cast<const char*>(data + offset), length);
+        offset += length;
+    }
+    offset = namesEnd;
+
+    tracks.resize((size_t)trackCount);
+    memcpy(tracks.data(), data + offset, tracks.size() * sizeof(Track));
+    offset += tracks.size() * sizeof(Track);
+
+    times.resize(header.timeCount);
+    memcpy(times.data(), data + offset, times.size() * sizeof(uint16_t));
+    offset += times.size() * sizeof(uint16_t);
+
+    keyLookup.resize(header.lookupCount);
+    memcpy(keyLookup.data(), data + offset, keyLookup.size() * sizeof(uint16_t));
+    offset += keyLookup.size() * sizeof(uint16_t);
+
+    values.resize(header.valueCount);
+    memcpy(values.data(), data + offset, values.size() * sizeof(uint16_t));
+    offset += values.size() * sizeof(uint16_t);
+
+    floatValues.resize(header.floatCount);
+    memcpy(floatValues.data(), data + offset, floatValues.size() * sizeof(float));
+
+    for (const Track& track : tracks)
+    {
+        if (!IsTrackValid(track))
+        {
+            LOG_CONSOLE("[AnimationClip] ERROR: Corrupt track in clip");
+            Clear();
+            return false;
+        }
+    }
+
+    duration = header.duration;
+    ticksPerSecond = header.ticksPerSecond;
+    return true;
+}
+
+// Sampling trusts the file, so everything it indexes with is checked once here
+bool AnimationClip::IsTrackValid(const Track& track) const
+{
+    if (track.keyCount <= 1) return true;
+    if ((uint64_t)track.firstKey + track.keyCount > times.size()) return false;
+
+    uint64_t valueEnd = (uint64_t)track.firstValue + (uint64_t)track.keyCount * 3;
+    if (track.encoding == ENCODING_FLOAT)
+    {
+        if (valueEnd > floatValues.size()) return false;
+    }
+    else if (track.encoding != ENCODING_QUANTIZED || valueEnd > values.size())
+    {
+        return false;
+    }
+
+    const uint16_t* trackTimes = times.data() + track.firstKey;
+    for (uint32_t key = 1; key < track.keyCount; ++key)
+    {
+        if (trackTimes[key] <= trackTimes[key - 1]) return false;
+    }
+
+    uint32_t blocks = ((uint32_t)trackTimes[track.keyCount - 1] >> LOOKUP_SHIFT) + 1;
+    if ((uint64_t)track.firstBlock + blocks > keyLookup.size()) return false;
+
+    for (uint32_t block = 0; block < blocks; ++block)
+    {
+        uint16_t key = keyLookup[track.firstBlock + block];
+        if (key >= track.keyCount || trackTimes[key] > (block << LOOKUP_SHIFT)) return false;
+    }
+
+    return true;
+}
+
+AnimationClip::Report AnimationClip::Measure(const Animation& source, const AnimationClip& clip)
+{
+    Report report;
+    report.channels = (uint32_t)clip.GetChannelCount();
+    report.compressedBytes = clip.GetMemoryBytes();
+
+    for (const Track& track : clip.tracks)
+    {
+        if (track.keyCount == 0) ++report.strippedTracks;
+        else if (track.keyCount == 1) ++report.constantTracks;
+        report.keptKeys += track.keyCount;
+    }
+
+    for (size_t c = 0; c < source.channels.size() && c < clip.GetChannelCount(); ++c)
+    {
+        const Channel& channel = source.channels[c];
+        report.rawBytes += sizeof(Channel) + channel.name.capacity() +
+            channel.positionKeys.size() * sizeof(glm::vec3) +
+            channel.rotationKeys.size() * sizeof(glm::quat) +
+            channel.scaleKeys.size() * sizeof(glm::vec3);
+        report.rawKeys += (uint32_t)(channel.positionKeys.size() + channel.rotationKeys.size() + channel.scaleKeys.size());
+
+        glm::vec3 position, scale;
+        glm::quat rotation;
+
+        for (size_t k = 0; k < channel.positionKeys.size() && k < MAX_FRAMES; ++k)
+        {
+            clip.Sample(c, (float)k, position, rotation, scale);
+            report.maxPositionError = std::max(report.maxPositionError, glm::distance(position, channel.positionKeys[k]));
+        }
+        for (size_t k = 0; k < channel.rotationKeys.size() && k < MAX_FRAMES; ++k)
+        {
+            clip.Sample(c, (float)k, position, rotation, scale);
+            report.maxRotationError = std::max(report.maxRotationError, RotationError(rotation, glm::normalize(channel.rotationKeys[k])));
+        }
+        for (size_t k = 0; k < channel.scaleKeys.size() && k < MAX_FRAMES; ++k)
+        {
+            clip.Sample(c, (float)k, position, rotation, scale);
+            report.maxScaleError = std::max(report.maxScaleError, glm::distance(scale, channel.scaleKeys[k]));
+        }
+    }
+
+    // Sampling speed over a sweep of the whole clip, as the runtime sees it
+    const int steps = 256;
+    float step = (float)std::max(clip.GetDuration(), 1.0) / steps;
+    glm::vec3 sink(0.0f);
+    size_t samples = 0;
+
+    auto rawStart = std::chrono::steady_clock::now();
+    for (int s = 0; s < steps; ++s)
+    {
+        float time = s * step;
+        for (const Channel& channel : source.channels)
+        {
+            if (channel.positionKeys.empty() || channel.rotationKeys.empty() || channel.scaleKeys.empty()) continue;
+
+            glm::vec3 position = SampleRawKeys(channel.positionKeys, time, [](const glm::vec3& a, const glm::vec3& b, float f) { return glm::mix(a, b, f); });
+            glm::quat rotation = SampleRawKeys(channel.rotationKeys, time, [](const glm::quat& a, const glm::quat& b, float f) { return glm::slerp(a, b, f); });
+            glm::vec3 scale = SampleRawKeys(channel.scaleKeys, time, [](const glm::vec3& a, const glm::vec3& b, float f) { return glm::mix(a, b, f); });
+            sink += position + scale + glm::vec3(rotation.x, rotation.y, rotation.z);
+            ++samples;
+        }
+    }
+    auto rawEnd = std::chrono::steady_clock::now();
+
+    for (int s = 0; s < steps; ++s)
+    {
+        float time = s * step;
+        for (size_t c = 0; c < clip.GetChannelCount(); ++c)
+        {
+            glm::vec3 position, scale;
+            glm::quat rotation;
+            clip.Sample(c, time, position, rotation, scale);
+            sink += position + scale + glm::vec3(rotation.x, rotation.y, rotation.z);
+        }
+    }
+    auto compressedEnd = std::chrono::steady_clock::now();
+
+    size_t compressedSamples = (size_t)steps * clip.GetChannelCount();
+    if (samples > 0)
+        report.rawSampleNs = std::chrono::duration<double, std::nano>(rawEnd - rawStart).count() / samples;
+    if (compressedSamples > 0)
+        report.compressedSampleNs = std::chrono::duration<double, std::nano>(compressedEnd - rawEnd).count() / compressedSamples;
+
+    // Keeps the loops from being optimized away
+    volatile float keep = sink.x + sink.y + sink.z;
+    (void)keep;
+
+    return report;
+}
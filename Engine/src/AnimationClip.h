@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Keys of one node, one per tick. Only used while importing, what is loaded is an AnimationClip.
+struct Channel
+{
+    std::string name;
+
+    std::vector<glm::vec3> positionKeys;
+    std::vector<glm::quat> rotationKeys;
+    std::vector<glm::vec3> scaleKeys;
+};
+
+// Per-tick keys of an imported animation, before compression
+struct Animation {
+    
+    double duration = 0.0;
+    double ticksPerSecond = 0.0;
+    std::vector<Channel> channels;
+
+    bool IsValid() const {
+        return !channels.empty();
+    }
+};
+
+// Compressed animation, built from the per-tick keys of an Animation at import and sampled
+// as is at runtime. Every channel has a position, rotation and scale track:
+//  - tracks that never move further than the error bound keep one full precision value,
+//    and are stripped altogether when that value is the default (no move, no rotation, scale 1)
+//  - animated tracks keep only the keys linear interpolation cannot rebuild within the bound,
+//    with their frame numbers plus a coarse frame -> key table, so sampling finds its keys
+//    without searching the whole track
+//  - positions / scales are quantized to 16 bits over the track's range (or kept as floats when
+//    the range is too wide for 16 bits to hold the bound), rotations are stored smallest-three
+//    (3 x 15 bits + the index of the dropped component)
+class AnimationClip
+{
+public:
+    struct Settings
+    {
+        float positionError = 0.001f;   // in model units
+        float rotationError = 0.001f;   // radians
+        float scaleError = 0.0001f;
+    };
+
+    // Compression results against the source keys, for the import log
+    struct Report
+    {
+        size_t rawBytes = 0;
+        size_t compressedBytes = 0;
+        uint32_t channels = 0;
+        uint32_t constantTracks = 0;
+        uint32_t strippedTracks = 0;
+        uint32_t rawKeys = 0;
+        uint32_t keptKeys = 0;
+        float maxPositionError = 0.0f;
+        float maxRotationError = 0.0f;
+        float maxScaleError = 0.0f;
+        double rawSampleNs = 0.0;       // per channel sample (position + rotation + scale)
+        double compressedSampleNs = 0.0;
+    };
+
+    static AnimationClip Compress(const Animation& source, const Settings& settings);
+    static AnimationClip Compress(const Animation& source) { return Compress(source, Settings()); }
+    static Report Measure(const Animation& source, const AnimationClip& clip);
+
+    void Write(std::vector<unsigned char>& outData) const;
+    bool Read(const unsigned char* data, size_t size);
+    static bool IsClipData(const unsigned char* data, size_t size);
+
+    bool IsValid() const { return !channelNames.empty(); }
+    void Clear();
+
+    double GetDuration() const { return duration; }
+    double GetTicksPerSecond() const { return ticksPerSecond; }
+
+    size_t GetChannelCount() const { return channelNames.size(); }
+    const std::string& GetChannelName(size_t channel) const { return channelNames[channel]; }
+    // -1 if the clip does not animate that node
+    int FindChannel(const std::string& name) const;
+
+    void Sample(size_t channel, float time, glm::vec3& outPosition, glm::quat& outRotation, glm::vec3& outScale) const;
+
+    size_t GetMemoryBytes() const;
+
+private:
+    enum TrackType
+    {
+        TRACK_POSITION = 0,
+        TRACK_ROTATION,
+        TRACK_SCALE,
+        TRACKS_PER_CHANNEL
+    };
+
+    enum TrackEncoding
+    {
+        ENCODING_QUANTIZED = 0,     // 3 uint16 per key in values
+        ENCODING_FLOAT              // 3 floats per key in floatValues
+    };
+
+    struct Track
+    {
+        uint32_t firstKey = 0;      // in times
+        uint32_t keyCount = 0;      // 0: default value, 1: constant value in base
+        uint32_t firstValue = 0;    // in values or floatValues, depending on encoding
+        uint32_t firstBlock = 0;    // in keyLookup
+        uint32_t encoding = ENCODING_QUANTIZED;
+        float base[4] = {};         // constant value, or range minimum of a quantized position / scale
+        float extent[3] = {};       // range size of a quantized position / scale
+    };
+
+    glm::vec3 SampleVector(const Track& track, float time, const glm::vec3& defaultValue) const;
+    glm::quat SampleRotation(const Track& track, float time) const;
+    glm::vec3 GetVectorKey(const Track& track, uint32_t key) const;
+    // Keys around time: k0 <= time < k1 (or both the first / last key), and the factor between them
+    void FindKeys(const Track& track, float time, uint32_t& outKey0, uint32_t& outKey1, float& outFactor) const;
+
+    void CompressVectorTrack(const std::vector<glm::vec3>& keys, const glm::vec3& defaultValue, float maxError, Track& outTrack);
+    void CompressRotationTrack(const std::vector<glm::quat>& keys, float maxError, Track& outTrack);
+    void BuildKeyLookup(Track& track);
+    bool IsTrackValid(const Track& track) const;
+
+    double duration = 0.0;
+    double ticksPerSecond = 0.0;
+
+    std::vector<std::string> channelNames;
+    std::vector<Track> tracks;          // TRACKS_PER_CHANNEL per channel
+    std::vector<uint16_t> times;        // frame of each kept key
+    std::vector<uint16_t> keyLookup;    // per track and block of frames, the last key at or before the block start
+    std::vector<uint16_t> values;       // 3 per quantized key
+    std::vector<float> floatValues;     // 3 per float key
+};
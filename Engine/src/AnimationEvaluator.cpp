@@ -0,0 +1,169 @@
+#include "AnimationEvaluator.h"
+#include "AnimationClip.h"
+#include <cmath>
+
+void AnimationEvaluator::Evaluate(const std::vector<BoneLink>& bones, const std::vector<int>& evaluationOrder, int ownerBone,
+    std::vector<AnimationLayer>& layers, int maxBoneDepth)
+{
+    // Only reads the channels and the evaluator's own buffers, no transforms
+    size_t boneCount = bones.size();
+    if (bindPose.GetBoneCount() != boneCount) bindPose.Resize(boneCount);
+    for (size_t i = 0; i < boneCount; ++i) {
+        const BoneLink& link = bones[i];
+        bindPose.SetBone(i, link.originalPos, link.originalRot, link.originalScl);
+    }
+
+    // What the base layer leaves uncovered (fading in from nothing, fading out) is bind pose
+    AnimationLayer& base = layers[0];
+    float coverage = SampleLayer(bones, base, false, maxBoneDepth, base.pose);
+    if (coverage >= 1.0f) {
+        sampledPose.CopyFrom(base.pose);
+    }
+    else {
+        sampledPose.CopyFrom(bindPose);
+        if (coverage > 0.0f) sampledPose.Blend(base.pose, coverage, nullptr);
+    }
+
+    for (size_t l = 1; l < layers.size(); ++l) {
+        AnimationLayer& layer = layers[l];
+        if (layer.weight <= 0.0f || layer.motions.empty()) continue;
+        if (!layer.boneWeights.empty() && layer.boneWeights.size() != boneCount) continue;
+
+        coverage = SampleLayer(bones, layer, false, maxBoneDepth, layer.pose);
+        if (coverage <= 0.0f) continue;
+
+        const float* mask = layer.boneWeights.empty() ? nullptr : layer.boneWeights.data();
+        if (layer.mode == AnimationLayerMode::ADDITIVE) {
+            SampleLayer(bones, layer, true, maxBoneDepth, layer.reference);
+            sampledPose.AddDifference(layer.pose, layer.reference, layer.weight * coverage, mask);
+        }
+        else {
+            sampledPose.Blend(layer.pose, layer.weight * coverage, mask);
+        }
+    }
+
+    ComputeModelPose(bones, evaluationOrder, ownerBone);
+}
+
+float AnimationEvaluator::SampleLayer(const std::vector<BoneLink>& bones, AnimationLayer& layer, bool atStart, int maxBoneDepth, AnimationPose& outPose)
+{
+    float coverage = AnimationGraph::ComputeMotionWeights(layer.motions, motionWeights);
+    if (coverage <= 0.0f) return 0.0f;
+
+    int single = -1;
+    int count = 0;
+    for (size_t m = 0; m < layer.motions.size(); ++m) {
+        if (motionWeights[m] > 0.0f) {
+            single = (int)m;
+            ++count;
+        }
+    }
+
+    if (count == 1) {
+        const AnimationMotion& motion = layer.motions[single];
+        SampleMotion(bones, motion, atStart ? 0.0f : motion.phase, maxBoneDepth, outPose);
+        return coverage;
+    }
+
+    // Cross-fade: the weights are over the covered part only
+    bool first = true;
+    for (size_t m = 0; m < layer.motions.size(); ++m) {
+        if (motionWeights[m] <= 0.0f) continue;
+
+        const AnimationMotion& motion = layer.motions[m];
+        SampleMotion(bones, motion, atStart ? 0.0f : motion.phase, maxBoneDepth, motionPose);
+
+        float weight = motionWeights[m] / coverage;
+        if (first) outPose.Scale(motionPose, weight);
+        else outPose.Accumulate(motionPose, weight);
+        first = false;
+    }
+    outPose.NormalizeRotations();
+
+    return coverage;
+}
+
+void AnimationEvaluator::SampleMotion(const std::vector<BoneLink>& bones, const AnimationMotion& motion, float phase, int maxBoneDepth, AnimationPose& outPose)
+{
+    int single = -1;
+    int count = 0;
+    for (size_t c = 0; c < motion.clips.size(); ++c) {
+        if (motion.clips[c].clip && motion.clips[c].weight > 0.0f) {
+            single = (int)c;
+            ++count;
+        }
+    }
+
+    if (count == 0) {
+        outPose.CopyFrom(bindPose);
+        return;
+    }
+    if (count == 1) {
+        SampleClip(bones, motion.clips[single], phase, maxBoneDepth, outPose);
+        return;
+    }
+
+    // Blend space: every clip at the same phase
+    bool first = true;
+    for (const ClipPlayback& playback : motion.clips) {
+        if (!playback.clip || playback.weight <= 0.0f) continue;
+
+        SampleClip(bones, playback, phase, maxBoneDepth, clipPose);
+        if (first) outPose.Scale(clipPose, playback.weight);
+        else outPose.Accumulate(clipPose, playback.weight);
+        first = false;
+    }
+    outPose.NormalizeRotations();
+}
+
+void AnimationEvaluator::SampleClip(const std::vector<BoneLink>& bones, const ClipPlayback& playback, float phase, int maxBoneDepth, AnimationPose& outPose) const
+{
+    outPose.CopyFrom(bindPose);
+
+    const AnimationClip& clip = *playback.clip;
+    float time = phase * (float)clip.GetDuration();
+
+    size_t count = std::min(playback.channels.size(), bones.size());
+    for (size_t i = 0; i < count; ++i) {
+        int channel = playback.channels[i];
+        if (channel < 0 || bones[i].depth > maxBoneDepth) continue;
+
+        glm::vec3 position, scale;
+        glm::quat rotation;
+        bindPose.GetBone(i, position, rotation, scale);
+        clip.Sample(channel, time, position, rotation, scale);
+        outPose.SetBone(i, position, rotation, scale);
+    }
+}
+
+void AnimationEvaluator::ComputeModelPose(const std::vector<BoneLink>& bones, const std::vector<int>& evaluationOrder, int ownerBone)
+{
+    modelPose.resize(bones.size());
+    float radiusSquared = 0.0f;
+
+    for (int index : evaluationOrder) {
+        // The owner itself is the origin of model space, its pose goes on its transform
+        if (index == ownerBone) {
+            modelPose[index] = glm::mat4(1.0f);
+            continue;
+        }
+
+        glm::vec3 position, scale;
+        glm::quat rotation;
+        sampledPose.GetBone(index, position, rotation, scale);
+
+        glm::mat4 local = glm::mat4_cast(rotation);
+        local[0] *= scale.x;
+        local[1] *= scale.y;
+        local[2] *= scale.z;
+        local[3] = glm::vec4(position, 1.0f);
+
+        int parent = bones[index].parent;
+        modelPose[index] = parent >= 0 ? modelPose[parent] * local : local;
+
+        glm::vec3 bonePosition(modelPose[index][3]);
+        radiusSquared = std::max(radiusSquared, glm::dot(bonePosition, bonePosition));
+    }
+
+    boundsRadius = std::sqrt(radiusSquared);
+}
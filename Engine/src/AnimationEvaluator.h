@@ -0,0 +1,123 @@
+#pragma once
+
+#include "AnimationGraph.h"
+#include "AnimationPose.h"
+#include "Handle.h"
+#include <algorithm>
+#include <climits>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+class GameObject;
+
+struct BoneLink {
+    std::string boneName;
+    // Resolves to nullptr once the bone object is deleted
+    GameObjectHandle bone;
+
+    glm::vec3 originalPos;
+    glm::quat originalRot;
+    glm::vec3 originalScl;
+
+    // Skeleton index of the parent bone, -1 right under the component owner
+    int parent = -1;
+    // Parent bones above it in the skeleton
+    int depth = 0;
+    // False for the nodes only added to link animated bones to the owner: the pose never
+    // writes them, their current local transform is read instead
+    bool animated = true;
+    // Children that never need the pose on their object: child bones and empty leaf nodes
+    // (end bones of the import). Anything past that is an attachment.
+    size_t staticChildren = 0;
+    // The bone object gets the sampled pose this frame
+    bool sync = false;
+};
+
+enum class AnimationLodLevel {
+    FULL,
+    REDUCED,
+    LOW,
+    CULLED      // outside every active camera
+};
+
+// Shared by every animation: how detail drops for characters that are small on screen,
+// far away or not seen by any camera. Only applies in play mode.
+struct AnimationLodPolicy {
+    enum class Metric {
+        SCREEN_SIZE,
+        DISTANCE
+    };
+
+    bool enabled = true;
+    Metric metric = Metric::SCREEN_SIZE;
+
+    // Fraction of the screen height the character covers, below which it drops a level
+    float reducedScreenSize = 0.3f;
+    float lowScreenSize = 0.1f;
+    // Distance to the nearest camera seeing it, above which it drops a level
+    float reducedDistance = 15.0f;
+    float lowDistance = 40.0f;
+
+    // Frames between pose updates, time still advances by the whole interval
+    int reducedInterval = 2;
+    int lowInterval = 4;
+    int culledInterval = 8;
+
+    // At LOW and CULLED deeper bones (fingers, face) are left in their bind pose
+    int lowMaxBoneDepth = 6;
+
+    int GetInterval(AnimationLodLevel level) const
+    {
+        switch (level)
+        {
+        case AnimationLodLevel::REDUCED:    return std::max(1, reducedInterval);
+        case AnimationLodLevel::LOW:        return std::max(1, lowInterval);
+        case AnimationLodLevel::CULLED:     return std::max(1, culledInterval);
+        default:                            return 1;
+        }
+    }
+
+    int GetMaxBoneDepth(AnimationLodLevel level) const
+    {
+        return level == AnimationLodLevel::LOW || level == AnimationLodLevel::CULLED ? lowMaxBoneDepth : INT_MAX;
+    }
+};
+
+// The part of ComponentAnimation's update that never touches a GameObject: sampling the
+// layers into a local pose and building the owner space pose from it. ComponentAnimation
+// runs it on a worker thread; the headless benchmark runs it on skeletons it builds itself.
+class AnimationEvaluator
+{
+public:
+    // bones in skeleton order, evaluationOrder with parents before children. ownerBone is
+    // the skeleton index of the owner when a clip animates it, -1 otherwise.
+    // Bones deeper than maxBoneDepth stay in their bind pose.
+    void Evaluate(const std::vector<BoneLink>& bones, const std::vector<int>& evaluationOrder, int ownerBone,
+        std::vector<AnimationLayer>& layers, int maxBoneDepth);
+
+    // Local transform of every bone
+    const AnimationPose& GetLocalPose() const { return sampledPose; }
+    // Bone -> owner space matrix of every bone
+    const std::vector<glm::mat4>& GetModelPose() const { return modelPose; }
+    // Farthest bone from the owner, in owner space
+    float GetBoundsRadius() const { return boundsRadius; }
+
+private:
+    // Returns how much of the layer its motions cover, outPose holds their blend alone.
+    // atStart samples every motion at its first frame (the additive reference).
+    float SampleLayer(const std::vector<BoneLink>& bones, AnimationLayer& layer, bool atStart, int maxBoneDepth, AnimationPose& outPose);
+    void SampleMotion(const std::vector<BoneLink>& bones, const AnimationMotion& motion, float phase, int maxBoneDepth, AnimationPose& outPose);
+    void SampleClip(const std::vector<BoneLink>& bones, const ClipPlayback& playback, float phase, int maxBoneDepth, AnimationPose& outPose) const;
+    void ComputeModelPose(const std::vector<BoneLink>& bones, const std::vector<int>& evaluationOrder, int ownerBone);
+
+    AnimationPose sampledPose;
+    // Original transforms of the bones, what no clip covers blends towards
+    AnimationPose bindPose;
+    AnimationPose clipPose;
+    AnimationPose motionPose;
+    std::vector<float> motionWeights;
+    std::vector<glm::mat4> modelPose;
+    float boundsRadius = 1.0f;
+};
@@ -0,0 +1,115 @@
+#include "AnimationGraph.h"
+#include "AnimationClip.h"
+#include <algorithm>
+#include <cmath>
+
+void AnimationGraph::UpdateBlendSpaceWeights(AnimationMotion& motion, const std::unordered_map<std::string, float>& parameters)
+{
+    std::vector<ClipPlayback>& clips = motion.clips;
+    if (motion.parameter.empty() || clips.empty()) return;
+
+    auto it = parameters.find(motion.parameter);
+    float value = it != parameters.end() ? it->second : 0.0f;
+
+    // Clips are sorted by position when the motion is created
+    for (ClipPlayback& clip : clips) clip.weight = 0.0f;
+
+    if (value <= clips.front().position)
+    {
+        clips.front().weight = 1.0f;
+        return;
+    }
+    if (value >= clips.back().position)
+    {
+        clips.back().weight = 1.0f;
+        return;
+    }
+
+    for (size_t i = 0; i + 1 < clips.size(); ++i)
+    {
+        float from = clips[i].position;
+        float to = clips[i + 1].position;
+        if (value < to)
+        {
+            float factor = to > from ? (value - from) / (to - from) : 0.0f;
+            clips[i].weight = 1.0f - factor;
+            clips[i + 1].weight = factor;
+            return;
+        }
+    }
+}
+
+float AnimationGraph::GetMotionLength(const AnimationMotion& motion)
+{
+    float length = 0.0f;
+    for (const ClipPlayback& clip : motion.clips)
+    {
+        if (!clip.clip || clip.weight <= 0.0f) continue;
+
+        double ticksPerSecond = clip.clip->GetTicksPerSecond();
+        if (ticksPerSecond > 0.0)
+        {
+            length += clip.weight * (float)(clip.clip->GetDuration() / ticksPerSecond);
+        }
+    }
+    return length;
+}
+
+void AnimationGraph::AdvanceMotion(AnimationMotion& motion, float dt)
+{
+    if (motion.fadeDuration > 0.0f)
+    {
+        motion.fade = std::min(1.0f, motion.fade + dt / motion.fadeDuration);
+    }
+
+    float length = GetMotionLength(motion);
+    if (length <= 0.0f || motion.ended) return;
+
+    motion.phase += dt * motion.speed / length;
+
+    if (motion.phase >= 1.0f)
+    {
+        if (motion.loop)
+        {
+            motion.phase -= std::floor(motion.phase);
+        }
+        else
+        {
+            motion.phase = 1.0f;
+            motion.ended = true;
+        }
+    }
+}
+
+void AnimationGraph::AdvanceLayers(std::vector<AnimationLayer>& layers, const std::unordered_map<std::string, float>& parameters, float dt)
+{
+    for (AnimationLayer& layer : layers)
+    {
+        for (AnimationMotion& motion : layer.motions)
+        {
+            UpdateBlendSpaceWeights(motion, parameters);
+            AdvanceMotion(motion, dt);
+        }
+    }
+}
+
+float AnimationGraph::ComputeMotionWeights(const std::vector<AnimationMotion>& motions, std::vector<float>& outWeights)
+{
+    outWeights.assign(motions.size(), 0.0f);
+
+    // The newest motion takes its fade, each one below gets its fade of what is left
+    float remaining = 1.0f;
+    for (size_t i = motions.size(); i-- > 0 && remaining > 0.0f; )
+    {
+        outWeights[i] = remaining * motions[i].fade;
+        remaining -= outWeights[i];
+    }
+
+    float coverage = 0.0f;
+    for (size_t i = 0; i < motions.size(); ++i)
+    {
+        if (motions[i].clips.empty()) outWeights[i] = 0.0f;
+        coverage += outWeights[i];
+    }
+    return std::min(1.0f, coverage);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "AnimationPose.h"
+#include "Globals.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class AnimationClip;
+
+// Clips laid out along one parameter. The two clips around the parameter value are
+// blended, and every clip of the space plays at the same phase so cycles of different
+// lengths (walk / run) stay in step.
+struct BlendSpacePoint
+{
+    std::string clip;           // name in the component's animation library
+    float position = 0.0f;
+};
+
+struct BlendSpace
+{
+    std::string parameter;
+    std::vector<BlendSpacePoint> points;
+    float speed = 1.0f;
+    bool loop = true;
+};
+
+// One clip of a motion
+struct ClipPlayback
+{
+    UID uid = 0;
+    // The loaded ResourceAnimation's clip, nullptr if it could not be loaded
+    const AnimationClip* clip = nullptr;
+    float position = 0.0f;      // in the blend space
+    float weight = 1.0f;        // inside the motion, the weights of a motion add up to 1
+    // Channel of every skeleton bone in the clip, -1 leaves the bone in its bind pose
+    std::vector<int> channels;
+};
+
+// A clip or a blend space playing on a layer
+struct AnimationMotion
+{
+    std::string name;
+    std::vector<ClipPlayback> clips;
+    std::string parameter;      // drives the blend space, empty for a single clip
+    float phase = 0.0f;         // 0..1 over the clip (or the blended clip length)
+    float speed = 1.0f;
+    bool loop = true;
+    bool ended = false;
+
+    // Cross-fade: the motion covers fade of whatever plays under it
+    float fade = 1.0f;
+    float fadeDuration = 0.0f;
+};
+
+enum class AnimationLayerMode
+{
+    OVERRIDE,   // replaces the layers below on its bones
+    ADDITIVE    // adds its difference from the clips' first frame
+};
+
+struct AnimationLayer
+{
+    std::string name;
+    AnimationLayerMode mode = AnimationLayerMode::OVERRIDE;
+    float weight = 1.0f;
+    // Bones driven by the layer together with everything under them, every bone when empty
+    std::vector<std::string> maskBones;
+
+    // Oldest first: each motion fades in over the ones before it
+    std::vector<AnimationMotion> motions;
+    // Per skeleton bone from maskBones, empty for every bone
+    std::vector<float> boneWeights;
+
+    // Evaluation buffers
+    AnimationPose pose;
+    AnimationPose reference;
+};
+
+namespace AnimationGraph
+{
+    // Weights of the clips of a blend space for the current parameter value
+    void UpdateBlendSpaceWeights(AnimationMotion& motion, const std::unordered_map<std::string, float>& parameters);
+
+    // Length in seconds of one cycle, the clip lengths blended by weight
+    float GetMotionLength(const AnimationMotion& motion);
+
+    // Moves phase and fade forward by dt seconds
+    void AdvanceMotion(AnimationMotion& motion, float dt);
+    // Blend space weights and AdvanceMotion for every motion of every layer
+    void AdvanceLayers(std::vector<AnimationLayer>& layers, const std::unordered_map<std::string, float>& parameters, float dt);
+
+    // Weight of each motion of the layer once the fades are applied. Returns the weight the
+    // motions with clips cover: a motion without clips is a fade out of the layer.
+    float ComputeMotionWeights(const std::vector<AnimationMotion>& motions, std::vector<float>& outWeights);
+}
@@ -1,9 +1,80 @@
 #include "AnimationImporter.h"
 #include "ResourceAnimation.h"
 #include "LibraryManager.h"
+#include "MappedFile.h"
 #include "Log.h"
 #include <assimp/scene.h>
 #include <fstream>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    // Assimp keys may come at any time. They are resampled to one key per tick, what the
+    // runtime and the clip compression expect. next is the first key after the previous
+    // sample, times only go forward.
+    glm::vec3 SampleVectorKeys(const aiVectorKey* keys, unsigned int numKeys, double time, unsigned int& next) {
+        while (next < numKeys && keys[next].mTime <= time) next++;
+
+        if (next == 0) return glm::vec3(keys[0].mValue.x, keys[0].mValue.y, keys[0].mValue.z);
+        const aiVectorKey& key0 = keys[next - 1];
+        if (next == numKeys) return glm::vec3(key0.mValue.x, key0.mValue.y, key0.mValue.z);
+
+        const aiVectorKey& key1 = keys[next];
+        float factor = (float)((time - key0.mTime) / (key1.mTime - key0.mTime));
+        return glm::mix(glm::vec3(key0.mValue.x, key0.mValue.y, key0.mValue.z),
+            glm::vec3(key1.mValue.x, key1.mValue.y, key1.mValue.z), factor);
+    }
+
+    glm::quat SampleQuatKeys(const aiQuatKey* keys, unsigned int numKeys, double time, unsigned int& next) {
+        while (next < numKeys && keys[next].mTime <= time) next++;
+
+        if (next == 0) return glm::quat(keys[0].mValue.w, keys[0].mValue.x, keys[0].mValue.y, keys[0].mValue.z);
+        const aiQuatKey& key0 = keys[next - 1];
+        if (next == numKeys) return glm::quat(key0.mValue.w, key0.mValue.x, key0.mValue.y, key0.mValue.z);
+
+        const aiQuatKey& key1 = keys[next];
+        float factor = (float)((time - key0.mTime) / (key1.mTime - key0.mTime));
+        return glm::slerp(glm::quat(key0.mValue.w, key0.mValue.x, key0.mValue.y, key0.mValue.z),
+            glm::quat(key1.mValue.w, key1.mValue.x, key1.mValue.y, key1.mValue.z), factor);
+    }
+
+    // Library files written before clip compression: raw keys per channel
+    bool ReadRawFormat(const unsigned char* data, size_t size, Animation& outAnimation) {
+        size_t offset = 0;
+        auto read = [&](void* target, size_t bytes) {
+            if (bytes > size - offset) return false;
+            memcpy(target, data + offset, bytes);
+            offset += bytes;
+            return true;
+        };
+
+        uint32_t numChannels = 0;
+        if (size < 2 * sizeof(double) + sizeof(uint32_t)) return false;
+        read(&outAnimation.duration, sizeof(double));
+        read(&outAnimation.ticksPerSecond, sizeof(double));
+        read(&numChannels, sizeof(uint32_t));
+
+        outAnimation.channels.resize(numChannels);
+        for (Channel& channel : outAnimation.channels) {
+            uint32_t nameSize = 0;
+            if (!read(&nameSize, sizeof(uint32_t)) || nameSize > size - offset) return false;
+            channel.name.assign(reinterpret_cast<const char*>(data + offset), nameSize);
+            offset += nameSize;
+
+            uint32_t numPos = 0, numRot = 0, numScl = 0;
+            if (!read(&numPos, sizeof(uint32_t)) || !read(&numRot, sizeof(uint32_t)) || !read(&numScl, sizeof(uint32_t))) return false;
+
+            channel.positionKeys.resize(numPos);
+            channel.rotationKeys.resize(numRot);
+            channel.scaleKeys.resize(numScl);
+            if (!read(channel.positionKeys.data(), numPos * sizeof(glm::vec3)) ||
+                !read(channel.rotationKeys.data(), numRot * sizeof(glm::quat)) ||
+                !read(channel.scaleKeys.data(), numScl * sizeof(glm::vec3))) return false;
+        }
+
+        return true;
+    }
+}
 
 AnimationImporter::AnimationImporter() {}
 AnimationImporter::~AnimationImporter() {}
@@ -26,9 +97,7 @@ Animation AnimationImporter::ImportFromAssimp(const aiAnimation* assimpAnim) {
         animData.ticksPerSecond = 24.0;
     }
 
-    if (assimpAnim->mChannels[0]->mNumPositionKeys < (unsigned int)animData.duration) {
-        LOG_CONSOLE("[AnimationImporter] WARNING: Animation %s seems NOT baked. Runtime glitches expected.", assimpAnim->mName.C_Str());
-    }
+    unsigned int numFrames = (unsigned int)std::floor(animData.duration) + 1;
 
     animData.channels.reserve(assimpAnim->mNumChannels);
 
@@ -40,24 +109,30 @@ Animation AnimationImporter::ImportFromAssimp(const aiAnimation* assimpAnim) {
         ourChannel.name = aiChannel->mNodeName.C_Str();
 
         // Extraer Posiciones
-        ourChannel.positionKeys.reserve(aiChannel->mNumPositionKeys);
-        for (unsigned int k = 0; k < aiChannel->mNumPositionKeys; k++) {
-            aiVectorKey aiKey = aiChannel->mPositionKeys[k];
-            ourChannel.positionKeys.push_back(glm::vec3(aiKey.mValue.x, aiKey.mValue.y, aiKey.mValue.z));
+        unsigned int numPos = aiChannel->mNumPositionKeys;
+        unsigned int posFrames = numPos > 1 ? numFrames : numPos;
+        ourChannel.positionKeys.reserve(posFrames);
+        unsigned int nextKey = 0;
+        for (unsigned int f = 0; f < posFrames; f++) {
+            ourChannel.positionKeys.push_back(SampleVectorKeys(aiChannel->mPositionKeys, numPos, (double)f, nextKey));
         }
 
         // Extraer Rotaciones
-        ourChannel.rotationKeys.reserve(aiChannel->mNumRotationKeys);
-        for (unsigned int k = 0; k < aiChannel->mNumRotationKeys; k++) {
-            aiQuatKey aiKey = aiChannel->mRotationKeys[k];
-            ourChannel.rotationKeys.push_back(glm::quat(aiKey.mValue.w, aiKey.mValue.x, aiKey.mValue.y, aiKey.mValue.z));
+        unsigned int numRot = aiChannel->mNumRotationKeys;
+        unsigned int rotFrames = numRot > 1 ? numFrames : numRot;
+        ourChannel.rotationKeys.reserve(rotFrames);
+        nextKey = 0;
+        for (unsigned int f = 0; f < rotFrames; f++) {
+            ourChannel.rotationKeys.push_back(SampleQuatKeys(aiChannel->mRotationKeys, numRot, (double)f, nextKey));
         }
 
         // Extraer Escalas
-        ourChannel.scaleKeys.reserve(aiChannel->mNumScalingKeys);
-        for (unsigned int k = 0; k < aiChannel->mNumScalingKeys; k++) {
-            aiVectorKey aiKey = aiChannel->mScalingKeys[k];
-            ourChannel.scaleKeys.push_back(glm::vec3(aiKey.mValue.x, aiKey.mValue.y, aiKey.mValue.z));
+        unsigned int numScl = aiChannel->mNumScalingKeys;
+        unsigned int sclFrames = numScl > 1 ? numFrames : numScl;
+        ourChannel.scaleKeys.reserve(sclFrames);
+        nextKey = 0;
+        for (unsigned int f = 0; f < sclFrames; f++) {
+            ourChannel.scaleKeys.push_back(SampleVectorKeys(aiChannel->mScalingKeys, numScl, (double)f, nextKey));
         }
 
         animData.channels.push_back(ourChannel);
@@ -66,7 +141,7 @@ Animation AnimationImporter::ImportFromAssimp(const aiAnimation* assimpAnim) {
     return animData;
 }
 
-// SAVE: Our AnimationData -> Custom Binary Format
+// SAVE: Our AnimationData -> compressed clip
 bool AnimationImporter::SaveToCustomFormat(const Animation& animData, const UID& uid) {
 
     std::string fullPath = LibraryManager::GetLibraryPath(uid);
@@ -77,92 +152,47 @@ bool AnimationImporter::SaveToCustomFormat(const Animation& animData, const UID&
         return false;
     }
 
-    file.write(reinterpret_cast<const char*>(&animData.duration), sizeof(double));
-    file.write(reinterpret_cast<const char*>(&animData.ticksPerSecond), sizeof(double));
-
-    uint32_t numChannels = static_cast<uint32_t>(animData.channels.size());
-    file.write(reinterpret_cast<const char*>(&numChannels), sizeof(uint32_t));
-
-    for (const auto& channel : animData.channels)
-    {
-        uint32_t nameSize = static_cast<uint32_t>(channel.name.size());
-        file.write(reinterpret_cast<const char*>(&nameSize), sizeof(uint32_t));
-        file.write(channel.name.c_str(), nameSize);
-
-        uint32_t numPos = static_cast<uint32_t>(channel.positionKeys.size());
-        uint32_t numRot = static_cast<uint32_t>(channel.rotationKeys.size());
-        uint32_t numScl = static_cast<uint32_t>(channel.scaleKeys.size());
-
-        file.write(reinterpret_cast<const char*>(&numPos), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&numRot), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&numScl), sizeof(uint32_t));
-
-        if (numPos > 0)
-            file.write(reinterpret_cast<const char*>(channel.positionKeys.data()), numPos * sizeof(glm::vec3));
-
-        if (numRot > 0)
-            file.write(reinterpret_cast<const char*>(channel.rotationKeys.data()), numRot * sizeof(glm::quat));
-
-        if (numScl > 0)
-            file.write(reinterpret_cast<const char*>(channel.scaleKeys.data()), numScl * sizeof(glm::vec3));
-    }
+    AnimationClip clip = AnimationClip::Compress(animData);
 
+    std::vector<unsigned char> data;
+    clip.Write(data);
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
     file.close();
-    LOG_CONSOLE("[AnimationImporter] Saved animation binary: %s", fullPath.c_str());
+
+    AnimationClip::Report report = AnimationClip::Measure(animData, clip);
+    LOG_CONSOLE("[AnimationImporter] Saved animation clip: %s", fullPath.c_str());
+    LOG_CONSOLE("[AnimationImporter]   %u channels, %u/%u keys kept, %u constant and %u stripped tracks",
+        report.channels, report.keptKeys, report.rawKeys, report.constantTracks, report.strippedTracks);
+    LOG_CONSOLE("[AnimationImporter]   %.1f KB -> %.1f KB (%.1fx), max error pos %.5f rot %.5f rad scale %.5f, sample %.1f -> %.1f ns",
+        report.rawBytes / 1024.0, report.compressedBytes / 1024.0,
+        report.compressedBytes > 0 ? (double)report.rawBytes / report.compressedBytes : 0.0,
+        report.maxPositionError, report.maxRotationError, report.maxScaleError,
+        report.rawSampleNs, report.compressedSampleNs);
     return true;
 }
 
-Animation AnimationImporter::LoadFromCustomFormat(const UID& uid) {
+AnimationClip AnimationImporter::LoadFromCustomFormat(const UID& uid) {
 
-    Animation animData;
+    AnimationClip clip;
     std::string fullPath = LibraryManager::GetLibraryPath(uid);
 
-    std::ifstream file(fullPath, std::ios::in | std::ios::binary);
-    if (!file.is_open()) {
+    MappedFile file;
+    if (!file.Open(fullPath)) {
         LOG_CONSOLE("[AnimationImporter] ERROR: Could not open file for reading: %s", fullPath.c_str());
-        return animData;
+        return clip;
     }
 
-    file.read(reinterpret_cast<char*>(&animData.duration), sizeof(double));
-    file.read(reinterpret_cast<char*>(&animData.ticksPerSecond), sizeof(double));
-
-    uint32_t numChannels = 0;
-    file.read(reinterpret_cast<char*>(&numChannels), sizeof(uint32_t));
-
-    animData.channels.reserve(numChannels);
-
-    for (uint32_t i = 0; i < numChannels; ++i)
-    {
-        Channel channel;
-
-        uint32_t nameSize = 0;
-        file.read(reinterpret_cast<char*>(&nameSize), sizeof(uint32_t));
-        if (nameSize > 0) {
-            channel.name.resize(nameSize);
-            file.read(&channel.name[0], nameSize);
-        }
-
-        uint32_t numPos = 0, numRot = 0, numScl = 0;
-        file.read(reinterpret_cast<char*>(&numPos), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&numRot), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&numScl), sizeof(uint32_t));
-
-        if (numPos > 0) {
-            channel.positionKeys.resize(numPos);
-            file.read(reinterpret_cast<char*>(channel.positionKeys.data()), numPos * sizeof(glm::vec3));
-        }
-        if (numRot > 0) {
-            channel.rotationKeys.resize(numRot);
-            file.read(reinterpret_cast<char*>(channel.rotationKeys.data()), numRot * sizeof(glm::quat));
-        }
-        if (numScl > 0) {
-            channel.scaleKeys.resize(numScl);
-            file.read(reinterpret_cast<char*>(channel.scaleKeys.data()), numScl * sizeof(glm::vec3));
-        }
+    if (AnimationClip::IsClipData(file.GetData(), file.GetSize())) {
+        clip.Read(file.GetData(), file.GetSize());
+        return clip;
+    }
 
-        animData.channels.push_back(channel);
+    // Raw keys from an older import, compressed here until the asset is imported again
+    Animation animData;
+    if (!ReadRawFormat(file.GetData(), file.GetSize(), animData)) {
+        LOG_CONSOLE("[AnimationImporter] ERROR: Corrupt animation file: %s", fullPath.c_str());
+        return clip;
     }
 
-    file.close();
-    return animData;
+    return AnimationClip::Compress(animData);
 }
\ No newline at end of file
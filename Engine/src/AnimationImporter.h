@@ -6,6 +6,7 @@
 #include <glm/gtc/quaternion.hpp>
 
 #include "ResourceAnimation.h"
+#include "AnimationClip.h"
 
 struct aiAnimation;
 
@@ -17,9 +18,9 @@ public:
     // IMPORT: Convert from Assimp animation to our AnimationData structure
     static Animation ImportFromAssimp(const aiAnimation* aiAnimation);
 
-    // SAVE: Save our AnimationData to custom binary format in Library/Animations/
+    // SAVE: Compress our AnimationData into a clip in Library/Animations/, logging the size / error report
     static bool SaveToCustomFormat(const Animation& animation, const UID& uid);
 
-    // LOAD: Load from custom binary format back into our AnimationData structure
-    static Animation LoadFromCustomFormat(const UID& uid);
+    // LOAD: Load the compressed clip back (older raw files are compressed on load)
+    static AnimationClip LoadFromCustomFormat(const UID& uid);
 };
\ No newline at end of file
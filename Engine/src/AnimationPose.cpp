@@ -0,0 +1,222 @@
+#include "AnimationPose.h"
+#include <cmath>
+#include <cstring>
+
+void AnimationPose::Resize(size_t count)
+{
+    boneCount = count;
+    stride = (count + 3) & ~(size_t)3;
+    data.assign(stride * COMPONENT_COUNT, 0.0f);
+
+    // Identity, so bones nothing writes are not degenerate
+    float* rw = Get(ROTATION_W);
+    float* sx = Get(SCALE_X);
+    float* sy = Get(SCALE_Y);
+    float* sz = Get(SCALE_Z);
+    for (size_t i = 0; i < stride; ++i)
+    {
+        rw[i] = 1.0f;
+        sx[i] = sy[i] = sz[i] = 1.0f;
+    }
+}
+
+void AnimationPose::SetBone(size_t bone, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+{
+    float* base = data.data() + bone;
+    base[POSITION_X * stride] = position.x;
+    base[POSITION_Y * stride] = position.y;
+    base[POSITION_Z * stride] = position.z;
+    base[ROTATION_X * stride] = rotation.x;
+    base[ROTATION_Y * stride] = rotation.y;
+    base[ROTATION_Z * stride] = rotation.z;
+    base[ROTATION_W * stride] = rotation.w;
+    base[SCALE_X * stride] = scale.x;
+    base[SCALE_Y * stride] = scale.y;
+    base[SCALE_Z * stride] = scale.z;
+}
+
+void AnimationPose::GetBone(size_t bone, glm::vec3& outPosition, glm::quat& outRotation, glm::vec3& outScale) const
+{
+    const float* base = data.data() + bone;
+    outPosition = glm::vec3(base[POSITION_X * stride], base[POSITION_Y * stride], base[POSITION_Z * stride]);
+    outRotation = glm::quat(base[ROTATION_W * stride], base[ROTATION_X * stride], base[ROTATION_Y * stride], base[ROTATION_Z * stride]);
+    outScale = glm::vec3(base[SCALE_X * stride], base[SCALE_Y * stride], base[SCALE_Z * stride]);
+}
+
+void AnimationPose::CopyFrom(const AnimationPose& source)
+{
+    if (source.boneCount != boneCount) Resize(source.boneCount);
+    if (!data.empty()) memcpy(data.data(), source.data.data(), data.size() * sizeof(float));
+}
+
+void AnimationPose::Scale(const AnimationPose& source, float weight)
+{
+    if (source.boneCount != boneCount) Resize(source.boneCount);
+
+    const float* in = source.data.data();
+    float* out = data.data();
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        out[i] = in[i] * weight;
+    }
+}
+
+void AnimationPose::Accumulate(const AnimationPose& source, float weight)
+{
+    for (int c = POSITION_X; c <= POSITION_Z; ++c)
+    {
+        const float* in = source.Get((Component)c);
+        float* out = Get((Component)c);
+        for (size_t i = 0; i < stride; ++i) out[i] += in[i] * weight;
+    }
+    for (int c = SCALE_X; c <= SCALE_Z; ++c)
+    {
+        const float* in = source.Get((Component)c);
+        float* out = Get((Component)c);
+        for (size_t i = 0; i < stride; ++i) out[i] += in[i] * weight;
+    }
+
+    const float* ix = source.Get(ROTATION_X);
+    const float* iy = source.Get(ROTATION_Y);
+    const float* iz = source.Get(ROTATION_Z);
+    const float* iw = source.Get(ROTATION_W);
+    float* ox = Get(ROTATION_X);
+    float* oy = Get(ROTATION_Y);
+    float* oz = Get(ROTATION_Z);
+    float* ow = Get(ROTATION_W);
+    for (size_t i = 0; i < stride; ++i)
+    {
+        float dot = ox[i] * ix[i] + oy[i] * iy[i] + oz[i] * iz[i] + ow[i] * iw[i];
+        float signedWeight = dot < 0.0f ? -weight : weight;
+        ox[i] += ix[i] * signedWeight;
+        oy[i] += iy[i] * signedWeight;
+        oz[i] += iz[i] * signedWeight;
+        ow[i] += iw[i] * signedWeight;
+    }
+}
+
+void AnimationPose::NormalizeRotations()
+{
+    float* x = Get(ROTATION_X);
+    float* y = Get(ROTATION_Y);
+    float* z = Get(ROTATION_Z);
+    float* w = Get(ROTATION_W);
+    for (size_t i = 0; i < stride; ++i)
+    {
+        float lengthSquared = x[i] * x[i] + y[i] * y[i] + z[i] * z[i] + w[i] * w[i];
+        float inverseLength = lengthSquared > 1e-12f ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+        x[i] *= inverseLength;
+        y[i] *= inverseLength;
+        z[i] *= inverseLength;
+        // A sum that cancelled out falls back to identity
+        w[i] = lengthSquared > 1e-12f ? w[i] * inverseLength : 1.0f;
+    }
+}
+
+const float* AnimationPose::BoneFactors(float weight, const float* boneWeights)
+{
+    factors.assign(stride, weight);
+    if (boneWeights)
+    {
+        for (size_t i = 0; i < boneCount; ++i) factors[i] *= boneWeights[i];
+    }
+    return factors.data();
+}
+
+void AnimationPose::Blend(const AnimationPose& target, float weight, const float* boneWeights)
+{
+    const float* t = BoneFactors(weight, boneWeights);
+
+    for (int c = POSITION_X; c <= POSITION_Z; ++c)
+    {
+        const float* in = target.Get((Component)c);
+        float* out = Get((Component)c);
+        for (size_t i = 0; i < stride; ++i) out[i] += (in[i] - out[i]) * t[i];
+    }
+    for (int c = SCALE_X; c <= SCALE_Z; ++c)
+    {
+        const float* in = target.Get((Component)c);
+        float* out = Get((Component)c);
+        for (size_t i = 0; i < stride; ++i) out[i] += (in[i] - out[i]) * t[i];
+    }
+
+    const float* ix = target.Get(ROTATION_X);
+    const float* iy = target.Get(ROTATION_Y);
+    const float* iz = target.Get(ROTATION_Z);
+    const float* iw = target.Get(ROTATION_W);
+    float* ox = Get(ROTATION_X);
+    float* oy = Get(ROTATION_Y);
+    float* oz = Get(ROTATION_Z);
+    float* ow = Get(ROTATION_W);
+    for (size_t i = 0; i < stride; ++i)
+    {
+        float dot = ox[i] * ix[i] + oy[i] * iy[i] + oz[i] * iz[i] + ow[i] * iw[i];
+        float sign = dot < 0.0f ? -1.0f : 1.0f;
+        ox[i] += (ix[i] * sign - ox[i]) * t[i];
+        oy[i] += (iy[i] * sign - oy[i]) * t[i];
+        oz[i] += (iz[i] * sign - oz[i]) * t[i];
+        ow[i] += (iw[i] * sign - ow[i]) * t[i];
+    }
+
+    NormalizeRotations();
+}
+
+void AnimationPose::AddDifference(const AnimationPose& pose, const AnimationPose& reference, float weight, const float* boneWeights)
+{
+    const float* t = BoneFactors(weight, boneWeights);
+
+    for (int c = POSITION_X; c <= POSITION_Z; ++c)
+    {
+        const float* in = pose.Get((Component)c);
+        const float* ref = reference.Get((Component)c);
+        float* out = Get((Component)c);
+        for (size_t i = 0; i < stride; ++i) out[i] += (in[i] - ref[i]) * t[i];
+    }
+    for (int c = SCALE_X; c <= SCALE_Z; ++c)
+    {
+        const float* in = pose.Get((Component)c);
+        const float* ref = reference.Get((Component)c);
+        float* out = Get((Component)c);
+        for (size_t i = 0; i < stride; ++i) out[i] += (in[i] - ref[i]) * t[i];
+    }
+
+    const float* px = pose.Get(ROTATION_X);
+    const float* py = pose.Get(ROTATION_Y);
+    const float* pz = pose.Get(ROTATION_Z);
+    const float* pw = pose.Get(ROTATION_W);
+    const float* rx = reference.Get(ROTATION_X);
+    const float* ry = reference.Get(ROTATION_Y);
+    const float* rz = reference.Get(ROTATION_Z);
+    const float* rw = reference.Get(ROTATION_W);
+    float* ox = Get(ROTATION_X);
+    float* oy = Get(ROTATION_Y);
+    float* oz = Get(ROTATION_Z);
+    float* ow = Get(ROTATION_W);
+    for (size_t i = 0; i < stride; ++i)
+    {
+        // delta = pose * inverse(reference)
+        float dw = pw[i] * rw[i] + px[i] * rx[i] + py[i] * ry[i] + pz[i] * rz[i];
+        float dx = -pw[i] * rx[i] + px[i] * rw[i] - py[i] * rz[i] + pz[i] * ry[i];
+        float dy = -pw[i] * ry[i] + px[i] * rz[i] + py[i] * rw[i] - pz[i] * rx[i];
+        float dz = -pw[i] * rz[i] - px[i] * ry[i] + py[i] * rx[i] + pz[i] * rw[i];
+
+        // Scaled from identity, on the short way round
+        float sign = dw < 0.0f ? -1.0f : 1.0f;
+        dx *= sign * t[i];
+        dy *= sign * t[i];
+        dz *= sign * t[i];
+        dw = 1.0f + (dw * sign - 1.0f) * t[i];
+
+        // out = delta * out
+        float x = dw * ox[i] + dx * ow[i] + dy * oz[i] - dz * oy[i];
+        float y = dw * oy[i] - dx * oz[i] + dy * ow[i] + dz * ox[i];
+        float z = dw * oz[i] + dx * oy[i] - dy * ox[i] + dz * ow[i];
+        float w = dw * ow[i] - dx * ox[i] - dy * oy[i] - dz * oz[i];
+        ox[i] = x;
+        oy[i] = y;
+        oz[i] = z;
+        ow[i] = w;
+    }
+
+    NormalizeRotations();
+}
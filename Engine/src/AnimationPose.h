@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Local pose of a skeleton as a structure of arrays: one float array per component
+// (position x, y, z, rotation x, y, z, w, scale x, y, z), each padded to a multiple of 4.
+// Every blend below is a plain loop over those arrays, with no per-bone glm types, so the
+// compiler vectorizes it and blending a pose costs a few instructions per bone.
+class AnimationPose
+{
+public:
+    enum Component
+    {
+        POSITION_X = 0,
+        POSITION_Y,
+        POSITION_Z,
+        ROTATION_X,
+        ROTATION_Y,
+        ROTATION_Z,
+        ROTATION_W,
+        SCALE_X,
+        SCALE_Y,
+        SCALE_Z,
+        COMPONENT_COUNT
+    };
+
+    void Resize(size_t boneCount);
+    size_t GetBoneCount() const { return boneCount; }
+
+    float* Get(Component component) { return data.data() + component * stride; }
+    const float* Get(Component component) const { return data.data() + component * stride; }
+
+    void SetBone(size_t bone, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+    void GetBone(size_t bone, glm::vec3& outPosition, glm::quat& outRotation, glm::vec3& outScale) const;
+
+    // Same bone count, copies every component
+    void CopyFrom(const AnimationPose& source);
+
+    // Weighted sum, for the clips of a layer: Scale starts it, Accumulate adds to it and
+    // NormalizeRotations closes it. Rotations are flipped to the sum's hemisphere first.
+    void Scale(const AnimationPose& source, float weight);
+    void Accumulate(const AnimationPose& source, float weight);
+    void NormalizeRotations();
+
+    // this = this + (target - this) * weight * boneWeights[bone] (nlerp for rotations).
+    // boneWeights may be nullptr for every bone at full weight.
+    void Blend(const AnimationPose& target, float weight, const float* boneWeights);
+
+    // Adds the difference between pose and reference, scaled the same way:
+    // position and scale offsets are added, the rotation delta goes on top of the current one
+    void AddDifference(const AnimationPose& pose, const AnimationPose& reference, float weight, const float* boneWeights);
+
+private:
+    // weight * boneWeights per bone, padded with weight
+    const float* BoneFactors(float weight, const float* boneWeights);
+
+    size_t boneCount = 0;
+    size_t stride = 0;
+    std::vector<float> data;
+    std::vector<float> factors;
+};
@@ -20,6 +20,7 @@ Application::Application() : isRunning(true), playState(PlayState::EDITING)
 
     window = std::make_shared<Window>();
     events = std::make_shared<ModuleEvents>();
+    jobs = std::make_shared<JobSystem>();
     input = std::make_shared<Input>();
     renderContext = std::make_shared<RenderContext>();
     renderer = std::make_shared<Renderer>();
@@ -42,6 +43,7 @@ Application::Application() : isRunning(true), playState(PlayState::EDITING)
 #endif
 
     AddModule(std::static_pointer_cast<Module>(window));
+    AddModule(std::static_pointer_cast<Module>(jobs));
     AddModule(std::static_pointer_cast<Module>(events));
     AddModule(std::static_pointer_cast<Module>(input));
     AddModule(std::static_pointer_cast<Module>(physics));
@@ -303,7 +305,7 @@ void Application::Play()
 
     if (wasEditing) {
         LOG_CONSOLE("Saving scene state to memory...");
-        savedSceneState = scene->SerializeSceneToString();
+        playSnapshot.Capture(scene->GetRoot());
     }
 
     playState = PlayState::PLAYING;
@@ -362,10 +364,11 @@ void Application::Stop()
     }
 
     // Restore from memory
-    if (playState != PlayState::EDITING && !savedSceneState.empty()) {
+    if (playState != PlayState::EDITING && !playSnapshot.IsEmpty()) {
         LOG_CONSOLE("Restoring scene from memory...");
-        scene->DeserializeSceneFromString(savedSceneState);
+        playSnapshot.Restore(scene->GetRoot());
     }
+    playSnapshot.Clear();
 
     playState = PlayState::EDITING;
     time->Reset();
@@ -26,6 +26,8 @@
 #include "NavMeshManager.h"
 #include "ModuleAudio.h"
 #include "ModuleEvents.h"
+#include "JobSystem.h"
+#include "PlaySnapshot.h"
 
 class Module;
 
@@ -75,6 +77,7 @@ public:
     std::shared_ptr<RenderContext> renderContext;
     std::shared_ptr<Renderer> renderer;
     std::shared_ptr<ModuleEvents> events;
+    std::shared_ptr<JobSystem> jobs;
     
     std::shared_ptr<ModuleLoader> loader;
     
@@ -113,8 +116,8 @@ private:
     bool isRunning;
     PlayState playState;
     
-    // Scene state saved in memory for Play/Stop
-    std::string savedSceneState;  
+    // Scene state taken on Play, put back in place on Stop
+    PlaySnapshot playSnapshot;
 
     // Call modules before each loop iteration
     bool PreUpdate();
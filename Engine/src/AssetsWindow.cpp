@@ -1955,14 +1955,9 @@ unsigned int AssetsWindow::RenderMeshToTexture(const Mesh& mesh, int width, int
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);
 
-    glm::vec3 minBounds(FLT_MAX);
-    glm::vec3 maxBounds(-FLT_MAX);
-
-    for (const auto& vertex : mesh.vertices)
-    {
-        minBounds = glm::min(minBounds, vertex.position);
-        maxBounds = glm::max(maxBounds, vertex.position);
-    }
+    // Library meshes keep no vertices once uploaded, only their bounds
+    glm::vec3 minBounds = mesh.boundsMin;
+    glm::vec3 maxBounds = mesh.boundsMax;
 
     glm::vec3 center = (minBounds + maxBounds) * 0.5f;
     glm::vec3 size = maxBounds - minBounds;
@@ -2035,10 +2030,10 @@ unsigned int AssetsWindow::RenderMeshToTexture(const Mesh& mesh, int width, int
         glUniformMatrix4fv(mvpLoc, 1, GL_FALSE, glm::value_ptr(mvp));
     }
 
-    if (mesh.VAO != 0 && !mesh.indices.empty())
+    if (mesh.VAO != 0 && mesh.GetIndexCount() != 0)
     {
         glBindVertexArray(mesh.VAO);
-        glDrawElements(GL_TRIANGLES, mesh.indices.size(), GL_UNSIGNED_INT, 0);
+        glDrawElements(GL_TRIANGLES, mesh.GetIndexCount(), mesh.GetIndexType(), 0);
         glBindVertexArray(0);
     }
 
@@ -2112,11 +2107,8 @@ unsigned int AssetsWindow::RenderMultipleMeshesToTexture(const std::vector<const
 
     for (const Mesh* mesh : meshes)
     {
-        for (const auto& vertex : mesh->vertices)
-        {
-            globalMinBounds = glm::min(globalMinBounds, vertex.position);
-            globalMaxBounds = glm::max(globalMaxBounds, vertex.position);
-        }
+        globalMinBounds = glm::min(globalMinBounds, mesh->boundsMin);
+        globalMaxBounds = glm::max(globalMaxBounds, mesh->boundsMax);
     }
 
     glm::vec3 center = (globalMinBounds + globalMaxBounds) * 0.5f;
@@ -2193,10 +2185,10 @@ unsigned int AssetsWindow::RenderMultipleMeshesToTexture(const std::vector<const
 
     for (const Mesh* mesh : meshes)
     {
-        if (mesh->VAO != 0 && !mesh->indices.empty())
+        if (mesh->VAO != 0 && mesh->GetIndexCount() != 0)
         {
             glBindVertexArray(mesh->VAO);
-            glDrawElements(GL_TRIANGLES, mesh->indices.size(), GL_UNSIGNED_INT, 0);
+            glDrawElements(GL_TRIANGLES, mesh->GetIndexCount(), mesh->GetIndexType(), 0);
             glBindVertexArray(0);
         }
     }
@@ -17,6 +17,7 @@ public:
     ComponentType GetType() const override { return ComponentType::AUDIOSOURCE; }
     bool IsType(ComponentType type) override { return type == ComponentType::AUDIOSOURCE; };
     bool IsIncompatible(ComponentType type) override { return false; };
+    bool HasRuntimeState() const override { return true; }
 
     void Serialize(nlohmann::json& componentObj) const override;
     void Deserialize(const nlohmann::json& componentObj) override;
@@ -70,9 +70,11 @@ bool Backup::CleanUp()
 void Backup::PerformBackup()
 {
 	std::string timestamp = GetTimestamp();
-	std::string backupFilename = tempSceneDir + "/backup_" + timestamp + ".scene";
+	// Binary: much faster to write than the indented JSON, and it is not meant to be diffed.
+	// Loaded back through ModuleLoader::LoadScene like any scene file.
+	std::string backupFilename = tempSceneDir + "/backup_" + timestamp + ".wscene";
 
-	bool success = Application::GetInstance().loader->SaveScene(backupFilename);
+	bool success = Application::GetInstance().scene->SaveSceneBinary(backupFilename);
 
 	/*if (success)
 	{
@@ -1,9 +1,12 @@
 #include "Component.h"
 #include "GameObject.h"
+#include "ObjectPool.h"
 #include <imgui.h>  
 #include <ImGuizmo.h>
 
 Component::Component(GameObject* owner, ComponentType type) : owner(owner), type(type), active(true) {
+    handle = HandleTable<Component>::Instance().Create(this);
+
     switch (type) {
     case ComponentType::TRANSFORM:               name = "Transform";                break;
     case ComponentType::MESH:                    name = "Mesh";                     break;
@@ -36,4 +39,16 @@ Component::Component(GameObject* owner, ComponentType type) : owner(owner), type
     case ComponentType::LIGHT:                   name = "Light";                    break;
     default:                                     name = "Unknown Component";        break;
     }
+}
+
+Component::~Component() {
+    HandleTable<Component>::Instance().Destroy(handle);
+}
+
+void* Component::operator new(size_t size) {
+    return ObjectPools::AllocateComponent(size);
+}
+
+void Component::operator delete(void* block, size_t size) {
+    ObjectPools::FreeComponent(block, size);
 }
\ No newline at end of file
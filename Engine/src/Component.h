@@ -1,6 +1,9 @@
 #pragma once
 #include <string>
+#include <cstdint>
+#include <cstddef>
 #include <nlohmann/json.hpp>
+#include "Handle.h"
 
 class GameObject;
 
@@ -47,10 +50,18 @@ class Component {
 public:
 
     Component(GameObject* owner, ComponentType type);
-    virtual ~Component() = default;
+    virtual ~Component();
+
+    // Storage comes from ObjectPools, one pool per component size. The virtual destructor
+    // makes delete pass the size of the concrete type.
+    static void* operator new(size_t size);
+    static void operator delete(void* block, size_t size);
     
     virtual void Enable() {};
     virtual void Update() {};
+    // Runs on a job worker before Update, only for the types ComponentScheduler updates
+    // in parallel. Must not touch anything outside the component (transforms, events...).
+    virtual void UpdateAsync() {};
     virtual void FixedUpdate() {};
     virtual void Disable() {};
     virtual void OnEditor() {};
@@ -62,8 +73,12 @@ public:
     virtual void SolveReferences() {};
 
     ComponentType GetType() const { return type; }
+    ComponentHandle GetHandle() const { return handle; }
     virtual bool IsType(ComponentType type) = 0;
     virtual bool IsIncompatible(ComponentType type) = 0;
+    // True if the component keeps state Serialize does not capture (Lua instance, playback...).
+    // Play mode restore recreates those instead of trusting their serialized data.
+    virtual bool HasRuntimeState() const { return false; }
 
     bool IsActive() const { return active; }
     void SetActive(bool active) { this->active = active; }
@@ -75,4 +90,10 @@ public:
     ComponentType type;
     bool active = true;
     std::string name;
+
+    // Position in the ComponentScheduler list of its type
+    uint32_t schedulerIndex = 0xFFFFFFFF;
+
+private:
+    ComponentHandle handle;
 };
\ No newline at end of file
@@ -2,21 +2,43 @@
 #include "Transform.h"
 #include "GameObject.h"
 #include "Application.h"
+#include "CameraLens.h"
+#include "Frustum.h"
 #include "ModuleResources.h"
+#include "SelectionManager.h"
 #include "Time.h"
 #include "Log.h"
 #include "imgui.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+
+AnimationLodPolicy ComponentAnimation::lodPolicy;
+static uint32_t nextLodFrame = 0;
 
 ComponentAnimation::ComponentAnimation(GameObject* owner) : Component(owner, ComponentType::ANIMATION)
 {
     name = "Animation";
-    Application::GetInstance().events->Subscribe(Event::Type::GameObjectDestroyed, this);
+    lodFrame = nextLodFrame++;
+
+    AnimationLayer base;
+    base.name = "Base";
+    layers.push_back(base);
 }
 
 ComponentAnimation::~ComponentAnimation()
 {
-    UnloadAnimation(currentAnimation);
-    Application::GetInstance().events->UnsubscribeAll(this);
+    for (AnimationLayer& layer : layers)
+    {
+        for (AnimationMotion& motion : layer.motions) ReleaseMotion(motion);
+    }
+}
+
+static Transform* GetBoneTransform(const BoneLink& link)
+{
+    GameObject* bone = link.bone.Get();
+    return bone ? bone->transform : nullptr;
 }
 
 void ComponentAnimation::AddAnimation(const std::string& name, UID uid)
@@ -38,9 +60,20 @@ void ComponentAnimation::RemoveAnimation(const std::string& name)
 
     UID uidToRemove = it->second.uid;
 
-    if (currentAnimation.uid == uidToRemove)
+    for (const AnimationLayer& layer : layers)
     {
-        Stop();
+        for (const AnimationMotion& motion : layer.motions)
+        {
+            for (const ClipPlayback& playback : motion.clips)
+            {
+                if (playback.uid == uidToRemove)
+                {
+                    Stop();
+                    animationsLibrary.erase(it);
+                    return;
+                }
+            }
+        }
     }
 
     animationsLibrary.erase(it);
@@ -50,63 +83,275 @@ void ComponentAnimation::ResetPose()
 {
     for (const auto& link : skeletonCache)
     {
-        if (link.transform)
+        Transform* transform = GetBoneTransform(link);
+        if (transform && link.animated)
         {
-            link.transform->SetPosition(link.originalPos);
-            link.transform->SetRotationQuat(link.originalRot);
-            link.transform->SetScale(link.originalScl);
+            transform->SetLocalTRS(link.originalPos, link.originalRot, link.originalScl);
         }
     }
 }
 
 void ComponentAnimation::Play(const std::string& name, float blendTime)
 {
-    if (currentAnimation.name == name) return;
+    PlayOnLayer(layers[0].name, name, blendTime);
+}
 
-    auto it = animationsLibrary.find(name);
-    if (it == animationsLibrary.end()) return;
+void ComponentAnimation::PlayOnLayer(const std::string& layerName, const std::string& name, float blendTime)
+{
+    AnimationLayer* layer = FindLayer(layerName);
+    if (!layer) return;
 
-    CaptureSnapshot();
-    
-    if (currentAnimation.uid != it->second.uid)
-    {
-        UnloadAnimation(currentAnimation);
-        currentAnimation.name = it->first;
-        currentAnimation.uid = it->second.uid;
-        currentAnimation.speed = it->second.speed;
-        currentAnimation.loop = it->second.loop;
-        currentAnimation.resource = (ResourceAnimation*)Application::GetInstance().resources->RequestResource(currentAnimation.uid);
-    }
+    if (!layer->motions.empty() && layer->motions.back().name == name) return;
 
-    currentTime = 0.0f;
-    ended = false;
+    AnimationMotion motion;
+    if (!CreateMotion(name, motion)) return;
 
-    if (blendTime > 0.0f) {
-        isBlending = true;
-        currentBlendTime = 0.0f;
-        blendDuration = blendTime;
+    // The motions under it keep playing until it has faded in, on an empty layer it fades in
+    // over the layers below (the bind pose for the base layer)
+    if (blendTime > 0.0f)
+    {
+        motion.fade = 0.0f;
+        motion.fadeDuration = blendTime;
     }
-    else {
-        isBlending = false;
+    else
+    {
+        for (AnimationMotion& previous : layer->motions) ReleaseMotion(previous);
+        layer->motions.clear();
     }
 
+    layer->motions.push_back(std::move(motion));
+
     playing = true;
+    poseSampled = false;
+}
 
-    EnsureSkeletonMatches(currentAnimation.resource);
-    UpdateChannelPointers();
+void ComponentAnimation::StopLayer(const std::string& layerName, float blendTime)
+{
+    AnimationLayer* layer = FindLayer(layerName);
+    if (!layer || layer->motions.empty()) return;
+
+    if (blendTime <= 0.0f)
+    {
+        for (AnimationMotion& motion : layer->motions) ReleaseMotion(motion);
+        layer->motions.clear();
+        return;
+    }
+
+    // A motion without clips fades the layer out (the base layer to the bind pose)
+    if (layer->motions.back().clips.empty()) return;
+
+    AnimationMotion fadeOut;
+    fadeOut.fade = 0.0f;
+    fadeOut.fadeDuration = blendTime;
+    layer->motions.push_back(fadeOut);
 }
 
 void ComponentAnimation::Stop()
 {
     playing = false;
-    isBlending = false;
-    currentBlendTime = 0.0f;
-    
-    UnloadAnimation(currentAnimation);
+    poseSampled = false;
+    modelPoseValid = false;
+
+    for (AnimationLayer& layer : layers)
+    {
+        for (AnimationMotion& motion : layer.motions) ReleaseMotion(motion);
+        layer.motions.clear();
+    }
 
     ResetPose();
 }
 
+const bool ComponentAnimation::IsPlayingAnimation(std::string animationName)
+{
+    const std::vector<AnimationMotion>& motions = layers[0].motions;
+    return IsPlaying() && !motions.empty() && !motions.back().clips.empty() && motions.back().name == animationName;
+}
+
+bool ComponentAnimation::CreateMotion(const std::string& name, AnimationMotion& outMotion)
+{
+    outMotion.name = name;
+
+    auto clipIt = animationsLibrary.find(name);
+    auto spaceIt = blendSpaces.find(name);
+    if (clipIt != animationsLibrary.end())
+    {
+        outMotion.speed = clipIt->second.speed;
+        outMotion.loop = clipIt->second.loop;
+
+        ClipPlayback playback;
+        playback.uid = clipIt->second.uid;
+        outMotion.clips.push_back(playback);
+    }
+    else if (spaceIt != blendSpaces.end())
+    {
+        const BlendSpace& space = spaceIt->second;
+        outMotion.parameter = space.parameter;
+        outMotion.speed = space.speed;
+        outMotion.loop = space.loop;
+
+        for (const BlendSpacePoint& point : space.points)
+        {
+            auto pointClip = animationsLibrary.find(point.clip);
+            if (pointClip == animationsLibrary.end())
+            {
+                LOG_CONSOLE("Blend space '%s' uses missing animation '%s'", name.c_str(), point.clip.c_str());
+                continue;
+            }
+
+            ClipPlayback playback;
+            playback.uid = pointClip->second.uid;
+            playback.position = point.position;
+            outMotion.clips.push_back(playback);
+        }
+
+        std::stable_sort(outMotion.clips.begin(), outMotion.clips.end(),
+            [](const ClipPlayback& a, const ClipPlayback& b) { return a.position < b.position; });
+        AnimationGraph::UpdateBlendSpaceWeights(outMotion, parameters);
+    }
+
+    if (outMotion.clips.empty()) return false;
+
+    ModuleResources* resources = Application::GetInstance().resources.get();
+    for (ClipPlayback& playback : outMotion.clips)
+    {
+        ResourceAnimation* resource = (ResourceAnimation*)resources->RequestResource(playback.uid);
+        playback.clip = resource ? &resource->GetClip() : nullptr;
+        EnsureSkeletonMatches(playback.clip);
+    }
+
+    // After every clip, the skeleton may have grown with the later ones
+    for (ClipPlayback& playback : outMotion.clips) RemapChannels(playback);
+
+    return true;
+}
+
+void ComponentAnimation::ReleaseMotion(AnimationMotion& motion)
+{
+    for (ClipPlayback& playback : motion.clips)
+    {
+        if (playback.clip)
+        {
+            Application::GetInstance().resources->ReleaseResource(playback.uid);
+        }
+        playback.clip = nullptr;
+    }
+}
+
+void ComponentAnimation::PruneMotions()
+{
+    bool anyMotion = false;
+
+    for (size_t l = 0; l < layers.size(); ++l)
+    {
+        std::vector<AnimationMotion>& motions = layers[l].motions;
+
+        // Nothing under a motion that has fully faded in shows any more
+        for (size_t i = motions.size(); i-- > 1; )
+        {
+            if (motions[i].fade < 1.0f) continue;
+
+            for (size_t below = 0; below < i; ++below) ReleaseMotion(motions[below]);
+            motions.erase(motions.begin(), motions.begin() + i);
+            break;
+        }
+
+        // A finished fade out leaves the layer empty
+        if (motions.size() == 1 && motions[0].clips.empty() && motions[0].fade >= 1.0f) motions.clear();
+
+        anyMotion = anyMotion || !motions.empty();
+    }
+
+    if (!anyMotion)
+    {
+        // Bone objects that were not synced still hold an old pose
+        playing = false;
+        modelPoseValid = false;
+        ResetPose();
+    }
+}
+
+AnimationLayer* ComponentAnimation::FindLayer(const std::string& layerName)
+{
+    for (AnimationLayer& layer : layers)
+    {
+        if (layer.name == layerName) return &layer;
+    }
+    return nullptr;
+}
+
+void ComponentAnimation::AddLayer(const std::string& layerName, AnimationLayerMode mode, float weight, const std::vector<std::string>& maskBones)
+{
+    if (layerName.empty() || FindLayer(layerName))
+    {
+        LOG_CONSOLE("Animation layer '%s' already exists", layerName.c_str());
+        return;
+    }
+
+    AnimationLayer layer;
+    layer.name = layerName;
+    layer.mode = mode;
+    layer.weight = glm::clamp(weight, 0.0f, 1.0f);
+    layer.maskBones = maskBones;
+    UpdateLayerMask(layer);
+
+    layers.push_back(std::move(layer));
+}
+
+void ComponentAnimation::RemoveLayer(const std::string& layerName)
+{
+    for (size_t i = 1; i < layers.size(); ++i)
+    {
+        if (layers[i].name != layerName) continue;
+
+        for (AnimationMotion& motion : layers[i].motions) ReleaseMotion(motion);
+        layers.erase(layers.begin() + i);
+        return;
+    }
+}
+
+void ComponentAnimation::SetLayerWeight(const std::string& layerName, float weight)
+{
+    AnimationLayer* layer = FindLayer(layerName);
+    if (layer && layer != &layers[0]) layer->weight = glm::clamp(weight, 0.0f, 1.0f);
+}
+
+void ComponentAnimation::SetLayerMode(const std::string& layerName, AnimationLayerMode mode)
+{
+    AnimationLayer* layer = FindLayer(layerName);
+    if (layer && layer != &layers[0]) layer->mode = mode;
+}
+
+void ComponentAnimation::SetLayerMask(const std::string& layerName, const std::vector<std::string>& maskBones)
+{
+    AnimationLayer* layer = FindLayer(layerName);
+    if (!layer || layer == &layers[0]) return;
+
+    layer->maskBones = maskBones;
+    UpdateLayerMask(*layer);
+}
+
+void ComponentAnimation::UpdateLayerMask(AnimationLayer& layer)
+{
+    layer.boneWeights.clear();
+    if (layer.maskBones.empty()) return;
+
+    // Parents first, so a bone is in the mask when its parent is
+    layer.boneWeights.assign(skeletonCache.size(), 0.0f);
+    for (int index : evaluationOrder)
+    {
+        const BoneLink& link = skeletonCache[index];
+        bool named = std::find(layer.maskBones.begin(), layer.maskBones.end(), link.boneName) != layer.maskBones.end();
+        bool underNamed = link.parent >= 0 && layer.boneWeights[link.parent] > 0.0f;
+        layer.boneWeights[index] = named || underNamed ? 1.0f : 0.0f;
+    }
+}
+
+float ComponentAnimation::GetParameter(const std::string& parameterName) const
+{
+    auto it = parameters.find(parameterName);
+    return it != parameters.end() ? it->second : 0.0f;
+}
+
 void ComponentAnimation::SetAnimationSpeed(const std::string& name, float newSpeed)
 {
 
@@ -124,10 +369,12 @@ void ComponentAnimation::SetAnimationSpeed(const std::string& name, float newSpe
     AnimationData& data = it->second;
     data.speed = speed;
 
-
-    if (currentAnimation.resource && currentAnimation.uid == data.uid)
+    for (AnimationLayer& layer : layers)
     {
-        currentAnimation.speed = speed;
+        for (AnimationMotion& motion : layer.motions)
+        {
+            if (motion.parameter.empty() && motion.name == name) motion.speed = speed;
+        }
     }
 }
 
@@ -139,178 +386,328 @@ void ComponentAnimation::SetAnimationLoop(const std::string& name, bool loop)
     AnimationData& data = it->second;
     data.loop = loop;
 
-    if (currentAnimation.resource && currentAnimation.uid == data.uid)
+    for (AnimationLayer& layer : layers)
     {
-        currentAnimation.loop = loop;
+        for (AnimationMotion& motion : layer.motions)
+        {
+            if (motion.parameter.empty() && motion.name == name) motion.loop = loop;
+        }
     }
 }
 
-void ComponentAnimation::UnloadAnimation(AnimationInstance& animation)
+void ComponentAnimation::UpdateAsync()
 {
-    if (animation.resource)
-    {
-        Application::GetInstance().resources->ReleaseResource(currentAnimation.uid);
-    }
-    animation.resource = nullptr;
-    animation.uid = 0;
-}
+    if (!playing) return;
 
-void ComponentAnimation::Update()
-{
-    if (!playing || !currentAnimation.resource) return;
+    // Skipped frames only add up time, the next update advances by all of it
+    lodElapsed += Application::GetInstance().time->GetDeltaTime();
+    int interval = lodPolicy.GetInterval(lodLevel);
+    if (interval > 1 && ++lodFrame % interval != 0) return;
 
-    float dt = Application::GetInstance().time->GetDeltaTime();
+    float dt = lodElapsed;
+    lodElapsed = 0.0f;
 
-    currentTime += dt * currentAnimation.resource->GetTicksPerSecond() * currentAnimation.speed;
+    AnimationGraph::AdvanceLayers(layers, parameters, dt);
 
-    if (currentTime >= currentAnimation.resource->GetDuration()) {
-        if (currentAnimation.loop)
-            currentTime = std::fmod(currentTime, currentAnimation.resource->GetDuration());
-        else {
-            currentTime = currentAnimation.resource->GetDuration();
-            ended = true;
-        }
-    }
+    evaluator.Evaluate(skeletonCache, evaluationOrder, ownerBone, layers, maxBoneDepth);
+    modelPoseValid = true;
+    poseSampled = true;
+}
 
+void ComponentAnimation::Update()
+{
+    UpdateLod();
 
-    if (isBlending) {
-        currentBlendTime += dt;
-        if (currentBlendTime >= blendDuration) {
-            isBlending = false;
-            snapshotPose.clear();
-        }
-    }
+    if (!poseSampled) return;
 
-    UpdateTransformations();
+    poseSampled = false;
+    ApplyPose();
+    PruneMotions();
 }
 
-glm::vec3 ComponentAnimation::GetPositionValue(const Channel& channel, float currentAnimTime)
+const std::vector<glm::mat4>* ComponentAnimation::GetModelPose() const
 {
-    int frameIndex = (int)currentAnimTime;
+    const std::vector<glm::mat4>& modelPose = evaluator.GetModelPose();
+    if (!playing || !modelPoseValid || modelPose.size() != skeletonCache.size()) return nullptr;
+    return &modelPose;
+}
 
-    int numKeys = channel.positionKeys.size();
+int ComponentAnimation::FindBone(const GameObject* bone) const
+{
+    auto it = boneObjectMap.find(bone);
+    if (it == boneObjectMap.end()) return -1;
 
-    if (frameIndex >= numKeys - 1) return channel.positionKeys.back();
-    if (frameIndex < 0) return channel.positionKeys[0];
+    // A deleted bone's address may have been reused
+    return skeletonCache[it->second].bone.Get() == bone ? it->second : -1;
+}
 
-    const auto& key0 = channel.positionKeys[frameIndex];
-    const auto& key1 = channel.positionKeys[frameIndex + 1];
+void ComponentAnimation::UpdateLod()
+{
+    lodLevel = AnimationLodLevel::FULL;
+    maxBoneDepth = INT_MAX;
+
+    // Scripts reading the bones and the editor get every bone every frame
+    Application& app = Application::GetInstance();
+    if (!lodPolicy.enabled || !playing || syncBones || app.GetPlayState() != Application::PlayState::PLAYING) return;
+
+    // A sphere around the owner through the farthest bone, with some room for the skin
+    const glm::mat4& world = owner->transform->GetGlobalMatrix();
+    float scale = std::max({ glm::length(glm::vec3(world[0])), glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2])) });
+    float radius = evaluator.GetBoundsRadius() * scale * 1.25f + 0.1f;
+    glm::vec3 center(world[3]);
+
+    AABB bounds;
+    bounds.min = center - glm::vec3(radius);
+    bounds.max = center + glm::vec3(radius);
+
+    bool visible = false;
+    float screenSize = 0.0f;
+    float distance = FLT_MAX;
+    for (CameraLens* camera : app.renderer->GetActiveCameras())
+    {
+        const Frustum* frustum = camera ? camera->GetFrustum() : nullptr;
+        if (!frustum || !frustum->InFrustum(bounds)) continue;
+
+        visible = true;
+        float cameraDistance = std::max(glm::distance(center, camera->position), 0.001f);
+        float halfHeight = cameraDistance * std::tan(glm::radians(camera->GetFov()) * 0.5f);
+        screenSize = std::max(screenSize, radius / halfHeight);
+        distance = std::min(distance, cameraDistance);
+    }
 
-    float factor = currentAnimTime - (float)frameIndex;
+    if (!visible)
+    {
+        lodLevel = AnimationLodLevel::CULLED;
+    }
+    else if (lodPolicy.metric == AnimationLodPolicy::Metric::SCREEN_SIZE)
+    {
+        if (screenSize < lodPolicy.lowScreenSize) lodLevel = AnimationLodLevel::LOW;
+        else if (screenSize < lodPolicy.reducedScreenSize) lodLevel = AnimationLodLevel::REDUCED;
+    }
+    else
+    {
+        if (distance > lodPolicy.lowDistance) lodLevel = AnimationLodLevel::LOW;
+        else if (distance > lodPolicy.reducedDistance) lodLevel = AnimationLodLevel::REDUCED;
+    }
 
-    return glm::mix(key0, key1, factor);
+    maxBoneDepth = lodPolicy.GetMaxBoneDepth(lodLevel);
 }
 
-glm::quat ComponentAnimation::GetRotationValue(const Channel& channel, float currentAnimTime)
+bool ComponentAnimation::NeedsAllBones() const
 {
-    int frameIndex = (int)currentAnimTime;
-    int numKeys = channel.rotationKeys.size();
-
-    if (frameIndex >= numKeys - 1) return channel.rotationKeys.back();
-    if (frameIndex < 0) return channel.rotationKeys[0];
+    if (syncBones) return true;
 
-    const auto& key0 = channel.rotationKeys[frameIndex];
-    const auto& key1 = channel.rotationKeys[frameIndex + 1];
+    // Outside play mode the editor shows and edits the bone objects
+    Application& app = Application::GetInstance();
+    if (app.GetPlayState() != Application::PlayState::PLAYING) return true;
 
-    float factor = currentAnimTime - (float)frameIndex;
+    if (app.selectionManager)
+    {
+        for (GameObject* selected : app.selectionManager->GetSelectedObjects())
+        {
+            for (GameObject* go = selected; go != nullptr; go = go->GetParent())
+            {
+                if (go == owner) return true;
+            }
+        }
+    }
 
-    return glm::slerp(key0, key1, factor);
+    return false;
 }
 
-glm::vec3 ComponentAnimation::GetScaleValue(const Channel& channel, float currentAnimTime)
+void ComponentAnimation::MarkBonesToSync()
 {
-    int frameIndex = (int)currentAnimTime;
-    int numKeys = channel.scaleKeys.size();
+    for (BoneLink& link : skeletonCache) {
+        GameObject* bone = link.bone.Get();
+        link.sync = bone && (bone == owner || bone->GetComponents().size() > 1 ||
+            bone->GetChildren().size() > link.staticChildren);
+    }
 
-    if (frameIndex >= numKeys - 1) return channel.scaleKeys.back();
-    if (frameIndex < 0) return channel.scaleKeys[0];
+    // An attachment follows the world matrix of its bone, which needs every bone above it
+    for (auto it = evaluationOrder.rbegin(); it != evaluationOrder.rend(); ++it) {
+        const BoneLink& link = skeletonCache[*it];
+        if (link.sync && link.parent >= 0) skeletonCache[link.parent].sync = true;
+    }
+}
 
-    const auto& key0 = channel.scaleKeys[frameIndex];
-    const auto& key1 = channel.scaleKeys[frameIndex + 1];
+void ComponentAnimation::ApplyPose()
+{
+    // The skeleton may have grown since sampling (Play from a script)
+    const AnimationPose& sampledPose = evaluator.GetLocalPose();
+    size_t count = std::min(sampledPose.GetBoneCount(), skeletonCache.size());
+
+    bool syncAll = NeedsAllBones();
+    if (!syncAll) MarkBonesToSync();
+
+    for (size_t i = 0; i < count; ++i) {
+        BoneLink& link = skeletonCache[i];
+        Transform* transform = GetBoneTransform(link);
+        if (!transform) continue;
+
+        if (!link.animated) {
+            // Not driven by any clip: the next sample takes whatever the object has now
+            link.originalPos = transform->GetPosition();
+            link.originalRot = transform->GetRotationQuat();
+            link.originalScl = transform->GetScale();
+            continue;
+        }
 
-    float factor = currentAnimTime - (float)frameIndex;
+        if (syncAll || link.sync) {
+            glm::vec3 position, scale;
+            glm::quat rotation;
+            sampledPose.GetBone(i, position, rotation, scale);
+            transform->SetLocalTRS(position, rotation, scale);
+        }
+    }
+}
 
-    return glm::mix(key0, key1, factor);
+void ComponentAnimation::RemapChannels()
+{
+    for (AnimationLayer& layer : layers)
+    {
+        for (AnimationMotion& motion : layer.motions)
+        {
+            for (ClipPlayback& playback : motion.clips) RemapChannels(playback);
+        }
+    }
 }
 
-void ComponentAnimation::UpdateTransformations()
+void ComponentAnimation::RemapChannels(ClipPlayback& playback)
 {
-    float factor = isBlending ? glm::clamp(currentBlendTime / blendDuration, 0.0f, 1.0f) : 1.0f;
+    playback.channels.resize(skeletonCache.size());
+    for (size_t i = 0; i < skeletonCache.size(); ++i)
+    {
+        playback.channels[i] = FindChannel(playback.clip, skeletonCache[i].boneName);
+    }
+}
 
-    for (size_t i = 0; i < skeletonCache.size(); ++i) {
-        auto& link = skeletonCache[i];
-        if (!link.transform) continue;
+void ComponentAnimation::EnsureSkeletonMatches(const AnimationClip* clip)
+{
+    if (!clip || !owner) return;
 
-        glm::vec3 targetPos = link.originalPos;
-        glm::quat targetRot = link.originalRot;
-        glm::vec3 targetScl = link.originalScl;
+    // Built on the first missing bone, one walk of the hierarchy for every channel
+    std::unordered_map<std::string, GameObject*> nodesByName;
+    bool added = false;
 
-        if (link.channelA) {
-            targetPos = GetPositionValue(*link.channelA, currentTime);
-            targetRot = GetRotationValue(*link.channelA, currentTime);
-            targetScl = GetScaleValue(*link.channelA, currentTime);
+    for (size_t c = 0; c < clip->GetChannelCount(); ++c)
+    {
+        const std::string& channelName = clip->GetChannelName(c);
+        auto existing = boneIndexMap.find(channelName);
+        if (existing != boneIndexMap.end())
+        {
+            skeletonCache[existing->second].animated = true;
+            continue;
         }
 
-        if (isBlending && i < snapshotPose.size()) {
-            link.transform->SetPosition(glm::mix(snapshotPose[i].pos, targetPos, factor));
-            link.transform->SetRotationQuat(glm::slerp(snapshotPose[i].rot, targetRot, factor));
-            link.transform->SetScale(glm::mix(snapshotPose[i].scl, targetScl, factor));
+        if (nodesByName.empty())
+            owner->BuildNameIndex(nodesByName);
+
+        auto found = nodesByName.find(channelName);
+        GameObject* go = found != nodesByName.end() ? found->second : nullptr;
+        if (!go) continue;
+
+        // Already in as a node between bones
+        auto known = boneObjectMap.find(go);
+        if (known != boneObjectMap.end())
+        {
+            skeletonCache[known->second].animated = true;
+            boneIndexMap.emplace(channelName, known->second);
+            continue;
         }
-        else {
-            link.transform->SetPosition(targetPos);
-            link.transform->SetRotationQuat(targetRot);
-            link.transform->SetScale(targetScl);
+
+        AddBone(go, channelName, true);
+        added = true;
+
+        // The nodes up to the owner join too, so every bone's parent is in the skeleton
+        if (go == owner) continue;
+        for (GameObject* parent = go->GetParent(); parent != nullptr && parent != owner; parent = parent->GetParent())
+        {
+            if (boneObjectMap.find(parent) != boneObjectMap.end()) break;
+            AddBone(parent, parent->GetName(), false);
         }
     }
+
+    if (added) RebuildSkeletonOrder();
 }
 
-void ComponentAnimation::UpdateChannelPointers()
+void ComponentAnimation::AddBone(GameObject* go, const std::string& boneName, bool animated)
 {
-    if (!currentAnimation.resource) return;
-
-    for (auto& link : skeletonCache)
-    {
-        link.channelA = FindChannel(currentAnimation.resource, link.boneName);
-    }
+    BoneLink newLink;
+    newLink.boneName = boneName;
+    newLink.bone = go->GetHandle();
+    newLink.animated = animated;
+
+    Transform* t = go->transform;
+    newLink.originalPos = t->GetPosition();
+    newLink.originalRot = t->GetRotationQuat();
+    newLink.originalScl = t->GetScale();
+
+    skeletonCache.push_back(newLink);
+    int index = (int)skeletonCache.size() - 1;
+    boneIndexMap.emplace(boneName, index);
+    boneObjectMap[go] = index;
 }
 
-void ComponentAnimation::EnsureSkeletonMatches(const ResourceAnimation* anim)
+void ComponentAnimation::RebuildSkeletonOrder()
 {
-    if (!anim || !owner) return;
+    boneObjectMap.clear();
+    for (size_t i = 0; i < skeletonCache.size(); ++i)
+    {
+        GameObject* go = skeletonCache[i].bone.Get();
+        if (go) boneObjectMap[go] = (int)i;
+    }
 
-    for (const auto& channel : anim->GetChanels())
+    ownerBone = -1;
+    for (size_t i = 0; i < skeletonCache.size(); ++i)
     {
-        if (boneIndexMap.find(channel.name) == boneIndexMap.end())
+        BoneLink& link = skeletonCache[i];
+        link.parent = -1;
+        link.staticChildren = 0;
+
+        GameObject* go = link.bone.Get();
+        if (!go) continue;
+
+        if (go == owner)
         {
-            GameObject* go = owner->FindChild(channel.name);
-            if (go)
-            {
-                BoneLink newLink;
-                newLink.boneName = channel.name;
-                newLink.transform = (Transform*)go->transform;
-                newLink.channelA = nullptr;
-                newLink.channelB = nullptr;
-
-                Transform* t = newLink.transform;
-                newLink.originalPos = t->GetPosition();
-                newLink.originalRot = t->GetRotationQuat();
-                newLink.originalScl = t->GetScale();
-
-                skeletonCache.push_back(newLink);
-                boneIndexMap[channel.name] = skeletonCache.size() - 1;
-            }
+            ownerBone = (int)i;
+            continue;
+        }
+
+        GameObject* parent = go->GetParent();
+        auto parentIt = boneObjectMap.find(parent);
+        if (parent != owner && parentIt != boneObjectMap.end()) link.parent = parentIt->second;
+
+        for (GameObject* child : go->GetChildren())
+        {
+            bool emptyLeaf = child->GetChildren().empty() && child->GetComponents().size() <= 1;
+            if (emptyLeaf || boneObjectMap.find(child) != boneObjectMap.end()) ++link.staticChildren;
         }
     }
-}
 
-const Channel* ComponentAnimation::FindChannel(const ResourceAnimation* anim, const std::string& name)
-{
-    if (!anim) return nullptr;
-    for (const auto& ch : anim->GetChanels())
+    std::vector<int> depths(skeletonCache.size(), 0);
+    for (size_t i = 0; i < skeletonCache.size(); ++i)
     {
-        if (ch.name == name) return &ch;
+        for (int parent = skeletonCache[i].parent; parent >= 0; parent = skeletonCache[parent].parent) ++depths[i];
     }
-    return nullptr;
+
+    for (size_t i = 0; i < skeletonCache.size(); ++i) skeletonCache[i].depth = depths[i];
+
+    evaluationOrder.resize(skeletonCache.size());
+    std::iota(evaluationOrder.begin(), evaluationOrder.end(), 0);
+    std::stable_sort(evaluationOrder.begin(), evaluationOrder.end(), [&depths](int a, int b) { return depths[a] < depths[b]; });
+
+    // Sampled with the old bone count
+    modelPoseValid = false;
+    ++skeletonVersion;
+
+    RemapChannels();
+    for (AnimationLayer& layer : layers) UpdateLayerMask(layer);
+}
+
+int ComponentAnimation::FindChannel(const AnimationClip* clip, const std::string& name)
+{
+    if (!clip) return -1;
+    return clip->FindChannel(name);
 }
 
 void ComponentAnimation::Serialize(nlohmann::json& componentObj) const
@@ -329,10 +726,49 @@ void ComponentAnimation::Serialize(nlohmann::json& componentObj) const
     }
 
     componentObj["Animations"] = animationsArray;
+    componentObj["SyncBones"] = syncBones;
+
+    nlohmann::json spacesArray = nlohmann::json::array();
+    for (const auto& [name, space] : blendSpaces)
+    {
+        nlohmann::json spaceNode;
+        spaceNode["name"] = name;
+        spaceNode["parameter"] = space.parameter;
+        spaceNode["speed"] = space.speed;
+        spaceNode["loop"] = space.loop;
+
+        nlohmann::json pointsArray = nlohmann::json::array();
+        for (const BlendSpacePoint& point : space.points)
+        {
+            pointsArray.push_back({ { "clip", point.clip }, { "position", point.position } });
+        }
+        spaceNode["points"] = pointsArray;
+
+        spacesArray.push_back(spaceNode);
+    }
+    componentObj["BlendSpaces"] = spacesArray;
+
+    // The base layer is implicit
+    nlohmann::json layersArray = nlohmann::json::array();
+    for (size_t i = 1; i < layers.size(); ++i)
+    {
+        const AnimationLayer& layer = layers[i];
+
+        nlohmann::json layerNode;
+        layerNode["name"] = layer.name;
+        layerNode["additive"] = layer.mode == AnimationLayerMode::ADDITIVE;
+        layerNode["weight"] = layer.weight;
+        layerNode["mask"] = layer.maskBones;
+
+        layersArray.push_back(layerNode);
+    }
+    componentObj["Layers"] = layersArray;
 }
 
 void ComponentAnimation::Deserialize(const nlohmann::json& componentObj)
 {
+    syncBones = componentObj.value("SyncBones", false);
+
     if (componentObj.contains("Animations") && componentObj["Animations"].is_array())
     {
         animationsLibrary.clear();
@@ -357,77 +793,81 @@ void ComponentAnimation::Deserialize(const nlohmann::json& componentObj)
             }
         }
     }
-}
-
-
-void ComponentAnimation::DrawSkeleton()
-{
-    glm::vec4 boneColor(0.0f, 1.0f, 1.0f, 1.0f);
 
-    for (const auto& link : skeletonCache)
+    if (componentObj.contains("BlendSpaces") && componentObj["BlendSpaces"].is_array())
     {
-        if (!link.transform) continue;
-
-        GameObject* currentParent = link.transform->GetOwner()->GetParent();
+        blendSpaces.clear();
 
-        while (currentParent != nullptr && currentParent != owner)
+        for (const auto& spaceNode : componentObj["BlendSpaces"])
         {
-            if (boneIndexMap.find(currentParent->GetName()) != boneIndexMap.end())
+            BlendSpace space;
+            space.parameter = spaceNode.value("parameter", "");
+            space.speed = spaceNode.value("speed", 1.0f);
+            space.loop = spaceNode.value("loop", true);
+
+            if (spaceNode.contains("points") && spaceNode["points"].is_array())
             {
-                Transform* parentTrans = (Transform*)currentParent->transform;
-                if (parentTrans)
+                for (const auto& pointNode : spaceNode["points"])
                 {
-                    glm::vec3 start = parentTrans->GetGlobalPosition();
-                    glm::vec3 end = link.transform->GetGlobalPosition();
-
-                    Application::GetInstance().renderer->DrawLine(start, end, boneColor);
+                    BlendSpacePoint point;
+                    point.clip = pointNode.value("clip", "");
+                    point.position = pointNode.value("position", 0.0f);
+                    space.points.push_back(point);
                 }
-                break;
             }
 
-            currentParent = currentParent->GetParent();
+            blendSpaces[spaceNode.value("name", "")] = space;
         }
     }
-}
 
-void ComponentAnimation::CaptureSnapshot()
-{
-    snapshotPose.clear();
-    for (const auto& link : skeletonCache)
+    if (componentObj.contains("Layers") && componentObj["Layers"].is_array())
     {
-        if (link.transform)
+        while (layers.size() > 1) RemoveLayer(layers.back().name);
+
+        for (const auto& layerNode : componentObj["Layers"])
         {
-            BoneSnapshot snap;
-            snap.pos = link.transform->GetPosition();
-            snap.rot = link.transform->GetRotationQuat();
-            snap.scl = link.transform->GetScale();
-            snapshotPose.push_back(snap);
+            std::vector<std::string> mask;
+            if (layerNode.contains("mask") && layerNode["mask"].is_array())
+            {
+                mask = layerNode["mask"].get<std::vector<std::string>>();
+            }
+
+            AnimationLayerMode mode = layerNode.value("additive", false) ? AnimationLayerMode::ADDITIVE : AnimationLayerMode::OVERRIDE;
+            AddLayer(layerNode.value("name", ""), mode, layerNode.value("weight", 1.0f), mask);
         }
     }
-    isBlending = true;
 }
 
-void ComponentAnimation::OnEvent(const Event& event)
+
+void ComponentAnimation::DrawSkeleton()
 {
-    switch (event.type)
-    {
-    case Event::Type::GameObjectDestroyed:
-    {
-        if (skeletonCache.empty()) return;
+    glm::vec4 boneColor(0.0f, 1.0f, 1.0f, 1.0f);
 
-        GameObject* deletedGO = event.data.gameObject.gameObject;
+    // Bone objects may be behind the pose, draw the pose when there is one
+    const std::vector<glm::mat4>* pose = GetModelPose();
+    const glm::mat4& ownerWorld = owner->transform->GetGlobalMatrix();
 
-        for (auto& link : skeletonCache)
+    for (size_t i = 0; i < skeletonCache.size(); ++i)
+    {
+        const BoneLink& link = skeletonCache[i];
+        if (link.parent < 0) continue;
+
+        glm::vec3 start, end;
+        if (pose)
         {
-            if (link.transform && link.transform->owner == deletedGO)
-            {
-                link.transform = nullptr;
-            }
+            start = glm::vec3(ownerWorld * (*pose)[link.parent][3]);
+            end = glm::vec3(ownerWorld * (*pose)[i][3]);
+        }
+        else
+        {
+            Transform* parentTrans = GetBoneTransform(skeletonCache[link.parent]);
+            Transform* transform = GetBoneTransform(link);
+            if (!parentTrans || !transform) continue;
+
+            start = parentTrans->GetGlobalPosition();
+            end = transform->GetGlobalPosition();
         }
-        break;
-    }
 
-    default:
-        break;
+        Application::GetInstance().renderer->DrawLine(start, end, boneColor);
     }
 }
\ No newline at end of file
@@ -1,9 +1,12 @@
 #pragma once
 #include "Component.h"
 #include "ResourceAnimation.h"
-#include "EventListener.h"
+#include "AnimationEvaluator.h"
+#include "Handle.h"
+#include <climits>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "glm/glm.hpp"
 #include <glm/gtc/quaternion.hpp>
@@ -11,102 +14,133 @@
 class GameObject;
 class Transform;
 
-struct BoneSnapshot {
-    glm::vec3 pos;
-    glm::quat rot;
-    glm::vec3 scl;
-};
-
-struct BoneLink {
-    std::string boneName;
-    Transform* transform;
-    const Channel* channelA;
-    const Channel* channelB;
-
-    glm::vec3 originalPos;
-    glm::quat originalRot;
-    glm::vec3 originalScl;
-};
-
-struct AnimationInstance {
-    UID uid = 0;
-    std::string name = "";
-    ResourceAnimation* resource = nullptr;
-
-    float speed = 1.0f;
-    bool loop = true;
-};
-
 struct AnimationData {
     UID uid = 0;
     float speed = 1.0f;
     bool loop = true;
 };
 
-class ComponentAnimation : public Component, public EventListener
+class ComponentAnimation : public Component
 {
 public:
     ComponentAnimation(GameObject* owner);
     virtual ~ComponentAnimation();
 
+    void UpdateAsync() override;
     void Update() override;
 
     bool IsType(ComponentType type) override { return type == ComponentType::ANIMATION; };
     bool IsIncompatible(ComponentType type) override { return type == ComponentType::ANIMATION; };
+    bool HasRuntimeState() const override { return true; }
 
     void AddAnimation(const std::string& name, UID uid);
     void RemoveAnimation(const std::string& name);
 
-    void UnloadAnimation(AnimationInstance& animation);
-
+    // name is a clip of the library or a blend space, played on the base layer
     void Play(const std::string& name, float blendTime = 0.2f);
+    void PlayOnLayer(const std::string& layerName, const std::string& name, float blendTime = 0.2f);
+    void StopLayer(const std::string& layerName, float blendTime = 0.2f);
     void Stop();
     void ResetPose();
 
     const bool IsPlaying() { return playing; };
-    const bool IsPlayingAnimation(std::string animationName) { return IsPlaying() && currentAnimation.name == animationName; };
+    const bool IsPlayingAnimation(std::string animationName);
+
+    // Base layer first, it always exists and cannot be removed
+    const std::vector<AnimationLayer>& GetLayers() const { return layers; }
+    void AddLayer(const std::string& layerName, AnimationLayerMode mode, float weight, const std::vector<std::string>& maskBones);
+    void RemoveLayer(const std::string& layerName);
+    void SetLayerWeight(const std::string& layerName, float weight);
+    void SetLayerMode(const std::string& layerName, AnimationLayerMode mode);
+    void SetLayerMask(const std::string& layerName, const std::vector<std::string>& maskBones);
+
+    // Read by the blend spaces
+    void SetParameter(const std::string& parameterName, float value) { parameters[parameterName] = value; }
+    float GetParameter(const std::string& parameterName) const;
 
     void SetAnimationSpeed(const std::string& name, float newSpeed);
     void SetAnimationLoop(const std::string& name, bool loop);
 
+    // Bone -> owner space matrix of every skeleton bone for the last sampled pose, nullptr
+    // when nothing is playing (the bone objects hold the pose then)
+    const std::vector<glm::mat4>* GetModelPose() const;
+    // Skeleton index of a bone object, -1 if it is not part of the skeleton
+    int FindBone(const GameObject* bone) const;
+    // Changes whenever bones are added, indices from FindBone stay valid but may have to be
+    // looked up again for bones that were missing
+    uint32_t GetSkeletonVersion() const { return skeletonVersion; }
+
+    // Bone objects only get the pose when something reads them: attachments, components
+    // on the bones, the editor. Scripts reading bone transforms turn this on.
+    void SetSyncBones(bool sync) { syncBones = sync; }
+    bool GetSyncBones() const { return syncBones; }
+
+    static AnimationLodPolicy& GetLodPolicy() { return lodPolicy; }
+    AnimationLodLevel GetLodLevel() const { return lodLevel; }
+
     void Serialize(nlohmann::json& componentObj) const override;
     void Deserialize(const nlohmann::json& componentObj) override;
 
-    void OnEvent(const Event& event) override;
     //void OnResourceLost(UID resourceUID) override;
 
 private:
 
-    void EnsureSkeletonMatches(const ResourceAnimation* anim);
-    void UpdateChannelPointers();
-    const Channel* FindChannel(const ResourceAnimation* anim, const std::string& name);
-
-    glm::vec3 GetPositionValue(const Channel& channel, float currentAnimTime);
-    glm::quat GetRotationValue(const Channel& channel, float currentAnimTime);
-    glm::vec3 GetScaleValue(const Channel& channel, float currentAnimTime);
-
-    void UpdateTransformations();
-    void CaptureSnapshot();
+    void EnsureSkeletonMatches(const AnimationClip* clip);
+    void AddBone(GameObject* go, const std::string& boneName, bool animated);
+    void RebuildSkeletonOrder();
+    void RemapChannels();
+    void RemapChannels(ClipPlayback& playback);
+    int FindChannel(const AnimationClip* clip, const std::string& name);
+
+    AnimationLayer* FindLayer(const std::string& layerName);
+    void UpdateLayerMask(AnimationLayer& layer);
+    bool CreateMotion(const std::string& name, AnimationMotion& outMotion);
+    void ReleaseMotion(AnimationMotion& motion);
+    void PruneMotions();
+
+    bool NeedsAllBones() const;
+    void MarkBonesToSync();
+    void ApplyPose();
     void DrawSkeleton();
 
+    void UpdateLod();
+
 public:
     
-    AnimationInstance currentAnimation;
     std::map<std::string, AnimationData> animationsLibrary;
+    std::map<std::string, BlendSpace> blendSpaces;
 
 private:
 
     bool addAnimation = false;
 
     bool playing = false;
-    bool ended = false;
-    bool isBlending = false;
-    
-    float currentTime;
-    float blendDuration = 0.0f;
-    float currentBlendTime = 0.0f;
 
-    std::vector<BoneSnapshot> snapshotPose;
+    std::vector<AnimationLayer> layers;
+    std::unordered_map<std::string, float> parameters;
+
+    // Run by UpdateAsync on a worker: the local pose of every bone and the same pose in
+    // owner space. Update copies the local pose to the bone objects that need it.
+    AnimationEvaluator evaluator;
+    bool poseSampled = false;
+    bool modelPoseValid = false;
+    bool syncBones = false;
+
+    // Append only, so indices stay valid for the poses and the skinned meshes
     std::vector<BoneLink> skeletonCache;
+    // Skeleton indices, parents before children
+    std::vector<int> evaluationOrder;
     std::map<std::string, int> boneIndexMap;
+    std::unordered_map<const GameObject*, int> boneObjectMap;
+    // Skeleton index of the owner when a clip animates it, -1 otherwise
+    int ownerBone = -1;
+    uint32_t skeletonVersion = 0;
+
+    static AnimationLodPolicy lodPolicy;
+    // Picked on the main thread each frame, used by the next UpdateAsync
+    AnimationLodLevel lodLevel = AnimationLodLevel::FULL;
+    int maxBoneDepth = INT_MAX;
+    // Staggers the reduced rate updates of different characters over frames
+    uint32_t lodFrame = 0;
+    float lodElapsed = 0.0f;
 };
\ No newline at end of file
@@ -26,12 +26,8 @@ ComponentMesh::~ComponentMesh()
     ReleaseCurrentMesh();
     Application::GetInstance().renderer->RemoveMesh(this);
 
-    if (hasDirectMesh && directMesh.VAO != 0) {
-        glDeleteVertexArrays(1, &directMesh.VAO);
-        glDeleteBuffers(1, &directMesh.VBO);
-        glDeleteBuffers(1, &directMesh.EBO);
-    }
-
+    if (Application::GetInstance().scene)
+        Application::GetInstance().scene->RemoveFromSpatialIndex(owner);
 }
 
 void ComponentMesh::ReleaseCurrentMesh()
@@ -41,6 +37,15 @@ void ComponentMesh::ReleaseCurrentMesh()
         meshUID = 0;
     }
 
+    if (hasDirectMesh && directMesh.VAO != 0) {
+        glDeleteVertexArrays(1, &directMesh.VAO);
+        glDeleteBuffers(1, &directMesh.VBO);
+        glDeleteBuffers(1, &directMesh.EBO);
+        directMesh.VAO = 0;
+        directMesh.VBO = 0;
+        directMesh.EBO = 0;
+    }
+
     hasDirectMesh = false;
 }
 
@@ -75,20 +80,25 @@ bool ComponentMesh::LoadMeshByUID(UID meshUID)
 
     ResourceMesh* meshResource = static_cast<ResourceMesh*>(resource);
 
-    const Mesh& loadedMesh = meshResource->GetMesh();
-
-    if (loadedMesh.vertices.empty() || loadedMesh.indices.empty())
+    if (meshResource->GetNumVertices() == 0 || meshResource->GetNumIndices() == 0)
     {
         LOG_CONSOLE("ERROR: Loaded mesh is empty (UID: %llu)", meshUID);
+        resources->ReleaseResource(meshUID);
         return false;
     }
 
-    // Assign mesh to component
-    SetMesh(loadedMesh);
+    // Drawn from the resource's buffers, the component keeps no copy of its own
+    ReleaseCurrentMesh();
+    directMesh = Mesh();
 
     // Store UID for reference
     this->meshUID = meshUID;
 
+    OnMeshAssigned();
+    UpdateStaticAABB();
+
+    owner->PublishGameObjectEvent(GameObjectEvent::MESH_CHANGED, this);
+
     return true;
 }
 
@@ -104,50 +114,83 @@ void ComponentMesh::SetMesh(const Mesh& mesh)
     // Upload mesh to GPU if data is available
     if (!directMesh.vertices.empty() && !directMesh.indices.empty())
     {
-        // Generate OpenGL buffers
-        glGenVertexArrays(1, &directMesh.VAO);
-        glGenBuffers(1, &directMesh.VBO);
-        glGenBuffers(1, &directMesh.EBO);
-
-        glBindVertexArray(directMesh.VAO);
-
-        // Upload vertex data
-        glBindBuffer(GL_ARRAY_BUFFER, directMesh.VBO);
-        glBufferData(GL_ARRAY_BUFFER,
-            directMesh.vertices.size() * sizeof(Vertex),
-            directMesh.vertices.data(),
-            GL_STATIC_DRAW);
-
-        // Upload index data
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, directMesh.EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-            directMesh.indices.size() * sizeof(unsigned int),
-            directMesh.indices.data(),
-            GL_STATIC_DRAW);
-
-        // Configure vertex attributes
-        // Position
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-
-        // Normal
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-            (void*)offsetof(Vertex, normal));
-
-        // TexCoords
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-            (void*)offsetof(Vertex, texCoords));
-
-        glBindVertexArray(0);
+        Application::GetInstance().renderer->LoadMesh(directMesh);
     }
 
+    OnMeshAssigned();
     UpdateStaticAABB();
 
     owner->PublishGameObjectEvent(GameObjectEvent::MESH_CHANGED, this);
 }
 
+const ResourceMesh* ComponentMesh::GetMeshResource() const
+{
+    if (meshUID == 0) return nullptr;
+
+    const Resource* resource = Application::GetInstance().resources->GetResource(meshUID);
+    if (!resource || !resource->IsLoadedToMemory()) return nullptr;
+
+    return dynamic_cast<const ResourceMesh*>(resource);
+}
+
+std::vector<Vertex> ComponentMesh::GetVertices() const
+{
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+
+    const ResourceMesh* meshResource = GetMeshResource();
+    if (meshResource)
+        meshResource->ReadCPUData(vertices, indices);
+    else
+        vertices = directMesh.vertices;
+
+    return vertices;
+}
+
+std::vector<unsigned int> ComponentMesh::GetIndices() const
+{
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+
+    const ResourceMesh* meshResource = GetMeshResource();
+    if (meshResource)
+        meshResource->ReadCPUData(vertices, indices);
+    else
+        indices = directMesh.indices;
+
+    return indices;
+}
+
+bool ComponentMesh::ReadGeometry(std::vector<Vertex>& outVertices, std::vector<unsigned int>& outIndices) const
+{
+    outVertices.clear();
+    outIndices.clear();
+
+    const ResourceMesh* meshResource = GetMeshResource();
+    if (meshResource)
+        return meshResource->ReadCPUData(outVertices, outIndices);
+
+    if (!hasDirectMesh) return false;
+
+    outVertices = directMesh.vertices;
+    outIndices = directMesh.indices;
+    return true;
+}
+
+void ComponentMesh::GetMemoryUsage(size_t& outCPUBytes, size_t& outGPUBytes) const
+{
+    const ResourceMesh* meshResource = GetMeshResource();
+    if (meshResource)
+    {
+        outCPUBytes = meshResource->GetCPUBytes();
+        outGPUBytes = meshResource->GetGPUBytes();
+        return;
+    }
+
+    outCPUBytes = directMesh.vertices.capacity() * sizeof(Vertex) + directMesh.indices.capacity() * sizeof(unsigned int);
+    outGPUBytes = directMesh.VAO != 0 ? outCPUBytes : 0;
+}
+
 const Mesh& ComponentMesh::GetMesh() const
 {
     // Return resource mesh if loaded
@@ -188,7 +231,7 @@ bool ComponentMesh::HasMesh() const
             const ResourceMesh* meshResource = dynamic_cast<const ResourceMesh*>(resource);
             if (meshResource) {
                 const Mesh& mesh = meshResource->GetMesh();
-                return !mesh.vertices.empty() && !mesh.indices.empty();
+                return mesh.GetVertexCount() != 0 && mesh.GetIndexCount() != 0;
             }
         }
     }
@@ -224,9 +267,9 @@ void ComponentMesh::Draw()
         meshToDraw = &directMesh;
     }
 
-    if (meshToDraw && meshToDraw->VAO != 0 && !meshToDraw->indices.empty()) {
+    if (meshToDraw && meshToDraw->VAO != 0 && meshToDraw->GetIndexCount() != 0) {
         glBindVertexArray(meshToDraw->VAO);
-        glDrawElements(GL_TRIANGLES, meshToDraw->indices.size(), GL_UNSIGNED_INT, 0);
+        glDrawElements(GL_TRIANGLES, meshToDraw->GetIndexCount(), meshToDraw->GetIndexType(), 0);
         glBindVertexArray(0);
     }
 }
@@ -247,7 +290,14 @@ void ComponentMesh::UpdateStaticAABB()
     staticAABB.SetNegativeInfinity();
     
     const Mesh& mesh = GetMesh();
-    if (!mesh.IsValid() || mesh.vertices.empty()) return;
+    if (!mesh.IsValid() || mesh.GetVertexCount() == 0) return;
+
+    // Resource meshes only have the bounds computed on load
+    if (mesh.vertices.empty()) {
+        staticAABB.Enclose(mesh.boundsMin);
+        staticAABB.Enclose(mesh.boundsMax);
+        return;
+    }
 
     for (const auto& vertex : mesh.vertices) {
         staticAABB.Enclose(vertex.position);
@@ -312,5 +362,9 @@ void ComponentMesh::OnGameObjectEvent(GameObjectEvent event, Component* componen
         if (component->IsType(ComponentType::MATERIAL))
             attachedMaterial = nullptr;
         break;
+    case GameObjectEvent::TRANSFORM_CHANGED:
+    case GameObjectEvent::MESH_CHANGED:
+        Application::GetInstance().scene->MarkSpatialDirty(owner);
+        break;
     }
 }
\ No newline at end of file
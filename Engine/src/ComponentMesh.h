@@ -45,23 +45,22 @@ public:
 
     unsigned int GetNumVertices() const {
         const Mesh& m = GetMesh();
-        return static_cast<unsigned int>(m.vertices.size());
+        return m.GetVertexCount();
     }
     
-    std::vector<Vertex> GetVertices() const {
-        const Mesh& m = GetMesh();
-        return m.vertices;
-    }
+    // Copies. Resource meshes only have their vertices on the GPU, these read them back
+    // from the Library file: call once and keep the result, not per vertex.
+    std::vector<Vertex> GetVertices() const;
 
     unsigned int GetNumIndices() const {
         const Mesh& m = GetMesh();
-        return static_cast<unsigned int>(m.indices.size());
+        return m.GetIndexCount();
     }
 
-    std::vector<unsigned int> GetIndices() const {
-        const Mesh& m = GetMesh();
-        return m.indices;
-    }
+    std::vector<unsigned int> GetIndices() const;
+
+    // Both at once, with a single read of the Library file. False if there is no mesh.
+    bool ReadGeometry(std::vector<Vertex>& outVertices, std::vector<unsigned int>& outIndices) const;
 
 
     unsigned int GetNumTriangles() const {
@@ -73,6 +72,9 @@ public:
         return static_cast<unsigned int>(m.textures.size());
     }
 
+    // Bytes held by the mesh in CPU memory and in GPU buffers
+    void GetMemoryUsage(size_t& outCPUBytes, size_t& outGPUBytes) const;
+
     ComponentMaterial* GetAttachedMaterial() { return attachedMaterial; }
 
     const AABB& GetAABB() const;
@@ -100,6 +102,9 @@ protected:
 
     UID meshUID = 0;
     void ReleaseCurrentMesh();
+    // After SetMesh / LoadMeshByUID changed the mesh, before MESH_CHANGED goes out
+    virtual void OnMeshAssigned() {}
+    const ResourceMesh* GetMeshResource() const;
 
     Mesh directMesh;
     bool hasDirectMesh;
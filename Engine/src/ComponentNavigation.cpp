@@ -91,7 +91,7 @@ void ComponentNavigation::OnEditor()
         int currentIndex = 0; // "None"
         for (int i = 0; i < (int)surfaces.size(); ++i)
         {
-            if (surfaces[i] == linkedSurface)
+            if (surfaces[i] == linkedSurface.Get())
             {
                 currentIndex = i + 1; // +1 por el "None"
                 break;
@@ -108,14 +108,15 @@ void ComponentNavigation::OnEditor()
         {
             if (currentIndex == 0)
             {
-                linkedSurface = nullptr;
+                linkedSurface.Reset();
                 tempSurfaceUID = 0;
             }
             else
             {
-                linkedSurface = surfaces[currentIndex - 1];
-                tempSurfaceUID = linkedSurface->GetUID();
-                LOG_CONSOLE("Agent linked to surface: %s", linkedSurface->GetName().c_str());
+                GameObject* surface = surfaces[currentIndex - 1];
+                linkedSurface = surface->GetHandle();
+                tempSurfaceUID = surface->GetUID();
+                LOG_CONSOLE("Agent linked to surface: %s", surface->GetName().c_str());
             }
         }
     }
@@ -149,18 +150,19 @@ void ComponentNavigation::OnEditor()
 
 bool ComponentNavigation::SetDestination(const glm::vec3& target)
 {
-    if (!linkedSurface) { LOG_CONSOLE("Sin superficie enlazada"); return false; }
+    GameObject* surface = linkedSurface.Get();
+    if (!surface) { LOG_CONSOLE("Sin superficie enlazada"); return false; }
 
     Transform* t = (Transform*)owner->GetComponent(ComponentType::TRANSFORM);
     glm::vec3 start = t->GetGlobalPosition();
 
     std::vector<glm::vec3> newPath;
-    bool found = Application::GetInstance().navMesh->FindPath(linkedSurface, start, target, newPath);
+    bool found = Application::GetInstance().navMesh->FindPath(surface, start, target, newPath);
 
     if (!found) { LOG_CONSOLE("No se encontr� camino"); return false; }
 
     // Inicializar el pol�gono actual para moveAlongSurface
-    auto* navData = Application::GetInstance().navMesh->GetNavMeshData(linkedSurface);
+    auto* navData = Application::GetInstance().navMesh->GetNavMeshData(surface);
     if (navData && navData->navQuery)
     {
         dtQueryFilter filter;
@@ -180,9 +182,10 @@ bool ComponentNavigation::SetDestination(const glm::vec3& target)
 
 bool ComponentNavigation::SnapPositionToNavMesh(glm::vec3& position)
 {
-    if (!linkedSurface) return false;
+    GameObject* surface = linkedSurface.Get();
+    if (!surface) return false;
 
-    auto* navData = Application::GetInstance().navMesh->GetNavMeshData(linkedSurface);
+    auto* navData = Application::GetInstance().navMesh->GetNavMeshData(surface);
     if (!navData || !navData->navQuery) return false;
 
     dtQueryFilter filter;
@@ -226,8 +229,8 @@ void ComponentNavigation::Serialize(nlohmann::json& componentObj) const {
     componentObj["MoveSpeed"] = moveSpeed;
     componentObj["ArrivalThreshold"] = arrivalThreshold;
 
-    if (linkedSurface) {
-        componentObj["LinkedSurfaceUID"] = linkedSurface->GetUID();
+    if (GameObject* surface = linkedSurface.Get()) {
+        componentObj["LinkedSurfaceUID"] = surface->GetUID();
     }
 }
 
@@ -254,7 +257,8 @@ void ComponentNavigation::Deserialize(const nlohmann::json& componentObj) {
 
 void ComponentNavigation::SolveReferences() {
     if (tempSurfaceUID != 0) {
-        this->linkedSurface = Application::GetInstance().scene->FindObject(this->tempSurfaceUID);
+        GameObject* surface = Application::GetInstance().scene->FindObject(this->tempSurfaceUID);
+        if (surface) this->linkedSurface = surface->GetHandle();
         this->tempSurfaceUID = 0;
     }
 }
@@ -25,7 +25,8 @@ public:
     NavType type = NavType::SURFACE;
 
     float maxSlopeAngle = 35.0f;
-    GameObject* linkedSurface = nullptr;
+    // Unlinked (nullptr) once the surface object is deleted
+    GameObjectHandle linkedSurface;
 
     // Par�metros
     float moveSpeed = 5.0f;
@@ -70,34 +70,47 @@ void ComponentParticleSystem::Update() {
     }
 
     // Prewarm logic, instant simulation at start
-    if (emitter->prewarm && emitter->systemTime == 0.0f) {
+    pendingPrewarm = emitter->prewarm && emitter->systemTime == 0.0f;
+
+    // The step itself runs later in Simulate, together with every other emitter
+    pendingDeltaTime += Application::GetInstance().time->GetDeltaTime();
+}
+
+void ComponentParticleSystem::Simulate() {
+    // Only touches this emitter, so it can run on any worker thread
+    if (pendingPrewarm) {
         float simStep = 0.1f;
         float simTime = 2.0f; // Simulate 2 seconds instantly
         for (float t = 0; t < simTime; t += simStep) {
             emitter->Update(simStep);
         }
+        pendingPrewarm = false;
     }
 
-    float dt = Application::GetInstance().time->GetDeltaTime();
-    emitter->Update(dt);
+    if (pendingDeltaTime > 0.0f) {
+        emitter->Update(pendingDeltaTime);
+        pendingDeltaTime = 0.0f;
+    }
 }
 
 void ComponentParticleSystem::UpdateProximityActivation() {
     // If it's the first time it searches the target and saves it cached
     if (!proximityTargetSearched) {
         proximityTargetSearched = true;
-        proximityTargetCache = Application::GetInstance().scene->FindObject(emitter->proximityTarget);
+        GameObject* found = Application::GetInstance().scene->FindObject(emitter->proximityTarget);
+        if (found) proximityTargetCache = found->GetHandle();
     }
 
-    if (!proximityTargetCache || proximityTargetCache->IsMarkedForDeletion()) {
+    GameObject* target = proximityTargetCache.Get();
+    if (!target || target->IsMarkedForDeletion()) {
         // Target disappeared or not found
         proximityTargetSearched = false;
-        proximityTargetCache = nullptr;
+        proximityTargetCache.Reset();
         return;
     }
 
     Transform* targetTrans = static_cast<Transform*>(
-        proximityTargetCache->GetComponent(ComponentType::TRANSFORM));
+        target->GetComponent(ComponentType::TRANSFORM));
     if (!targetTrans) return;
 
     float dist = glm::distance(emitter->ownerPosition,
@@ -115,43 +128,6 @@ void ComponentParticleSystem::UpdateProximityActivation() {
     }
 }
 
-void ComponentParticleSystem::Draw(ComponentCamera* camera) {
-    if (!active || !emitter) return;
-
-    // Don't draw because there are no particles and every emitter is stopped
-    if (emitter->particles.empty() && !emitter->active) return;
-
-    glUseProgram(0);
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-    // Setup Legacy Matrices
-    glMatrixMode(GL_PROJECTION);
-    glLoadMatrixf(glm::value_ptr(camera->GetProjectionMatrix()));
-
-    glMatrixMode(GL_MODELVIEW);
-    glm::mat4 viewMatrix = camera->GetViewMatrix();
-    glLoadMatrixf(glm::value_ptr(viewMatrix));
-
-    // Simulation space logic in render
-    if (emitter->simulationSpace == SimulationSpace::LOCAL) {
-        // In LOCAL, we apply the object's matrix. Particles move with it
-        Transform* trans = dynamic_cast<Transform*>(owner->GetComponent(ComponentType::TRANSFORM));
-        if (trans) {
-            glm::mat4 globalMat = trans->GetGlobalMatrix();
-            glMultMatrixf(glm::value_ptr(globalMat));
-            glm::mat4 invGlobal = glm::inverse(globalMat);
-            glm::vec3 camWorld = camera->owner->transform->GetGlobalPosition();
-            glm::vec3 camLocal = glm::vec3(invGlobal * glm::vec4(camWorld, 1.0f));
-            emitter->Draw(camLocal);
-            return;
-        }
-    }
-    // WORLD space: camera and particle positions are both world-space, pass directly
-    emitter->Draw(camera->owner->transform->GetGlobalPosition());
-}
-
 // Scripting
 void ComponentParticleSystem::Play() {
     if (!emitter) return;
@@ -290,7 +266,7 @@ void ComponentParticleSystem::OnEditor() {
         if (ImGui::InputText("Target Name", proxBuf, sizeof(proxBuf))) {
             emitter->proximityTarget = proxBuf;
             // Reset cache so the new target is searched next frame
-            proximityTargetCache = nullptr;
+            proximityTargetCache.Reset();
             proximityTargetSearched = false;
         }
         ImGui::DragFloat("Activation Radius", &emitter->activationRadius,
@@ -514,7 +490,7 @@ void ComponentParticleSystem::OnEditor() {
 
     ImGui::Separator();
     // Runtime status display
-    ImGui::TextColored(ImVec4(0, 1, 1, 1), "Particles Alive: %d", (int)emitter->particles.size());
+    ImGui::TextColored(ImVec4(0, 1, 1, 1), "Particles Alive: %d", (int)emitter->particles.Size());
     ImGui::SameLine();
     if (emitter->active && !emitter->stopEmittingFlag)
         ImGui::TextColored(ImVec4(0.3f, 1.0f, 0.3f, 1.0f), "[EMITTING]");
@@ -581,6 +557,8 @@ void ComponentParticleSystem::Serialize(nlohmann::json& componentObj) const {
     componentObj["activationRadius"] = emitter->activationRadius;
     componentObj["proximityTarget"] = emitter->proximityTarget;
 
+    componentObj["randomSeed"] = emitter->randomSeed;
+
     // Serialize Bursts
     nlohmann::json burstsJson = nlohmann::json::array();
     for (const auto& b : emitter->bursts) {
@@ -680,6 +658,11 @@ void ComponentParticleSystem::Deserialize(const nlohmann::json& componentObj) {
     if (componentObj.contains("proximityTarget"))
         emitter->proximityTarget = componentObj["proximityTarget"].get<std::string>();
 
+    if (componentObj.contains("randomSeed")) {
+        emitter->randomSeed = componentObj["randomSeed"].get<uint32_t>();
+        emitter->random.Seed(emitter->randomSeed);
+    }
+
     // Deserialize Bursts
     if (componentObj.contains("bursts")) {
         emitter->bursts.clear();
@@ -4,18 +4,19 @@
 #include <string>
 #include <nlohmann/json.hpp>
 
-class ComponentCamera;
-
 class ComponentParticleSystem : public Component {
 public:
     ComponentParticleSystem(GameObject* owner);
     virtual ~ComponentParticleSystem();
 
     void Update() override;
-    void Draw(ComponentCamera* camera);
+    // Runs the emitter step queued by Update. Called by the renderer for every system
+    // in parallel before drawing.
+    void Simulate();
 
     bool IsType(ComponentType type) override { return type == ComponentType::PARTICLE; };
     bool IsIncompatible(ComponentType type) override { return false; };
+    bool HasRuntimeState() const override { return true; }
 
     // Inspector UI for the module
     void OnEditor() override;
@@ -51,8 +52,9 @@ private:
     unsigned long long textureResourceUID = 0;
 
     // Proximity activation
-    // The pointer of the player is cached so it does not search every frame
-    GameObject* proximityTargetCache = nullptr;
+    // The player is cached so it does not search every frame. The handle goes stale
+    // by itself when the target is deleted.
+    GameObjectHandle proximityTargetCache;
     // True after the first search attempt
     bool proximityTargetSearched = false;
 
@@ -61,4 +63,8 @@ private:
     bool feedbackIsError = false;
 
     void UpdateProximityActivation();
+
+    // Simulation queued by Update for the next Simulate call
+    float pendingDeltaTime = 0.0f;
+    bool pendingPrewarm = false;
 };
\ No newline at end of file
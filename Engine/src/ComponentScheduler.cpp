@@ -0,0 +1,225 @@
+#include "ComponentScheduler.h"
+#include "GameObject.h"
+#include "Application.h"
+#include "JobSystem.h"
+#include <algorithm>
+
+// Components that move objects go first, so everything after them (cameras, particles,
+// audio, skinned meshes...) sees this frame's transforms. Types not listed follow in
+// enum order.
+static const ComponentType MOVER_TYPES[] =
+{
+    ComponentType::RIGIDBODY,
+    ComponentType::SCRIPT,
+    ComponentType::ROTATE,
+    ComponentType::NAVIGATION,
+    ComponentType::ANIMATION,
+};
+
+// Components of a parallel type per job
+static const uint32_t PARALLEL_GRAIN = 4;
+
+ComponentScheduler::ComponentScheduler()
+{
+    for (ComponentType type : MOVER_TYPES)
+    {
+        updateOrder.push_back(type);
+    }
+
+    for (size_t i = 0; i < TYPE_COUNT; ++i)
+    {
+        ComponentType type = (ComponentType)i;
+        if (std::find(updateOrder.begin(), updateOrder.end(), type) == updateOrder.end())
+        {
+            updateOrder.push_back(type);
+        }
+    }
+}
+
+bool ComponentScheduler::UpdatesInParallel(ComponentType type)
+{
+    switch (type)
+    {
+    case ComponentType::ANIMATION:  return true;    // pose sampling
+    default:                        return false;
+    }
+}
+
+void ComponentScheduler::Register(Component* component)
+{
+    if (!component || component->schedulerIndex != INVALID_INDEX) return;
+
+    if (updating)
+    {
+        if (std::find(pendingAdds.begin(), pendingAdds.end(), component) == pendingAdds.end())
+        {
+            pendingAdds.push_back(component);
+        }
+        return;
+    }
+
+    std::vector<Component*>& list = lists[(size_t)component->GetType()];
+    component->schedulerIndex = (uint32_t)list.size();
+    list.push_back(component);
+}
+
+void ComponentScheduler::Unregister(Component* component)
+{
+    if (!component) return;
+
+    if (component->schedulerIndex == INVALID_INDEX)
+    {
+        auto it = std::find(pendingAdds.begin(), pendingAdds.end(), component);
+        if (it != pendingAdds.end())
+        {
+            pendingAdds.erase(it);
+        }
+        return;
+    }
+
+    std::vector<Component*>& list = lists[(size_t)component->GetType()];
+    const uint32_t index = component->schedulerIndex;
+    component->schedulerIndex = INVALID_INDEX;
+
+    if (updating)
+    {
+        // Keep indices stable for the running loop, compacted in Sync
+        list[index] = nullptr;
+        hasRemovals = true;
+        return;
+    }
+
+    Component* last = list.back();
+    list[index] = last;
+    last->schedulerIndex = index;
+    list.pop_back();
+}
+
+void ComponentScheduler::RegisterSubtree(GameObject* obj)
+{
+    if (!obj || obj->IsMarkedForDeletion()) return;
+
+    for (Component* component : obj->GetComponents())
+    {
+        Register(component);
+    }
+    for (GameObject* child : obj->GetChildren())
+    {
+        RegisterSubtree(child);
+    }
+}
+
+void ComponentScheduler::UnregisterSubtree(GameObject* obj)
+{
+    if (!obj) return;
+
+    for (Component* component : obj->GetComponents())
+    {
+        Unregister(component);
+    }
+    for (GameObject* child : obj->GetChildren())
+    {
+        UnregisterSubtree(child);
+    }
+}
+
+bool ComponentScheduler::ShouldUpdate(const Component* component)
+{
+    return component && component->IsActive() && !component->owner->IsMarkedForDeletion();
+}
+
+void ComponentScheduler::UpdateParallel(ComponentType type)
+{
+    std::vector<Component*>& list = lists[(size_t)type];
+    if (!UpdatesInParallel(type) || list.empty()) return;
+
+    Application::GetInstance().jobs->ParallelFor((uint32_t)list.size(), PARALLEL_GRAIN, [&list](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t j = begin; j < end; ++j)
+            {
+                if (ShouldUpdate(list[j]))
+                {
+                    list[j]->UpdateAsync();
+                }
+            }
+        });
+}
+
+void ComponentScheduler::UpdateMainThread(ComponentType type)
+{
+    // Indexed loop: Update may null out entries, but the list never grows while updating
+    std::vector<Component*>& list = lists[(size_t)type];
+    for (size_t i = 0; i < list.size(); ++i)
+    {
+        if (ShouldUpdate(list[i]))
+        {
+            list[i]->Update();
+        }
+    }
+}
+
+void ComponentScheduler::Update()
+{
+    updating = true;
+
+    for (size_t i = 0; i < TYPE_COUNT; ++i)
+    {
+        UpdateParallel((ComponentType)i);
+    }
+
+    for (ComponentType type : updateOrder)
+    {
+        UpdateMainThread(type);
+    }
+
+    updating = false;
+    Sync();
+}
+
+void ComponentScheduler::FixedUpdate()
+{
+    updating = true;
+
+    for (ComponentType type : updateOrder)
+    {
+        std::vector<Component*>& list = lists[(size_t)type];
+        for (size_t i = 0; i < list.size(); ++i)
+        {
+            if (ShouldUpdate(list[i]))
+            {
+                list[i]->FixedUpdate();
+            }
+        }
+    }
+
+    updating = false;
+    Sync();
+}
+
+void ComponentScheduler::Sync()
+{
+    if (hasRemovals)
+    {
+        for (std::vector<Component*>& list : lists)
+        {
+            size_t write = 0;
+            for (size_t read = 0; read < list.size(); ++read)
+            {
+                if (list[read] == nullptr) continue;
+
+                list[read]->schedulerIndex = (uint32_t)write;
+                list[write++] = list[read];
+            }
+            list.resize(write);
+        }
+        hasRemovals = false;
+    }
+
+    for (Component* component : pendingAdds)
+    {
+        std::vector<Component*>& list = lists[(size_t)component->GetType()];
+        component->schedulerIndex = (uint32_t)list.size();
+        list.push_back(component);
+    }
+    pendingAdds.clear();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Component.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class GameObject;
+
+// Flat per-type lists of every live component, updated in phases instead of by
+// recursing over the GameObject tree:
+//   1. UpdateAsync of the parallel types, spread over the job system
+//   2. Update of every type on the main thread, movers (physics, scripts, animation)
+//      before the types that read the final transforms (cameras, particles, audio...)
+//   3. Sync point: components added or removed while updating are applied here
+// Only objects attached to the scene root and not marked for deletion are in the lists,
+// detached trees (importer output, undo buffers, prefab templates) never update.
+class ComponentScheduler
+{
+public:
+    ComponentScheduler();
+
+    // Called by GameObject when a component joins / leaves the list of a scene object
+    void Register(Component* component);
+    void Unregister(Component* component);
+    // Every component of the object and its descendants, when the subtree is attached to /
+    // detached from the scene. Objects marked for deletion are skipped with their children.
+    void RegisterSubtree(GameObject* obj);
+    void UnregisterSubtree(GameObject* obj);
+
+    void Update();
+    void FixedUpdate();
+
+    // Types whose UpdateAsync only touches the component itself and can run on workers
+    static bool UpdatesInParallel(ComponentType type);
+
+    size_t GetCount(ComponentType type) const { return lists[(size_t)type].size(); }
+
+private:
+    static const size_t TYPE_COUNT = (size_t)ComponentType::UNKNOWN + 1;
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+    static bool ShouldUpdate(const Component* component);
+    void UpdateParallel(ComponentType type);
+    void UpdateMainThread(ComponentType type);
+    void Sync();
+
+    std::vector<Component*> lists[TYPE_COUNT];
+    std::vector<ComponentType> updateOrder;
+
+    // Changes made while a phase is iterating the lists
+    bool updating = false;
+    bool hasRemovals = false;
+    std::vector<Component*> pendingAdds;
+};
@@ -67,6 +67,7 @@ public:
 
     bool IsType(ComponentType type) override { return type == ComponentType::SCRIPT; };
     bool IsIncompatible(ComponentType type) override { return false; };
+    bool HasRuntimeState() const override { return true; }
 
     void Enable() override;
     void Update() override;
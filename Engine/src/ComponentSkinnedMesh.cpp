@@ -4,33 +4,32 @@
 #include "Application.h"
 #include "ModuleResources.h"
 #include "ModuleEvents.h"
+#include "ComponentAnimation.h"
 #include "ResourceMesh.h"
 #include "Transform.h"
 #include "Log.h"
+#include "MatrixMath.h"
 #include <glad/glad.h>
+#include <unordered_map>
 #include "Application.h"
 
 ComponentSkinnedMesh::ComponentSkinnedMesh(GameObject* owner) : ComponentMesh (owner, ComponentType::SKINNED_MESH)
 {
     name = "Skinned Mesh";
     bonesLinked = false;
-    Application::GetInstance().events->Subscribe(Event::Type::GameObjectDestroyed, this);
 }
 
 ComponentSkinnedMesh::~ComponentSkinnedMesh()
 {
     ComponentMesh::~ComponentMesh();
-    Application::GetInstance().renderer->DeleteSSBO(ssboGlobalMatrices);
-    Application::GetInstance().renderer->DeleteSSBO(ssboOffsetMatrices);
-    Application::GetInstance().events->UnsubscribeAll(this);
 }
 
 
-void ComponentSkinnedMesh::SetMesh(const Mesh& meshData)
+void ComponentSkinnedMesh::OnMeshAssigned()
 {
-    ComponentMesh::SetMesh(meshData);
     bonesLinked = false;
     boneGameObjects.clear();
+    poseAnimation = nullptr;
 }
 
 void ComponentSkinnedMesh::LinkBones() {
@@ -40,10 +39,10 @@ void ComponentSkinnedMesh::LinkBones() {
     if (!GetMesh().IsValid() || !GetMesh().IsSkinned()) return;
 
     size_t numBones = GetMesh().bones.size();
-    fastBones.clear();
-    fastBones.resize(numBones);
-    boneGlobalMatrices.resize(numBones);
-    boneGameObjects.resize(numBones);
+    boneGameObjects.assign(numBones, GameObjectHandle());
+    boneOffsets.assign(numBones, glm::mat4(1.0f));
+    poseAnimation = nullptr;
+    paletteFrame = UINT64_MAX;
 
     GameObject* root = nullptr;
 
@@ -51,19 +50,17 @@ void ComponentSkinnedMesh::LinkBones() {
         root = owner->GetParent();
     else root = owner;
 
-    std::vector<glm::mat4> offsets(numBones);
+    std::unordered_map<std::string, GameObject*> nodesByName;
+    root->BuildNameIndex(nodesByName);
 
     for (size_t i = 0; i < numBones; ++i) {
-        GameObject* foundBone = root->FindChild(GetMesh().bones[i].name);
+        auto found = nodesByName.find(GetMesh().bones[i].name);
+        GameObject* foundBone = found != nodesByName.end() ? found->second : nullptr;
         if (foundBone) {
-            boneGameObjects[i] = foundBone;
-            fastBones[i].globalMatrixPtr = &foundBone->transform->GetGlobalMatrix();
-            fastBones[i].offsetMatrix = GetMesh().bones[i].offsetMatrix;
-            offsets[i] = fastBones[i].offsetMatrix;
+            boneGameObjects[i] = foundBone->GetHandle();
+            boneOffsets[i] = GetMesh().bones[i].offsetMatrix;
         }
     }
-
-    Application::GetInstance().renderer->CreateSkinningSSBOs(ssboGlobalMatrices, ssboOffsetMatrices, offsets);
 }
 
 void ComponentSkinnedMesh::Update()
@@ -74,58 +71,98 @@ void ComponentSkinnedMesh::Update()
     }
 }
 
+void ComponentSkinnedMesh::MapBonesToPose(const ComponentAnimation* animation)
+{
+    poseAnimation = animation;
+    poseSkeletonVersion = animation->GetSkeletonVersion();
+    poseBones.assign(boneGameObjects.size(), PoseBone());
+
+    for (size_t i = 0; i < boneGameObjects.size(); ++i)
+    {
+        GameObject* bone = boneGameObjects[i].Get();
+
+        // Bones the clips do not move (end bones...) follow the nearest one they do
+        for (GameObject* go = bone; go != nullptr; go = go->GetParent())
+        {
+            int index = animation->FindBone(go);
+            if (index >= 0)
+            {
+                poseBones[i].index = index;
+                poseBones[i].relative = go != bone;
+                poseBones[i].anchor = go->GetHandle();
+                break;
+            }
+            if (go == animation->owner) break;
+        }
+    }
+}
+
 void ComponentSkinnedMesh::UpdateSkinningMatrices()
 {
     if (!bonesLinked) return;
 
-    meshInverseTransform = glm::inverse(owner->transform->GetGlobalMatrix());
+    // Every camera and the picking pass of a frame share one palette
+    Renderer* renderer = Application::GetInstance().renderer.get();
+    if (paletteFrame == renderer->GetFrameIndex()) return;
 
-    if (boneGlobalMatrices.size() != boneGameObjects.size())
-        boneGlobalMatrices.resize(boneGameObjects.size());
+    glm::mat4 meshInverse = glm::inverse(owner->transform->GetGlobalMatrix());
 
-    for (size_t i = 0; i < boneGameObjects.size(); ++i)
+    // While an animation plays its bone objects may not be synced: bones come straight from its pose
+    ComponentAnimation* animation = static_cast<ComponentAnimation*>(owner->GetComponentInParent(ComponentType::ANIMATION));
+    const std::vector<glm::mat4>* pose = animation ? animation->GetModelPose() : nullptr;
+    if (pose && (animation != poseAnimation || animation->GetSkeletonVersion() != poseSkeletonVersion))
     {
-        if (boneGameObjects[i])
-            boneGlobalMatrices[i] = boneGameObjects[i]->transform->GetGlobalMatrix();
-        else
-            boneGlobalMatrices[i] = glm::mat4(1.0f);
+        MapBonesToPose(animation);
     }
 
-    Application::GetInstance().renderer->UploadGlobalMatricesToGPU(ssboGlobalMatrices, boneGlobalMatrices);
+    // Pose matrices are in the animation's space, this takes them to the mesh's in one multiply
+    glm::mat4 poseToMesh(1.0f);
+    if (pose) MultiplyMatrices(meshInverse, animation->owner->transform->GetGlobalMatrix(), poseToMesh);
 
-    hasSkinningData = true;
-}
+    // Written in place in this frame's ring, already premultiplied so the shader does one fetch per influence
+    glm::mat4* palette = renderer->AllocateBoneMatrices(boneGameObjects.size(), boneMatricesRange);
+    hasSkinningData = palette != nullptr;
+    if (!palette) return;
+    paletteFrame = renderer->GetFrameIndex();
 
-void ComponentSkinnedMesh::ReleaseCurrentMesh()
-{
-    ComponentMesh::ReleaseCurrentMesh();
-    bonesLinked = false;
-    boneGameObjects.clear();
-}
-
-void ComponentSkinnedMesh::OnEvent(const Event& event)
-{
-    switch (event.type)
-    {
-    case Event::Type::GameObjectDestroyed:
+    glm::mat4 bonePose;
+    for (size_t i = 0; i < boneGameObjects.size(); ++i)
     {
-        if (boneGameObjects.empty()) return;
-
-        GameObject* deletedGO = event.data.gameObject.gameObject;
+        const PoseBone* poseBone = pose && poseBones[i].index >= 0 ? &poseBones[i] : nullptr;
+        GameObject* bone = boneGameObjects[i].Get();
 
-        for (size_t i = 0; i < boneGameObjects.size(); ++i)
+        if (poseBone && !poseBone->relative)
         {
-            if (boneGameObjects[i] == deletedGO)
-            {
-                boneGameObjects[i] = nullptr;
-            }
+            MultiplyMatrices(poseToMesh, (*pose)[poseBone->index], bonePose);
+        }
+        else if (poseBone && bone && poseBone->anchor.Get())
+        {
+            // The objects may be stale, but the offset between them is not
+            GameObject* anchor = poseBone->anchor.Get();
+            glm::mat4 anchorPose, offset;
+            MultiplyMatrices(poseToMesh, (*pose)[poseBone->index], anchorPose);
+            MultiplyMatrices(glm::inverse(anchor->transform->GetGlobalMatrix()), bone->transform->GetGlobalMatrix(), offset);
+            MultiplyMatrices(anchorPose, offset, bonePose);
+        }
+        else if (bone)
+        {
+            MultiplyMatrices(meshInverse, bone->transform->GetGlobalMatrix(), bonePose);
+        }
+        else
+        {
+            // Deleted bones skin with identity
+            palette[i] = glm::mat4(1.0f);
+            continue;
         }
 
-        break;
+        MultiplyMatrices(bonePose, boneOffsets[i], palette[i]);
     }
+}
 
-    default:
-        break;
-    }
+void ComponentSkinnedMesh::ReleaseCurrentMesh()
+{
+    ComponentMesh::ReleaseCurrentMesh();
+    bonesLinked = false;
+    boneGameObjects.clear();
 }
 
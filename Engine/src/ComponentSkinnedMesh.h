@@ -2,12 +2,15 @@
 
 #include "Component.h"
 #include "ComponentMesh.h"
-#include "EventListener.h"
 #include "ModuleLoader.h"  
 #include "ModuleResources.h"  
+#include "FrameRingBuffer.h"
+#include "Handle.h"
 #include <glm/glm.hpp>
 
-class ComponentSkinnedMesh : public ComponentMesh , public EventListener{
+class ComponentAnimation;
+
+class ComponentSkinnedMesh : public ComponentMesh {
 public:
     // Constructor and destructor
     ComponentSkinnedMesh(GameObject* owner);
@@ -22,35 +25,43 @@ public:
     void UpdateSkinningMatrices();
     bool HasSkinning() const override { return hasSkinningData; }
 
-    void SetMesh(const Mesh& meshData) override;
-
-    const glm::mat4& GetMeshInverse() const { return meshInverseTransform; }
-    unsigned int GetSSBOGlobal() const { return ssboGlobalMatrices; }
-    unsigned int GetSSBOOffset() const { return ssboOffsetMatrices; }
+    // Skinning matrices of the last UpdateSkinningMatrices, valid for the current frame
+    const FrameRingAllocation& GetBoneMatricesRange() const { return boneMatricesRange; }
+    // Buffer holding the palette: the frame ring, or its overflow when the ring was full
+    unsigned int GetPaletteBuffer() const { return boneMatricesRange.buffer; }
+    // First matrix of this mesh in that buffer, the shader's boneBase
+    int GetPaletteBase() const { return (int)(boneMatricesRange.offset / sizeof(glm::mat4)); }
     int GetLinkedBonesNum() const { return boneGameObjects.size(); }
 
-    void OnEvent(const Event& event);
-
 protected:
 
+    void OnMeshAssigned() override;
+
     UID meshUID = 0;
     void ReleaseCurrentMesh();
 
 private:
 
-    struct BoneInfo {
-        const glm::mat4* globalMatrixPtr;
-        glm::mat4 offsetMatrix;
+    // Where a bone's matrix comes from while an animation above the mesh is playing
+    struct PoseBone
+    {
+        int index = -1;             // in the animation's model pose, -1: read the bone object
+        bool relative = false;      // the bone is not in the skeleton, its ancestor anchor at index is
+        GameObjectHandle anchor;
     };
 
-    std::vector<BoneInfo> fastBones;
-    std::vector<GameObject*> boneGameObjects;
-    std::vector<glm::mat4> cachedBoneMatrices;
-    std::vector<glm::mat4> boneGlobalMatrices;
-    glm::mat4 meshInverseTransform;
+    void MapBonesToPose(const ComponentAnimation* animation);
+
+    // Deleted bones resolve to nullptr and skin with identity
+    std::vector<GameObjectHandle> boneGameObjects;
+    std::vector<glm::mat4> boneOffsets;
+
+    std::vector<PoseBone> poseBones;
+    const ComponentAnimation* poseAnimation = nullptr;
+    uint32_t poseSkeletonVersion = 0;
 
-    unsigned int ssboGlobalMatrices = 0;
-    unsigned int ssboOffsetMatrices = 0;
+    FrameRingAllocation boneMatricesRange;
+    uint64_t paletteFrame = UINT64_MAX;
 
     bool bonesLinked = false;
     bool hasSkinningData = false;
@@ -9,6 +9,7 @@
 #include "ModuleCamera.h"
 #include "ModuleEditor.h"
 #include "EditorCamera.h"
+#include "ComponentAnimation.h"
 #include "Log.h"
 
 ConfigurationWindow::ConfigurationWindow()
@@ -60,6 +61,13 @@ void ConfigurationWindow::Draw()
 
     ImGui::Separator();
 
+    if (ImGui::CollapsingHeader("Animation"))
+    {
+        DrawAnimationSettings();
+    }
+
+    ImGui::Separator();
+
     if (ImGui::CollapsingHeader("Hardware"))
     {
         DrawHardwareInfo();
@@ -250,6 +258,52 @@ void ConfigurationWindow::DrawAudioVolumeSettings() {
     
 }
 
+void ConfigurationWindow::DrawAnimationSettings()
+{
+    AnimationLodPolicy& lod = ComponentAnimation::GetLodPolicy();
+
+    ImGui::Checkbox("Animation LOD", &lod.enabled);
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("In play mode, characters small on screen or outside every camera\nupdate less often and with fewer bones");
+
+    if (lod.enabled)
+    {
+        ImGui::Indent();
+
+        int metric = (int)lod.metric;
+        const char* metrics[] = { "Screen Size", "Distance" };
+        if (ImGui::Combo("Metric", &metric, metrics, 2))
+        {
+            lod.metric = (AnimationLodPolicy::Metric)metric;
+        }
+
+        if (lod.metric == AnimationLodPolicy::Metric::SCREEN_SIZE)
+        {
+            ImGui::SliderFloat("Reduced Below", &lod.reducedScreenSize, 0.0f, 1.0f, "%.2f of screen");
+            ImGui::SliderFloat("Low Below", &lod.lowScreenSize, 0.0f, 1.0f, "%.2f of screen");
+        }
+        else
+        {
+            ImGui::DragFloat("Reduced Beyond", &lod.reducedDistance, 0.5f, 0.0f, 1000.0f, "%.1f m");
+            ImGui::DragFloat("Low Beyond", &lod.lowDistance, 0.5f, 0.0f, 1000.0f, "%.1f m");
+        }
+
+        ImGui::SliderInt("Reduced Interval", &lod.reducedInterval, 1, 8, "every %d frames");
+        ImGui::SliderInt("Low Interval", &lod.lowInterval, 1, 16, "every %d frames");
+        ImGui::SliderInt("Culled Interval", &lod.culledInterval, 1, 60, "every %d frames");
+        ImGui::SliderInt("Low Max Bone Depth", &lod.lowMaxBoneDepth, 0, 16);
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("At Low and Culled, deeper bones stay in their bind pose");
+
+        ImGui::Unindent();
+    }
+
+    ImGui::Spacing();
+    ImGui::Separator();
+
+    ModuleScene* scene = Application::GetInstance().scene.get();
+    size_t animated = scene->GetComponentScheduler().GetCount(ComponentType::ANIMATION);
+    ImGui::Text("Animated Characters: %zu", animated);
+}
+
 void ConfigurationWindow::DrawRendererSettings()
 {
     ImGui::Text("OpenGL Renderer Settings");
@@ -313,6 +367,30 @@ void ConfigurationWindow::DrawRendererSettings()
     ImGui::Spacing();
     ImGui::Separator();
 
+    bool instancing = renderer->IsInstancingEnabled();
+    if (ImGui::Checkbox("GPU Instancing", &instancing))
+    {
+        renderer->SetInstancing(instancing);
+    }
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Draw repeated static meshes with the same material in a single call");
+
+    ImGui::Spacing();
+    ImGui::Separator();
+
+    ImGui::Text("Frame Statistics");
+
+    const RenderStats& stats = renderer->GetFrameStats();
+    ImGui::Text("Draw Calls: %u", stats.drawCalls);
+    ImGui::Text("Instanced Draw Calls: %u (%u instances)", stats.instancedDrawCalls, stats.instances);
+    ImGui::Text("Program Binds: %u", stats.programBinds);
+    ImGui::Text("Material Binds: %u", stats.materialBinds);
+    ImGui::Text("Texture Binds: %u", stats.textureBinds);
+    ImGui::Text("Buffer Uploads: %u", stats.bufferUploads);
+    ImGui::Text("Particles: %u", stats.particles);
+
+    ImGui::Spacing();
+    ImGui::Separator();
+
     ImGui::Text("Background Color");
 
     float currentR, currentG, currentB;
@@ -22,6 +22,7 @@ private:
     void DrawHardwareInfo();
     void DrawWindowSettings();
     void DrawRendererSettings();
+    void DrawAnimationSettings();
     void DrawAudioVolumeSettings();
     void DrawCameraSettings();
 
@@ -56,11 +56,12 @@ void ConvexCollider::CookMesh() {
     }
     else
     {
-        int size = meshRenderer->GetNumVertices();
+        std::vector<Vertex> meshVertices = meshRenderer->GetVertices();
+        int size = (int)meshVertices.size();
         std::vector<glm::vec3> vertices(size);
 
         for (int i = 0; i < size; i++) {
-            vertices[i] = meshRenderer->GetVertices()[i].position;
+            vertices[i] = meshVertices[i].position;
         }
 
         cookedMesh = PhysicsCooker::CookConvex((const float*)vertices.data(), (uint32_t)size, sizeof(glm::vec3));
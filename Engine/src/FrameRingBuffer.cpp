@@ -0,0 +1,310 @@
+#include "FrameRingBuffer.h"
+#include "Log.h"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstring>
+
+// FrameRingAllocator
+
+FrameRingAllocator::FrameRingAllocator(size_t capacity, unsigned int framesInFlight, FenceBackend* fences)
+    : capacity(capacity), maxFramesInFlight(std::max(1u, framesInFlight)), fences(fences)
+{
+}
+
+FrameRingAllocator::~FrameRingAllocator()
+{
+    for (FrameFence& frame : inFlight)
+        fences->Release(frame.fence);
+    inFlight.clear();
+}
+
+void FrameRingAllocator::BeginFrame()
+{
+    while (inFlight.size() >= maxFramesInFlight)
+        RetireOldest();
+
+    frameStart = head;
+}
+
+void FrameRingAllocator::EndFrame()
+{
+    // Nothing written, nothing for the GPU to protect
+    if (head == frameStart) return;
+
+    inFlight.push_back({ fences->Insert(), head });
+}
+
+bool FrameRingAllocator::Allocate(size_t size, size_t alignment, size_t& outOffset)
+{
+    if (size == 0 || size > capacity) return false;
+    if (alignment == 0) alignment = 1;
+
+    // Capacity is a multiple of the alignment, so aligning the virtual offset aligns the physical one
+    uint64_t offset = (head + alignment - 1) / alignment * alignment;
+
+    // Allocations never straddle the end of the buffer
+    size_t physical = (size_t)(offset % capacity);
+    if (physical + size > capacity)
+        offset += capacity - physical;
+
+    // Reclaim space from the oldest frames until the range is free
+    while (offset + size - tail > capacity)
+    {
+        if (!inFlight.empty())
+        {
+            RetireOldest();
+        }
+        else if (tail == head)
+        {
+            // Nothing is live, the bytes skipped to reach offset are free as well
+            tail = offset;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    head = offset + size;
+    outOffset = (size_t)(offset % capacity);
+    return true;
+}
+
+void FrameRingAllocator::WaitIdle()
+{
+    while (!inFlight.empty())
+        RetireOldest();
+
+    tail = head;
+}
+
+void FrameRingAllocator::RetireOldest()
+{
+    FrameFence& oldest = inFlight.front();
+    fences->Wait(oldest.fence);
+    fences->Release(oldest.fence);
+
+    tail = oldest.end;
+    inFlight.pop_front();
+    waitCount++;
+}
+
+// GL fences
+
+class GLFenceBackend : public FenceBackend
+{
+public:
+    FenceHandle Insert() override
+    {
+        return (FenceHandle)glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    void Wait(FenceHandle fence) override
+    {
+        GLsync sync = (GLsync)fence;
+        GLenum result = glClientWaitSync(sync, 0, 0);
+
+        while (result == GL_TIMEOUT_EXPIRED)
+            result = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+    }
+
+    void Release(FenceHandle fence) override
+    {
+        glDeleteSync((GLsync)fence);
+    }
+};
+
+// FrameRingBuffer
+
+// Smallest overflow buffer, so a frame that overflows with many small uploads creates few
+static const size_t OVERFLOW_BLOCK_SIZE = 1024 * 1024;
+
+static const GLbitfield MAP_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+FrameRingBuffer::FrameRingBuffer()
+{
+}
+
+FrameRingBuffer::~FrameRingBuffer()
+{
+    Destroy();
+}
+
+bool FrameRingBuffer::Init(size_t capacity, unsigned int frames)
+{
+    framesInFlight = frames;
+    fences = std::make_unique<GLFenceBackend>();
+
+    GLint alignment = 0;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    if (alignment > 0) storageAlignment = (size_t)alignment;
+
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    if (alignment > 0) uniformAlignment = (size_t)alignment;
+
+    return CreateStorage(capacity);
+}
+
+void FrameRingBuffer::Destroy()
+{
+    if (allocator) allocator->WaitIdle();
+    ReleaseOverflow();
+    DestroyStorage();
+    fences.reset();
+    frameOpen = false;
+}
+
+bool FrameRingBuffer::CreateStorage(size_t capacity)
+{
+    // Round up so every alignment we hand out divides the capacity
+    size_t granularity = std::max<size_t>(256, std::max(storageAlignment, uniformAlignment));
+    capacity = (capacity + granularity - 1) / granularity * granularity;
+
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferStorage(GL_COPY_WRITE_BUFFER, (GLsizeiptr)capacity, nullptr, MAP_FLAGS);
+    mapped = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, (GLsizeiptr)capacity, MAP_FLAGS);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    if (mapped == nullptr)
+    {
+        LOG_CONSOLE("ERROR: Failed to map frame ring buffer (%zu bytes)", capacity);
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+        return false;
+    }
+
+    allocator = std::make_unique<FrameRingAllocator>(capacity, framesInFlight, fences.get());
+    requestedCapacity = capacity;
+
+    LOG_DEBUG("Frame ring buffer created - %zu bytes, %u frames in flight", capacity, framesInFlight);
+    return true;
+}
+
+void FrameRingBuffer::DestroyStorage()
+{
+    allocator.reset();
+
+    if (buffer != 0)
+    {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+
+    mapped = nullptr;
+}
+
+void FrameRingBuffer::NextFrame()
+{
+    if (!allocator) return;
+
+    if (frameOpen)
+        allocator->EndFrame();
+
+    ReleaseOverflow();
+
+    if (requestedCapacity > allocator->GetCapacity())
+    {
+        size_t newCapacity = requestedCapacity;
+        allocator->WaitIdle();
+        DestroyStorage();
+        CreateStorage(newCapacity);
+        if (!allocator) return;
+    }
+
+    allocator->BeginFrame();
+    frameOpen = true;
+}
+
+void* FrameRingBuffer::Allocate(size_t size, size_t alignment, FrameRingAllocation& outAllocation)
+{
+    outAllocation = FrameRingAllocation();
+    if (!allocator || size == 0) return nullptr;
+
+    size_t offset = 0;
+    if (!allocator->Allocate(size, alignment, offset))
+    {
+        // Out of space this frame: this frame overflows, the ring grows next frame
+        size_t capacity = allocator->GetCapacity();
+        size_t grown = std::max(capacity * 2, size * 2);
+        if (grown > requestedCapacity)
+        {
+            requestedCapacity = grown;
+            LOG_DEBUG("Frame ring buffer full (%zu bytes requested), growing to %zu", size, requestedCapacity);
+        }
+        return AllocateOverflow(size, alignment, outAllocation);
+    }
+
+    outAllocation.buffer = buffer;
+    outAllocation.offset = offset;
+    outAllocation.size = size;
+    return mapped + offset;
+}
+
+void* FrameRingBuffer::AllocateOverflow(size_t size, size_t alignment, FrameRingAllocation& outAllocation)
+{
+    if (alignment == 0) alignment = 1;
+
+    if (!overflow.empty())
+    {
+        OverflowBlock& block = overflow.back();
+        size_t offset = (block.used + alignment - 1) / alignment * alignment;
+        if (offset + size <= block.capacity)
+        {
+            block.used = offset + size;
+            outAllocation.buffer = block.buffer;
+            outAllocation.offset = offset;
+            outAllocation.size = size;
+            return block.mapped + offset;
+        }
+    }
+
+    OverflowBlock block;
+    block.capacity = std::max(size, OVERFLOW_BLOCK_SIZE);
+    block.used = size;
+    block.buffer = 0;
+
+    glGenBuffers(1, &block.buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, block.buffer);
+    glBufferStorage(GL_COPY_WRITE_BUFFER, (GLsizeiptr)block.capacity, nullptr, MAP_FLAGS);
+    block.mapped = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, (GLsizeiptr)block.capacity, MAP_FLAGS);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    if (block.mapped == nullptr)
+    {
+        LOG_CONSOLE("ERROR: Failed to map frame ring overflow buffer (%zu bytes)", block.capacity);
+        glDeleteBuffers(1, &block.buffer);
+        return nullptr;
+    }
+
+    overflow.push_back(block);
+    outAllocation.buffer = block.buffer;
+    outAllocation.offset = 0;
+    outAllocation.size = size;
+    return block.mapped;
+}
+
+void FrameRingBuffer::ReleaseOverflow()
+{
+    for (OverflowBlock& block : overflow)
+    {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, block.buffer);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        glDeleteBuffers(1, &block.buffer);
+    }
+    overflow.clear();
+}
+
+FrameRingAllocation FrameRingBuffer::Upload(const void* data, size_t size, size_t alignment)
+{
+    FrameRingAllocation allocation;
+    void* dst = Allocate(size, alignment, allocation);
+    if (dst && data)
+        memcpy(dst, data, size);
+    return allocation;
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+// Handle to a GPU fence. Opaque so the allocator can be driven by a fake backend.
+typedef void* FenceHandle;
+
+class FenceBackend
+{
+public:
+    virtual ~FenceBackend() = default;
+
+    // Fence signalled once the GPU has consumed every command issued so far
+    virtual FenceHandle Insert() = 0;
+    // Blocks until the fence is signalled
+    virtual void Wait(FenceHandle fence) = 0;
+    virtual void Release(FenceHandle fence) = 0;
+};
+
+// Offset bookkeeping of a ring shared by several frames in flight, without any GL.
+// Offsets grow monotonically and wrap by modulo, so "used" is simply head - tail.
+// Every closed frame keeps a fence; space is only reused after its fence is waited on.
+class FrameRingAllocator
+{
+public:
+    FrameRingAllocator(size_t capacity, unsigned int framesInFlight, FenceBackend* fences);
+    ~FrameRingAllocator();
+
+    // Waits if framesInFlight frames are already queued on the GPU
+    void BeginFrame();
+    // Fences every allocation made since BeginFrame
+    void EndFrame();
+
+    // Returns false if the current frame alone does not fit in the ring
+    bool Allocate(size_t size, size_t alignment, size_t& outOffset);
+
+    // Waits for every frame in flight (before destroying or resizing the storage)
+    void WaitIdle();
+
+    size_t GetCapacity() const { return capacity; }
+    size_t GetFrameBytes() const { return (size_t)(head - frameStart); }
+    unsigned int GetFramesInFlight() const { return (unsigned int)inFlight.size(); }
+    // Fences waited on so far (including already signalled ones)
+    unsigned int GetWaitCount() const { return waitCount; }
+
+private:
+    void RetireOldest();
+
+    struct FrameFence
+    {
+        FenceHandle fence;
+        uint64_t end;
+    };
+
+    size_t capacity;
+    unsigned int maxFramesInFlight;
+    FenceBackend* fences;
+
+    uint64_t head = 0;          // next free byte
+    uint64_t tail = 0;          // everything before this is no longer read by the GPU
+    uint64_t frameStart = 0;
+
+    std::deque<FrameFence> inFlight;
+    unsigned int waitCount = 0;
+};
+
+// Sub-range of the ring returned by FrameRingBuffer::Upload
+struct FrameRingAllocation
+{
+    unsigned int buffer = 0;
+    size_t offset = 0;
+    size_t size = 0;
+
+    bool IsValid() const { return buffer != 0 && size > 0; }
+};
+
+// Persistent, coherently mapped GL buffer handed out per frame through FrameRingAllocator.
+// Replaces glBufferData/glBufferSubData for data that changes every frame.
+class FrameRingBuffer
+{
+public:
+    FrameRingBuffer();
+    ~FrameRingBuffer();
+
+    bool Init(size_t capacity, unsigned int framesInFlight);
+    void Destroy();
+
+    // Closes the previous frame and opens a new one. Grows the ring here if the last
+    // frame ran out of space.
+    void NextFrame();
+
+    // Reserves space and returns a pointer to write into. When the ring is full the space
+    // comes from a one-off overflow buffer instead (outAllocation.buffer is not GetBuffer()),
+    // so nothing is drawn with last frame's data. nullptr only if GL fails.
+    void* Allocate(size_t size, size_t alignment, FrameRingAllocation& outAllocation);
+
+    // Allocate + memcpy
+    FrameRingAllocation Upload(const void* data, size_t size, size_t alignment);
+
+    // Required offset alignment for each kind of binding
+    size_t GetStorageAlignment() const { return storageAlignment; }
+    size_t GetUniformAlignment() const { return uniformAlignment; }
+
+    unsigned int GetBuffer() const { return buffer; }
+    size_t GetFrameBytes() const { return allocator ? allocator->GetFrameBytes() : 0; }
+
+private:
+    // Standalone mapped buffer for what did not fit in the ring this frame
+    struct OverflowBlock
+    {
+        unsigned int buffer;
+        unsigned char* mapped;
+        size_t capacity;
+        size_t used;
+    };
+
+    bool CreateStorage(size_t capacity);
+    void DestroyStorage();
+    void* AllocateOverflow(size_t size, size_t alignment, FrameRingAllocation& outAllocation);
+    // Deleted as soon as the frame closes: GL keeps them alive until the GPU is done reading
+    void ReleaseOverflow();
+
+    unsigned int buffer = 0;
+    unsigned char* mapped = nullptr;
+    unsigned int framesInFlight = 3;
+
+    std::unique_ptr<FenceBackend> fences;
+    std::unique_ptr<FrameRingAllocator> allocator;
+
+    size_t storageAlignment = 256;
+    size_t uniformAlignment = 256;
+
+    size_t requestedCapacity = 0;
+    bool frameOpen = false;
+
+    std::vector<OverflowBlock> overflow;
+};
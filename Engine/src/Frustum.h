@@ -110,7 +110,49 @@ public:
 
         return true;
     };
-    
+
+    enum Intersection
+    {
+        OUTSIDE,
+        INTERSECT,
+        INSIDE
+    };
+
+    // Like InFrustum, but also reports when the box is fully inside every plane
+    Intersection Frustum::Classify(const AABB& aabb) const
+    {
+        Intersection result = INSIDE;
+
+        for (int i = 0; i < 6; ++i)
+        {
+            const Plane& plane = planes[i];
+
+            glm::vec3 pVertex;
+            glm::vec3 nVertex;
+
+            if (plane.normal.x > 0) { pVertex.x = aabb.max.x; nVertex.x = aabb.min.x; }
+            else                    { pVertex.x = aabb.min.x; nVertex.x = aabb.max.x; }
+
+            if (plane.normal.y > 0) { pVertex.y = aabb.max.y; nVertex.y = aabb.min.y; }
+            else                    { pVertex.y = aabb.min.y; nVertex.y = aabb.max.y; }
+
+            if (plane.normal.z > 0) { pVertex.z = aabb.max.z; nVertex.z = aabb.min.z; }
+            else                    { pVertex.z = aabb.min.z; nVertex.z = aabb.max.z; }
+
+            if (plane.DistanceToPoint(pVertex) < 0)
+            {
+                return OUTSIDE;
+            }
+
+            if (plane.DistanceToPoint(nVertex) < 0)
+            {
+                result = INTERSECT;
+            }
+        }
+
+        return result;
+    };
+
 private:
     std::array<Plane, 6> planes = {};
 };
\ No newline at end of file
@@ -36,17 +36,82 @@
 #include "ComponentPostProcessing.h"
 #include "ComponentLight.h"
 #include "LightManager.h"
+#include "ComponentScheduler.h"
+#include "SceneRegistry.h"
+#include "ObjectPool.h"
 #include <nlohmann/json.hpp>
 
 GameObject::GameObject(const std::string& name) : name(name), active(true), parent(nullptr) {
+    handle = HandleTable<GameObject>::Instance().Create(this);
     CreateComponent(ComponentType::TRANSFORM);
     objectUID = GenerateUID();
 }
 
+void* GameObject::operator new(size_t size) {
+    return ObjectPools::AllocateGameObject(size);
+}
+
+void GameObject::operator delete(void* block, size_t size) {
+    ObjectPools::FreeGameObject(block, size);
+}
+
+static ComponentScheduler& Scheduler()
+{
+    return Application::GetInstance().scene->GetComponentScheduler();
+}
+
+static SceneRegistry& Registry()
+{
+    return Application::GetInstance().scene->GetRegistry();
+}
+
+// Only scene objects that are not being deleted get their components updated
+static bool UpdatesComponents(const GameObject* obj)
+{
+    if (!obj->IsInScene()) return false;
+
+    for (const GameObject* it = obj; it != nullptr; it = it->GetParent())
+    {
+        if (it->IsMarkedForDeletion()) return false;
+    }
+    return true;
+}
+
+// Indexes / unindexes the subtree and schedules / unschedules its components when it is
+// attached to / detached from the scene
+static void SyncSceneMembership(GameObject* obj)
+{
+    GameObject* parent = obj->GetParent();
+    bool attached = parent != nullptr && parent->IsInScene();
+
+    if (attached == obj->IsInScene()) return;
+
+    if (attached) {
+        Registry().AddSubtree(obj);
+        if (UpdatesComponents(parent)) Scheduler().RegisterSubtree(obj);
+    }
+    else {
+        Registry().RemoveSubtree(obj);
+        Scheduler().UnregisterSubtree(obj);
+    }
+}
+
 GameObject::~GameObject() {
     
     MarkCleaning();
 
+    // Stale from here on, even for components that resolve handles while cleaning up
+    HandleTable<GameObject>::Instance().Destroy(handle);
+
+    // Children unregister themselves when they are deleted below
+    if (inScene) {
+        Registry().Remove(this);
+    }
+
+    for (auto* component : components) {
+        Scheduler().Unregister(component);
+    }
+
     for (auto* component : components) {
         componentOwners.clear();
         component = nullptr;
@@ -179,6 +244,7 @@ Component* GameObject::CreateComponent(ComponentType type) {
     if (newComponent) {
         componentOwners.push_back(std::unique_ptr<Component>(newComponent));
         components.push_back(newComponent);
+        if (UpdatesComponents(this)) Scheduler().Register(newComponent);
     }
     
     PublishGameObjectEvent(GameObjectEvent::COMPONENT_ADDED, newComponent);
@@ -190,6 +256,8 @@ void GameObject::RemoveComponent(Component* comp) {
     
     if (!comp) return;
 
+    Scheduler().Unregister(comp);
+
     auto it = std::find(components.begin(), components.end(), comp);
     if (it != components.end()) {
         components.erase(it);
@@ -296,6 +364,8 @@ void GameObject::AddChild(GameObject* child) {
 
         child->parent = this;
         children.push_back(child);
+        child->transform->OnParentChanged();
+        SyncSceneMembership(child);
     }
 }
 
@@ -303,6 +373,8 @@ void GameObject::RemoveChild(GameObject* child) {
     auto it = std::find(children.begin(), children.end(), child);
     if (it != children.end()) {
         (*it)->parent = nullptr;
+        (*it)->transform->OnParentChanged();
+        SyncSceneMembership(*it);
         children.erase(it);
     }
 }
@@ -316,6 +388,14 @@ void GameObject::SetParent(GameObject* newParent) {
     }
 }
 
+void GameObject::SetParentDirect(GameObject* p) {
+    parent = p;
+    if (transform) {
+        transform->OnParentChanged();
+    }
+    SyncSceneMembership(this);
+}
+
 void GameObject::InsertChildAt(GameObject* child, int index) {
     if (child && child != this) {
         if (child->parent) {
@@ -329,6 +409,8 @@ void GameObject::InsertChildAt(GameObject* child, int index) {
 
         // Insert child
         children.insert(children.begin() + index, child);
+        child->transform->OnParentChanged();
+        SyncSceneMembership(child);
     }
 }
 
@@ -353,6 +435,17 @@ GameObject* GameObject::FindChild(const std::string& nameToFind)
     return nullptr;
 }
 
+void GameObject::BuildNameIndex(std::unordered_map<std::string, GameObject*>& outIndex)
+{
+    // Pre-order like FindChild, emplace keeps the first match
+    outIndex.emplace(name, this);
+
+    for (GameObject* child : children)
+    {
+        child->BuildNameIndex(outIndex);
+    }
+}
+
 GameObject* GameObject::FindChild(const UID uidToFind)
 {
     if (this->objectUID == uidToFind) return this;
@@ -366,68 +459,6 @@ GameObject* GameObject::FindChild(const UID uidToFind)
     return nullptr;
 }
 
-void GameObject::Update() {
-    // Si este GameObject está marcado para eliminación, no actualizar
-    if (markedForDeletion) {
-        return;
-    }
-
-    //if (!active) return;
-
-    for (auto* component : components) {
-        if (component->IsActive()) {
-            component->Update();
-        }
-
-        // Si durante el Update del componente se marcó para eliminación, detener
-        if (markedForDeletion) {
-            return;
-        }
-    }
-
-    // Crear copia de children para iterar de forma segura
-    std::vector<GameObject*> childrenCopy = children;
-
-    for (auto* child : childrenCopy) {
-        // Verificar que el hijo todavía es válido y no está marcado para eliminación
-        if (child && !child->IsMarkedForDeletion()) {
-            child->Update();
-        }
-    }
-}
-
-void GameObject::FixedUpdate() {
-    // Si este GameObject está marcado para eliminación, no actualizar
-    if (markedForDeletion) {
-        return;
-    }
-
-    //if (!active) return;
-
-    for (auto* component : components) {
-        
-        if (component->IsActive()) {
-            component->FixedUpdate();
-        }
-
-        // Si durante el Update del componente se marcó para eliminación, detener
-        if (markedForDeletion) {
-            return;
-        }
-    }
-
-    // Crear copia de children para iterar de forma segura
-    std::vector<GameObject*> childrenCopy = children;
-
-    for (auto* child : childrenCopy) {
-        
-        // Verificar que el hijo todavía es válido y no está marcado para eliminación
-        if (child && !child->IsMarkedForDeletion()) {
-            child->FixedUpdate();
-        }
-    }
-}
-
 void GameObject::Serialize(nlohmann::json& gameObjectArray) const {
     // Create a JSON object
     nlohmann::json gameObjectObj;
@@ -471,7 +502,7 @@ GameObject* GameObject::Deserialize(const nlohmann::json& gameObjectObj, GameObj
     std::string objName = gameObjectObj.contains("name") ? gameObjectObj["name"].get<std::string>() : "GameObject";
     GameObject* newObject = new GameObject(objName);
     UID uid = gameObjectObj.contains("uid") ? gameObjectObj["uid"].get<UID>() : newObject->objectUID;
-    if (uid != 0)newObject->objectUID = uid;
+    if (uid != 0) newObject->SetUID(uid);
 
     if (gameObjectObj.contains("active")) {
         newObject->SetActive(gameObjectObj["active"].get<bool>());
@@ -482,7 +513,7 @@ GameObject* GameObject::Deserialize(const nlohmann::json& gameObjectObj, GameObj
     }
 
     if (gameObjectObj.contains("tag")) {
-        newObject->tag = gameObjectObj["tag"].get<std::string>();
+        newObject->SetTag(gameObjectObj["tag"].get<std::string>());
     }
 
     // Components
@@ -546,13 +577,44 @@ void GameObject::PublishGameObjectEvent(GameObjectEvent event, Component* newCom
     }
 }
 
+void GameObject::SetUID(UID uid)
+{
+    if (objectUID == uid) return;
+
+    UID oldUID = objectUID;
+    objectUID = uid;
+    if (inScene) Registry().OnUIDChanged(this, oldUID);
+}
+
+void GameObject::SetName(const std::string& newName)
+{
+    if (name == newName) return;
+
+    std::string oldName = name;
+    name = newName;
+    if (inScene) Registry().OnNameChanged(this, oldName);
+}
+
+void GameObject::SetTag(const std::string& newTag)
+{
+    if (tag == newTag) return;
+
+    std::string oldTag = tag;
+    tag = newTag;
+    if (inScene) Registry().OnTagChanged(this, oldTag);
+}
+
 void GameObject::MarkForDeletion()
 {
     markedForDeletion = true;
+    // Children too: they stay in the tree until the object is deleted in PostUpdate
+    Scheduler().UnregisterSubtree(this);
     Application::GetInstance().events.get()->PublishImmediate({ Event::Type::GameObjectDestroyed, this });
 }
 std::unique_ptr<Component> GameObject::ExtractComponent(Component* comp)
 {
+    Scheduler().Unregister(comp);
+
     auto it = std::find(components.begin(), components.end(), comp);
     if (it != components.end())
         components.erase(it);
@@ -573,6 +635,7 @@ std::unique_ptr<Component> GameObject::ExtractComponent(Component* comp)
 void GameObject::ReinsertComponentAt(std::unique_ptr<Component> comp, int index)
 {
     Component* raw = comp.get();
+    if (UpdatesComponents(this)) Scheduler().Register(raw);
 
     if (index < 0 || index >= static_cast<int>(componentOwners.size()))
     {
@@ -2,8 +2,10 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
 #include "Globals.h"
+#include "Handle.h"
 
 class Component;
 class Transform;
@@ -25,7 +27,15 @@ public:
     GameObject(const std::string& name = "GameObject");
     ~GameObject();
 
+    // Storage comes from ObjectPools instead of the global heap
+    static void* operator new(size_t size);
+    static void operator delete(void* block, size_t size);
+
+    // Weak reference that resolves to nullptr once this object is deleted
+    GameObjectHandle GetHandle() const { return handle; }
+
     const UID GetUID() { return objectUID; };
+    void SetUID(UID uid);
 
     Component* CreateComponent(ComponentType type);
     void RemoveComponent(Component* comp);
@@ -48,11 +58,8 @@ public:
     void InsertChildAt(GameObject* child, int index);
     int GetChildIndex(GameObject* child) const;
 
-    void Update();
-    void FixedUpdate();
-
     const std::string& GetName() const { return name; }
-    void SetName(const std::string& newName) { name = newName; }
+    void SetName(const std::string& newName);
     bool IsActive() const { return active; }
     void SetActive(bool state) { active = state; }
     GameObject* GetParent() const { return parent; }
@@ -60,6 +67,9 @@ public:
     const std::vector<Component*>& GetComponents() const { return components; }
     GameObject* FindChild(const std::string& findName);
     GameObject* FindChild(const UID uid);
+    // Name -> first match of FindChild(name) for every name in this subtree, in one walk.
+    // For binding many bones at once.
+    void BuildNameIndex(std::unordered_map<std::string, GameObject*>& outIndex);
 
     void SetSelected(bool b) { isSelected = b; };
     bool IsSelected() { return isSelected; };
@@ -77,7 +87,7 @@ public:
     //INTERNAL EVENTS
     void PublishGameObjectEvent(GameObjectEvent event, Component* component = nullptr);
 
-    void SetParentDirect(GameObject* p) { parent = p; }
+    void SetParentDirect(GameObject* p);
 
 public:
     UID objectUID;
@@ -89,20 +99,26 @@ public:
     std::string tag = "";
 
     const std::string& GetTag() const { return tag; }
-    void SetTag(const std::string& newTag) { tag = newTag; }
+    void SetTag(const std::string& newTag);
     bool CompareTag(const std::string& t) const { return tag == t; }
     void SetPersistency(bool persistent) {
         isPersistent = persistent;
     }
     bool IsPersistent() { return isPersistent; }
 
+    // Attached to the scene root and indexed by SceneRegistry
+    bool IsInScene() const { return inScene; }
+    void SetInScene(bool value) { inScene = value; }
+
 private:
+    GameObjectHandle handle;
     GameObject* parent = nullptr;
     std::vector<GameObject*> children;
     std::vector<std::unique_ptr<Component>> componentOwners;
     std::vector<Component*> components;
 
     bool markedForDeletion = false;
+    bool inScene = false;
     bool isCleaning = false;
     bool isSelected = false;
     bool isPersistent = false;
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+template<typename T> class HandleTable;
+
+// Weak reference to a GameObject / Component: slot index + generation. Destroying the
+// object bumps the slot's generation, so a stored handle simply resolves to nullptr
+// afterwards. No destroy events have to be listened to in order to null pointers.
+template<typename T>
+struct Handle
+{
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+    uint32_t index = INVALID_INDEX;
+    uint32_t generation = 0;
+
+    // nullptr if the object was destroyed (or the handle was never set)
+    T* Get() const { return HandleTable<T>::Instance().Resolve(*this); }
+    bool IsValid() const { return Get() != nullptr; }
+    void Reset() { index = INVALID_INDEX; generation = 0; }
+
+    bool operator==(const Handle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Handle& other) const { return !(*this == other); }
+};
+
+template<typename T>
+class HandleTable
+{
+public:
+    // Never destroyed: objects can still be released during static destruction
+    static HandleTable& Instance()
+    {
+        static HandleTable* instance = new HandleTable();
+        return *instance;
+    }
+
+    Handle<T> Create(T* object)
+    {
+        uint32_t index;
+        if (!freeSlots.empty())
+        {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            index = (uint32_t)slots.size();
+            slots.push_back({ nullptr, 1 });
+        }
+
+        slots[index].object = object;
+
+        Handle<T> handle;
+        handle.index = index;
+        handle.generation = slots[index].generation;
+        return handle;
+    }
+
+    void Destroy(const Handle<T>& handle)
+    {
+        if (Resolve(handle) == nullptr) return;
+
+        Slot& slot = slots[handle.index];
+        slot.object = nullptr;
+        ++slot.generation;
+        freeSlots.push_back(handle.index);
+    }
+
+    T* Resolve(const Handle<T>& handle) const
+    {
+        if (handle.index >= slots.size()) return nullptr;
+
+        const Slot& slot = slots[handle.index];
+        return slot.generation == handle.generation ? slot.object : nullptr;
+    }
+
+    size_t GetLiveCount() const { return slots.size() - freeSlots.size(); }
+
+private:
+    struct Slot
+    {
+        T* object;
+        uint32_t generation;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+};
+
+class GameObject;
+class Component;
+typedef Handle<GameObject> GameObjectHandle;
+typedef Handle<Component> ComponentHandle;
@@ -52,6 +52,7 @@
 #include <filesystem>
 #include <nlohmann/json.hpp>
 #include <algorithm>
+#include <sstream>
 
 static nlohmann::json copiedComponentData;
 static ComponentType copiedComponentType = static_cast<ComponentType>(-1);
@@ -733,12 +734,15 @@ void InspectorWindow::DrawMeshComponent(Component* component)
             ImGui::Separator();
             ImGui::Spacing();
 
-            const Mesh& mesh = meshComp->GetMesh();
-
             ImGui::Text("Mesh Statistics:");
-            ImGui::Text("Vertices: %d", (int)mesh.vertices.size());
-            ImGui::Text("Indices: %d", (int)mesh.indices.size());
-            ImGui::Text("Triangles: %d", (int)mesh.indices.size() / 3);
+            ImGui::Text("Vertices: %d", (int)meshComp->GetNumVertices());
+            ImGui::Text("Indices: %d", (int)meshComp->GetNumIndices());
+            ImGui::Text("Triangles: %d", (int)meshComp->GetNumIndices() / 3);
+
+            size_t cpuBytes = 0;
+            size_t gpuBytes = 0;
+            meshComp->GetMemoryUsage(cpuBytes, gpuBytes);
+            ImGui::Text("Memory: CPU %.1f KB / GPU %.1f KB", cpuBytes / 1024.0f, gpuBytes / 1024.0f);
 
             ImGui::Spacing();
             ImGui::Separator();
@@ -871,9 +875,14 @@ void InspectorWindow::DrawSkinnedMeshComponent(Component* component)
             const Mesh& mesh = meshComp->GetMesh();
 
             ImGui::Text("Mesh Statistics:");
-            ImGui::Text("Vertices: %d", (int)mesh.vertices.size());
-            ImGui::Text("Indices: %d", (int)mesh.indices.size());
-            ImGui::Text("Triangles: %d", (int)mesh.indices.size() / 3);
+            ImGui::Text("Vertices: %d", (int)meshComp->GetNumVertices());
+            ImGui::Text("Indices: %d", (int)meshComp->GetNumIndices());
+            ImGui::Text("Triangles: %d", (int)meshComp->GetNumIndices() / 3);
+
+            size_t cpuBytes = 0;
+            size_t gpuBytes = 0;
+            meshComp->GetMemoryUsage(cpuBytes, gpuBytes);
+            ImGui::Text("Memory: CPU %.1f KB / GPU %.1f KB", cpuBytes / 1024.0f, gpuBytes / 1024.0f);
             ImGui::Text("Linked bones: %d / %d", meshComp->GetLinkedBonesNum(), (int)mesh.bones.size());
 
             if (ImGui::Button("Link Bones"))
@@ -1272,6 +1281,22 @@ void InspectorWindow::DrawAnimationComponent(Component* component)
     DrawComponentContextMenu(animation, true);
     if (!open) return;
 
+    bool syncBones = animation->GetSyncBones();
+    if (ImGui::Checkbox("Sync Bone Objects", &syncBones))
+    {
+        animation->SetSyncBones(syncBones);
+    }
+    if (ImGui::IsItemHovered())
+    {
+        ImGui::SetTooltip("Write the pose to every bone GameObject in play mode\nOnly needed by scripts reading bone transforms");
+    }
+
+    if (animation->IsPlaying())
+    {
+        const char* lodNames[] = { "Full", "Reduced", "Low", "Culled" };
+        ImGui::Text("LOD: %s", lodNames[(int)animation->GetLodLevel()]);
+    }
+
     ImGui::Separator();
     ImGui::Text("Library:");
 
@@ -1374,6 +1399,202 @@ void InspectorWindow::DrawAnimationComponent(Component* component)
         }
         ImGui::EndDragDropTarget();
     }
+
+    DrawAnimationBlendSpaces(animation);
+    DrawAnimationLayers(animation);
+}
+
+void InspectorWindow::DrawAnimationBlendSpaces(ComponentAnimation* animation)
+{
+    ImGui::Separator();
+    ImGui::Text("Blend Spaces:");
+
+    std::string spaceToRemove;
+    for (auto& [spaceName, space] : animation->blendSpaces)
+    {
+        ImGui::PushID(("BlendSpace" + spaceName).c_str());
+
+        ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_Framed | ImGuiTreeNodeFlags_AllowItemOverlap | ImGuiTreeNodeFlags_SpanAvailWidth;
+        bool isNodeOpen = ImGui::TreeNodeEx(spaceName.c_str(), flags);
+
+        ImGui::SameLine();
+        ImGui::SetCursorPosX(ImGui::GetCursorPosX() + ImGui::GetContentRegionAvail().x - 20.0f);
+        if (ImGui::SmallButton("X"))
+        {
+            spaceToRemove = spaceName;
+        }
+
+        if (isNodeOpen)
+        {
+            char parameterBuffer[64];
+            strncpy(parameterBuffer, space.parameter.c_str(), sizeof(parameterBuffer) - 1);
+            parameterBuffer[sizeof(parameterBuffer) - 1] = '\0';
+            if (ImGui::InputText("Parameter", parameterBuffer, sizeof(parameterBuffer)))
+            {
+                space.parameter = parameterBuffer;
+            }
+
+            ImGui::DragFloat("Speed", &space.speed, 0.05f, 0.0f, 10.0f);
+            ImGui::Checkbox("Loop", &space.loop);
+
+            int pointToRemove = -1;
+            for (size_t p = 0; p < space.points.size(); ++p)
+            {
+                BlendSpacePoint& point = space.points[p];
+                ImGui::PushID((int)p);
+
+                ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x * 0.5f);
+                if (ImGui::BeginCombo("##Clip", point.clip.c_str()))
+                {
+                    for (const auto& [clipName, data] : animation->animationsLibrary)
+                    {
+                        if (ImGui::Selectable(clipName.c_str(), clipName == point.clip)) point.clip = clipName;
+                    }
+                    ImGui::EndCombo();
+                }
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x - 30.0f);
+                ImGui::DragFloat("##Position", &point.position, 0.05f);
+                ImGui::SameLine();
+                if (ImGui::SmallButton("X")) pointToRemove = (int)p;
+
+                ImGui::PopID();
+            }
+            if (pointToRemove >= 0) space.points.erase(space.points.begin() + pointToRemove);
+
+            if (ImGui::Button("Add Point") && !animation->animationsLibrary.empty())
+            {
+                BlendSpacePoint point;
+                point.clip = animation->animationsLibrary.begin()->first;
+                point.position = space.points.empty() ? 0.0f : space.points.back().position + 1.0f;
+                space.points.push_back(point);
+            }
+
+            if (!space.parameter.empty())
+            {
+                float value = animation->GetParameter(space.parameter);
+                if (ImGui::DragFloat("Preview Value", &value, 0.05f))
+                {
+                    animation->SetParameter(space.parameter, value);
+                }
+            }
+
+            if (ImGui::Button("Play", ImVec2(-1, 0)))
+            {
+                animation->Play(spaceName, 0.5f);
+            }
+
+            ImGui::TreePop();
+        }
+
+        ImGui::PopID();
+    }
+
+    if (!spaceToRemove.empty())
+    {
+        animation->Stop();
+        animation->blendSpaces.erase(spaceToRemove);
+    }
+
+    static char spaceNameBuffer[64] = "New Blend Space";
+    ImGui::InputText("##BlendSpaceName", spaceNameBuffer, 64);
+    ImGui::SameLine();
+    if (ImGui::Button("Add Blend Space") && spaceNameBuffer[0] != '\0')
+    {
+        animation->blendSpaces.emplace(spaceNameBuffer, BlendSpace());
+    }
+}
+
+void InspectorWindow::DrawAnimationLayers(ComponentAnimation* animation)
+{
+    ImGui::Separator();
+    ImGui::Text("Layers:");
+
+    const std::vector<AnimationLayer>& layers = animation->GetLayers();
+    std::string layerToRemove;
+
+    // The base layer has nothing to edit
+    for (size_t l = 1; l < layers.size(); ++l)
+    {
+        const AnimationLayer& layer = layers[l];
+        ImGui::PushID(("Layer" + layer.name).c_str());
+
+        ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_Framed | ImGuiTreeNodeFlags_AllowItemOverlap | ImGuiTreeNodeFlags_SpanAvailWidth;
+        bool isNodeOpen = ImGui::TreeNodeEx(layer.name.c_str(), flags);
+
+        ImGui::SameLine();
+        ImGui::SetCursorPosX(ImGui::GetCursorPosX() + ImGui::GetContentRegionAvail().x - 20.0f);
+        if (ImGui::SmallButton("X"))
+        {
+            layerToRemove = layer.name;
+        }
+
+        if (isNodeOpen)
+        {
+            bool additive = layer.mode == AnimationLayerMode::ADDITIVE;
+            if (ImGui::Checkbox("Additive", &additive))
+            {
+                animation->SetLayerMode(layer.name, additive ? AnimationLayerMode::ADDITIVE : AnimationLayerMode::OVERRIDE);
+            }
+
+            float weight = layer.weight;
+            if (ImGui::SliderFloat("Weight", &weight, 0.0f, 1.0f))
+            {
+                animation->SetLayerWeight(layer.name, weight);
+            }
+
+            // Comma separated bone names, each with everything under it
+            std::string mask;
+            for (const std::string& bone : layer.maskBones)
+            {
+                if (!mask.empty()) mask += ", ";
+                mask += bone;
+            }
+
+            char maskBuffer[256];
+            strncpy(maskBuffer, mask.c_str(), sizeof(maskBuffer) - 1);
+            maskBuffer[sizeof(maskBuffer) - 1] = '\0';
+            if (ImGui::InputText("Mask Bones", maskBuffer, sizeof(maskBuffer), ImGuiInputTextFlags_EnterReturnsTrue))
+            {
+                std::vector<std::string> bones;
+                std::stringstream stream(maskBuffer);
+                std::string bone;
+                while (std::getline(stream, bone, ','))
+                {
+                    size_t first = bone.find_first_not_of(' ');
+                    size_t last = bone.find_last_not_of(' ');
+                    if (first != std::string::npos) bones.push_back(bone.substr(first, last - first + 1));
+                }
+                animation->SetLayerMask(layer.name, bones);
+            }
+            if (ImGui::IsItemHovered())
+            {
+                ImGui::SetTooltip("Bones driven by the layer, empty for all of them");
+            }
+
+            if (!layer.motions.empty())
+            {
+                ImGui::Text("Playing: %s", layer.motions.back().name.c_str());
+            }
+
+            ImGui::TreePop();
+        }
+
+        ImGui::PopID();
+    }
+
+    if (!layerToRemove.empty())
+    {
+        animation->RemoveLayer(layerToRemove);
+    }
+
+    static char layerNameBuffer[64] = "New Layer";
+    ImGui::InputText("##LayerName", layerNameBuffer, 64);
+    ImGui::SameLine();
+    if (ImGui::Button("Add Layer") && layerNameBuffer[0] != '\0')
+    {
+        animation->AddLayer(layerNameBuffer, AnimationLayerMode::OVERRIDE, 1.0f, {});
+    }
 }
 
 bool InspectorWindow::DrawGameObjectSection(GameObject* selectedObject)
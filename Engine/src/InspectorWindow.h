@@ -10,6 +10,7 @@
 #include <nlohmann/json.hpp>
 
 class GameObject;
+class ComponentAnimation;
 
 class InspectorWindow : public EditorWindow, public EventListener
 {
@@ -62,6 +63,8 @@ private:
     void DrawAudioListenerComponent(Component* component);
     void DrawReverbZoneComponent(Component* component);
     void DrawAnimationComponent(Component* component);
+    void DrawAnimationBlendSpaces(ComponentAnimation* animation);
+    void DrawAnimationLayers(ComponentAnimation* animation);
     void DrawNavigationComponent(Component* component);
     void DrawLightComponent(Component* component);
 
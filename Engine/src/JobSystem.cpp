@@ -0,0 +1,213 @@
+#include "JobSystem.h"
+#include "Log.h"
+
+#include <tracy/Tracy.hpp>
+#include <algorithm>
+#include <cstring>
+
+// Deque owned by the current thread, 0 for threads outside the pool
+static thread_local unsigned int threadQueueIndex = 0;
+
+JobSystem::JobSystem() : Module()
+{
+    name = "JobSystem";
+}
+
+JobSystem::~JobSystem()
+{
+    StopWorkers();
+}
+
+bool JobSystem::Awake()
+{
+    // The main thread also runs jobs while it waits, leave one core for it
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    unsigned int count = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+
+    StartWorkers(count);
+    LOG_DEBUG("Job system started with %u workers", count);
+
+    return true;
+}
+
+bool JobSystem::CleanUp()
+{
+    LOG_DEBUG("Cleaning up Job System");
+    StopWorkers();
+    return true;
+}
+
+void JobSystem::SetWorkerCount(unsigned int count)
+{
+    StopWorkers();
+    StartWorkers(count);
+}
+
+void JobSystem::StartWorkers(unsigned int count)
+{
+    quitting = false;
+
+    queues.clear();
+    for (unsigned int i = 0; i < count + 1; ++i)
+        queues.push_back(std::make_unique<WorkQueue>());
+
+    workers.reserve(count);
+    for (unsigned int i = 0; i < count; ++i)
+        workers.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+}
+
+void JobSystem::StopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        quitting = true;
+    }
+    wakeCondition.notify_all();
+
+    for (std::thread& worker : workers)
+    {
+        if (worker.joinable()) worker.join();
+    }
+    workers.clear();
+
+    // Whatever is left runs here, so no counter is left waiting
+    if (!queues.empty())
+    {
+        while (TryRunJob(0)) {}
+    }
+}
+
+unsigned int JobSystem::GetQueueIndex() const
+{
+    return threadQueueIndex < queues.size() ? threadQueueIndex : 0;
+}
+
+void JobSystem::Run(std::function<void()> function, JobCounter* counter, const char* name)
+{
+    if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+
+    Job job;
+    job.function = std::move(function);
+    job.counter = counter;
+    job.name = name;
+
+    if (queues.empty())
+    {
+        // Pool not started (or already stopped): run inline
+        Execute(job);
+        return;
+    }
+
+    WorkQueue& queue = *queues[GetQueueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+
+    queuedJobs.fetch_add(1, std::memory_order_release);
+
+    // Taking the lock orders this with a worker that is about to sleep
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeCondition.notify_one();
+}
+
+bool JobSystem::PopJob(unsigned int queueIndex, Job& outJob)
+{
+    {
+        WorkQueue& own = *queues[queueIndex];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty())
+        {
+            outJob = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            return true;
+        }
+    }
+
+    const unsigned int queueCount = (unsigned int)queues.size();
+    for (unsigned int offset = 1; offset < queueCount; ++offset)
+    {
+        WorkQueue& victim = *queues[(queueIndex + offset) % queueCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty())
+        {
+            outJob = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool JobSystem::TryRunJob(unsigned int queueIndex)
+{
+    Job job;
+    if (!PopJob(queueIndex, job)) return false;
+
+    queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    Execute(job);
+    return true;
+}
+
+void JobSystem::Execute(Job& job)
+{
+    {
+        ZoneScopedN("Job");
+        if (job.name) ZoneText(job.name, strlen(job.name));
+
+        job.function();
+    }
+
+    if (job.counter) job.counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void JobSystem::WorkerLoop(unsigned int queueIndex)
+{
+    threadQueueIndex = queueIndex;
+
+    while (true)
+    {
+        if (TryRunJob(queueIndex)) continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeCondition.wait(lock, [&] { return quitting || queuedJobs.load(std::memory_order_acquire) > 0; });
+        if (quitting) return;
+    }
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+    const unsigned int queueIndex = GetQueueIndex();
+
+    while (!counter.IsDone())
+    {
+        // Help instead of blocking: the job we wait for may be sitting in our own deque
+        if (queues.empty() || !TryRunJob(queueIndex))
+            std::this_thread::yield();
+    }
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t grain, const std::function<void(uint32_t begin, uint32_t end)>& body)
+{
+    if (count == 0) return;
+    if (grain == 0) grain = 1;
+
+    // Not worth queueing anything
+    if (workers.empty() || count <= grain)
+    {
+        body(0, count);
+        return;
+    }
+
+    JobCounter counter;
+    for (uint32_t begin = 0; begin < count; begin += grain)
+    {
+        uint32_t end = std::min(begin + grain, count);
+        Run([&body, begin, end]() { body(begin, end); }, &counter, "ParallelFor");
+    }
+
+    Wait(counter);
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "Module.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Number of jobs still running. A job started with a counter keeps it above zero until
+// it returns, so children it starts on the same counter are waited on together with it.
+struct JobCounter
+{
+    std::atomic<int32_t> pending{ 0 };
+
+    bool IsDone() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+struct Job
+{
+    std::function<void()> function;
+    JobCounter* counter = nullptr;
+    const char* name = "Job";
+};
+
+// Work-stealing scheduler shared by every module (and PhysX, see PhysicsJobDispatcher).
+// Each thread owns a deque: it pushes and pops its own jobs at the back, idle threads
+// steal from the front of the others. The main thread owns deque 0 and runs jobs
+// while it waits, so nothing blocks on a sleeping worker.
+class JobSystem : public Module
+{
+public:
+    JobSystem();
+    ~JobSystem();
+
+    bool Awake() override;
+    bool CleanUp() override;
+
+    // Queues a job on the calling thread's deque. counter (optional) is incremented now
+    // and decremented when the job returns.
+    void Run(std::function<void()> function, JobCounter* counter = nullptr, const char* name = "Job");
+
+    // Runs queued jobs until counter reaches zero
+    void Wait(JobCounter& counter);
+
+    // Splits [0, count) in ranges of grain items and waits for all of them
+    void ParallelFor(uint32_t count, uint32_t grain, const std::function<void(uint32_t begin, uint32_t end)>& body);
+
+    // Restarts the pool with count workers (0 runs everything on the waiting thread)
+    void SetWorkerCount(unsigned int count);
+    unsigned int GetWorkerCount() const { return (unsigned int)workers.size(); }
+
+private:
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void StartWorkers(unsigned int count);
+    void StopWorkers();
+    void WorkerLoop(unsigned int queueIndex);
+
+    // Own deque first (newest job), then steal the oldest job of another deque
+    bool PopJob(unsigned int queueIndex, Job& outJob);
+    bool TryRunJob(unsigned int queueIndex);
+    void Execute(Job& job);
+
+    unsigned int GetQueueIndex() const;
+
+    std::vector<std::thread> workers;
+    // queues[0] is the main thread (and any thread outside the pool)
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+
+    std::atomic<int32_t> queuedJobs{ 0 };
+    std::mutex sleepMutex;
+    std::condition_variable wakeCondition;
+    bool quitting = false;
+};
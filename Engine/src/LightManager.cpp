@@ -1,43 +1,21 @@
 #include "LightManager.h"
 #include "ComponentLight.h"
 #include "Shader.h"
+#include "FrameRingBuffer.h"
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <string>
 
 LightManager::LightManager()
 {
-    InitSSBOs();
 }
 
 LightManager::~LightManager()
 {
-    if (ssboDir)   glDeleteBuffers(1, &ssboDir);
-    if (ssboPoint) glDeleteBuffers(1, &ssboPoint);
-    if (ssboSpot)  glDeleteBuffers(1, &ssboSpot);
-}
-
-void LightManager::InitSSBOs()
-{
-    glGenBuffers(1, &ssboDir);
-    glGenBuffers(1, &ssboPoint);
-    glGenBuffers(1, &ssboSpot);
-
-    // Allocate empty buffers so the binding points exist from the start
-    auto emptyAlloc = [](unsigned int ssbo, int binding) {
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
-        glBufferData(GL_SHADER_STORAGE_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, ssbo);
-        };
-
-    emptyAlloc(ssboDir, 2);
-    emptyAlloc(ssboPoint, 3);
-    emptyAlloc(ssboSpot, 4);
-
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
 void LightManager::RegisterLight(ComponentLight* light)
@@ -54,26 +32,17 @@ void LightManager::UnregisterLight(ComponentLight* light)
         lights.erase(it);
 }
 
-void LightManager::UploadBuffer(unsigned int ssbo, const void* data, size_t bytes)
-{
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
-    glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr)bytes, data, GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-}
-
-void LightManager::UploadToShader(Shader* shader)
+void LightManager::Upload(FrameRingBuffer& ring)
 {
-    if (!shader) return;
-
     for (ComponentLight* l : lights)
     {
         if (l && l->IsActive())
             l->UpdateTransformData();
     }
 
-    std::vector<GPUDirLight>   dirPacked;
-    std::vector<GPUPointLight> pointPacked;
-    std::vector<GPUSpotLight>  spotPacked;
+    dirPacked.clear();
+    pointPacked.clear();
+    spotPacked.clear();
 
     for (const ComponentLight* l : lights)
     {
@@ -126,20 +95,30 @@ void LightManager::UploadToShader(Shader* shader)
         }
     }
 
-    // Upload SSBOs and rebind to correct binding points
-    auto upload = [](unsigned int ssbo, int binding, const void* data, size_t bytes) {
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
-        glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr)bytes, bytes > 0 ? data : nullptr, GL_DYNAMIC_DRAW);
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, ssbo);
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    // Empty lists still get one zeroed element so every binding points at valid storage
+    auto upload = [&ring](int binding, const void* data, size_t bytes, size_t elementSize) {
+        FrameRingAllocation allocation;
+        void* dst = ring.Allocate(bytes > 0 ? bytes : elementSize, ring.GetStorageAlignment(), allocation);
+        if (!dst) return;
+
+        if (bytes > 0) memcpy(dst, data, bytes);
+        else memset(dst, 0, elementSize);
+
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, allocation.buffer, allocation.offset, allocation.size);
         };
 
-    upload(ssboDir, 2, dirPacked.data(), dirPacked.size() * sizeof(GPUDirLight));
-    upload(ssboPoint, 3, pointPacked.data(), pointPacked.size() * sizeof(GPUPointLight));
-    upload(ssboSpot, 4, spotPacked.data(), spotPacked.size() * sizeof(GPUSpotLight));
+    upload(2, dirPacked.data(), dirPacked.size() * sizeof(GPUDirLight), sizeof(GPUDirLight));
+    upload(3, pointPacked.data(), pointPacked.size() * sizeof(GPUPointLight), sizeof(GPUPointLight));
+    upload(4, spotPacked.data(), spotPacked.size() * sizeof(GPUSpotLight), sizeof(GPUSpotLight));
+}
+
+void LightManager::ApplyToShader(Shader* shader) const
+{
+    if (!shader) return;
 
     //Tell the shader how many lights of each type are active
-    shader->SetInt("numDirLights", (int)dirPacked.size());
-    shader->SetInt("numPointLights", (int)pointPacked.size());
-    shader->SetInt("numSpotLights", (int)spotPacked.size());
+    const SceneUniforms& uniforms = shader->GetSceneUniforms();
+    shader->Set(uniforms.numDirLights, (int)dirPacked.size());
+    shader->Set(uniforms.numPointLights, (int)pointPacked.size());
+    shader->Set(uniforms.numSpotLights, (int)spotPacked.size());
 }
\ No newline at end of file
@@ -4,8 +4,9 @@
 
 class Shader;
 class ComponentLight;
+class FrameRingBuffer;
 
-// Collects all active ComponentLights and uploads them to the GPU via SSBOs.
+// Collects all active ComponentLights and uploads them to the GPU as SSBO ranges of the frame ring.
 // The Renderer owns one instance. ComponentLight registers/unregisters itself.
 
 //   binding 2 -> directional lights
@@ -21,19 +22,22 @@ public:
     void RegisterLight(ComponentLight* light);
     void UnregisterLight(ComponentLight* light);
 
-    // Pack active lights into GPU structs and upload via SSBOs.
-    // Call once per frame before drawing lit meshes, then bind the shader.
-    // Also sets numDirLights / numPointLights / numSpotLights uniforms.
-    void UploadToShader(Shader* shader);
+    // Pack active lights into GPU structs and bind them from the frame ring.
+    // Call once per camera before drawing lit meshes.
+    void Upload(FrameRingBuffer& ring);
 
-private:
-    void InitSSBOs();
-    void UploadBuffer(unsigned int ssbo, const void* data, size_t bytes);
+    // Sets numDirLights / numPointLights / numSpotLights on the bound shader.
+    // Needed each time a lit program is bound, the SSBOs are shared.
+    void ApplyToShader(Shader* shader) const;
+
+    // Buffers written by each Upload (for renderer statistics)
+    static const unsigned int BUFFERS_PER_UPLOAD = 3;
 
+private:
     std::vector<ComponentLight*> lights;
 
-    // One SSBO per light type
-    unsigned int ssboDir = 0;
-    unsigned int ssboPoint = 0;
-    unsigned int ssboSpot = 0;
+    // Packing scratch, kept to avoid reallocating every upload
+    std::vector<GPUDirLight>   dirPacked;
+    std::vector<GPUPointLight> pointPacked;
+    std::vector<GPUSpotLight>  spotPacked;
 };
\ No newline at end of file
@@ -3,9 +3,15 @@
 #include <cstdarg>
 #include <cstdio>
 #include <string>
+#include <mutex>
+
+// The resource I/O threads log too
+static std::mutex logMutex;
 
 void LogDebug(const char file[], int line, const char* format, ...)
 {
+    std::lock_guard<std::mutex> lock(logMutex);
+
     static char tmpString1[4096];
     static va_list ap;
 
@@ -24,6 +30,8 @@ void LogDebug(const char file[], int line, const char* format, ...)
 
 void LogConsole(const char file[], int line, const char* format, ...)
 {
+    std::lock_guard<std::mutex> lock(logMutex);
+
     static char tmpString[4096];
     static va_list ap;
 
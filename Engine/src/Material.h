@@ -20,6 +20,9 @@ public:
 
     virtual void Bind(Shader* shader) = 0;
 
+    // Textures bound by the last Bind (missing maps excluded), used for the renderer statistics
+    virtual unsigned int GetBoundTextureCount() const { return 0; }
+
     MaterialType GetType() const { return type; }
     const std::string& GetName() const { return name; }
     const float GetOpacity() const { return opacity; }
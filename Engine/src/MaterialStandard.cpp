@@ -18,11 +18,11 @@ MaterialStandard::~MaterialStandard()
 {
     auto* resModule = Application::GetInstance().resources.get();
 
-    if (albedoMapUID != 0) resModule->ReleaseResource(albedoMapUID);
-    if (normalMapUID != 0) resModule->ReleaseResource(normalMapUID);
-    if (heightMapUID != 0) resModule->ReleaseResource(heightMapUID);
-    if (metallicMapUID != 0) resModule->ReleaseResource(metallicMapUID);
-    if (occlusionMapUID != 0) resModule->ReleaseResource(occlusionMapUID);
+    resModule->ReleaseRequest(albedoMapRequest);
+    resModule->ReleaseRequest(normalMapRequest);
+    resModule->ReleaseRequest(heightMapRequest);
+    resModule->ReleaseRequest(metallicMapRequest);
+    resModule->ReleaseRequest(occlusionMapRequest);
 
     albedoMapUID = 0;
     normalMapUID = 0;
@@ -35,77 +35,87 @@ void MaterialStandard::Bind(Shader* shader)
 {
     if (!shader) return;
 
-    auto* resModule = Application::GetInstance().resources.get();
-    if (albedoMap == nullptr && albedoMapUID != 0) albedoMap = (ResourceTexture*)resModule->RequestResource(albedoMapUID);
-    if (normalMap == nullptr && normalMapUID != 0) normalMap = (ResourceTexture*)resModule->RequestResource(normalMapUID);
-    if (metallicMap == nullptr && metallicMapUID != 0) metallicMap = (ResourceTexture*)resModule->RequestResource(metallicMapUID);
-    if (occlusionMap == nullptr && occlusionMapUID != 0) occlusionMap = (ResourceTexture*)resModule->RequestResource(occlusionMapUID);
-    if (heightMap == nullptr && heightMapUID != 0) heightMap = (ResourceTexture*)resModule->RequestResource(heightMapUID);
-
-    shader->SetVec4("uColor", color);
-    shader->SetFloat("uMetallic", metallic);
-    shader->SetFloat("uRoughness", roughness);
-    shader->SetFloat("uHeightScale", heightScale);
-    shader->SetVec2("uTiling", tiling);
-    shader->SetVec2("uOffset", offset);
+    ResolveTextureMap(albedoMapUID, albedoMap, albedoMapRequest);
+    ResolveTextureMap(metallicMapUID, metallicMap, metallicMapRequest);
+    ResolveTextureMap(normalMapUID, normalMap, normalMapRequest);
+    ResolveTextureMap(occlusionMapUID, occlusionMap, occlusionMapRequest);
+    ResolveTextureMap(heightMapUID, heightMap, heightMapRequest);
+
+    // Resolved when the shader links, no name lookups per bind
+    const MaterialUniforms& uniforms = shader->GetMaterialUniforms();
+
+    shader->Set(uniforms.color, color);
+    shader->Set(uniforms.metallic, metallic);
+    shader->Set(uniforms.roughness, roughness);
+    shader->Set(uniforms.heightScale, heightScale);
+    shader->Set(uniforms.tiling, tiling);
+    shader->Set(uniforms.offset, offset);
+
+    // Only real textures count, missing maps bind 0
+    boundTextureCount = 0;
 
     // Albedo
     glActiveTexture(GL_TEXTURE0);
     if (albedoMap && albedoMap->IsLoadedToMemory()) {
         glBindTexture(GL_TEXTURE_2D, albedoMap->GetGPU_ID());
+        boundTextureCount++;
     }
     else {
         glBindTexture(GL_TEXTURE_2D, 0);
     }
-    shader->SetInt("uAlbedoMap", 0);
+    shader->Set(uniforms.albedoMap, 0);
 
     // Metallic
     glActiveTexture(GL_TEXTURE1);
     if (metallicMap && metallicMap->IsLoadedToMemory()) {
         glBindTexture(GL_TEXTURE_2D, metallicMap->GetGPU_ID());
-        shader->SetBool("uUseMetallicMap", true);
+        boundTextureCount++;
+        shader->Set(uniforms.useMetallicMap, true);
     }
     else {
         glBindTexture(GL_TEXTURE_2D, 0);
-        shader->SetBool("uUseMetallicMap", false);
+        shader->Set(uniforms.useMetallicMap, false);
     }
-    shader->SetInt("uMetallicMap", 1);
+    shader->Set(uniforms.metallicMap, 1);
 
     // Normal
     glActiveTexture(GL_TEXTURE2);
     if (normalMap && normalMap->IsLoadedToMemory()) {
         glBindTexture(GL_TEXTURE_2D, normalMap->GetGPU_ID());
-        shader->SetBool("uUseNormalMap", true);
+        boundTextureCount++;
+        shader->Set(uniforms.useNormalMap, true);
     }
     else {
         glBindTexture(GL_TEXTURE_2D, 0);
-        shader->SetBool("uUseNormalMap", false);
+        shader->Set(uniforms.useNormalMap, false);
     }
-    shader->SetInt("uNormalMap", 2);
+    shader->Set(uniforms.normalMap, 2);
 
     // Occlusion
     glActiveTexture(GL_TEXTURE3);
     if (occlusionMap && occlusionMap->IsLoadedToMemory()) {
         glBindTexture(GL_TEXTURE_2D, occlusionMap->GetGPU_ID());
-        shader->SetBool("uUseOcclusionMap", true);
+        boundTextureCount++;
+        shader->Set(uniforms.useOcclusionMap, true);
     }
     else {
         glBindTexture(GL_TEXTURE_2D, 0);
-        shader->SetBool("uUseOcclusionMap", false);
+        shader->Set(uniforms.useOcclusionMap, false);
     }
-    shader->SetInt("uOcclusionMap", 3);
+    shader->Set(uniforms.occlusionMap, 3);
 
     // Height
     glActiveTexture(GL_TEXTURE4);
     if (heightMap && heightMap->IsLoadedToMemory()) {
         glBindTexture(GL_TEXTURE_2D, heightMap->GetGPU_ID());
-        shader->SetBool("uUseHeightMap", true);
+        boundTextureCount++;
+        shader->Set(uniforms.useHeightMap, true);
     }
     else {
         glBindTexture(GL_TEXTURE_2D, 0);
-        shader->SetBool("uUseHeightMap", false);
+        shader->Set(uniforms.useHeightMap, false);
     }
-    shader->SetInt("uHeightMap", 4);
+    shader->Set(uniforms.heightMap, 4);
 
     glActiveTexture(GL_TEXTURE0);
 }
@@ -199,41 +209,56 @@ void MaterialStandard::LoadFromJson(const nlohmann::json& j) {
 }
 
 void MaterialStandard::SetAlbedoMap(UID uid) {
-    if (albedoMapUID != 0) {
-        Application::GetInstance().resources->ReleaseResource(albedoMapUID);
-    }
-    albedoMapUID = uid;
-    albedoMap = (albedoMapUID != 0) ? (ResourceTexture*)Application::GetInstance().resources->RequestResource(albedoMapUID) : nullptr;
+    SetTextureMap(uid, albedoMapUID, albedoMap, albedoMapRequest);
 }
 
 void MaterialStandard::SetHeightMap(UID uid) {
-    if (heightMapUID != 0) {
-        Application::GetInstance().resources->ReleaseResource(heightMapUID);
-    }
-    heightMapUID = uid;
-    heightMap = (heightMapUID != 0) ? (ResourceTexture*)Application::GetInstance().resources->RequestResource(heightMapUID) : nullptr;
+    SetTextureMap(uid, heightMapUID, heightMap, heightMapRequest);
 }
 
 void MaterialStandard::SetNormalMap(UID uid) {
-    if (normalMapUID != 0) {
-        Application::GetInstance().resources->ReleaseResource(normalMapUID);
-    }
-    normalMapUID = uid;
-    normalMap = (normalMapUID != 0) ? (ResourceTexture*)Application::GetInstance().resources->RequestResource(normalMapUID) : nullptr;
+    SetTextureMap(uid, normalMapUID, normalMap, normalMapRequest);
 }
 
 void MaterialStandard::SetMetallicMap(UID uid) {
-    if (metallicMapUID != 0) {
-        Application::GetInstance().resources->ReleaseResource(metallicMapUID);
-    }
-    metallicMapUID = uid;
-    metallicMap = (metallicMapUID != 0) ? (ResourceTexture*)Application::GetInstance().resources->RequestResource(metallicMapUID) : nullptr;
+    SetTextureMap(uid, metallicMapUID, metallicMap, metallicMapRequest);
 }
 
 void MaterialStandard::SetOcclusionMap(UID uid) {
-    if (occlusionMapUID != 0) {
-        Application::GetInstance().resources->ReleaseResource(occlusionMapUID);
+    SetTextureMap(uid, occlusionMapUID, occlusionMap, occlusionMapRequest);
+}
+
+void MaterialStandard::SetTextureMap(UID uid, UID& mapUID, ResourceTexture*& map, ResourceRequestPtr& request) {
+    ModuleResources* resources = Application::GetInstance().resources.get();
+
+    // Gives back the previous texture, or cancels it if it was still loading
+    resources->ReleaseRequest(request);
+    request = nullptr;
+    map = nullptr;
+
+    mapUID = uid;
+    if (mapUID == 0) {
+        return;
+    }
+
+    // Not registered yet, Bind asks again once it is
+    if (!resources->GetResourceDirect(mapUID)) {
+        return;
+    }
+
+    // The request is cancelled before this material goes away, so map is still there when it runs
+    request = resources->RequestResourceAsync(mapUID, [&map](Resource* resource) {
+        map = static_cast<ResourceTexture*>(resource);
+        });
+}
+
+void MaterialStandard::ResolveTextureMap(UID& mapUID, ResourceTexture*& map, ResourceRequestPtr& request) {
+    // A request that failed after the texture was found is not retried every frame
+    if (mapUID == 0 || request) {
+        return;
+    }
+
+    if (Application::GetInstance().resources->GetResourceDirect(mapUID)) {
+        SetTextureMap(mapUID, mapUID, map, request);
     }
-    occlusionMapUID = uid;
-    occlusionMap = (occlusionMapUID != 0) ? (ResourceTexture*)Application::GetInstance().resources->RequestResource(occlusionMapUID) : nullptr;
 }
\ No newline at end of file
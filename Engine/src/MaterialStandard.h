@@ -2,6 +2,7 @@
 
 #include "Material.h"
 #include "Globals.h"
+#include "ResourceLoader.h"
 #include "glm/glm.hpp"
 
 
@@ -15,6 +16,7 @@ public:
     ~MaterialStandard() override;
 
     void Bind(Shader* shader) override;
+    unsigned int GetBoundTextureCount() const override { return boundTextureCount; }
 
     void SetAlbedoMap(UID uid);
     void SetMetallicMap(UID uid);
@@ -50,6 +52,11 @@ public:
 
 private:
     
+    // Textures are requested asynchronously, each map stays unbound until its upload is done
+    void SetTextureMap(UID uid, UID& mapUID, ResourceTexture*& map, ResourceRequestPtr& request);
+    // Requests a map whose texture was not registered yet when it was set (still being imported)
+    void ResolveTextureMap(UID& mapUID, ResourceTexture*& map, ResourceRequestPtr& request);
+
     UID albedoMapUID = 0;
     UID metallicMapUID = 0;
     UID normalMapUID = 0;
@@ -62,6 +69,12 @@ private:
     ResourceTexture* heightMap = nullptr;
     ResourceTexture* occlusionMap = nullptr;
 
+    ResourceRequestPtr albedoMapRequest;
+    ResourceRequestPtr metallicMapRequest;
+    ResourceRequestPtr normalMapRequest;
+    ResourceRequestPtr heightMapRequest;
+    ResourceRequestPtr occlusionMapRequest;
+
     glm::vec4 color = { 1.0f, 1.0f, 1.0f , 1.0f};
     float metallic = 0.0f;
     float roughness = 0.5f;
@@ -69,4 +82,6 @@ private:
     glm::vec2 tiling = { 1.0f, 1.0f };
     glm::vec2 offset = { 0.0f, 0.0f };
 
+    unsigned int boundTextureCount = 0;
+
 };
\ No newline at end of file
@@ -54,17 +54,17 @@ void MeshCollider::CookMesh() {
     }
     else {
 
-        int vertexSize = meshRenderer->GetNumVertices();
+        std::vector<Vertex> meshVertices;
+        std::vector<uint32_t> indices;
+        meshRenderer->ReadGeometry(meshVertices, indices);
+
+        int vertexSize = (int)meshVertices.size();
         std::vector<glm::vec3> vertices(vertexSize);
         for (int i = 0; i < vertexSize; i++) {
-            vertices[i] = meshRenderer->GetVertices()[i].position;
+            vertices[i] = meshVertices[i].position;
         }
 
-        int indicesSize = meshRenderer->GetNumIndices();
-        std::vector<uint32_t> indices(indicesSize);
-        for (int i = 0; i < indicesSize; i++) {
-            indices[i] = meshRenderer->GetIndices()[i];
-        }
+        int indicesSize = (int)indices.size();
 
         cookedMesh = PhysicsCooker::CookTriangleMesh(
             (const float*)vertices.data(),
@@ -2,6 +2,7 @@
 
 #include "MeshImporter.h"
 #include "LibraryManager.h"
+#include "MappedFile.h"
 #include <filesystem>
 #include <assimp/mesh.h>
 #include <fstream>
@@ -9,6 +10,7 @@
 #include <chrono>
 #include <algorithm>
 #include <limits>
+#include <cstring>
 
 MeshImporter::MeshImporter() {}
 MeshImporter::~MeshImporter() {}
@@ -128,6 +130,24 @@ Mesh MeshImporter::ImportFromAssimp(const aiMesh* assimpMesh) {
     return mesh;
 }
 
+// Library file: header, vertices in the header's VertexFormat, indices (16 bits when the
+// vertex count allows it), then bones. Files written before the header existed start
+// straight with the counts and hold full Vertex structs and 32-bit indices.
+namespace {
+    const char MESH_MAGIC[4] = { 'W', 'M', 'S', 'H' };
+    const unsigned int MESH_VERSION = 1;
+
+    struct MeshFileHeader {
+        char magic[4];
+        unsigned int version;
+        unsigned int vertexFormat;
+        unsigned int indexSize;
+        unsigned int numVertices;
+        unsigned int numIndices;
+        unsigned int numBones;
+    };
+}
+
 // SAVE: Our Mesh -> Custom Binary Format
 bool MeshImporter::SaveToCustomFormat(const Mesh& mesh, const UID& uid) {
     std::string fullPath = LibraryManager::GetLibraryPath(uid);
@@ -135,17 +155,30 @@ bool MeshImporter::SaveToCustomFormat(const Mesh& mesh, const UID& uid) {
 
     if (!file.is_open()) return false;
 
-    unsigned int numVertices = static_cast<unsigned int>(mesh.vertices.size());
-    unsigned int numIndices = static_cast<unsigned int>(mesh.indices.size());
-    unsigned int numBones = static_cast<unsigned int>(mesh.bones.size());
+    MeshFileHeader header = {};
+    memcpy(header.magic, MESH_MAGIC, sizeof(MESH_MAGIC));
+    header.version = MESH_VERSION;
+    header.numVertices = static_cast<unsigned int>(mesh.vertices.size());
+    header.numIndices = static_cast<unsigned int>(mesh.indices.size());
+    header.numBones = static_cast<unsigned int>(mesh.bones.size());
 
-    file.write(reinterpret_cast<const char*>(&numVertices), sizeof(unsigned int));
-    file.write(reinterpret_cast<const char*>(&numIndices), sizeof(unsigned int));
-    file.write(reinterpret_cast<const char*>(&numBones), sizeof(unsigned int));
+    VertexFormat format = VertexLayout::ChooseFormat(mesh.vertices, mesh.bones.size());
+    header.vertexFormat = static_cast<unsigned int>(format);
+    header.indexSize = header.numVertices <= 0x10000 ? sizeof(uint16_t) : sizeof(unsigned int);
 
-    file.write(reinterpret_cast<const char*>(mesh.vertices.data()), numVertices * sizeof(Vertex));
+    file.write(reinterpret_cast<const char*>(&header), sizeof(MeshFileHeader));
 
-    file.write(reinterpret_cast<const char*>(mesh.indices.data()), numIndices * sizeof(unsigned int));
+    std::vector<unsigned char> vertexData;
+    VertexLayout::Pack(mesh.vertices.data(), mesh.vertices.size(), format, vertexData);
+    file.write(reinterpret_cast<const char*>(vertexData.data()), vertexData.size());
+
+    if (header.indexSize == sizeof(uint16_t)) {
+        std::vector<uint16_t> shortIndices(mesh.indices.begin(), mesh.indices.end());
+        file.write(reinterpret_cast<const char*>(shortIndices.data()), shortIndices.size() * sizeof(uint16_t));
+    }
+    else {
+        file.write(reinterpret_cast<const char*>(mesh.indices.data()), header.numIndices * sizeof(unsigned int));
+    }
 
     for (const auto& bone : mesh.bones) {
         unsigned int nameSize = static_cast<unsigned int>(bone.name.size());
@@ -155,46 +188,127 @@ bool MeshImporter::SaveToCustomFormat(const Mesh& mesh, const UID& uid) {
     }
 
     file.close();
+
+    LOG_DEBUG("[MeshImporter] Saved mesh %llu: %u vertices (%u bytes each), %u-bit indices",
+        uid, header.numVertices, VertexLayout::Get(format).stride, header.indexSize * 8);
     return true;
 }
 
 Mesh MeshImporter::LoadFromCustomFormat(const UID& uid) {
-    std::string fullPath = LibraryManager::GetLibraryPath(uid);
     Mesh mesh;
-    std::ifstream file(fullPath, std::ios::binary);
 
-    if (!file.is_open()) return mesh;
+    MappedFile file;
+    if (!file.Open(LibraryManager::GetLibraryPath(uid))) return mesh;
+
+    MeshFileView view;
+    if (!ReadCustomFormatView(file.GetData(), file.GetSize(), view)) return mesh;
+
+    view.ReadVertices(mesh.vertices);
+    view.ReadIndices(mesh.indices);
+    mesh.bones = std::move(view.bones);
+
+    return mesh;
+}
+
+bool MeshImporter::ReadCustomFormatView(const unsigned char* data, size_t size, MeshFileView& outView) {
+    const size_t legacyHeaderSize = 3 * sizeof(unsigned int);
+    if (!data || size < legacyHeaderSize) return false;
 
     unsigned int numVertices = 0, numIndices = 0, numBones = 0;
+    size_t offset = 0;
+
+    if (size >= sizeof(MeshFileHeader) && memcmp(data, MESH_MAGIC, sizeof(MESH_MAGIC)) == 0) {
+        MeshFileHeader header;
+        memcpy(&header, data, sizeof(MeshFileHeader));
 
-    file.read(reinterpret_cast<char*>(&numVertices), sizeof(unsigned int));
-    file.read(reinterpret_cast<char*>(&numIndices), sizeof(unsigned int));
-    file.read(reinterpret_cast<char*>(&numBones), sizeof(unsigned int));
+        if (header.version != MESH_VERSION || !VertexLayout::IsValidFormat(header.vertexFormat) ||
+            (header.indexSize != sizeof(uint16_t) && header.indexSize != sizeof(unsigned int))) {
+            LOG_DEBUG("[MeshImporter] ERROR: Unsupported mesh file (version %u)", header.version);
+            return false;
+        }
 
-    if (numVertices > 0) {
-        mesh.vertices.resize(numVertices);
-        file.read(reinterpret_cast<char*>(mesh.vertices.data()), numVertices * sizeof(Vertex));
+        outView.vertexFormat = static_cast<VertexFormat>(header.vertexFormat);
+        outView.indexSize = header.indexSize;
+        numVertices = header.numVertices;
+        numIndices = header.numIndices;
+        numBones = header.numBones;
+        offset = sizeof(MeshFileHeader);
     }
-    if (numIndices > 0) {
-        mesh.indices.resize(numIndices);
-        file.read(reinterpret_cast<char*>(mesh.indices.data()), numIndices * sizeof(unsigned int));
+    else {
+        memcpy(&numVertices, data, sizeof(unsigned int));
+        memcpy(&numIndices, data + sizeof(unsigned int), sizeof(unsigned int));
+        memcpy(&numBones, data + 2 * sizeof(unsigned int), sizeof(unsigned int));
+
+        outView.vertexFormat = VertexFormat::FULL;
+        outView.indexSize = sizeof(unsigned int);
+        offset = legacyHeaderSize;
     }
 
-    if (numBones > 0) {
-        mesh.bones.resize(numBones);
-        for (unsigned int i = 0; i < numBones; i++) {
-            unsigned int nameSize = 0;
-            file.read(reinterpret_cast<char*>(&nameSize), sizeof(unsigned int));
+    size_t vertexBytes = (size_t)numVertices * VertexLayout::Get(outView.vertexFormat).stride;
+    size_t indexBytes = (size_t)numIndices * outView.indexSize;
 
-            mesh.bones[i].name.resize(nameSize);
-            file.read(&mesh.bones[i].name[0], nameSize);
+    if (vertexBytes > size - offset) {
+        LOG_DEBUG("[MeshImporter] ERROR: Truncated vertex data");
+        return false;
+    }
+    outView.vertexData = data + offset;
+    outView.numVertices = numVertices;
+    offset += vertexBytes;
 
-            file.read(reinterpret_cast<char*>(&mesh.bones[i].offsetMatrix), sizeof(glm::mat4));
+    if (indexBytes > size - offset) {
+        LOG_DEBUG("[MeshImporter] ERROR: Truncated index data");
+        return false;
+    }
+    outView.indexData = data + offset;
+    outView.numIndices = numIndices;
+    offset += indexBytes;
+
+    outView.bones.clear();
+    outView.bones.resize(numBones);
+    for (unsigned int i = 0; i < numBones; i++) {
+        unsigned int nameSize = 0;
+        if (sizeof(unsigned int) > size - offset) return false;
+        memcpy(&nameSize, data + offset, sizeof(unsigned int));
+        offset += sizeof(unsigned int);
+
+        if ((size_t)nameSize + sizeof(glm::mat4) > size - offset) {
+            LOG_DEBUG("[MeshImporter] ERROR: Truncated bone data");
+            return false;
         }
+        outView.bones[i].name.assign(reinterpret_cast<const char*>(data + offset), nameSize);
+        offset += nameSize;
+
+        memcpy(&outView.bones[i].offsetMatrix, data + offset, sizeof(glm::mat4));
+        offset += sizeof(glm::mat4);
     }
 
-    file.close();
-    return mesh;
+    return true;
+}
+
+glm::vec3 MeshFileView::GetPosition(unsigned int index) const {
+    // Every format starts with the position as 3 floats
+    glm::vec3 position;
+    memcpy(&position, vertexData + (size_t)index * VertexLayout::Get(vertexFormat).stride, sizeof(glm::vec3));
+    return position;
+}
+
+void MeshFileView::ReadVertices(std::vector<Vertex>& outVertices) const {
+    VertexLayout::Unpack(vertexData, numVertices, vertexFormat, outVertices);
+}
+
+void MeshFileView::ReadIndices(std::vector<unsigned int>& outIndices) const {
+    outIndices.resize(numIndices);
+
+    if (indexSize == sizeof(uint16_t)) {
+        for (unsigned int i = 0; i < numIndices; i++) {
+            uint16_t index;
+            memcpy(&index, indexData + (size_t)i * sizeof(uint16_t), sizeof(uint16_t));
+            outIndices[i] = index;
+        }
+    }
+    else if (numIndices > 0) {
+        memcpy(outIndices.data(), indexData, (size_t)numIndices * sizeof(unsigned int));
+    }
 }
 
 std::string MeshImporter::GenerateMeshFilename(const std::string& originalName) {
@@ -10,6 +10,23 @@ struct Mesh;
 struct aiMesh;
 struct aiScene;
 
+// Library mesh file read in place (e.g. from a MappedFile): vertex and index data point
+// into the file, in the file's format, only the bones are copied out
+struct MeshFileView {
+    const unsigned char* vertexData = nullptr;
+    const unsigned char* indexData = nullptr;
+    VertexFormat vertexFormat = VertexFormat::FULL;
+    unsigned int indexSize = sizeof(unsigned int);
+    unsigned int numVertices = 0;
+    unsigned int numIndices = 0;
+    std::vector<Bone> bones;
+
+    glm::vec3 GetPosition(unsigned int index) const;
+    // Decoded to Vertex / 32-bit indices
+    void ReadVertices(std::vector<Vertex>& outVertices) const;
+    void ReadIndices(std::vector<unsigned int>& outIndices) const;
+};
+
 class MeshImporter {
 public:
     MeshImporter();
@@ -24,6 +41,10 @@ public:
     // LOAD: Load from custom binary format back into our Mesh structure
     static Mesh LoadFromCustomFormat(const UID& uid);
 
+    // LOAD: Parse custom binary format without copying the vertex / index arrays.
+    // data must stay alive (and mapped) while the view is used.
+    static bool ReadCustomFormatView(const unsigned char* data, size_t size, MeshFileView& outView);
+
     // Utility: Generate unique filename for mesh
     static std::string GenerateMeshFilename(const std::string& originalName);
 };
\ No newline at end of file
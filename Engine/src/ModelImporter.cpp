@@ -109,8 +109,8 @@ bool ModelImporter::ImportFromFile(const std::string& file_path, const MetaFile&
     std::string directory = file_path.substr(0, file_path.find_last_of("/\\"));
     rootObj = ProcessNode(scene->mRootNode, scene, directory, referedMeshes, materialMap);
 
-    rootObj->name = FileSystem::GetFileNameNoExtension(file_path);
-    rootObj->objectUID = 0;
+    rootObj->SetName(FileSystem::GetFileNameNoExtension(file_path));
+    rootObj->SetUID(0);
 
     if (hasAnimations)
     {
@@ -214,7 +214,7 @@ GameObject* ModelImporter::ProcessNode(aiNode* node, const aiScene* scene, const
     if (nodeName.empty()) nodeName = "Unnamed";
 
     GameObject* gameObject = new GameObject(nodeName);
-    gameObject->objectUID = 0;
+    gameObject->SetUID(0);
 
     Transform* transform = static_cast<Transform*>(gameObject->GetComponent(ComponentType::TRANSFORM));
 
@@ -395,23 +395,18 @@ void ModelImporter::CalculateBoundingBox(GameObject* obj, glm::vec3& minBounds,
     glm::mat4 worldTransform = parentTransform * localTransform;
 
     ComponentMesh* meshComp = static_cast<ComponentMesh*>(obj->GetComponent(ComponentType::MESH));
-    if (meshComp != nullptr)
+    if (meshComp != nullptr && meshComp->HasMesh())
     {
-        const Mesh& mesh = meshComp->GetMesh();
+        // The mesh's stored bounds, no need to read its vertices back from the Library file
+        AABB bounds = meshComp->GetAABB().GetGlobalAABB(worldTransform);
 
-        for (const auto& vertex : mesh.vertices)
-        {
-            glm::vec4 worldPos = worldTransform * glm::vec4(vertex.position, 1.0f);
-            glm::vec3 pos3(worldPos.x, worldPos.y, worldPos.z);
-
-            minBounds.x = std::min(minBounds.x, pos3.x);
-            minBounds.y = std::min(minBounds.y, pos3.y);
-            minBounds.z = std::min(minBounds.z, pos3.z);
+        minBounds.x = std::min(minBounds.x, bounds.min.x);
+        minBounds.y = std::min(minBounds.y, bounds.min.y);
+        minBounds.z = std::min(minBounds.z, bounds.min.z);
 
-            maxBounds.x = std::max(maxBounds.x, pos3.x);
-            maxBounds.y = std::max(maxBounds.y, pos3.y);
-            maxBounds.z = std::max(maxBounds.z, pos3.z);
-        }
+        maxBounds.x = std::max(maxBounds.x, bounds.max.x);
+        maxBounds.y = std::max(maxBounds.y, bounds.max.y);
+        maxBounds.z = std::max(maxBounds.z, bounds.max.z);
     }
 
     for (GameObject* child : obj->GetChildren())
@@ -1036,7 +1036,7 @@ std::string ModuleEditor::OpenLoadFile(const std::string& defaultPath)
     ofn.hwndOwner = NULL;
     ofn.lpstrFile = szFile;
     ofn.nMaxFile = sizeof(szFile);
-    ofn.lpstrFilter = "SCENE Files\0*.scene\0All Files\0*.*\0";
+    ofn.lpstrFilter = "SCENE Files\0*.scene\0Binary Scenes (backups)\0*.wscene\0All Files\0*.*\0";
     ofn.nFilterIndex = 1;
     ofn.lpstrFileTitle = NULL;
     ofn.nMaxFileTitle = 0;
@@ -1395,6 +1395,11 @@ GameObject* ModuleEditor::CloneGameObject(GameObject* original)
         std::map<std::string, AnimationData> animations = originalAnimator->animationsLibrary;
         for(auto & anim: animations)
 			newAnimator->AddAnimation(anim.first, anim.second.uid);
+        newAnimator->SetSyncBones(originalAnimator->GetSyncBones());
+        newAnimator->blendSpaces = originalAnimator->blendSpaces;
+        const std::vector<AnimationLayer>& layers = originalAnimator->GetLayers();
+        for (size_t i = 1; i < layers.size(); ++i)
+            newAnimator->AddLayer(layers[i].name, layers[i].mode, layers[i].weight, layers[i].maskBones);
     }
     if (original->GetComponent(ComponentType::PARTICLE))
     {
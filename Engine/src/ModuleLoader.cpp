@@ -163,14 +163,9 @@ GameObject* ModuleLoader::LoadPrefab(UID prefabUID)
         ResourcePrefab* resource = (ResourcePrefab*)Application::GetInstance().resources.get()->RequestResource(prefabUID);
         if (resource)
         {
-            nlohmann::json prefabHierarchy = resource->GetPrefabHierarchy();
+            // Every root of the hierarchy is attached to the scene root
             GameObject* root = Application::GetInstance().scene->GetRoot();
-
-            for (const auto& jsonNode : prefabHierarchy) {
-
-                GameObject* node = GameObject::Deserialize(jsonNode, root);
-                if (node && !firstLoaded) firstLoaded = node;
-            }
+            firstLoaded = resource->GetTemplate().Instantiate(root);
 
             prefabLoaded = true;
         }
@@ -320,6 +315,10 @@ bool ModuleLoader::LoadMaterialToGameObject(GameObject* obj, UID materialUID)
 
 bool ModuleLoader::LoadScene(const std::string& scenePath)
 {
+    // Binary scenes (backups) are not imported assets, they are mapped straight from disk
+    if (FileSystem::GetFileExtension(scenePath) == "wscene")
+        return Application::GetInstance().scene->LoadSceneBinary(scenePath);
+
     UID uid = Application::GetInstance().resources.get()->Find(scenePath.c_str(), Resource::SCENE);
 
     if (uid != 0) 
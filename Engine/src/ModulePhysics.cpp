@@ -53,11 +53,12 @@ bool ModulePhysics::Start() {
 
     gMaterial = gPhysics->createMaterial(0.5f, 0.5f, 0.6f);
 
-    gDispatcher = PxDefaultCpuDispatcherCreate(2);
+    // Simulation tasks run on the engine job system
+    gDispatcher = std::make_unique<PhysicsJobDispatcher>(*Application::GetInstance().jobs);
 
     PxSceneDesc sceneDesc(gPhysics->getTolerancesScale());
     sceneDesc.gravity = PxVec3(0.0f, -9.81f, 0.0f);
-    sceneDesc.cpuDispatcher = gDispatcher;
+    sceneDesc.cpuDispatcher = gDispatcher.get();
     sceneDesc.filterShader = CustomFilterShader;
     sceneDesc.simulationEventCallback = this;
     sceneDesc.flags |= PxSceneFlag::eENABLE_CCD;
@@ -87,7 +88,7 @@ bool ModulePhysics::CleanUp() {
     //LOG(LogType::LOG_INFO, "Cleaning PhysX...");
 
     if (gScene) gScene->release();
-    if (gDispatcher) gDispatcher->release();
+    gDispatcher.reset();
     if (gPhysics) gPhysics->release();
     if (gFoundation) gFoundation->release();
 
@@ -2,6 +2,8 @@
 #include "Module.h"
 #include <vector>
 #include <PxPhysicsAPI.h>
+#include <memory>
+#include "PhysicsJobDispatcher.h"
 
 enum class PhysicsEventType {
     ON_COLLISION_ENTER,
@@ -54,7 +56,7 @@ private:
     physx::PxDefaultErrorCallback  gErrorCallback;
     physx::PxFoundation* gFoundation = nullptr;
     physx::PxPhysics* gPhysics = nullptr;
-    physx::PxDefaultCpuDispatcher* gDispatcher = nullptr;
+    std::unique_ptr<PhysicsJobDispatcher> gDispatcher;
     physx::PxScene* gScene = nullptr;
     physx::PxMaterial* gMaterial = nullptr;
 
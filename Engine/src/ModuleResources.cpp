@@ -30,6 +30,9 @@ Resource::Resource(UID uid, Type type)
 Resource::~Resource() {
 }
 
+// I/O threads for RequestResourceAsync, reads are disk bound so a couple is enough
+static const unsigned int RESOURCE_IO_THREADS = 2;
+
 // ModuleResources Implementation
 ModuleResources::ModuleResources() : Module() {
 }
@@ -38,6 +41,7 @@ ModuleResources::~ModuleResources() {
 }
 
 bool ModuleResources::Awake() {
+    loader.Start(RESOURCE_IO_THREADS);
     return true;
 }
 
@@ -64,6 +68,7 @@ bool ModuleResources::Start() {
 }
 
 bool ModuleResources::Update() {
+    loader.Finalize(uploadBudgetMs);
     return true;
 }
 
@@ -71,6 +76,8 @@ bool ModuleResources::CleanUp() {
 
     shuttingDown = true;
 
+    loader.Stop();
+
     for (auto& pair : resources) {
 
         if (pair.second->IsLoadedToMemory()) {
@@ -300,6 +307,7 @@ UID ModuleResources::ImportFile(const char* newFileInAssets, bool forceReimport)
             return meta.uid;
         }
         resource = it->second;
+        loader.FinishNow(meta.uid);
     }
     else {
         resource = CreateNewResourceWithUID(newFileInAssets, type, meta.uid);
@@ -444,6 +452,9 @@ const Resource* ModuleResources::RequestResource(UID uid) const {
 
 Resource* ModuleResources::RequestResource(UID uid) {
     
+    // Already on its way: finish it here rather than load it a second time under the I/O thread
+    loader.FinishNow(uid);
+
     auto it = resources.find(uid);
 
     if (it != resources.end()) {
@@ -481,6 +492,49 @@ const Resource* ModuleResources::PeekResource(UID uid)
     return nullptr;
 }
 
+ResourceRequestPtr ModuleResources::RequestResourceAsync(UID uid, std::function<void(Resource*)> callback) {
+
+    ResourceRequestPtr request = std::make_shared<ResourceRequest>();
+    request->uid = uid;
+    request->callback = std::move(callback);
+
+    auto it = resources.find(uid);
+
+    if (it == resources.end()) {
+        LOG_CONSOLE("ERROR: Resource %llu not found", uid);
+        request->state = ResourceRequest::State::FAILED;
+        loader.Complete(request);
+        return request;
+    }
+
+    Resource* resource = it->second;
+    request->resource = resource;
+
+    if (resource->IsLoadedToMemory()) {
+        resource->referenceCount++;
+        request->state = ResourceRequest::State::READY;
+        loader.Complete(request);
+    }
+    else {
+        loader.Load(resource, request);
+    }
+
+    return request;
+}
+
+void ModuleResources::ReleaseRequest(const ResourceRequestPtr& request) {
+    if (!request) {
+        return;
+    }
+
+    if (request->state == ResourceRequest::State::READY) {
+        ReleaseResource(request->uid);
+    }
+
+    request->state = ResourceRequest::State::CANCELLED;
+    request->callback = nullptr;
+}
+
 void ModuleResources::ReleaseResource(UID uid) {
     auto it = resources.find(uid);
 
@@ -677,6 +731,8 @@ void ModuleResources::RemoveResource(UID uid) {
         return;
     }
 
+    loader.FinishNow(uid);
+
     Resource* resource = it->second;
 
     if (resource->GetReferenceCount() > 0) {
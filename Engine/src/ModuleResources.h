@@ -1,6 +1,8 @@
 ﻿#pragma once
 
 #include "Module.h"
+#include "ResourceLoader.h"
+#include <functional>
 #include <map>
 #include <string>
 
@@ -29,6 +31,14 @@ public:
     virtual bool LoadInMemory() = 0;
     virtual void UnloadFromMemory() = 0;
 
+    // Split load used by RequestResourceAsync. ReadFromDisk runs on an I/O thread and must not
+    // touch GL or other resources; UploadToGPU and ReleaseDiskData run on the main thread.
+    // Types that keep the defaults do their whole LoadInMemory in the upload step.
+    virtual bool ReadFromDisk() { return true; }
+    virtual bool UploadToGPU() { return LoadInMemory(); }
+    // Frees whatever ReadFromDisk left for the upload, called whether it succeeded or not
+    virtual void ReleaseDiskData() {}
+
     // Getters
     UID GetUID() const { return uid; }
     Type GetType() const { return type; }
@@ -48,6 +58,7 @@ protected:
     unsigned int referenceCount = 0;
 
     friend class ModuleResources;
+    friend class ResourceLoader;
 };
 // Resource management module
 class ModuleResources : public Module {
@@ -73,8 +84,23 @@ public:
     const Resource* RequestResource(UID uid) const;
     Resource* RequestResource(UID uid);
 
+    // Same as RequestResource, but reading and decoding happen on the I/O threads and only the
+    // GPU upload is done here, in Update, within the upload budget. callback (optional) runs on
+    // the main thread with the resource, or nullptr if it failed; at the earliest on the next
+    // Update, even if the resource is already loaded.
+    ResourceRequestPtr RequestResourceAsync(UID uid, std::function<void(Resource*)> callback = nullptr);
+
     // Release resource (decrement ref count)
     void ReleaseResource(UID uid);
+    // Releases the reference of a finished request, or cancels it (its callback will not run)
+    void ReleaseRequest(const ResourceRequestPtr& request);
+
+    bool IsResourceLoading(UID uid) const { return loader.IsLoading(uid); }
+    size_t GetPendingLoadCount() const { return loader.GetPendingCount(); }
+
+    // Main thread time per frame for finishing async loads, in milliseconds
+    void SetUploadBudget(double milliseconds) { uploadBudgetMs = milliseconds; }
+    double GetUploadBudget() const { return uploadBudgetMs; }
 
     const Resource* PeekResource(UID uid);
 
@@ -130,6 +156,7 @@ public:
 
     void RegisterResource(UID uid, Resource* resource) {
         if (resources.find(uid) != resources.end()) {
+            loader.FinishNow(uid);
             LOG_DEBUG("[ModuleResources] WARNING: Resource %llu already exists, replacing", uid);
             // Cleanup old resource
             Resource* old = resources[uid];
@@ -179,4 +206,7 @@ private:
     std::map<UID, Resource*> resources;
     UID nextUID = 1;
     bool shuttingDown = false;
+
+    ResourceLoader loader;
+    double uploadBudgetMs = 2.0;
 };
\ No newline at end of file
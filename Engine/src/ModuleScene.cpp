@@ -9,9 +9,14 @@
 #include "ComponentMesh.h"
 #include "ComponentCamera.h"
 #include "ComponentNavigation.h"
+#include "SceneBinary.h"
+#include "MappedFile.h"
 
 #include <fstream>
 
+// Objects outside these bounds still work, they just go to the octree overflow list
+static const float SPATIAL_INDEX_HALF_SIZE = 2048.0f;
+
 ModuleScene::ModuleScene() : Module()
 {
     name = "ModuleScene";
@@ -37,6 +42,9 @@ bool ModuleScene::Start()
 {
     LOG_DEBUG("Initializing Scene");
     root = new GameObject("Root");
+    registry.Add(root);
+    componentScheduler.RegisterSubtree(root);
+    spatialIndex.Create(glm::vec3(-SPATIAL_INDEX_HALF_SIZE), glm::vec3(SPATIAL_INDEX_HALF_SIZE), 8, 8);
     LOG_CONSOLE("Scene ready");
 
     return true;
@@ -46,22 +54,14 @@ bool ModuleScene::Start()
 
 bool ModuleScene::Update()
 {
-    // Update all GameObjects
-    if (root)
-    {
-        root->Update();
-    }
+    componentScheduler.Update();
 
     return true;
 }
 
 bool ModuleScene::FixedUpdate()
 {
-    // Update all GameObjects
-    if (root)
-    {
-        root->FixedUpdate();
-    }
+    componentScheduler.FixedUpdate();
 
     return true;
 }
@@ -74,6 +74,15 @@ bool ModuleScene::PostUpdate()
         CleanupMarkedObjects(root);
     }
 
+    UpdateSpatialIndex();
+
+#ifndef WAVE_GAME
+    if (Application::GetInstance().editor->ShouldShowOctree())
+    {
+        spatialIndex.DebugDraw();
+    }
+#endif
+
     return true;
 }
 
@@ -87,6 +96,10 @@ bool ModuleScene::CleanUp()
         root = nullptr;
     }
 
+    spatialDirty.clear();
+    spatialIndex.Clear();
+    registry.Clear();
+
     return true;
 }
 
@@ -160,6 +173,15 @@ bool ModuleScene::LoadScene(const nlohmann::json& sceneHierarchy)
     if (root)
         root->SolveReferences();
 
+    BakeNavMeshes();
+
+    LOG_CONSOLE("Scene loaded successfully from JSON");
+
+    return true;
+}
+
+void ModuleScene::BakeNavMeshes()
+{
     LOG_CONSOLE("Iniciando Auto-Bake de NavMeshes...");
 
     std::function<void(GameObject*)> autoBakeNav = [&](GameObject* obj) {
@@ -180,11 +202,6 @@ bool ModuleScene::LoadScene(const nlohmann::json& sceneHierarchy)
     if (root) {
         autoBakeNav(root);
     }
-
-
-    LOG_CONSOLE("Scene loaded successfully from JSON");
-
-    return true;
 }
 
 void ModuleScene::NewScene()
@@ -239,12 +256,53 @@ void ModuleScene::ClearScene()
 
 GameObject* ModuleScene::FindObject(const UID uid) 
 { 
-    return root->FindChild(uid); 
+    return registry.Find(uid); 
 }
 
 GameObject* ModuleScene::FindObject(const std::string& name)
 { 
-    return root->FindChild(name); 
+    return registry.Find(name); 
+}
+
+const std::vector<GameObject*>& ModuleScene::FindObjectsWithTag(const std::string& tag) const
+{
+    return registry.FindWithTag(tag);
+}
+
+void ModuleScene::MarkSpatialDirty(GameObject* obj)
+{
+    if (!obj) return;
+
+    spatialDirty.insert(obj);
+}
+
+void ModuleScene::RemoveFromSpatialIndex(GameObject* obj)
+{
+    spatialDirty.erase(obj);
+    spatialIndex.Remove(obj);
+}
+
+void ModuleScene::UpdateSpatialIndex()
+{
+    // Moves made after the last flush (editor gizmos, physics callbacks) only published
+    // TRANSFORM_CHANGED for the moved object; the flush publishes it for its descendants
+    transformStore.UpdateWorldMatrices();
+
+    if (spatialDirty.empty()) return;
+
+    // Insert moves the object if it was already indexed, and drops it if it lost its mesh
+    for (GameObject* obj : spatialDirty)
+    {
+        spatialIndex.Insert(obj);
+    }
+
+    spatialDirty.clear();
+}
+
+void ModuleScene::CollectVisible(const Frustum& frustum, std::vector<GameObject*>& outObjects)
+{
+    UpdateSpatialIndex();
+    spatialIndex.CollectIntersections(outObjects, frustum);
 }
 
 ComponentCamera* ModuleScene::FindCameraInHierarchy(GameObject* obj)
@@ -317,4 +375,58 @@ bool ModuleScene::DeserializeSceneFromString(const std::string& jsonString)
 
     LOG_CONSOLE("Scene restored from memory");
     return true;
+}
+
+void ModuleScene::SerializeSceneToBinary(std::vector<unsigned char>& outData)
+{
+    SceneBinary::Write(root, outData);
+}
+
+bool ModuleScene::DeserializeSceneFromBinary(const unsigned char* data, size_t size)
+{
+    if (!SceneBinary::IsBinaryScene(data, size)) {
+        LOG_CONSOLE("[ModuleScene] ERROR: Not a binary scene");
+        return false;
+    }
+
+    Application::GetInstance().selectionManager->ClearSelection();
+
+    ClearScene();
+
+    bool success = SceneBinary::Read(data, size, root);
+
+    // Whatever was read before an error stays, like with a partly broken JSON scene
+    if (root)
+        root->SolveReferences();
+
+    if (success) LOG_CONSOLE("Scene restored from binary data");
+    return success;
+}
+
+bool ModuleScene::SaveSceneBinary(const std::string& path)
+{
+    std::vector<unsigned char> data;
+    SerializeSceneToBinary(data);
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        LOG_CONSOLE("ERROR: Failed to open file for writing: %s", path.c_str());
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return file.good();
+}
+
+bool ModuleScene::LoadSceneBinary(const std::string& path)
+{
+    MappedFile file;
+    if (!file.Open(path)) return false;
+
+    if (!DeserializeSceneFromBinary(file.GetData(), file.GetSize())) return false;
+
+    BakeNavMeshes();
+
+    LOG_CONSOLE("Scene loaded successfully from %s", path.c_str());
+    return true;
 }
\ No newline at end of file
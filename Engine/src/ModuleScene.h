@@ -1,15 +1,20 @@
 ﻿#pragma once
 #include "Module.h"
 #include "Octree.h"
+#include "TransformStore.h"
+#include "ComponentScheduler.h"
+#include "SceneRegistry.h"
 #include "Globals.h"
 #include <memory>
 #include <vector>
+#include <unordered_set>
 #include <nlohmann/json.hpp>
 
 class GameObject;
 class Renderer;
 class ComponentCamera;
 class SceneWindow;
+class Frustum;
 
 class ModuleScene : public Module
 {
@@ -28,8 +33,11 @@ public:
 
     GameObject* GetRoot() const { return root; }
 
+    // O(1) through the registry; only objects attached to the root are found
     GameObject* FindObject(const UID uid) ; 
     GameObject* FindObject(const std::string& name);
+    const std::vector<GameObject*>& FindObjectsWithTag(const std::string& tag) const;
+    SceneRegistry& GetRegistry() { return registry; }
 
     void CleanupMarkedObjects(GameObject* parent);
 
@@ -49,10 +57,40 @@ public:
     std::string SerializeSceneToString();
     bool DeserializeSceneFromString(const std::string& jsonString);
 
+    // Binary scene (SceneBinary), in memory for backups and mapped from disk for files
+    void SerializeSceneToBinary(std::vector<unsigned char>& outData);
+    bool DeserializeSceneFromBinary(const unsigned char* data, size_t size);
+    bool SaveSceneBinary(const std::string& path);
+    bool LoadSceneBinary(const std::string& path);
+
+    // Spatial index of every GameObject with a mesh, kept up to date from
+    // TRANSFORM_CHANGED / MESH_CHANGED instead of being rebuilt per frame
+    // UpdateSpatialIndex flushes pending transforms first, so queries see every moved subtree
+    void MarkSpatialDirty(GameObject* obj);
+    void RemoveFromSpatialIndex(GameObject* obj);
+    void UpdateSpatialIndex();
+    void CollectVisible(const Frustum& frustum, std::vector<GameObject*>& outObjects);
+    const Octree& GetSpatialIndex() const { return spatialIndex; }
+
+    // Matrices and hierarchy of every Transform, world matrices updated once per frame
+    TransformStore& GetTransformStore() { return transformStore; }
+
+    // Per-type component lists, updated in phases every frame
+    ComponentScheduler& GetComponentScheduler() { return componentScheduler; }
+
 private:
 
+    void BakeNavMeshes();
+
     GameObject* root = nullptr;
 
     Renderer* renderer = nullptr;
 
+    Octree spatialIndex;
+    std::unordered_set<GameObject*> spatialDirty;
+
+    TransformStore transformStore;
+    ComponentScheduler componentScheduler;
+    SceneRegistry registry;
+
 };
\ No newline at end of file
@@ -59,8 +59,8 @@ void ModuleNavMesh::RecollectGeometry(GameObject* obj, std::vector<float>& verti
         LOG_CONSOLE("Checking mesh for object: %s, HasMesh: %d, Vertices: %d, Indices: %d",
             obj->GetName().c_str(),
             mesh->HasMesh(),
-            (int)mesh->GetMesh().vertices.size(),
-            (int)mesh->GetMesh().indices.size());
+            (int)mesh->GetNumVertices(),
+            (int)mesh->GetNumIndices());
         if (mesh->HasMesh())
             ExtractVertices(mesh, vertices, indices);
     }
@@ -76,7 +76,6 @@ void ModuleNavMesh::ExtractVertices(ComponentMesh* mesh, std::vector<float>& ver
 {
     if (mesh == nullptr || !mesh->HasMesh()) return;
 
-    const Mesh& meshData = mesh->GetMesh();
     GameObject* owner = mesh->owner;
     if (!owner) return;
 
@@ -88,7 +87,11 @@ void ModuleNavMesh::ExtractVertices(ComponentMesh* mesh, std::vector<float>& ver
     // Offset para que los índices apunten correctamente al buffer global
     int vertexOffset = vertices.size() / 3;
 
-    for (const auto& vertex : meshData.vertices)
+    std::vector<Vertex> meshVertices;
+    std::vector<unsigned int> meshIndices;
+    if (!mesh->ReadGeometry(meshVertices, meshIndices)) return;
+
+    for (const auto& vertex : meshVertices)
     {
         glm::vec4 worldPos = globalMat * glm::vec4(vertex.position.x, vertex.position.y, vertex.position.z, 1.0f);
         vertices.push_back(worldPos.x);
@@ -97,7 +100,7 @@ void ModuleNavMesh::ExtractVertices(ComponentMesh* mesh, std::vector<float>& ver
     }
 
     // Usar los índices reales del mesh
-    for (unsigned int idx : meshData.indices)
+    for (unsigned int idx : meshIndices)
         indices.push_back(vertexOffset + (int)idx);
 }
 void ModuleNavMesh::Bake(GameObject* root)
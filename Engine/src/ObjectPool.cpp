@@ -0,0 +1,143 @@
+#include "ObjectPool.h"
+#include <cassert>
+#include <new>
+
+static size_t AlignSize(size_t size)
+{
+    return (size + ObjectPools::BLOCK_ALIGNMENT - 1) & ~(ObjectPools::BLOCK_ALIGNMENT - 1);
+}
+
+FixedBlockPool::FixedBlockPool(size_t blockSize, size_t blocksPerChunk)
+    : blockSize(AlignSize(blockSize < sizeof(FreeBlock) ? sizeof(FreeBlock) : blockSize)),
+    blocksPerChunk(blocksPerChunk)
+{
+}
+
+void* FixedBlockPool::Allocate()
+{
+    if (!freeList)
+    {
+        AddChunk();
+    }
+
+    FreeBlock* block = freeList;
+    freeList = block->next;
+    ++liveCount;
+    return block;
+}
+
+void FixedBlockPool::Free(void* block)
+{
+    if (!block) return;
+
+    assert(liveCount > 0);
+
+    FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+    freeBlock->next = freeList;
+    freeList = freeBlock;
+    --liveCount;
+}
+
+void FixedBlockPool::AddChunk()
+{
+    // new[] of unsigned char is aligned for any fundamental type, and blockSize is a
+    // multiple of BLOCK_ALIGNMENT, so every block keeps that alignment
+    unsigned char* chunk = new unsigned char[blockSize * blocksPerChunk];
+    chunks.emplace_back(chunk);
+
+    // Threaded in address order so consecutive allocations are adjacent in memory
+    for (size_t i = blocksPerChunk; i-- > 0;)
+    {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + i * blockSize);
+        block->next = freeList;
+        freeList = block;
+    }
+}
+
+namespace
+{
+    const size_t GAMEOBJECTS_PER_CHUNK = 256;
+    const size_t COMPONENTS_PER_CHUNK = 64;
+    const size_t SIZE_CLASSES = ObjectPools::MAX_POOLED_SIZE / ObjectPools::BLOCK_ALIGNMENT;
+
+    // Never destroyed: objects can still be released during static destruction
+    FixedBlockPool*& GameObjectPool()
+    {
+        static FixedBlockPool* pool = nullptr;
+        return pool;
+    }
+
+    std::vector<FixedBlockPool*>& ComponentPools()
+    {
+        static std::vector<FixedBlockPool*>* pools = new std::vector<FixedBlockPool*>(SIZE_CLASSES + 1, nullptr);
+        return *pools;
+    }
+}
+
+void* ObjectPools::AllocateGameObject(size_t size)
+{
+    FixedBlockPool*& pool = GameObjectPool();
+    if (!pool)
+    {
+        pool = new FixedBlockPool(size, GAMEOBJECTS_PER_CHUNK);
+    }
+
+    assert(AlignSize(size) == pool->GetBlockSize());
+    return pool->Allocate();
+}
+
+void ObjectPools::FreeGameObject(void* block, size_t size)
+{
+    if (!block) return;
+
+    assert(AlignSize(size) == GameObjectPool()->GetBlockSize());
+    GameObjectPool()->Free(block);
+}
+
+void* ObjectPools::AllocateComponent(size_t size)
+{
+    if (size > MAX_POOLED_SIZE)
+    {
+        return ::operator new(size);
+    }
+
+    FixedBlockPool*& pool = ComponentPools()[AlignSize(size) / BLOCK_ALIGNMENT];
+    if (!pool)
+    {
+        pool = new FixedBlockPool(size, COMPONENTS_PER_CHUNK);
+    }
+    return pool->Allocate();
+}
+
+void ObjectPools::FreeComponent(void* block, size_t size)
+{
+    if (!block) return;
+
+    if (size > MAX_POOLED_SIZE)
+    {
+        ::operator delete(block);
+        return;
+    }
+
+    ComponentPools()[AlignSize(size) / BLOCK_ALIGNMENT]->Free(block);
+}
+
+size_t ObjectPools::GetLiveCount()
+{
+    size_t count = GameObjectPool() ? GameObjectPool()->GetLiveCount() : 0;
+    for (FixedBlockPool* pool : ComponentPools())
+    {
+        if (pool) count += pool->GetLiveCount();
+    }
+    return count;
+}
+
+size_t ObjectPools::GetCapacity()
+{
+    size_t capacity = GameObjectPool() ? GameObjectPool()->GetCapacity() : 0;
+    for (FixedBlockPool* pool : ComponentPools())
+    {
+        if (pool) capacity += pool->GetCapacity();
+    }
+    return capacity;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Fixed-size blocks carved out of chunks that are never returned to the heap while the
+// pool lives. Freed blocks go to an intrusive free list, so once a pool has seen its
+// peak population, spawning and despawning does not allocate. Main thread only, like
+// the scene graph it serves.
+class FixedBlockPool
+{
+public:
+    FixedBlockPool(size_t blockSize, size_t blocksPerChunk);
+
+    void* Allocate();
+    void Free(void* block);
+
+    size_t GetBlockSize() const { return blockSize; }
+    size_t GetLiveCount() const { return liveCount; }
+    size_t GetCapacity() const { return chunks.size() * blocksPerChunk; }
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    void AddChunk();
+
+    size_t blockSize;
+    size_t blocksPerChunk;
+    std::vector<std::unique_ptr<unsigned char[]>> chunks;
+    FreeBlock* freeList = nullptr;
+    size_t liveCount = 0;
+};
+
+// Class-level storage for GameObjects and components. Components are pooled by exact
+// (aligned) size, which in practice gives each component type its own pool; anything
+// bigger than MAX_POOLED_SIZE falls back to the global heap.
+namespace ObjectPools
+{
+    static const size_t BLOCK_ALIGNMENT = 16;
+    static const size_t MAX_POOLED_SIZE = 4096;
+
+    void* AllocateGameObject(size_t size);
+    void FreeGameObject(void* block, size_t size);
+
+    void* AllocateComponent(size_t size);
+    void FreeComponent(void* block, size_t size);
+
+    // Live / reserved blocks over all pools
+    size_t GetLiveCount();
+    size_t GetCapacity();
+}
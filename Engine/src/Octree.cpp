@@ -59,43 +59,27 @@ OctreeNode::~OctreeNode()
     Clear();
 }
 
-bool OctreeNode::GetObjectWorldAABB(GameObject* obj, glm::vec3& outMin, glm::vec3& outMax)
+bool OctreeNode::Contains(const AABB& other) const
 {
-    if (obj == nullptr)
-        return false;
-
-    ComponentMesh* mesh = static_cast<ComponentMesh*>(obj->GetComponent(ComponentType::MESH));
-    Transform* transform = static_cast<Transform*>(obj->GetComponent(ComponentType::TRANSFORM));
-
-    if (!mesh || !mesh->HasMesh() || !transform)
-        return false;
-
-    // Get AABB in local space
-    glm::vec3 localMin = mesh->GetAABB().min;
-    glm::vec3 localMax = mesh->GetAABB().max;
+    return other.min.x >= box.min.x && other.max.x <= box.max.x &&
+           other.min.y >= box.min.y && other.max.y <= box.max.y &&
+           other.min.z >= box.min.z && other.max.z <= box.max.z;
+}
 
-    // Transform to world space (transform all 8 corners and recalculate AABB)
-    glm::mat4 globalMatrix = transform->GetGlobalMatrix();
-    glm::vec3 corners[8] = {
-        glm::vec3(globalMatrix * glm::vec4(localMin.x, localMin.y, localMin.z, 1.0f)),
-        glm::vec3(globalMatrix * glm::vec4(localMax.x, localMin.y, localMin.z, 1.0f)),
-        glm::vec3(globalMatrix * glm::vec4(localMin.x, localMax.y, localMin.z, 1.0f)),
-        glm::vec3(globalMatrix * glm::vec4(localMax.x, localMax.y, localMin.z, 1.0f)),
-        glm::vec3(globalMatrix * glm::vec4(localMin.x, localMin.y, localMax.z, 1.0f)),
-        glm::vec3(globalMatrix * glm::vec4(localMax.x, localMin.y, localMax.z, 1.0f)),
-        glm::vec3(globalMatrix * glm::vec4(localMin.x, localMax.y, localMax.z, 1.0f)),
-        glm::vec3(globalMatrix * glm::vec4(localMax.x, localMax.y, localMax.z, 1.0f))
-    };
+int OctreeNode::GetChildIndexFor(const AABB& other) const
+{
+    if (IsLeaf())
+        return -1;
 
-    outMin = corners[0];
-    outMax = corners[0];
-    for (int i = 1; i < 8; ++i)
+    for (int i = 0; i < 8; ++i)
     {
-        outMin = glm::min(outMin, corners[i]);
-        outMax = glm::max(outMax, corners[i]);
+        if (children[i] != nullptr && children[i]->Contains(other))
+        {
+            return i;
+        }
     }
 
-    return true;
+    return -1;
 }
 
 void OctreeNode::Clear()
@@ -114,100 +98,103 @@ void OctreeNode::Clear()
     objects.clear();
 }
 
-bool OctreeNode::Insert(GameObject* obj)
+void OctreeNode::Insert(const OctreeEntry& entry)
 {
-    if (obj == nullptr)
-        return false;
+    // Push down to the child that fully contains the object
+    int childIndex = GetChildIndexFor(entry.box);
+    if (childIndex != -1)
+    {
+        children[childIndex]->Insert(entry);
+        return;
+    }
 
-    // Get object's AABB in world space
-    glm::vec3 worldMin, worldMax;
-    if (!GetObjectWorldAABB(obj, worldMin, worldMax))
-        return false;
+    objects.push_back(entry);
 
-    // Check if object is completely outside this node
-    if (worldMax.x < box.min.x || worldMin.x > box.max.x ||
-        worldMax.y < box.min.y || worldMin.y > box.max.y ||
-        worldMax.z < box.min.z || worldMin.z > box.max.z)
+    // If we're a leaf but full, subdivide
+    if (IsLeaf() && objects.size() > static_cast<size_t>(max_objects) && current_depth < max_depth)
     {
-        return false; // Object is outside this node
+        Subdivide();
+        RedistributeObjects();
     }
+}
 
-    // If we're a leaf and have space, add to this node
-    if (IsLeaf() && objects.size() < static_cast<size_t>(max_objects))
+bool OctreeNode::Remove(GameObject* obj, const AABB& objBox)
+{
+    // Remove from this node
+    for (size_t i = 0; i < objects.size(); ++i)
     {
-        objects.push_back(obj);
-        return true;
+        if (objects[i].object == obj)
+        {
+            objects[i] = objects.back();
+            objects.pop_back();
+            return true;
+        }
     }
 
-    // If we're a leaf but full, subdivide
-    if (IsLeaf() && current_depth < max_depth)
+    // The object can only be in the child that contains the box it was inserted with
+    int childIndex = GetChildIndexFor(objBox);
+    if (childIndex != -1 && children[childIndex]->Remove(obj, objBox))
     {
-        Subdivide();
-        RedistributeObjects();
+        // After child removed object, check if we should collapse
+        CollapseIfPossible();
+        return true;
     }
 
-    // If we have children, try to add to appropriate child(ren)
+    return false;
+}
+
+int OctreeNode::CountObjectsRecursive() const
+{
+    int total = static_cast<int>(objects.size());
+
     if (!IsLeaf())
     {
-        bool added = false;
         for (int i = 0; i < 8; ++i)
         {
-            if (children[i] != nullptr && children[i]->Insert(obj))
+            if (children[i] != nullptr)
             {
-                added = true;
+                total += children[i]->CountObjectsRecursive();
             }
         }
-
-        // If object doesn't fit completely in any child, keep it in this node
-        if (!added)
-        {
-            objects.push_back(obj);
-            return true;
-        }
-
-        return added;
     }
 
-    // We're at max depth and full, add anyway
-    objects.push_back(obj);
-    return true;
+    return total;
 }
 
-bool OctreeNode::Remove(GameObject* obj)
+void OctreeNode::MoveObjectsTo(std::vector<OctreeEntry>& out)
 {
-    if (obj == nullptr)
-        return false;
+    out.insert(out.end(), objects.begin(), objects.end());
+    objects.clear();
 
-    // Remove from this node
-    auto it = std::find(objects.begin(), objects.end(), obj);
-    if (it != objects.end())
+    if (!IsLeaf())
     {
-        objects.erase(it);
-
-        // After removing, check if we should collapse this node
-        if (!IsLeaf())
+        for (int i = 0; i < 8; ++i)
         {
-            CollapseIfPossible();
+            if (children[i] != nullptr)
+            {
+                children[i]->MoveObjectsTo(out);
+            }
         }
+    }
+}
 
-        return true;
+void OctreeNode::CollectAll(std::vector<GameObject*>& objects_out) const
+{
+    for (const OctreeEntry& entry : objects)
+    {
+        objects_out.push_back(entry.object);
     }
 
-    // Try children
     if (!IsLeaf())
     {
         for (int i = 0; i < 8; ++i)
         {
-            if (children[i] != nullptr && children[i]->Remove(obj))
+            if (children[i] != nullptr)
             {
-                // After child removed object, check if we should collapse
-                CollapseIfPossible();
-                return true;
+                children[i]->CollectAll(objects_out);
             }
         }
     }
-
-    return false;
 }
 
 void OctreeNode::CollapseIfPossible()
@@ -215,69 +202,25 @@ void OctreeNode::CollapseIfPossible()
     if (IsLeaf())
         return;
 
-    // Count total objects in this node and all children
-    int totalObjects = objects.size();
-
-    std::function<void(OctreeNode*)> countObjects = [&](OctreeNode* node) {
-        if (!node) return;
-
-        totalObjects += node->objects.size();
-
-        if (!node->IsLeaf())
-        {
-            for (int i = 0; i < 8; ++i)
-            {
-                if (node->children[i] != nullptr)
-                {
-                    countObjects(node->children[i]);
-                }
-            }
-        }
-        };
-
+    // Only collapse when the children are leaves, deeper levels collapse on their own
     for (int i = 0; i < 8; ++i)
     {
-        if (children[i] != nullptr)
-        {
-            countObjects(children[i]);
-        }
+        if (children[i] != nullptr && !children[i]->IsLeaf())
+            return;
     }
 
     // If total objects is less than max_objects, collapse
-    if (totalObjects <= max_objects)
+    if (CountObjectsRecursive() <= max_objects)
     {
-        // Collect all objects from children
-        std::vector<GameObject*> allObjects = objects;
-
-        std::function<void(OctreeNode*)> collectObjects = [&](OctreeNode* node) {
-            if (!node) return;
-
-            allObjects.insert(allObjects.end(), node->objects.begin(), node->objects.end());
-
-            if (!node->IsLeaf())
-            {
-                for (int i = 0; i < 8; ++i)
-                {
-                    if (node->children[i] != nullptr)
-                    {
-                        collectObjects(node->children[i]);
-                    }
-                }
-            }
-            };
-
         for (int i = 0; i < 8; ++i)
         {
             if (children[i] != nullptr)
             {
-                collectObjects(children[i]);
+                children[i]->MoveObjectsTo(objects);
                 delete children[i];
                 children[i] = nullptr;
             }
         }
-
-        // Move all objects to this node
-        objects = allObjects;
     }
 }
 
@@ -340,29 +283,18 @@ void OctreeNode::Subdivide()
 void OctreeNode::RedistributeObjects()
 {
     // Keep current objects
-    std::vector<GameObject*> objectsToRedistribute = objects;
-    objects.clear();
+    std::vector<OctreeEntry> objectsToRedistribute;
+    objectsToRedistribute.swap(objects);
 
-    // Try to insert each object into children
-    for (GameObject* obj : objectsToRedistribute)
+    for (const OctreeEntry& entry : objectsToRedistribute)
     {
-        bool added = false;
-
-        // Try to add to children
-        for (int i = 0; i < 8; ++i)
-        {
-            if (children[i] != nullptr && children[i]->Insert(obj))
-            {
-                added = true;
-                break; // Object added to a child
-            }
-        }
+        int childIndex = GetChildIndexFor(entry.box);
 
         // If object doesn't fit in any child, keep it in this node
-        if (!added)
-        {
-            objects.push_back(obj);
-        }
+        if (childIndex != -1)
+            children[childIndex]->Insert(entry);
+        else
+            objects.push_back(entry);
     }
 }
 
@@ -397,22 +329,72 @@ void Octree::Clear()
         delete root;
         root = nullptr;
     }
+
+    outside.clear();
+    registered.clear();
+}
+
+bool Octree::GetObjectWorldAABB(GameObject* obj, AABB& outBox)
+{
+    if (obj == nullptr || obj->transform == nullptr)
+        return false;
+
+    ComponentMesh* mesh = static_cast<ComponentMesh*>(obj->GetComponent(ComponentType::MESH));
+
+    if (!mesh || !mesh->HasMesh())
+        return false;
+
+    // Transform the local AABB to world space
+    outBox = mesh->GetAABB().GetGlobalAABB(obj->transform->GetGlobalMatrix());
+    return true;
 }
 
 bool Octree::Insert(GameObject* obj)
 {
-    if (root == nullptr)
+    if (root == nullptr || obj == nullptr)
         return false;
 
-    return root->Insert(obj);
+    // Re-inserting an object moves it, so drop the stale entry first
+    Remove(obj);
+
+    AABB worldBox;
+    if (!GetObjectWorldAABB(obj, worldBox))
+        return false;
+
+    OctreeEntry entry = { obj, worldBox };
+
+    if (root->Contains(worldBox))
+        root->Insert(entry);
+    else
+        outside.push_back(entry);
+
+    registered[obj] = worldBox;
+    return true;
 }
 
 bool Octree::Remove(GameObject* obj)
 {
-    if (root == nullptr)
+    auto it = registered.find(obj);
+    if (it == registered.end())
         return false;
 
-    return root->Remove(obj);
+    const AABB worldBox = it->second;
+    registered.erase(it);
+
+    if (root != nullptr && root->Contains(worldBox))
+        return root->Remove(obj, worldBox);
+
+    for (size_t i = 0; i < outside.size(); ++i)
+    {
+        if (outside[i].object == obj)
+        {
+            outside[i] = outside.back();
+            outside.pop_back();
+            return true;
+        }
+    }
+
+    return false;
 }
 
 void Octree::DebugDraw() const
@@ -425,18 +407,38 @@ void Octree::DebugDraw() const
 
 GameObject* Octree::RayPick(const Ray& ray, float& outDistance) const
 {
-    if (root == nullptr)
-        return nullptr;
+    GameObject* closestObject = nullptr;
+    float closestDistance = std::numeric_limits<float>::max();
+
+    if (root != nullptr)
+    {
+        closestObject = root->RayPick(ray, closestDistance);
+    }
+
+    for (const OctreeEntry& entry : outside)
+    {
+        if (!entry.object->IsActive()) continue;
+
+        float objDistance;
+        if (RayIntersectsAABB(ray.origin, ray.direction, entry.box.min, entry.box.max, objDistance) && objDistance < closestDistance)
+        {
+            closestDistance = objDistance;
+            closestObject = entry.object;
+        }
+    }
 
-    return root->RayPick(ray, outDistance);
+    outDistance = closestDistance;
+    return closestObject;
 }
 
 int Octree::GetTotalObjectCount() const
 {
+    int count = static_cast<int>(outside.size());
+
     if (root == nullptr)
-        return 0;
+        return count;
 
-    int count = root->GetObjectCount();
+    count += root->GetObjectCount();
 
     std::function<void(const OctreeNode*)> countRecursive = [&](const OctreeNode* node) {
         if (node->HasChildren())
@@ -494,21 +496,17 @@ GameObject* OctreeNode::RayPick(const Ray& ray, float& outDistance) const
     float closestDistance = std::numeric_limits<float>::max();
 
     // Check objects in this node
-    for (GameObject* obj : objects)
+    for (const OctreeEntry& entry : objects)
     {
-        if (!obj || !obj->IsActive()) continue;
+        if (!entry.object || !entry.object->IsActive()) continue;
 
-        glm::vec3 worldMin, worldMax;
-        if (GetObjectWorldAABB(obj, worldMin, worldMax))
+        float objDistance;
+        if (RayIntersectsAABB(ray.origin, ray.direction, entry.box.min, entry.box.max, objDistance))
         {
-            float objDistance;
-            if (RayIntersectsAABB(ray.origin, ray.direction, worldMin, worldMax, objDistance))
+            if (objDistance < closestDistance)
             {
-                if (objDistance < closestDistance)
-                {
-                    closestDistance = objDistance;
-                    closestObject = obj;
-                }
+                closestDistance = objDistance;
+                closestObject = entry.object;
             }
         }
     }
@@ -2,6 +2,7 @@
 
 #include <glm/glm.hpp>
 #include <vector>
+#include <unordered_map>
 #include "AABB.h"
 
 class GameObject;
@@ -15,6 +16,14 @@ struct Ray
     Ray(const glm::vec3& o, const glm::vec3& d) : origin(o), direction(d) {}
 };
 
+// Object stored in the tree together with the world AABB it was inserted with.
+// Keeping the box here means queries never touch the Transform/Mesh components.
+struct OctreeEntry
+{
+    GameObject* object;
+    AABB box;
+};
+
 class OctreeNode
 {
 public:
@@ -22,8 +31,8 @@ public:
     ~OctreeNode();
 
     void Clear();
-    bool Insert(GameObject* obj);
-    bool Remove(GameObject* obj);
+    void Insert(const OctreeEntry& entry);
+    bool Remove(GameObject* obj, const AABB& box);
 
     template<typename TYPE>
     void CollectIntersections(std::vector<GameObject*>& objects, const TYPE& primitive) const;
@@ -37,23 +46,29 @@ public:
     void DebugDraw() const;
     const AABB& GetAABB() const { return box; }
 
+    bool Contains(const AABB& other) const;
+
 private:
     void Subdivide();
     void RedistributeObjects();
     void CollapseIfPossible(); // Collapse node if it has few objects
     bool IsLeaf() const { return children[0] == nullptr; }
 
-    // Helper to get world-space AABB of a GameObject
-    static bool GetObjectWorldAABB(GameObject* obj, glm::vec3& outMin, glm::vec3& outMax);
+    // Child that fully contains the box, or -1 if it straddles a split plane
+    int GetChildIndexFor(const AABB& other) const;
+
+    void CollectAll(std::vector<GameObject*>& objects_out) const;
+    int CountObjectsRecursive() const;
+    void MoveObjectsTo(std::vector<OctreeEntry>& out);
 
     // Grant Octree access to private members for counting
     friend class Octree;
 
 private:
-    
+
     AABB box;
 
-    std::vector<GameObject*> objects;
+    std::vector<OctreeEntry> objects;
     OctreeNode* children[8];  // 8 children for octree
 
     int max_objects;    // Max objects before subdividing
@@ -61,6 +76,9 @@ private:
     int current_depth;  // Current depth level
 };
 
+// Every object lives in exactly one node: the deepest one that fully contains its
+// world AABB. Objects that do not fit in the root bounds go to an overflow list
+// that is always tested, so the tree never silently drops geometry.
 class Octree
 {
 public:
@@ -70,8 +88,11 @@ public:
 
     void Create(const glm::vec3& min, const glm::vec3& max, int maxObjects = 4, int maxDepth = 5);
     void Clear();
+
+    // Insert or move an object. Uses the mesh AABB in world space.
     bool Insert(GameObject* obj);
     bool Remove(GameObject* obj);
+    bool Contains(GameObject* obj) const { return registered.find(obj) != registered.end(); }
 
     template<typename TYPE>
     void CollectIntersections(std::vector<GameObject*>& objects, const TYPE& primitive) const;
@@ -86,8 +107,14 @@ public:
     // Debug
     void DebugDraw() const;
 
+    // Helper to get world-space AABB of a GameObject
+    static bool GetObjectWorldAABB(GameObject* obj, AABB& outBox);
+
 private:
     OctreeNode* root;
+
+    std::vector<OctreeEntry> outside;
+    std::unordered_map<GameObject*, AABB> registered;
 };
 
 
@@ -102,15 +129,25 @@ void OctreeNode::CollectIntersections(std::vector<GameObject*>& objects_out, con
 template<>
 inline void OctreeNode::CollectIntersections(std::vector<GameObject*>& objects_out, const Frustum& frustum) const
 {
-    if (frustum.InFrustum(box))
+    switch (frustum.Classify(box))
     {
+    case Frustum::OUTSIDE:
         return; // Node completely outside frustum, skip
+
+    case Frustum::INSIDE:
+        CollectAll(objects_out); // Whole subtree visible, no more plane tests
+        return;
+
+    default:
+        break;
     }
 
-    // Add all objects in this node
-    for (GameObject* obj : objects)
+    for (const OctreeEntry& entry : objects)
     {
-        objects_out.push_back(obj);
+        if (frustum.InFrustum(entry.box))
+        {
+            objects_out.push_back(entry.object);
+        }
     }
 
     // Check children recursively
@@ -133,4 +170,21 @@ void Octree::CollectIntersections(std::vector<GameObject*>& objects, const TYPE&
     {
         root->CollectIntersections(objects, primitive);
     }
-}
\ No newline at end of file
+}
+
+template<>
+inline void Octree::CollectIntersections(std::vector<GameObject*>& objects, const Frustum& frustum) const
+{
+    if (root != nullptr)
+    {
+        root->CollectIntersections(objects, frustum);
+    }
+
+    for (const OctreeEntry& entry : outside)
+    {
+        if (frustum.InFrustum(entry.box))
+        {
+            objects.push_back(entry.object);
+        }
+    }
+}
@@ -0,0 +1,256 @@
+#include "ParticleRenderer.h"
+#include "ParticleSystem.h"
+#include "ShaderParticle.h"
+#include "FrameRingBuffer.h"
+#include "Renderer.h"
+#include "Log.h"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstddef>
+
+ParticleRenderer::ParticleRenderer()
+{
+}
+
+ParticleRenderer::~ParticleRenderer()
+{
+}
+
+bool ParticleRenderer::Init()
+{
+    shader = std::make_unique<ShaderParticle>();
+    if (!shader->CreateShader())
+    {
+        LOG_DEBUG("ERROR: Failed to create particle shader");
+        LOG_CONSOLE("ERROR: Failed to compile particle shader");
+        return false;
+    }
+
+    textureUniform = shader->GetUniform<int>("particleTexture");
+    hasTextureUniform = shader->GetUniform<bool>("hasTexture");
+
+    // Only per-instance attributes, the buffer and offset are set on every flush
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+    for (GLuint attribute = 0; attribute < 4; ++attribute)
+    {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribDivisor(attribute, 1);
+    }
+    glBindVertexArray(0);
+
+    instances.reserve(4096);
+    entries.reserve(4096);
+    scratch.reserve(4096);
+
+    return true;
+}
+
+void ParticleRenderer::CleanUp()
+{
+    if (VAO != 0)
+    {
+        glDeleteVertexArrays(1, &VAO);
+        VAO = 0;
+    }
+
+    if (shader)
+    {
+        shader->Delete();
+        shader.reset();
+    }
+}
+
+void ParticleRenderer::Begin(const glm::vec3& position)
+{
+    cameraPosition = position;
+    instances.clear();
+    entries.clear();
+    textures.clear();
+}
+
+uint32_t ParticleRenderer::GetTextureSlot(unsigned int textureID)
+{
+    // A handful of textures per frame, a linear search is enough
+    for (size_t i = 0; i < textures.size(); ++i)
+    {
+        if (textures[i] == textureID) return (uint32_t)i;
+    }
+
+    textures.push_back(textureID);
+    return (uint32_t)(textures.size() - 1);
+}
+
+void ParticleRenderer::AddEmitter(const EmitterInstance& emitter, const glm::mat4& modelMatrix)
+{
+    const ParticlePool& pool = emitter.particles;
+    if (pool.Empty()) return;
+
+    BlendMode blend = BlendMode::ALPHA;
+    if (emitter.luminanceBlending) blend = BlendMode::LUMINANCE;
+    else if (emitter.additiveBlending) blend = BlendMode::ADDITIVE;
+
+    // Blend mode (2 bits) -> texture slot (30) -> back to front depth (32)
+    uint64_t groupKey = ((uint64_t)blend << 62) | ((uint64_t)(GetTextureSlot(emitter.textureID) & 0x3FFFFFFF) << 32);
+
+    // LOCAL particles are moved to world space here so every emitter shares one draw
+    bool local = emitter.simulationSpace == SimulationSpace::LOCAL;
+    float scale = 1.0f;
+    if (local)
+    {
+        scale = std::max(glm::length(glm::vec3(modelMatrix[0])),
+            std::max(glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2]))));
+    }
+
+    // Animation frame sizes
+    int totalFrames = emitter.textureRows * emitter.textureCols;
+    float frameWidth = 1.0f / (float)emitter.textureCols;
+    float frameHeight = 1.0f / (float)emitter.textureRows;
+
+    const size_t count = pool.Size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        glm::vec3 position = pool.GetPosition(i);
+
+        ParticleInstance instance;
+        instance.position = local ? glm::vec3(modelMatrix * glm::vec4(position, 1.0f)) : position;
+        instance.size = pool.size[i] * scale;
+        instance.color = pool.color[i];
+        instance.rotation = glm::radians(pool.rotation[i]);
+
+        // UV animation
+        int currentFrame = 0;
+        if (totalFrames > 1)
+        {
+            float animationTime = pool.lifeRatio[i] * emitter.animationSpeed;
+            currentFrame = (int)(animationTime * totalFrames);
+            if (emitter.animLoop) currentFrame %= totalFrames;
+            else if (currentFrame >= totalFrames) currentFrame = totalFrames - 1;
+        }
+
+        int col = currentFrame % emitter.textureCols;
+        int row = currentFrame / emitter.textureCols;
+
+        float uLeft = col * frameWidth;
+        float vTop = 1.0f - (row * frameHeight);
+        instance.uvRect = glm::vec4(uLeft, vTop - frameHeight, uLeft + frameWidth, vTop);
+
+        // Additive blending does not depend on order, leave the depth bits equal
+        uint32_t depthBits = 0;
+        if (blend != BlendMode::ADDITIVE)
+        {
+            glm::vec3 toCamera = instance.position - cameraPosition;
+            depthBits = 0xFFFFFFFFu - RenderQueue::DepthToBits(glm::dot(toCamera, toCamera));
+        }
+
+        entries.push_back({ groupKey | depthBits, (uint32_t)instances.size() });
+        instances.push_back(instance);
+    }
+}
+
+void ParticleRenderer::ApplyBlendMode(BlendMode mode) const
+{
+    switch (mode)
+    {
+    case BlendMode::LUMINANCE:
+        glBlendFunc(GL_SRC_COLOR, GL_ONE_MINUS_SRC_COLOR);
+        break;
+    case BlendMode::ADDITIVE:
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE); // Glow/fire/sparks
+        break;
+    default:
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        break;
+    }
+}
+
+void ParticleRenderer::Flush(FrameRingBuffer& frameRing, RenderStats& stats)
+{
+    if (instances.empty() || !shader) return;
+
+    RenderQueue::SortEntries(entries, scratch);
+
+    // Instances are written in sorted order, so each group is a contiguous range
+    const size_t count = entries.size();
+    FrameRingAllocation allocation;
+    ParticleInstance* data = (ParticleInstance*)frameRing.Allocate(count * sizeof(ParticleInstance), sizeof(glm::vec4), allocation);
+    if (!data) return;
+
+    for (size_t i = 0; i < count; ++i)
+        data[i] = instances[entries[i].index];
+    stats.bufferUploads++;
+
+    glEnable(GL_BLEND);
+    glDepthMask(GL_FALSE);
+    glDisable(GL_CULL_FACE);
+
+    shader->Use();
+    stats.programBinds++;
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, allocation.buffer);
+
+    const GLsizei stride = (GLsizei)sizeof(ParticleInstance);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride, (void*)(allocation.offset + offsetof(ParticleInstance, position)));
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (void*)(allocation.offset + offsetof(ParticleInstance, color)));
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (void*)(allocation.offset + offsetof(ParticleInstance, uvRect)));
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, (void*)(allocation.offset + offsetof(ParticleInstance, rotation)));
+
+    glActiveTexture(GL_TEXTURE0);
+    shader->Set(textureUniform, 0);
+
+    unsigned int boundTexture = 0;
+    bool hasTexture = false;
+    shader->Set(hasTextureUniform, false);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    uint32_t currentBlend = 0xFFFFFFFFu;
+
+    size_t first = 0;
+    while (first < count)
+    {
+        uint32_t group = (uint32_t)(entries[first].key >> 32);
+        size_t end = first + 1;
+        while (end < count && (uint32_t)(entries[end].key >> 32) == group)
+            ++end;
+
+        uint32_t blend = group >> 30;
+        if (blend != currentBlend)
+        {
+            ApplyBlendMode((BlendMode)blend);
+            currentBlend = blend;
+        }
+
+        unsigned int textureID = textures[group & 0x3FFFFFFF];
+        if (textureID != boundTexture)
+        {
+            glBindTexture(GL_TEXTURE_2D, textureID);
+            boundTexture = textureID;
+            stats.textureBinds++;
+        }
+        if ((textureID != 0) != hasTexture)
+        {
+            hasTexture = textureID != 0;
+            shader->Set(hasTextureUniform, hasTexture);
+        }
+
+        GLsizei groupSize = (GLsizei)(end - first);
+        glDrawArraysInstancedBaseInstance(GL_TRIANGLE_STRIP, 0, 4, groupSize, (GLuint)first);
+        stats.drawCalls++;
+        stats.instancedDrawCalls++;
+        stats.particles += groupSize;
+
+        first = end;
+    }
+
+    // Restore state
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+    glEnable(GL_CULL_FACE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    glUseProgram(0);
+}
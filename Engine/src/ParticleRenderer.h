@@ -0,0 +1,73 @@
+#pragma once
+
+#include "RenderQueue.h"
+#include "Shader.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct EmitterInstance;
+struct RenderStats;
+class FrameRingBuffer;
+class ShaderParticle;
+
+// Collects the particles of every visible emitter for one camera and draws them as
+// instanced quads, one draw per blend mode / texture group.
+class ParticleRenderer
+{
+public:
+    ParticleRenderer();
+    ~ParticleRenderer();
+
+    bool Init();
+    void CleanUp();
+
+    // Starts a new list for a camera
+    void Begin(const glm::vec3& cameraPosition);
+
+    // Appends the live particles of an emitter. modelMatrix is only applied to
+    // LOCAL simulation space emitters.
+    void AddEmitter(const EmitterInstance& emitter, const glm::mat4& modelMatrix);
+
+    // Sorts, streams the instances into the frame ring and submits every group
+    void Flush(FrameRingBuffer& frameRing, RenderStats& stats);
+
+    size_t GetParticleCount() const { return instances.size(); }
+
+private:
+    // Layout of the per-instance vertex attributes
+    struct ParticleInstance
+    {
+        glm::vec3 position;
+        float size;
+        glm::vec4 color;
+        glm::vec4 uvRect;       // uLeft, vBottom, uRight, vTop
+        float rotation;         // radians
+    };
+
+    // Blend modes in submission order: sorted modes first, additive last
+    enum class BlendMode : uint32_t
+    {
+        ALPHA = 0,
+        LUMINANCE = 1,
+        ADDITIVE = 2
+    };
+
+    // Groups textures of this frame into small slots for the sort key
+    uint32_t GetTextureSlot(unsigned int textureID);
+    void ApplyBlendMode(BlendMode mode) const;
+
+    std::unique_ptr<ShaderParticle> shader;
+    UniformHandle<int> textureUniform;
+    UniformHandle<bool> hasTextureUniform;
+    unsigned int VAO = 0;
+
+    glm::vec3 cameraPosition = glm::vec3(0.0f);
+
+    // Scratch storage reused between frames
+    std::vector<ParticleInstance> instances;
+    std::vector<RenderQueue::SortEntry> entries;
+    std::vector<RenderQueue::SortEntry> scratch;
+    std::vector<unsigned int> textures;
+};
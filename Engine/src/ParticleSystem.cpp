@@ -1,16 +1,50 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include "ParticleSystem.h"
-#include <glad/glad.h>
 #include <algorithm>
-#include <cstdlib>
+#include <atomic>
+#include <cmath>
 #include <glm/gtx/vector_angle.hpp>
 
-// Helper for random numbers
-float RandomFloat(float min, float max) {
-    if (max - min < 0.0001f) return min; // Avoid division by zero
-    return min + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (max - min)));
+#if defined(_M_X64) || defined(__SSE2__)
+#define PARTICLES_SSE 1
+#include <immintrin.h>
+#endif
+
+static inline uint32_t RotateLeft(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+void ParticleRandom::Seed(uint32_t seed) {
+    // splitmix32 spreads the seed over the whole state, which must not be all zero
+    for (int i = 0; i < 4; ++i) {
+        seed += 0x9E3779B9u;
+        uint32_t z = seed;
+        z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+        z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+        state[i] = z ^ (z >> 16);
+    }
+    if ((state[0] | state[1] | state[2] | state[3]) == 0) state[0] = 1;
 }
 
+uint32_t ParticleRandom::Next() {
+    const uint32_t result = RotateLeft(state[1] * 5, 7) * 9;
+    const uint32_t t = state[1] << 9;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = RotateLeft(state[3], 11);
+
+    return result;
+}
+
+bool EmitterInstance::simdKernels = true;
+
+// Every new emitter starts from a different seed
+static std::atomic<uint32_t> nextEmitterSeed{ 1 };
+
 void ModuleEmitterSpawn::ResetDefaults() {
     // Reset to default paremeters
     lifetimeMin = 1.0f; lifetimeMax = 2.0f;
@@ -37,30 +71,29 @@ void ModuleEmitterSpawn::ResetDefaults() {
 
 // Creation of the particle
 void ModuleEmitterSpawn::Spawn(EmitterInstance* emitter, Particle* particle) {
-    particle->active = true;
-    float speed = RandomFloat(speedMin, speedMax);
+    float speed = emitter->random.Range(speedMin, speedMax);
     glm::vec3 offset(0.0f);
     glm::vec3 dir(0, 1, 0); // Default direction is up
 
     if (shape == EmitterShape::BOX) {
         // Random point inside a box
         offset = glm::vec3(
-            RandomFloat(-emissionArea.x, emissionArea.x),
-            RandomFloat(-emissionArea.y, emissionArea.y),
-            RandomFloat(-emissionArea.z, emissionArea.z)
+            emitter->random.Range(-emissionArea.x, emissionArea.x),
+            emitter->random.Range(-emissionArea.y, emissionArea.y),
+            emitter->random.Range(-emissionArea.z, emissionArea.z)
         );
         // Direction up with variation
-        dir = glm::vec3(RandomFloat(-0.2f, 0.2f), 1.0f, RandomFloat(-0.2f, 0.2f));
+        dir = glm::vec3(emitter->random.Range(-0.2f, 0.2f), 1.0f, emitter->random.Range(-0.2f, 0.2f));
     }
     else if (shape == EmitterShape::SPHERE) {
         // Sphere: Random point in unit vector
-        glm::vec3 randomDir = glm::vec3(RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f));
+        glm::vec3 randomDir = glm::vec3(emitter->random.Range(-1.0f, 1.0f), emitter->random.Range(-1.0f, 1.0f), emitter->random.Range(-1.0f, 1.0f));
         if (glm::length(randomDir) > 0.01f) randomDir = glm::normalize(randomDir);
         else randomDir = glm::vec3(0, 1, 0);
 
         float r = emissionRadius;
         // If not Shell, randomize radius to fill the volume
-        if (!emitFromShell) r *= std::cbrt(RandomFloat(0.0f, 1.0f));
+        if (!emitFromShell) r *= std::cbrt(emitter->random.Range(0.0f, 1.0f));
 
         offset = randomDir * r;
         dir = randomDir; // Explosion outwards
@@ -69,10 +102,10 @@ void ModuleEmitterSpawn::Spawn(EmitterInstance* emitter, Particle* particle) {
         // Cone: Advanced trigonometric logic
         float angleRad = glm::radians(coneAngle);
         float r = coneRadius;
-        if (!emitFromShell) r *= sqrt(RandomFloat(0.0f, 1.0f));
+        if (!emitFromShell) r *= sqrt(emitter->random.Range(0.0f, 1.0f));
 
         // Random polar angle (around Y circle)
-        float theta = RandomFloat(0.0f, glm::two_pi<float>());
+        float theta = emitter->random.Range(0.0f, glm::two_pi<float>());
 
         // Position at the cone base
         float x = r * cos(theta);
@@ -84,7 +117,7 @@ void ModuleEmitterSpawn::Spawn(EmitterInstance* emitter, Particle* particle) {
         if (glm::length(baseDir) < 0.01f) baseDir = glm::vec3(1, 0, 0);
 
         // Rotate UP vector towards the cone edge by a random amount
-        float tiltAngle = RandomFloat(0.0f, angleRad);
+        float tiltAngle = emitter->random.Range(0.0f, angleRad);
 
         // Rotation axis: perpendicular to base direction and UP
         glm::vec3 rotationAxis = glm::cross(glm::vec3(0, 1, 0), baseDir);
@@ -94,9 +127,9 @@ void ModuleEmitterSpawn::Spawn(EmitterInstance* emitter, Particle* particle) {
     }
     else if (shape == EmitterShape::CIRCLE) {
         // Circle: Plane on the ground (XZ)
-        float theta = RandomFloat(0.0f, glm::two_pi<float>());
+        float theta = emitter->random.Range(0.0f, glm::two_pi<float>());
         float r = circleRadius;
-        if (!emitFromShell) r *= sqrt(RandomFloat(0.0f, 1.0f));
+        if (!emitFromShell) r *= sqrt(emitter->random.Range(0.0f, 1.0f));
 
         offset = glm::vec3(r * cos(theta), 0.0f, r * sin(theta));
         dir = glm::vec3(0, 1, 0); // Goes straight up like a column or portal
@@ -114,43 +147,168 @@ void ModuleEmitterSpawn::Spawn(EmitterInstance* emitter, Particle* particle) {
     particle->velocity = glm::normalize(dir) * speed;
 
     // Initialize Properties
-    particle->lifetime = RandomFloat(lifetimeMin, lifetimeMax);
+    particle->lifetime = emitter->random.Range(lifetimeMin, lifetimeMax);
     particle->maxLifetime = particle->lifetime;
 
-    // Start and End values
-    particle->sizeStart = sizeStart;
-    particle->sizeEnd = sizeEnd;
+    // Over-life values come from the lookup tables, start at t = 0
     particle->size = sizeStart;
+    particle->color = colorGradient.empty() ? colorStart : colorGradient.front().color;
+
+    // Spin
+    particle->rotation = emitter->random.Range(0.0f, 360.0f);
+    particle->angularVelocity = emitter->random.Range(rotationSpeedMin, rotationSpeedMax);
+}
 
-    // Color (Gradient or Simple Interpolation)
-    if (!colorGradient.empty()) {
-        particle->colorStart = colorGradient.front().color;
-        particle->colorEnd = colorGradient.back().color;
-        particle->color = particle->colorStart;
+int ModuleEmitterSpawn::LutIndex(float lifeRatio) {
+    int index = (int)(lifeRatio * (float)(LUT_SIZE - 1) + 0.5f);
+    if (index < 0) return 0;
+    if (index >= LUT_SIZE) return LUT_SIZE - 1;
+    return index;
+}
+
+void ModuleEmitterSpawn::UpdateLookupTables() {
+    // The inspector, scripts and scene loading edit the settings directly, so compare
+    // against the last bake instead of tracking every write
+    bool colorChanged = !lutBaked || bakedColorStart != colorStart || bakedColorEnd != colorEnd
+        || bakedColorGradient.size() != colorGradient.size();
+    for (size_t i = 0; !colorChanged && i < colorGradient.size(); ++i)
+        colorChanged = bakedColorGradient[i].time != colorGradient[i].time || bakedColorGradient[i].color != colorGradient[i].color;
+
+    bool sizeChanged = !lutBaked || bakedSizeStart != sizeStart || bakedSizeEnd != sizeEnd
+        || bakedSizeCurve.size() != sizeCurve.size();
+    for (size_t i = 0; !sizeChanged && i < sizeCurve.size(); ++i)
+        sizeChanged = bakedSizeCurve[i].time != sizeCurve[i].time || bakedSizeCurve[i].size != sizeCurve[i].size;
+
+    if (colorChanged) {
+        for (int i = 0; i < LUT_SIZE; ++i) {
+            float t = (float)i / (float)(LUT_SIZE - 1);
+            colorLUT[i] = colorGradient.empty() ? glm::mix(colorStart, colorEnd, t)
+                : EmitterInstance::EvaluateGradient(t, colorGradient);
+        }
+        bakedColorStart = colorStart;
+        bakedColorEnd = colorEnd;
+        bakedColorGradient = colorGradient;
     }
-    else {
-        particle->colorStart = colorStart;
-        particle->colorEnd = colorEnd;
-        particle->color = colorStart;
+
+    if (sizeChanged) {
+        for (int i = 0; i < LUT_SIZE; ++i)
+            sizeLUT[i] = EmitterInstance::EvaluateSizeCurve((float)i / (float)(LUT_SIZE - 1), this);
+        bakedSizeStart = sizeStart;
+        bakedSizeEnd = sizeEnd;
+        bakedSizeCurve = sizeCurve;
     }
 
-    // Spin
-    particle->rotation = RandomFloat(0.0f, 360.0f);
-    particle->angularVelocity = RandomFloat(rotationSpeedMin, rotationSpeedMax);
+    lutBaked = true;
+}
 
-    // Animation
-    particle->animationTime = 0.0f;
+// Polynomial sine shared by the scalar and SIMD noise paths so both give the same result.
+// Range reduced to [-pi, pi], folded to [-pi/2, pi/2], then a 7th order Taylor series.
+static const float PARTICLE_PI = 3.14159265f;
+static const float PARTICLE_TWO_PI = 6.28318531f;
+static const float PARTICLE_INV_TWO_PI = 0.15915494f;
+
+static inline float FastSin(float x) {
+    x -= PARTICLE_TWO_PI * std::floor(x * PARTICLE_INV_TWO_PI + 0.5f);
+    float sign = x < 0.0f ? -1.0f : 1.0f;
+    float ax = std::fabs(x);
+    float y = std::min(ax, PARTICLE_PI - ax);
+    float y2 = y * y;
+    return sign * y * (1.0f + y2 * (-1.0f / 6.0f + y2 * (1.0f / 120.0f + y2 * (-1.0f / 5040.0f))));
 }
 
+#if PARTICLES_SSE
+static inline __m128 FastSin4(__m128 x) {
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+
+    // Round to nearest with floor(v + 0.5) so it matches the scalar path
+    __m128 v = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(PARTICLE_INV_TWO_PI)), _mm_set1_ps(0.5f));
+    __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+    __m128 k = _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, v), _mm_set1_ps(1.0f)));
+    x = _mm_sub_ps(x, _mm_mul_ps(k, _mm_set1_ps(PARTICLE_TWO_PI)));
+
+    __m128 sign = _mm_and_ps(x, signMask);
+    __m128 ax = _mm_andnot_ps(signMask, x);
+    __m128 y = _mm_min_ps(ax, _mm_sub_ps(_mm_set1_ps(PARTICLE_PI), ax));
+    __m128 y2 = _mm_mul_ps(y, y);
+
+    __m128 p = _mm_set1_ps(-1.0f / 5040.0f);
+    p = _mm_add_ps(_mm_mul_ps(p, y2), _mm_set1_ps(1.0f / 120.0f));
+    p = _mm_add_ps(_mm_mul_ps(p, y2), _mm_set1_ps(-1.0f / 6.0f));
+    p = _mm_add_ps(_mm_mul_ps(p, y2), _mm_set1_ps(1.0f));
+    return _mm_or_ps(_mm_mul_ps(y, p), sign);
+}
+#endif
+
+#if defined(__AVX__)
+static inline __m256 FastSin8(__m256 x) {
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+    __m256 k = _mm256_floor_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(PARTICLE_INV_TWO_PI)), _mm256_set1_ps(0.5f)));
+    x = _mm256_sub_ps(x, _mm256_mul_ps(k, _mm256_set1_ps(PARTICLE_TWO_PI)));
+
+    __m256 sign = _mm256_and_ps(x, signMask);
+    __m256 ax = _mm256_andnot_ps(signMask, x);
+    __m256 y = _mm256_min_ps(ax, _mm256_sub_ps(_mm256_set1_ps(PARTICLE_PI), ax));
+    __m256 y2 = _mm256_mul_ps(y, y);
+
+    __m256 p = _mm256_set1_ps(-1.0f / 5040.0f);
+    p = _mm256_add_ps(_mm256_mul_ps(p, y2), _mm256_set1_ps(1.0f / 120.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, y2), _mm256_set1_ps(-1.0f / 6.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, y2), _mm256_set1_ps(1.0f));
+    return _mm256_or_ps(_mm256_mul_ps(y, p), sign);
+}
+#endif
+
 void ModuleEmitterMovement::ResetDefaults() {
     gravity = glm::vec3(0.0f, -1.0f, 0.0f);
 }
 
 void ModuleEmitterMovement::Update(EmitterInstance* emitter, float dt) {
-    for (auto& p : emitter->particles) {
-        if (!p.active) continue;
-        p.velocity += gravity * dt;
-        p.position += p.velocity * dt;
+    ParticlePool& pool = emitter->particles;
+    const size_t count = pool.Size();
+    float* posX = pool.posX.data(); float* posY = pool.posY.data(); float* posZ = pool.posZ.data();
+    float* velX = pool.velX.data(); float* velY = pool.velY.data(); float* velZ = pool.velZ.data();
+    size_t i = 0;
+
+#if defined(__AVX__)
+    if (EmitterInstance::simdKernels) {
+        const __m256 gx = _mm256_set1_ps(gravity.x * dt), gy = _mm256_set1_ps(gravity.y * dt), gz = _mm256_set1_ps(gravity.z * dt);
+        const __m256 step = _mm256_set1_ps(dt);
+        for (; i + 8 <= count; i += 8) {
+            __m256 vx = _mm256_add_ps(_mm256_loadu_ps(velX + i), gx);
+            __m256 vy = _mm256_add_ps(_mm256_loadu_ps(velY + i), gy);
+            __m256 vz = _mm256_add_ps(_mm256_loadu_ps(velZ + i), gz);
+            _mm256_storeu_ps(velX + i, vx);
+            _mm256_storeu_ps(velY + i, vy);
+            _mm256_storeu_ps(velZ + i, vz);
+            _mm256_storeu_ps(posX + i, _mm256_add_ps(_mm256_loadu_ps(posX + i), _mm256_mul_ps(vx, step)));
+            _mm256_storeu_ps(posY + i, _mm256_add_ps(_mm256_loadu_ps(posY + i), _mm256_mul_ps(vy, step)));
+            _mm256_storeu_ps(posZ + i, _mm256_add_ps(_mm256_loadu_ps(posZ + i), _mm256_mul_ps(vz, step)));
+        }
+    }
+#endif
+#if PARTICLES_SSE
+    if (EmitterInstance::simdKernels) {
+        const __m128 gx = _mm_set1_ps(gravity.x * dt), gy = _mm_set1_ps(gravity.y * dt), gz = _mm_set1_ps(gravity.z * dt);
+        const __m128 step = _mm_set1_ps(dt);
+        for (; i + 4 <= count; i += 4) {
+            __m128 vx = _mm_add_ps(_mm_loadu_ps(velX + i), gx);
+            __m128 vy = _mm_add_ps(_mm_loadu_ps(velY + i), gy);
+            __m128 vz = _mm_add_ps(_mm_loadu_ps(velZ + i), gz);
+            _mm_storeu_ps(velX + i, vx);
+            _mm_storeu_ps(velY + i, vy);
+            _mm_storeu_ps(velZ + i, vz);
+            _mm_storeu_ps(posX + i, _mm_add_ps(_mm_loadu_ps(posX + i), _mm_mul_ps(vx, step)));
+            _mm_storeu_ps(posY + i, _mm_add_ps(_mm_loadu_ps(posY + i), _mm_mul_ps(vy, step)));
+            _mm_storeu_ps(posZ + i, _mm_add_ps(_mm_loadu_ps(posZ + i), _mm_mul_ps(vz, step)));
+        }
+    }
+#endif
+
+    // Remainder
+    for (; i < count; ++i) {
+        velX[i] += gravity.x * dt; velY[i] += gravity.y * dt; velZ[i] += gravity.z * dt;
+        posX[i] += velX[i] * dt; posY[i] += velY[i] * dt; posZ[i] += velZ[i] * dt;
     }
 }
 
@@ -163,23 +321,131 @@ void ModuleEmitterNoise::ResetDefaults() {
 void ModuleEmitterNoise::Update(EmitterInstance* emitter, float dt) {
     if (!active) return;
 
-    for (auto& p : emitter->particles) {
-        if (!p.active) continue;
+    // Turbulence simulation using trigonometric functions (faster than Perlin)
+    // x: sin(arg), y: cos(arg * 0.7) with half the impact, z: sin(arg * 1.3)
+    ParticlePool& pool = emitter->particles;
+    const size_t count = pool.Size();
+    float* posX = pool.posX.data(); float* posY = pool.posY.data(); float* posZ = pool.posZ.data();
+    const float* lifetime = pool.lifetime.data();
+    const float* maxLifetime = pool.maxLifetime.data();
+    const float amount = strength * dt;
+    const float halfPi = PARTICLE_PI * 0.5f;
+    size_t i = 0;
+
+#if defined(__AVX__)
+    if (EmitterInstance::simdKernels) {
+        const __m256 half = _mm256_set1_ps(0.5f), freq = _mm256_set1_ps(frequency);
+        const __m256 amountV = _mm256_set1_ps(amount), amountY = _mm256_set1_ps(amount * 0.5f);
+        for (; i + 8 <= count; i += 8) {
+            __m256 px = _mm256_loadu_ps(posX + i), pz = _mm256_loadu_ps(posZ + i);
+            __m256 lived = _mm256_sub_ps(_mm256_loadu_ps(maxLifetime + i), _mm256_loadu_ps(lifetime + i));
+            __m256 arg = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(px, pz), half), lived), freq);
+
+            __m256 nx = FastSin8(arg);
+            __m256 ny = FastSin8(_mm256_add_ps(_mm256_mul_ps(arg, _mm256_set1_ps(0.7f)), _mm256_set1_ps(halfPi)));
+            __m256 nz = FastSin8(_mm256_mul_ps(arg, _mm256_set1_ps(1.3f)));
+
+            _mm256_storeu_ps(posX + i, _mm256_add_ps(px, _mm256_mul_ps(nx, amountV)));
+            _mm256_storeu_ps(posY + i, _mm256_add_ps(_mm256_loadu_ps(posY + i), _mm256_mul_ps(ny, amountY)));
+            _mm256_storeu_ps(posZ + i, _mm256_add_ps(pz, _mm256_mul_ps(nz, amountV)));
+        }
+    }
+#endif
+#if PARTICLES_SSE
+    if (EmitterInstance::simdKernels) {
+        const __m128 half = _mm_set1_ps(0.5f), freq = _mm_set1_ps(frequency);
+        const __m128 amountV = _mm_set1_ps(amount), amountY = _mm_set1_ps(amount * 0.5f);
+        for (; i + 4 <= count; i += 4) {
+            __m128 px = _mm_loadu_ps(posX + i), pz = _mm_loadu_ps(posZ + i);
+            __m128 lived = _mm_sub_ps(_mm_loadu_ps(maxLifetime + i), _mm_loadu_ps(lifetime + i));
+            __m128 arg = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(px, pz), half), lived), freq);
+
+            __m128 nx = FastSin4(arg);
+            __m128 ny = FastSin4(_mm_add_ps(_mm_mul_ps(arg, _mm_set1_ps(0.7f)), _mm_set1_ps(halfPi)));
+            __m128 nz = FastSin4(_mm_mul_ps(arg, _mm_set1_ps(1.3f)));
+
+            _mm_storeu_ps(posX + i, _mm_add_ps(px, _mm_mul_ps(nx, amountV)));
+            _mm_storeu_ps(posY + i, _mm_add_ps(_mm_loadu_ps(posY + i), _mm_mul_ps(ny, amountY)));
+            _mm_storeu_ps(posZ + i, _mm_add_ps(pz, _mm_mul_ps(nz, amountV)));
+        }
+    }
+#endif
+
+    // Remainder
+    for (; i < count; ++i) {
+        float noiseArg = ((posX[i] + posZ[i]) * 0.5f + (maxLifetime[i] - lifetime[i])) * frequency;
+        posX[i] += FastSin(noiseArg) * amount;
+        posY[i] += FastSin(noiseArg * 0.7f + halfPi) * amount * 0.5f;
+        posZ[i] += FastSin(noiseArg * 1.3f) * amount;
+    }
+}
 
-        // Turbulence simulation using trigonometric functions (faster than Perlin)
-        float timeScale = p.maxLifetime - p.lifetime; // Lived time
-        float noiseArg = (p.position.x * 0.5f + p.position.z * 0.5f + timeScale) * frequency;
+void ParticlePool::Reserve(size_t capacity) {
+    posX.reserve(capacity); posY.reserve(capacity); posZ.reserve(capacity);
+    velX.reserve(capacity); velY.reserve(capacity); velZ.reserve(capacity);
+    lifetime.reserve(capacity);
+    maxLifetime.reserve(capacity);
+    lifeRatio.reserve(capacity);
+    size.reserve(capacity);
+    rotation.reserve(capacity);
+    angularVelocity.reserve(capacity);
+    color.reserve(capacity);
+}
 
-        glm::vec3 noiseVel;
-        noiseVel.x = sin(noiseArg) * strength;
-        noiseVel.y = cos(noiseArg * 0.7f) * strength * 0.5f; // Less impact on Y
-        noiseVel.z = sin(noiseArg * 1.3f) * strength;
+void ParticlePool::Clear() {
+    posX.clear(); posY.clear(); posZ.clear();
+    velX.clear(); velY.clear(); velZ.clear();
+    lifetime.clear();
+    maxLifetime.clear();
+    lifeRatio.clear();
+    size.clear();
+    rotation.clear();
+    angularVelocity.clear();
+    color.clear();
+}
+
+void ParticlePool::Add(const Particle& particle) {
+    posX.push_back(particle.position.x); posY.push_back(particle.position.y); posZ.push_back(particle.position.z);
+    velX.push_back(particle.velocity.x); velY.push_back(particle.velocity.y); velZ.push_back(particle.velocity.z);
+    lifetime.push_back(particle.lifetime);
+    maxLifetime.push_back(particle.maxLifetime);
+    lifeRatio.push_back(0.0f);
+    size.push_back(particle.size);
+    rotation.push_back(particle.rotation);
+    angularVelocity.push_back(particle.angularVelocity);
+    color.push_back(particle.color);
+}
 
-        p.position += noiseVel * dt;
+void ParticlePool::Remove(size_t index) {
+    const size_t last = Size() - 1;
+    if (index != last) {
+        posX[index] = posX[last]; posY[index] = posY[last]; posZ[index] = posZ[last];
+        velX[index] = velX[last]; velY[index] = velY[last]; velZ[index] = velZ[last];
+        lifetime[index] = lifetime[last];
+        maxLifetime[index] = maxLifetime[last];
+        lifeRatio[index] = lifeRatio[last];
+        size[index] = size[last];
+        rotation[index] = rotation[last];
+        angularVelocity[index] = angularVelocity[last];
+        color[index] = color[last];
     }
+
+    posX.pop_back(); posY.pop_back(); posZ.pop_back();
+    velX.pop_back(); velY.pop_back(); velZ.pop_back();
+    lifetime.pop_back();
+    maxLifetime.pop_back();
+    lifeRatio.pop_back();
+    size.pop_back();
+    rotation.pop_back();
+    angularVelocity.pop_back();
+    color.pop_back();
 }
 
-EmitterInstance::EmitterInstance() { particles.reserve(maxParticles); }
+EmitterInstance::EmitterInstance() {
+    particles.Reserve(maxParticles);
+    randomSeed = nextEmitterSeed.fetch_add(1);
+    random.Seed(randomSeed);
+}
 
 EmitterInstance::~EmitterInstance() {
     for (auto m : modules) delete m;
@@ -195,7 +461,8 @@ void EmitterInstance::Init() {
 }
 
 void EmitterInstance::Reset() {
-    particles.clear();
+    particles.Clear();
+    random.Seed(randomSeed);
     timeSinceLastEmit = 0.0f;
     systemTime = 0.0f;
 
@@ -259,11 +526,11 @@ void EmitterInstance::Stop() {
 
 bool EmitterInstance::IsAlive() const {
     // True while there are still visible particles on screen
-    return !particles.empty();
+    return !particles.Empty();
 }
 
 // Gradient Interpolation
-glm::vec4 EmitterInstance::EvaluateGradient(float t, std::vector<ColorKey>& gradient) {
+glm::vec4 EmitterInstance::EvaluateGradient(float t, const std::vector<ColorKey>& gradient) {
     if (gradient.empty()) return glm::vec4(1.0f);
     if (gradient.size() == 1) return gradient[0].color;
 
@@ -282,7 +549,7 @@ glm::vec4 EmitterInstance::EvaluateGradient(float t, std::vector<ColorKey>& grad
     return gradient.back().color;
 }
 
-float EmitterInstance::EvaluateSizeCurve(float t, ModuleEmitterSpawn* spawner) {
+float EmitterInstance::EvaluateSizeCurve(float t, const ModuleEmitterSpawn* spawner) {
     if (!spawner || spawner->sizeCurve.empty()) {
         // If theres no curve defined for the size, fall back to linear interpolation
         if (spawner) return glm::mix(spawner->sizeStart, spawner->sizeEnd, t);
@@ -306,31 +573,54 @@ float EmitterInstance::EvaluateSizeCurve(float t, ModuleEmitterSpawn* spawner) {
     return curve.back().size;
 }
 
+ModuleEmitterSpawn* EmitterInstance::GetSpawner() const {
+    for (auto m : modules)
+        if (m->type == ParticleModuleType::SPAWNER) return (ModuleEmitterSpawn*)m;
+    return nullptr;
+}
+
+void EmitterInstance::Spawn() {
+    if (particles.Size() >= (size_t)maxParticles) return;
+
+    Particle p;
+    for (auto mod : modules) mod->Spawn(this, &p);
+    particles.Add(p);
+}
+
+void EmitterInstance::Simulate(float dt) {
+    // Age and kill first, so the kernels below only see live particles
+    size_t i = 0;
+    while (i < particles.Size()) {
+        particles.lifetime[i] -= dt;
+        if (particles.lifetime[i] <= 0.0f) particles.Remove(i);
+        else ++i;
+    }
+
+    const size_t count = particles.Size();
+    if (count == 0) return;
+
+    ModuleEmitterSpawn* spawner = GetSpawner();
+    if (spawner) spawner->UpdateLookupTables();
+
+    for (size_t j = 0; j < count; ++j) {
+        float lifeRatio = 1.0f - (particles.lifetime[j] / particles.maxLifetime[j]);
+        particles.lifeRatio[j] = lifeRatio;
+        particles.rotation[j] += particles.angularVelocity[j] * dt;
+
+        if (spawner) {
+            particles.color[j] = spawner->SampleColor(lifeRatio);
+            particles.size[j] = spawner->SampleSize(lifeRatio);
+        }
+    }
+
+    // Update modules (Movement, Noise)
+    for (auto mod : modules) mod->Update(this, dt);
+}
+
 void EmitterInstance::Update(float dt) {
     if (!active) {
-        if (!particles.empty()) {
-            ModuleEmitterSpawn* spawner = nullptr;
-            for (auto m : modules)
-                if (m->type == ParticleModuleType::SPAWNER) spawner = (ModuleEmitterSpawn*)m;
-
-            for (auto& p : particles) {
-                if (!p.active) continue;
-                p.lifetime -= dt;
-                if (p.lifetime <= 0.0f) { p.active = false; continue; }
-
-                float lifeRatio = 1.0f - (p.lifetime / p.maxLifetime);
-                if (spawner && !spawner->colorGradient.empty())
-                    p.color = EvaluateGradient(lifeRatio, spawner->colorGradient);
-                else
-                    p.color = glm::mix(p.colorStart, p.colorEnd, lifeRatio);
-
-                p.size = EvaluateSizeCurve(lifeRatio, spawner);
-                p.rotation += p.angularVelocity * dt;
-                p.animationTime = lifeRatio * animationSpeed;
-            }
-            for (auto mod : modules) mod->Update(this, dt);
-            KillDeadParticles();
-        }
+        // Emission stopped, live particles finish their lifetime
+        if (!particles.Empty()) Simulate(dt);
         return;
     }
 
@@ -357,12 +647,10 @@ void EmitterInstance::Update(float dt) {
             glm::vec3 endPos = ownerPosition;
 
             for (int i = 0; i < count; i++) {
-                if (particles.size() >= (size_t)maxParticles) break;
+                if (particles.Size() >= (size_t)maxParticles) break;
                 float t = (float)(i + 1) / (float)(count + 1);
                 ownerPosition = glm::mix(startPos, endPos, t);
-                Particle p;
-                for (auto mod : modules) mod->Spawn(this, &p);
-                particles.push_back(p);
+                Spawn();
             }
             ownerPosition = endPos;
         }
@@ -390,161 +678,18 @@ void EmitterInstance::Update(float dt) {
         timeSinceLastEmit += dt;
         float emitInterval = 1.0f / emissionRate;
         while (timeSinceLastEmit >= emitInterval) {
-            if (particles.size() < (size_t)maxParticles) {
-                Particle p;
-                for (auto mod : modules) mod->Spawn(this, &p);
-                particles.push_back(p);
-            }
+            Spawn();
             timeSinceLastEmit -= emitInterval;
         }
     }
 
-    ModuleEmitterSpawn* spawner = nullptr;
-    for (auto m : modules) if (m->type == ParticleModuleType::SPAWNER) spawner = (ModuleEmitterSpawn*)m;
-
-    for (auto& p : particles) {
-        if (!p.active) continue;
-
-        p.lifetime -= dt;
-        if (p.lifetime <= 0.0f) {
-            p.active = false;
-            continue;
-        }
-
-        float lifeRatio = 1.0f - (p.lifetime / p.maxLifetime);
-
-        if (spawner && !spawner->colorGradient.empty())
-            p.color = EvaluateGradient(lifeRatio, spawner->colorGradient);
-        else
-            p.color = glm::mix(p.colorStart, p.colorEnd, lifeRatio);
-
-        p.size = EvaluateSizeCurve(lifeRatio, spawner);
-        p.rotation += p.angularVelocity * dt;
-        p.animationTime = lifeRatio * animationSpeed;
-    }
-
-    // Update modules (Movement, Noise)
-    for (auto mod : modules) mod->Update(this, dt);
-
-    KillDeadParticles();
-}
-
-void EmitterInstance::KillDeadParticles() {
-    // Remove all dead particles
-    particles.erase(std::remove_if(particles.begin(), particles.end(),
-        [](const Particle& p) { return !p.active; }), particles.end());
+    Simulate(dt);
 }
 
 // Explosion effect
 void EmitterInstance::Burst(int count) {
     for (int i = 0; i < count; ++i) {
-        if (particles.size() < (size_t)maxParticles) {
-            Particle p;
-            for (auto mod : modules) mod->Spawn(this, &p);
-            particles.push_back(p);
-        }
-    }
-}
-
-void EmitterInstance::Draw(glm::vec3 cameraPos) {
-    if (particles.empty()) return;
-
-    // Draw far to near (Z-Sorting for transparency)
-    for (auto& p : particles) p.distanceToCamera = glm::distance(p.position, cameraPos);
-    std::sort(particles.begin(), particles.end(), [](const Particle& a, const Particle& b) {
-        return a.distanceToCamera > b.distanceToCamera;
-        });
-
-    // Render state
-    glEnable(GL_BLEND);
-    glDepthMask(GL_FALSE); // Disable for transparent objects
-    glDisable(GL_CULL_FACE);
-
-    // Blending Mode
-    if (luminanceBlending) {
-        glBlendFunc(GL_SRC_COLOR, GL_ONE_MINUS_SRC_COLOR);
-    }
-    else if (additiveBlending) {
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE); // Glow/fire/sparks
-    }
-    else {
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Standard Alpha
-    }
-
-    // Texture Setup
-    glActiveTexture(GL_TEXTURE0);
-    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE); // Multiply Texture * Color
-
-    if (textureID != 0) {
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, textureID);
+        if (particles.Size() >= (size_t)maxParticles) break;
+        Spawn();
     }
-    else {
-        glDisable(GL_TEXTURE_2D);
-    }
-
-    glBegin(GL_QUADS);
-
-    // Animation frame sizes
-    int totalFrames = textureRows * textureCols;
-    float frameWidth = 1.0f / (float)textureCols;
-    float frameHeight = 1.0f / (float)textureRows;
-
-    for (const auto& p : particles) {
-        // BILLBOARDING
-        glm::vec3 direction = glm::normalize(cameraPos - p.position);
-        glm::vec3 worldUp = (glm::abs(direction.y) > 0.99f) ? glm::vec3(0, 0, 1) : glm::vec3(0, 1, 0);
-        glm::vec3 baseRight = glm::normalize(glm::cross(worldUp, direction));
-        glm::vec3 baseUp = glm::normalize(glm::cross(direction, baseRight));
-
-        // Apply Particle Rotation
-        float rad = glm::radians(p.rotation);
-        float c = cos(rad);
-        float s = sin(rad);
-
-        glm::vec3 right = baseRight * c + baseUp * s;
-        glm::vec3 up = baseRight * -s + baseUp * c;
-
-        float halfSize = p.size * 0.5f;
-
-        glm::vec3 v1 = p.position - (right * halfSize) + (up * halfSize);
-        glm::vec3 v2 = p.position + (right * halfSize) + (up * halfSize);
-        glm::vec3 v3 = p.position + (right * halfSize) - (up * halfSize);
-        glm::vec3 v4 = p.position - (right * halfSize) - (up * halfSize);
-
-        // UV animation
-        int currentFrame = 0;
-        if (totalFrames > 1) {
-            if (animLoop)
-                currentFrame = (int)(p.animationTime * totalFrames) % totalFrames;
-            else {
-                currentFrame = (int)(p.animationTime * totalFrames);
-                if (currentFrame >= totalFrames) currentFrame = totalFrames - 1;
-            }
-        }
-
-        int col = currentFrame % textureCols;
-        int row = currentFrame / textureCols;
-
-        float uLeft = col * frameWidth;
-        float uRight = uLeft + frameWidth;
-        float vTop = 1.0f - (row * frameHeight);
-        float vBottom = vTop - frameHeight;
-
-        glColor4f(p.color.r, p.color.g, p.color.b, p.color.a);
-
-        glTexCoord2f(uLeft, vTop);    glVertex3f(v1.x, v1.y, v1.z);
-        glTexCoord2f(uRight, vTop);    glVertex3f(v2.x, v2.y, v2.z);
-        glTexCoord2f(uRight, vBottom); glVertex3f(v3.x, v3.y, v3.z);
-        glTexCoord2f(uLeft, vBottom); glVertex3f(v4.x, v4.y, v4.z);
-    }
-
-    glEnd();
-
-    // Restore state
-    glDepthMask(GL_TRUE);
-    glDisable(GL_BLEND);
-    glEnable(GL_CULL_FACE);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glDisable(GL_TEXTURE_2D);
 }
\ No newline at end of file
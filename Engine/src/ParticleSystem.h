@@ -3,9 +3,25 @@
 #include <vector>
 #include <string>
 #include <map> 
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+// xoshiro128** generator. Every emitter owns one, so emitters can be simulated
+// on different threads and replay the same particles for the same seed.
+struct ParticleRandom {
+    uint32_t state[4] = { 1, 2, 3, 4 };
+
+    void Seed(uint32_t seed);
+    uint32_t Next();
+    // Uniform in [0, 1)
+    float Float() { return (float)(Next() >> 8) * (1.0f / 16777216.0f); }
+    float Range(float min, float max) {
+        if (max - min < 0.0001f) return min; // Avoid empty ranges
+        return min + Float() * (max - min);
+    }
+};
+
 // Gradient
 struct ColorKey {
     float time; // Position from 0.0 to 1.0
@@ -35,34 +51,48 @@ enum class SimulationSpace {
     WORLD // The particles remain in the world, leaving a trail
 };
 
+// Initial state of a particle, filled by the modules on Spawn and copied into the pool
 struct Particle {
     glm::vec3 position;
     glm::vec3 velocity;
 
-    // Color properties
     glm::vec4 color; // Current color
-    glm::vec4 colorStart; // Initial color
-    glm::vec4 colorEnd; // Final color, the target when interpolation is active
 
     // Lifecycle properties
     float lifetime; // Time remaining in seconds
     float maxLifetime; // Total life duration since creation
 
-    // Size properties
     float size; // Current size
-    float sizeStart; // Initial size
-    float sizeEnd; // Final size
 
     // Spin properties
     float rotation; // Current rotation
     float angularVelocity; // Rotation speed
+};
 
-    // Animation properties
-    float animationTime;
-
-    // Rendering sorting
-    float distanceToCamera;
-    bool active;
+// Live particles stored as one array per field, so the update kernels stream
+// through exactly the data they touch. Dead particles are swap-removed: order is
+// not kept, the renderer sorts anyway.
+struct ParticlePool {
+    std::vector<float> posX, posY, posZ;
+    std::vector<float> velX, velY, velZ;
+    std::vector<float> lifetime; // Time remaining in seconds
+    std::vector<float> maxLifetime;
+    std::vector<float> lifeRatio; // 0 at spawn, 1 at death
+    std::vector<float> size;
+    std::vector<float> rotation;
+    std::vector<float> angularVelocity;
+    std::vector<glm::vec4> color;
+
+    size_t Size() const { return lifetime.size(); }
+    bool Empty() const { return lifetime.empty(); }
+
+    void Reserve(size_t capacity);
+    void Clear();
+    void Add(const Particle& particle);
+    // Moves the last particle into index
+    void Remove(size_t index);
+
+    glm::vec3 GetPosition(size_t index) const { return glm::vec3(posX[index], posY[index], posZ[index]); }
 };
 
 // Forward declaration
@@ -136,6 +166,26 @@ public:
     void Spawn(EmitterInstance* emitter, Particle* particle) override;
     void Update(EmitterInstance* emitter, float dt) override {}
     void ResetDefaults() override;
+
+    // Color and size over life sampled at LUT_SIZE points. Rebaked only when the
+    // settings differ from the ones used for the last bake.
+    static const int LUT_SIZE = 256;
+    void UpdateLookupTables();
+    const glm::vec4& SampleColor(float lifeRatio) const { return colorLUT[LutIndex(lifeRatio)]; }
+    float SampleSize(float lifeRatio) const { return sizeLUT[LutIndex(lifeRatio)]; }
+
+private:
+    static int LutIndex(float lifeRatio);
+
+    glm::vec4 colorLUT[LUT_SIZE];
+    float sizeLUT[LUT_SIZE];
+    bool lutBaked = false;
+
+    // Settings the tables were baked from
+    glm::vec4 bakedColorStart = glm::vec4(0.0f), bakedColorEnd = glm::vec4(0.0f);
+    std::vector<ColorKey> bakedColorGradient;
+    float bakedSizeStart = 0.0f, bakedSizeEnd = 0.0f;
+    std::vector<SizeKey> bakedSizeCurve;
 };
 
 // Basic gravity
@@ -194,6 +244,8 @@ struct EmitterInstance {
 
     // Simulation Settings
     SimulationSpace simulationSpace = SimulationSpace::LOCAL;
+    uint32_t randomSeed = 0; // Assigned per instance, the generator restarts from it on Reset
+    ParticleRandom random;
     float emissionRateDistance = 0.0f; // Emission per distance traveled
     bool prewarm = false; // Pre-warm up
 
@@ -215,7 +267,7 @@ struct EmitterInstance {
     bool animLoop = false;
 
     // Internal State
-    std::vector<Particle> particles; // The particle group
+    ParticlePool particles; // The particle group
     std::vector<ParticleModule*> modules; // List of behaviors
 
     float timeSinceLastEmit = 0.0f; // Accumulator for emission timing
@@ -225,15 +277,20 @@ struct EmitterInstance {
     glm::vec3 ownerPosition = glm::vec3(0.0f);// Current position of the owner object
     glm::vec3 lastPosition = glm::vec3(0.0f); // Position in the previous frame
 
+    // Movement and noise use the SSE/AVX kernels when the build has them. Off runs
+    // the scalar loops instead, to benchmark and check the kernels against them.
+    static bool simdKernels;
+
     EmitterInstance();
     ~EmitterInstance();
 
     void Init();
     void Update(float dt);
-    void Draw(glm::vec3 cameraPosition);
+    // Ages, colors, moves and kills the live particles (no emission)
+    void Simulate(float dt);
     void Reset();
     void ResetValues();
-    void KillDeadParticles();
+    void Spawn();
     void Burst(int count); // Explosion
 
     // Lua Scripting
@@ -242,8 +299,10 @@ struct EmitterInstance {
     bool IsAlive() const;
 
     // Helper for gradients
-    glm::vec4 EvaluateGradient(float t, std::vector<ColorKey>& gradient);
+    static glm::vec4 EvaluateGradient(float t, const std::vector<ColorKey>& gradient);
 
    // Helper for size curve
-    float EvaluateSizeCurve(float t, ModuleEmitterSpawn* spawner);
+    static float EvaluateSizeCurve(float t, const ModuleEmitterSpawn* spawner);
+
+    ModuleEmitterSpawn* GetSpawner() const;
 };
\ No newline at end of file
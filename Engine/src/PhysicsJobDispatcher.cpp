@@ -0,0 +1,34 @@
+#include "PhysicsJobDispatcher.h"
+#include "JobSystem.h"
+
+using namespace physx;
+
+PhysicsJobDispatcher::PhysicsJobDispatcher(JobSystem& jobs) : jobs(jobs)
+{
+}
+
+void PhysicsJobDispatcher::submitTask(PxBaseTask& task)
+{
+    // PhysX tracks task completion itself (release() notifies the task manager),
+    // no counter needed
+    // Without workers nobody would pick the task up while fetchResults blocks
+    if (jobs.GetWorkerCount() == 0)
+    {
+        task.run();
+        task.release();
+        return;
+    }
+
+    PxBaseTask* pxTask = &task;
+    jobs.Run([pxTask]()
+        {
+            pxTask->run();
+            pxTask->release();
+        }, nullptr, task.getName());
+}
+
+uint32_t PhysicsJobDispatcher::getWorkerCount() const
+{
+    unsigned int count = jobs.GetWorkerCount();
+    return count > 0 ? count : 1;
+}
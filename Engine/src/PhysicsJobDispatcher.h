@@ -0,0 +1,18 @@
+#pragma once
+#include <PxPhysicsAPI.h>
+
+class JobSystem;
+
+// Hands PhysX simulation tasks to the engine job system, so physics runs on the same
+// worker threads as everything else instead of a pool of its own.
+class PhysicsJobDispatcher : public physx::PxCpuDispatcher
+{
+public:
+    explicit PhysicsJobDispatcher(JobSystem& jobs);
+
+    void submitTask(physx::PxBaseTask& task) override;
+    uint32_t getWorkerCount() const override;
+
+private:
+    JobSystem& jobs;
+};
@@ -0,0 +1,268 @@
+#include "PlaySnapshot.h"
+#include "GameObject.h"
+#include "Transform.h"
+#include "Application.h"
+#include "SelectionManager.h"
+#include "Log.h"
+#include <unordered_set>
+#include <nlohmann/json.hpp>
+
+void PlaySnapshot::Capture(GameObject* root)
+{
+    Clear();
+
+    if (!root) return;
+
+    for (GameObject* child : root->GetChildren())
+    {
+        CaptureSubtree(child, -1);
+    }
+}
+
+void PlaySnapshot::CaptureSubtree(GameObject* obj, int parent)
+{
+    ObjectState state;
+    state.handle = obj->GetHandle();
+    state.parent = parent;
+    state.uid = obj->GetUID();
+    state.name = obj->GetName();
+    state.tag = obj->GetTag();
+    state.active = obj->IsActive();
+    state.position = obj->transform->GetPosition();
+    state.rotation = obj->transform->GetRotation();
+    state.scale = obj->transform->GetScale();
+    state.firstComponent = (uint32_t)components.size();
+
+    for (const Component* component : obj->GetComponents())
+    {
+        if (component->GetType() == ComponentType::TRANSFORM) continue;
+
+        ComponentState componentState;
+        componentState.type = component->GetType();
+        componentState.active = component->IsActive();
+        SerializeComponent(component, componentState.data);
+        components.push_back(std::move(componentState));
+    }
+
+    state.componentCount = (uint32_t)components.size() - state.firstComponent;
+
+    int index = (int)objects.size();
+    objects.push_back(std::move(state));
+
+    for (GameObject* child : obj->GetChildren())
+    {
+        CaptureSubtree(child, index);
+    }
+}
+
+void PlaySnapshot::Restore(GameObject* root)
+{
+    if (!root || objects.empty()) return;
+
+    Application::GetInstance().selectionManager->ClearSelection();
+
+    RestoreStats stats;
+    std::vector<GameObject*> live(objects.size(), nullptr);
+    std::unordered_set<GameObject*> captured;
+    std::vector<Component*> newComponents;
+
+    // Parents come first, so a destroyed object always has its parent back by the time it is rebuilt
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        const ObjectState& state = objects[i];
+        GameObject* obj = state.handle.Get();
+
+        if (obj)
+        {
+            RestoreObject(obj, state, newComponents, stats);
+        }
+        else
+        {
+            GameObject* parent = state.parent < 0 ? root : live[state.parent];
+            obj = Recreate(state, newComponents);
+            parent->AddChild(obj);
+            ++stats.recreated;
+        }
+
+        live[i] = obj;
+        captured.insert(obj);
+    }
+
+    // Hierarchy and sibling order. Objects are placed as the k-th child of their captured parent,
+    // anything spawned under the same parent ends up after them.
+    std::vector<int> nextSlot(objects.size() + 1, 0);
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        const ObjectState& state = objects[i];
+        GameObject* obj = live[i];
+        GameObject* parent = state.parent < 0 ? root : live[state.parent];
+        int slot = nextSlot[state.parent + 1]++;
+
+        if (obj->GetParent() != parent || parent->GetChildIndex(obj) != slot)
+        {
+            parent->InsertChildAt(obj, slot);
+        }
+    }
+
+    // What is left outside the snapshot was spawned during play
+    std::vector<GameObject*> spawned;
+    std::vector<GameObject*> stack(1, root);
+    while (!stack.empty())
+    {
+        GameObject* obj = stack.back();
+        stack.pop_back();
+
+        for (GameObject* child : obj->GetChildren())
+        {
+            if (captured.count(child))
+                stack.push_back(child);
+            else if (!child->IsPersistent())
+                spawned.push_back(child);
+        }
+    }
+
+    for (GameObject* obj : spawned)
+    {
+        obj->GetParent()->RemoveChild(obj);
+        delete obj;
+    }
+    stats.spawnedDeleted = spawned.size();
+
+    // After everything exists again, references to other objects can be found
+    for (Component* component : newComponents)
+    {
+        component->SolveReferences();
+    }
+
+    LOG_CONSOLE("Scene restored: %zu objects, %zu recreated, %zu spawned removed, %zu components rebuilt",
+        objects.size(), stats.recreated, stats.spawnedDeleted, stats.componentsRebuilt);
+}
+
+void PlaySnapshot::Clear()
+{
+    objects.clear();
+    components.clear();
+}
+
+GameObject* PlaySnapshot::Recreate(const ObjectState& state, std::vector<Component*>& outNewComponents)
+{
+    GameObject* obj = new GameObject(state.name);
+    if (state.uid != 0) obj->SetUID(state.uid);
+    obj->SetActive(state.active);
+    obj->SetTag(state.tag);
+    obj->transform->SetLocalTRS(state.position, state.rotation, state.scale);
+
+    for (uint32_t c = 0; c < state.componentCount; ++c)
+    {
+        Component* component = CreateFromState(obj, components[state.firstComponent + c]);
+        if (component) outNewComponents.push_back(component);
+    }
+
+    return obj;
+}
+
+// Same teardown as the editor's remove component command, plus the event ComponentMesh and
+// Rigidbody listen to for their cached pointers
+static void DestroyComponent(GameObject* obj, Component* component)
+{
+    std::unique_ptr<Component> owned = obj->ExtractComponent(component);
+
+    if (component->IsType(ComponentType::JOINT))
+    {
+        component->CleanUp();
+    }
+
+    obj->PublishGameObjectEvent(GameObjectEvent::COMPONENT_REMOVED, component);
+}
+
+void PlaySnapshot::RestoreObject(GameObject* obj, const ObjectState& state, std::vector<Component*>& outNewComponents, RestoreStats& stats)
+{
+    obj->SetName(state.name);
+    obj->SetTag(state.tag);
+    obj->SetUID(state.uid);
+    obj->SetActive(state.active);
+    // No-op (and no event) if the object did not move
+    obj->transform->SetLocalTRS(state.position, state.rotation, state.scale);
+
+    std::vector<Component*> current;
+    for (Component* component : obj->GetComponents())
+    {
+        if (component->GetType() != ComponentType::TRANSFORM) current.push_back(component);
+    }
+
+    bool sameLayout = current.size() == state.componentCount;
+    for (uint32_t c = 0; sameLayout && c < state.componentCount; ++c)
+    {
+        sameLayout = current[c]->GetType() == components[state.firstComponent + c].type;
+    }
+
+    // Components added or removed during play: the whole set is rebuilt
+    if (!sameLayout)
+    {
+        for (Component* component : current)
+        {
+            DestroyComponent(obj, component);
+        }
+
+        for (uint32_t c = 0; c < state.componentCount; ++c)
+        {
+            Component* component = CreateFromState(obj, components[state.firstComponent + c]);
+            if (component) outNewComponents.push_back(component);
+        }
+
+        stats.componentsRebuilt += state.componentCount;
+        return;
+    }
+
+    std::vector<uint8_t> currentData;
+    for (uint32_t c = 0; c < state.componentCount; ++c)
+    {
+        Component* component = current[c];
+        const ComponentState& componentState = components[state.firstComponent + c];
+
+        bool rebuild = component->HasRuntimeState();
+        if (!rebuild)
+        {
+            SerializeComponent(component, currentData);
+            rebuild = currentData != componentState.data;
+        }
+
+        if (!rebuild)
+        {
+            component->SetActive(componentState.active);
+            continue;
+        }
+
+        int index = obj->GetComponentIndex(component);
+        DestroyComponent(obj, component);
+
+        Component* fresh = CreateFromState(obj, componentState);
+        if (fresh)
+        {
+            // Back to the slot of the one it replaces
+            obj->ReinsertComponentAt(obj->ExtractComponent(fresh), index);
+            outNewComponents.push_back(fresh);
+        }
+
+        ++stats.componentsRebuilt;
+    }
+}
+
+Component* PlaySnapshot::CreateFromState(GameObject* obj, const ComponentState& state)
+{
+    Component* component = obj->CreateComponent(state.type);
+    if (!component) return nullptr;
+
+    component->SetActive(state.active);
+    component->Deserialize(nlohmann::json::from_msgpack(state.data));
+    return component;
+}
+
+void PlaySnapshot::SerializeComponent(const Component* component, std::vector<uint8_t>& outData)
+{
+    nlohmann::json componentObj = nlohmann::json::object();
+    component->Serialize(componentObj);
+
+    outData.clear();
+    nlohmann::json::to_msgpack(componentObj, outData);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Globals.h"
+#include "Component.h"
+#include "Handle.h"
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+class GameObject;
+
+// Scene state taken when entering play mode, restored in place when leaving it. Every
+// object keeps a handle to the live GameObject plus its serialized state; on Restore only
+// what differs is touched:
+//  - objects spawned during play are deleted (persistent ones are kept, as ClearScene does)
+//  - objects destroyed during play are rebuilt from their state
+//  - live objects get hierarchy, name, tag, flags and transform put back, and only the
+//    components whose data changed (or that HasRuntimeState) are recreated
+// Untouched meshes, materials, rigidbodies... keep their GPU and physics resources.
+class PlaySnapshot
+{
+public:
+    // Children of root, not root itself
+    void Capture(GameObject* root);
+    void Restore(GameObject* root);
+    void Clear();
+
+    bool IsEmpty() const { return objects.empty(); }
+
+private:
+    struct ComponentState
+    {
+        ComponentType type;
+        bool active;
+        std::vector<uint8_t> data;      // Serialize output as MessagePack
+    };
+
+    struct ObjectState
+    {
+        GameObjectHandle handle;
+        int parent;                     // index in objects, -1 for children of root
+        UID uid;
+        std::string name;
+        std::string tag;
+        bool active;
+
+        glm::vec3 position;
+        glm::vec3 rotation;             // Euler angles
+        glm::vec3 scale;
+
+        uint32_t firstComponent;
+        uint32_t componentCount;
+    };
+
+    struct RestoreStats
+    {
+        size_t spawnedDeleted = 0;
+        size_t recreated = 0;
+        size_t componentsRebuilt = 0;
+    };
+
+    void CaptureSubtree(GameObject* obj, int parent);
+    GameObject* Recreate(const ObjectState& state, std::vector<Component*>& outNewComponents);
+    void RestoreObject(GameObject* obj, const ObjectState& state, std::vector<Component*>& outNewComponents, RestoreStats& stats);
+    Component* CreateFromState(GameObject* obj, const ComponentState& state);
+
+    static void SerializeComponent(const Component* component, std::vector<uint8_t>& outData);
+
+    std::vector<ObjectState> objects;   // pre-order, parents before children
+    std::vector<ComponentState> components;
+};
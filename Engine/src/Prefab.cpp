@@ -2,7 +2,9 @@
 #include "GameObject.h"
 #include "Application.h"
 #include "ModuleScene.h"
+#include "Component.h"
 #include "Log.h"
+#include <algorithm>
 #include <fstream>
 
 Prefab::Prefab(const std::string& name)
@@ -37,6 +39,7 @@ bool Prefab::SaveFromGameObject(GameObject* source, const std::string& filepath)
     file.close();
 
     isValid = true;
+    Compile();
     LOG_CONSOLE("[Prefab] Saved: %s with %zu objects", name.c_str(), rootArray.size());
     return true;
 }
@@ -47,46 +50,75 @@ GameObject* Prefab::Instantiate() {
         return nullptr;
     }
 
-    // Check if prefabData is an array (hierarchy) or single object
-    GameObject* instance = nullptr;
+    GameObject* root = Application::GetInstance().scene->GetRoot();
+
+    while (!pooledInstances.empty()) {
+        GameObject* instance = pooledInstances.back().Get();
+        pooledInstances.pop_back();
 
-    if (prefabData.is_array() && !prefabData.empty()) {
-        // Deserialize the root object (first in array)
-        instance = GameObject::Deserialize(prefabData[0], nullptr);
+        // Deleted with the scene while pooled
+        if (!instance || instance->IsMarkedForDeletion()) continue;
 
-        if (!instance) {
-            LOG_CONSOLE("[Prefab] ERROR: Failed to instantiate root object");
-            return nullptr;
+        if (!compiled.Reset(instance)) {
+            // A script reshaped it, it can't pass for a fresh instance anymore
+            instance->MarkForDeletion();
+            continue;
         }
 
-        // Deserialize children if there are more objects in the array
-        for (size_t i = 1; i < prefabData.size(); ++i) {
-            GameObject* child = GameObject::Deserialize(prefabData[i], instance);
-            if (child) {
-                // Child should already be added to parent during Deserialize
-                LOG_DEBUG("[Prefab] Deserialized child: %s", child->GetName().c_str());
-            }
+        if (root && instance->GetParent() != root) {
+            root->AddChild(instance);
         }
+
+        LOG_DEBUG("[Prefab] Reused pooled instance: %s", name.c_str());
+        return instance;
     }
-    else {
-        // Old format: single object
-        instance = GameObject::Deserialize(prefabData, nullptr);
+
+    return InstantiateCompiled();
+}
+
+GameObject* Prefab::InstantiateCompiled() {
+    if (!isValid) {
+        LOG_CONSOLE("[Prefab] ERROR: Prefab is not valid");
+        return nullptr;
     }
 
+    GameObject* instance = compiled.Instantiate(Application::GetInstance().scene->GetRoot());
     if (!instance) {
         LOG_CONSOLE("[Prefab] ERROR: Failed to instantiate");
         return nullptr;
     }
 
-    GameObject* root = Application::GetInstance().scene->GetRoot();
-    if (root) {
-        root->AddChild(instance);
-    }
-
     LOG_DEBUG("[Prefab] Instantiated: %s", name.c_str());
     return instance;
 }
 
+void Prefab::ReleaseInstance(GameObject* instance) {
+    if (!instance || instance->IsMarkedForDeletion()) return;
+
+    GameObjectHandle handle = instance->GetHandle();
+    if (std::find(pooledInstances.begin(), pooledInstances.end(), handle) != pooledInstances.end()) return;
+
+    // Inactive objects still get their components updated, so those are switched off too.
+    // Reset puts back the flags and component state the template says.
+    std::vector<GameObject*> stack(1, instance);
+    while (!stack.empty()) {
+        GameObject* obj = stack.back();
+        stack.pop_back();
+
+        obj->SetActive(false);
+        for (Component* component : obj->GetComponents()) {
+            if (component->GetType() != ComponentType::TRANSFORM) {
+                component->SetActive(false);
+            }
+        }
+
+        const std::vector<GameObject*>& children = obj->GetChildren();
+        stack.insert(stack.end(), children.begin(), children.end());
+    }
+
+    pooledInstances.push_back(handle);
+}
+
 bool Prefab::LoadFromFile(const std::string& filepath) {
     std::ifstream file(filepath);
     if (!file.is_open()) {
@@ -97,6 +129,7 @@ bool Prefab::LoadFromFile(const std::string& filepath) {
     try {
         file >> prefabData;
         isValid = true;
+        Compile();
 
         if (prefabData.is_array()) {
             LOG_CONSOLE("[Prefab] Loaded: %s (%zu objects)", name.c_str(), prefabData.size());
@@ -105,11 +138,23 @@ bool Prefab::LoadFromFile(const std::string& filepath) {
             LOG_CONSOLE("[Prefab] Loaded: %s (single object - old format)", name.c_str());
         }
 
-        return true;
+        return isValid;
     }
     catch (const std::exception& e) {
         LOG_CONSOLE("[Prefab] ERROR: Failed to parse: %s", e.what());
         isValid = false;
         return false;
     }
+}
+
+void Prefab::Compile() {
+    pooledInstances.clear();
+
+    if (!compiled.Compile(prefabData)) {
+        LOG_CONSOLE("[Prefab] ERROR: Nothing to instantiate in: %s", name.c_str());
+        isValid = false;
+        return;
+    }
+
+    compiled.AcquireResources();
 }
\ No newline at end of file
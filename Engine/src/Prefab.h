@@ -1,6 +1,9 @@
 #pragma once
 #include <string>
+#include <vector>
 #include <nlohmann/json.hpp>
+#include "PrefabTemplate.h"
+#include "Handle.h"
 
 class GameObject;
 
@@ -9,13 +12,25 @@ public:
     Prefab(const std::string& name);
 
     bool SaveFromGameObject(GameObject* source, const std::string& filepath);
+    // Reuses a released instance when there is one, otherwise InstantiateCompiled
     GameObject* Instantiate();
+    // Always a new instance, built from the compiled template
+    GameObject* InstantiateCompiled();
     bool LoadFromFile(const std::string& filepath);
 
+    // Deactivates an instance and keeps it for the next Instantiate
+    void ReleaseInstance(GameObject* instance);
+    size_t GetPooledCount() const { return pooledInstances.size(); }
+
     bool IsValid() const { return isValid; }
 
 private:
+    void Compile();
+
     std::string name;
     nlohmann::json prefabData;
+    PrefabTemplate compiled;
+    // Released instances. Handles, since the scene may delete them while pooled.
+    std::vector<GameObjectHandle> pooledInstances;
     bool isValid;
 };
\ No newline at end of file
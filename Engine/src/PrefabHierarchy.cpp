@@ -0,0 +1,131 @@
+#include "PrefabHierarchy.h"
+#include <algorithm>
+
+// Component fields that hold resource UIDs (see the components' Serialize)
+static const char* const RESOURCE_UID_KEYS[] = { "meshUID", "materialUID", "textureUID", "scriptUID" };
+
+static glm::vec3 ReadVec3(const nlohmann::json& obj, const char* key, const glm::vec3& fallback)
+{
+    if (!obj.contains(key) || !obj[key].is_array() || obj[key].size() < 3) return fallback;
+
+    const nlohmann::json& values = obj[key];
+    return glm::vec3(values[0].get<float>(), values[1].get<float>(), values[2].get<float>());
+}
+
+static void CollectResourceUIDs(const nlohmann::json& componentObj, std::vector<UID>& outUIDs)
+{
+    for (const char* key : RESOURCE_UID_KEYS)
+    {
+        if (componentObj.contains(key) && componentObj[key].is_number_unsigned())
+        {
+            UID uid = componentObj[key].get<UID>();
+            if (uid != 0) outUIDs.push_back(uid);
+        }
+    }
+
+    if (componentObj.contains("Animations") && componentObj["Animations"].is_array())
+    {
+        for (const auto& animNode : componentObj["Animations"])
+        {
+            if (animNode.contains("UID") && animNode["UID"].is_number_unsigned())
+            {
+                UID uid = animNode["UID"].get<UID>();
+                if (uid != 0) outUIDs.push_back(uid);
+            }
+        }
+    }
+}
+
+bool PrefabHierarchy::Compile(const nlohmann::json& hierarchy)
+{
+    Clear();
+
+    if (hierarchy.is_array())
+    {
+        for (const auto& rootObj : hierarchy)
+        {
+            CompileNode(rootObj, -1);
+        }
+    }
+    else
+    {
+        CompileNode(hierarchy, -1);
+    }
+
+    std::sort(resourceUIDs.begin(), resourceUIDs.end());
+    resourceUIDs.erase(std::unique(resourceUIDs.begin(), resourceUIDs.end()), resourceUIDs.end());
+
+    return IsValid();
+}
+
+void PrefabHierarchy::CompileNode(const nlohmann::json& nodeObj, int parent)
+{
+    if (!nodeObj.is_object()) return;
+
+    Node node;
+    node.parent = parent;
+    node.name = nodeObj.contains("name") ? nodeObj["name"].get<std::string>() : "GameObject";
+    node.tag = nodeObj.contains("tag") ? nodeObj["tag"].get<std::string>() : "";
+    node.uid = nodeObj.contains("uid") ? nodeObj["uid"].get<UID>() : 0;
+    node.active = nodeObj.contains("active") ? nodeObj["active"].get<bool>() : true;
+    node.position = glm::vec3(0.0f);
+    node.rotation = glm::vec3(0.0f);
+    node.scale = glm::vec3(1.0f);
+    node.firstComponent = (uint32_t)components.size();
+    node.componentCount = 0;
+
+    if (nodeObj.contains("components") && nodeObj["components"].is_array())
+    {
+        for (const auto& componentObj : nodeObj["components"])
+        {
+            if (!componentObj.contains("type")) continue;
+
+            ComponentType type = static_cast<ComponentType>(componentObj["type"].get<int>());
+
+            // Every GameObject creates its own Transform, only its values are kept
+            if (type == ComponentType::TRANSFORM)
+            {
+                node.position = ReadVec3(componentObj, "position", node.position);
+                node.rotation = ReadVec3(componentObj, "rotation", node.rotation);
+                node.scale = ReadVec3(componentObj, "scale", node.scale);
+                continue;
+            }
+
+            ComponentRecord record;
+            record.type = type;
+            record.active = componentObj.contains("active") ? componentObj["active"].get<bool>() : true;
+            record.data = componentObj;
+            components.push_back(std::move(record));
+            ++node.componentCount;
+
+            CollectResourceUIDs(componentObj, resourceUIDs);
+        }
+    }
+
+    int index = (int)nodes.size();
+    nodes.push_back(std::move(node));
+
+    if (nodeObj.contains("children") && nodeObj["children"].is_array())
+    {
+        for (const auto& childObj : nodeObj["children"])
+        {
+            CompileNode(childObj, index);
+        }
+    }
+}
+
+void PrefabHierarchy::Clear()
+{
+    nodes.clear();
+    components.clear();
+    resourceUIDs.clear();
+}
+
+size_t PrefabHierarchy::GetInstanceNodeCount() const
+{
+    if (nodes.empty()) return 0;
+
+    size_t count = 1;
+    while (count < nodes.size() && nodes[count].parent >= 0) ++count;
+    return count;
+}
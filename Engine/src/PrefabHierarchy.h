@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Globals.h"
+#include "Component.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <glm/glm.hpp>
+
+// Prefab hierarchy decoded once from its JSON: a flat pre-order node array with the
+// names, tags, UIDs and local transforms already read, and each component's type and
+// data split out. Never touches a GameObject; PrefabTemplate builds instances from it.
+class PrefabHierarchy
+{
+public:
+    struct ComponentRecord
+    {
+        ComponentType type;
+        bool active;
+        nlohmann::json data;
+    };
+
+    struct Node
+    {
+        int parent;     // index in nodes, -1 for roots
+        std::string name;
+        std::string tag;
+        UID uid;
+        bool active;
+
+        glm::vec3 position;
+        glm::vec3 rotation;     // Euler angles, as Transform serializes them
+        glm::vec3 scale;
+
+        uint32_t firstComponent;
+        uint32_t componentCount;
+    };
+
+    // Accepts a hierarchy array (one entry per root) or a single object (old format)
+    bool Compile(const nlohmann::json& hierarchy);
+    void Clear();
+    bool IsValid() const { return !nodes.empty(); }
+
+    const std::vector<Node>& GetNodes() const { return nodes; }
+    // Every component but the Transform, whose values are in the node
+    const std::vector<ComponentRecord>& GetComponents() const { return components; }
+    // Meshes / materials / textures / scripts / animations referenced, sorted and unique
+    const std::vector<UID>& GetResourceUIDs() const { return resourceUIDs; }
+    // Nodes in the first root's subtree, what a single instance is made of
+    size_t GetInstanceNodeCount() const;
+
+private:
+    void CompileNode(const nlohmann::json& nodeObj, int parent);
+
+    std::vector<Node> nodes;
+    std::vector<ComponentRecord> components;
+    std::vector<UID> resourceUIDs;
+};
@@ -1,5 +1,6 @@
 #include "PrefabManager.h"
 #include "Prefab.h"
+#include "GameObject.h"
 #include "Log.h"
 
 PrefabManager& PrefabManager::GetInstance() {
@@ -31,6 +32,17 @@ GameObject* PrefabManager::InstantiatePrefab(const std::string& name) {
     return it->second->Instantiate();
 }
 
+bool PrefabManager::ReleaseInstance(const std::string& name, GameObject* instance) {
+    auto it = prefabs.find(name);
+    if (it == prefabs.end()) {
+        LOG_CONSOLE("[PrefabManager] ERROR: Prefab not found: %s", name.c_str());
+        return false;
+    }
+
+    it->second->ReleaseInstance(instance);
+    return true;
+}
+
 bool PrefabManager::CreatePrefab(const std::string& name, GameObject* source, const std::string& filepath) {
     if (!source) {
         LOG_CONSOLE("[PrefabManager] ERROR: Source GameObject is null");
@@ -57,4 +69,4 @@ bool PrefabManager::HasPrefab(const std::string& name) const {
 void PrefabManager::Clear() {
     prefabs.clear();
     LOG_CONSOLE("[PrefabManager] Cleared all prefabs");
-}
\ No newline at end of file
+}
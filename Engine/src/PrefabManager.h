@@ -12,6 +12,8 @@ public:
 
     bool LoadPrefab(const std::string& name, const std::string& filepath);
     GameObject* InstantiatePrefab(const std::string& name);
+    // Hands an instance of that prefab back to its pool for the next InstantiatePrefab
+    bool ReleaseInstance(const std::string& name, GameObject* instance);
     bool CreatePrefab(const std::string& name, GameObject* source, const std::string& filepath);
     bool HasPrefab(const std::string& name) const;
     void Clear();
@@ -0,0 +1,196 @@
+#include "PrefabTemplate.h"
+#include "GameObject.h"
+#include "Transform.h"
+#include "Application.h"
+#include "ModuleResources.h"
+
+// Same teardown as PlaySnapshot's, including the event ComponentMesh and Rigidbody listen to
+static void DestroyComponent(GameObject* obj, Component* component)
+{
+    std::unique_ptr<Component> owned = obj->ExtractComponent(component);
+
+    if (component->IsType(ComponentType::JOINT))
+    {
+        component->CleanUp();
+    }
+
+    obj->PublishGameObjectEvent(GameObjectEvent::COMPONENT_REMOVED, component);
+}
+
+PrefabTemplate::~PrefabTemplate()
+{
+    ReleaseResources();
+}
+
+bool PrefabTemplate::Compile(const nlohmann::json& hierarchyJson)
+{
+    Clear();
+    return hierarchy.Compile(hierarchyJson);
+}
+
+void PrefabTemplate::Clear()
+{
+    ReleaseResources();
+    hierarchy.Clear();
+}
+
+void PrefabTemplate::AcquireResources()
+{
+    if (resourcesAcquired) return;
+
+    ModuleResources* resources = Application::GetInstance().resources.get();
+    if (!resources) return;
+
+    for (UID uid : hierarchy.GetResourceUIDs())
+    {
+        resourceRequests.push_back(resources->RequestResourceAsync(uid));
+    }
+    resourcesAcquired = true;
+}
+
+void PrefabTemplate::ReleaseResources()
+{
+    if (!resourcesAcquired) return;
+    resourcesAcquired = false;
+
+    std::vector<ResourceRequestPtr> requests;
+    requests.swap(resourceRequests);
+
+    // Null during shutdown, the resources go away with their module anyway
+    ModuleResources* resources = Application::GetInstance().resources.get();
+    if (!resources) return;
+
+    for (const ResourceRequestPtr& request : requests)
+    {
+        resources->ReleaseRequest(request);
+    }
+}
+
+GameObject* PrefabTemplate::Instantiate(GameObject* parent) const
+{
+    const std::vector<PrefabHierarchy::Node>& nodes = hierarchy.GetNodes();
+    const std::vector<PrefabHierarchy::ComponentRecord>& components = hierarchy.GetComponents();
+    if (nodes.empty()) return nullptr;
+
+    std::vector<GameObject*> created(nodes.size(), nullptr);
+    std::vector<GameObject*> roots;
+
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        const PrefabHierarchy::Node& node = nodes[i];
+
+        GameObject* obj = new GameObject(node.name);
+        if (node.uid != 0) obj->SetUID(node.uid);
+        obj->SetActive(node.active);
+        obj->SetTag(node.tag);
+        obj->transform->SetLocalTRS(node.position, node.rotation, node.scale);
+
+        // Nothing is attached to the scene yet, so this indexes nothing
+        if (node.parent >= 0)
+            created[node.parent]->AddChild(obj);
+        else
+            roots.push_back(obj);
+
+        for (uint32_t c = 0; c < node.componentCount; ++c)
+        {
+            const PrefabHierarchy::ComponentRecord& record = components[node.firstComponent + c];
+
+            Component* component = obj->CreateComponent(record.type);
+            if (component)
+            {
+                component->SetActive(record.active);
+                component->Deserialize(record.data);
+            }
+        }
+
+        created[i] = obj;
+    }
+
+    if (parent)
+    {
+        for (GameObject* root : roots)
+        {
+            parent->AddChild(root);
+        }
+    }
+
+    return roots.front();
+}
+
+bool PrefabTemplate::Reset(GameObject* instance) const
+{
+    const std::vector<PrefabHierarchy::Node>& nodes = hierarchy.GetNodes();
+    const std::vector<PrefabHierarchy::ComponentRecord>& components = hierarchy.GetComponents();
+    if (!instance || nodes.empty()) return false;
+
+    // Same pre-order walk the template was compiled with
+    std::vector<GameObject*> order;
+    order.reserve(nodes.size());
+    std::vector<GameObject*> stack(1, instance);
+    while (!stack.empty())
+    {
+        GameObject* obj = stack.back();
+        stack.pop_back();
+        order.push_back(obj);
+
+        const std::vector<GameObject*>& children = obj->GetChildren();
+        for (auto it = children.rbegin(); it != children.rend(); ++it)
+        {
+            stack.push_back(*it);
+        }
+    }
+
+    // Only the first root's subtree belongs to a single instance
+    size_t count = hierarchy.GetInstanceNodeCount();
+    if (order.size() != count) return false;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const PrefabHierarchy::Node& node = nodes[i];
+        const std::vector<Component*>& objComponents = order[i]->GetComponents();
+
+        // Transform first, then the template's components in order
+        if (order[i]->GetName() != node.name || objComponents.size() != node.componentCount + 1)
+            return false;
+
+        for (uint32_t c = 0; c < node.componentCount; ++c)
+        {
+            if (objComponents[c + 1]->GetType() != components[node.firstComponent + c].type)
+                return false;
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const PrefabHierarchy::Node& node = nodes[i];
+        GameObject* obj = order[i];
+
+        obj->SetActive(node.active);
+        obj->SetTag(node.tag);
+        obj->transform->SetLocalTRS(node.position, node.rotation, node.scale);
+
+        for (uint32_t c = 0; c < node.componentCount; ++c)
+        {
+            const PrefabHierarchy::ComponentRecord& record = components[node.firstComponent + c];
+            Component* component = obj->GetComponents()[c + 1];
+
+            // Scripts, emitters, animations and audio keep state Deserialize does not clear
+            // (Lua tables, live particles, play time), so those are rebuilt like PlaySnapshot does
+            if (component->HasRuntimeState())
+            {
+                DestroyComponent(obj, component);
+
+                Component* fresh = obj->CreateComponent(record.type);
+                if (!fresh) continue;
+
+                obj->ReinsertComponentAt(obj->ExtractComponent(fresh), (int)c + 1);
+                component = fresh;
+            }
+
+            component->SetActive(record.active);
+            component->Deserialize(record.data);
+        }
+    }
+
+    return true;
+}
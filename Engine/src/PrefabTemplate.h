@@ -0,0 +1,43 @@
+#pragma once
+
+#include "PrefabHierarchy.h"
+#include "ResourceLoader.h"
+#include <vector>
+#include <nlohmann/json.hpp>
+
+class GameObject;
+
+// Builds GameObjects from a PrefabHierarchy compiled once from the prefab's JSON.
+// Instantiating walks its arrays instead of looking keys up in the JSON tree for every
+// object, and can re-apply the initial state to a pooled instance.
+class PrefabTemplate
+{
+public:
+    ~PrefabTemplate();
+
+    // Accepts a hierarchy array (one entry per root) or a single object (old format)
+    bool Compile(const nlohmann::json& hierarchyJson);
+    void Clear();
+    bool IsValid() const { return hierarchy.IsValid(); }
+
+    // Keeps the meshes / materials / textures / scripts referenced by the prefab loaded
+    // between spawns, so the last instance dying does not unload them. Requested in the
+    // background: a spawn before they are ready just loads what it needs on the spot.
+    void AcquireResources();
+    void ReleaseResources();
+
+    // Builds every root detached, then attaches them to parent (if any). Returns the first root.
+    GameObject* Instantiate(GameObject* parent) const;
+    // Puts an instance made from this template back to its initial state: active flags,
+    // tags, local transforms and component data, with stateful components recreated.
+    // False if its hierarchy no longer matches (a script changed it).
+    bool Reset(GameObject* instance) const;
+
+    size_t GetNodeCount() const { return hierarchy.GetNodes().size(); }
+    const PrefabHierarchy& GetHierarchy() const { return hierarchy; }
+
+private:
+    PrefabHierarchy hierarchy;
+    std::vector<ResourceRequestPtr> resourceRequests;
+    bool resourcesAcquired = false;
+};
@@ -0,0 +1,148 @@
+#include "RenderQueue.h"
+#include <cstring>
+
+void RenderQueue::Reserve(size_t count)
+{
+    packets.reserve(count);
+    entries.reserve(count);
+    scratch.reserve(count);
+}
+
+void RenderQueue::Clear()
+{
+    // clear() keeps the capacity, so the next frame reuses the same storage
+    packets.clear();
+    entries.clear();
+}
+
+RenderPacket& RenderQueue::Push(uint64_t sortKey)
+{
+    entries.push_back({ sortKey, (uint32_t)packets.size() });
+    packets.emplace_back();
+    return packets.back();
+}
+
+void RenderQueue::Sort()
+{
+    SortEntries(entries, scratch);
+}
+
+void RenderQueue::SortEntries(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch)
+{
+    const size_t count = entries.size();
+    if (count < 2) return;
+
+    if (scratch.size() < count)
+        scratch.resize(count);
+
+    // One pass over the keys builds the histograms of all 8 bytes
+    uint32_t histograms[8][256];
+    memset(histograms, 0, sizeof(histograms));
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint64_t key = entries[i].key;
+        for (int byte = 0; byte < 8; ++byte)
+        {
+            histograms[byte][(key >> (byte * 8)) & 0xFF]++;
+        }
+    }
+
+    SortEntry* src = entries.data();
+    SortEntry* dst = scratch.data();
+
+    for (int byte = 0; byte < 8; ++byte)
+    {
+        uint32_t* histogram = histograms[byte];
+
+        // Every key has the same value in this byte, the pass would not move anything
+        if (histogram[(src[0].key >> (byte * 8)) & 0xFF] == count)
+            continue;
+
+        uint32_t offset = 0;
+        for (int bucket = 0; bucket < 256; ++bucket)
+        {
+            uint32_t bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint32_t bucket = (src[i].key >> (byte * 8)) & 0xFF;
+            dst[histogram[bucket]++] = src[i];
+        }
+
+        SortEntry* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    // After an odd number of passes the result lives in the scratch buffer
+    if (src != entries.data())
+        memcpy(entries.data(), src, count * sizeof(SortEntry));
+}
+
+void RenderQueue::BuildBatches(std::vector<RenderBatch>& batches, uint32_t minInstances) const
+{
+    batches.clear();
+
+    uint32_t instanceCount = 0;
+    const uint32_t count = (uint32_t)entries.size();
+    uint32_t i = 0;
+
+    while (i < count)
+    {
+        const RenderPacket& first = (*this)[i];
+        uint32_t end = i + 1;
+
+        if (minInstances > 0 && first.instanceable)
+        {
+            while (end < count)
+            {
+                const RenderPacket& next = (*this)[end];
+                if (!next.instanceable || next.shader != first.shader || next.material != first.material
+                    || next.VAO != first.VAO || next.indexCount != first.indexCount)
+                    break;
+                ++end;
+            }
+        }
+
+        uint32_t runLength = end - i;
+        if (runLength > 1 && runLength >= minInstances)
+        {
+            batches.push_back({ i, runLength, instanceCount });
+            instanceCount += runLength;
+        }
+        else
+        {
+            for (uint32_t j = i; j < end; ++j)
+                batches.push_back({ j, 1, 0 });
+        }
+
+        i = end;
+    }
+}
+
+uint32_t RenderQueue::DepthToBits(float depth)
+{
+    if (!(depth > 0.0f)) return 0;
+
+    // Positive IEEE floats already sort like unsigned integers
+    uint32_t bits;
+    memcpy(&bits, &depth, sizeof(bits));
+    return bits;
+}
+
+uint64_t RenderQueue::MakeOpaqueKey(uint32_t shaderKey, uint32_t materialKey, uint32_t meshKey, float depth)
+{
+    return ((uint64_t)(shaderKey & 0xFF) << 56)
+        | ((uint64_t)(materialKey & 0xFFFFFF) << 32)
+        | ((uint64_t)(meshKey & 0xFFFF) << 16)
+        | (DepthToBits(depth) >> 16);
+}
+
+uint64_t RenderQueue::MakeTransparentKey(float depth)
+{
+    return (uint64_t)(0xFFFFFFFFu - DepthToBits(depth));
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ComponentMesh;
+class Shader;
+class Material;
+
+// Everything the draw loop needs for one visible mesh. It is resolved once while
+// building the list, so submission never goes back to component/resource lookups.
+struct RenderPacket
+{
+    ComponentMesh* mesh = nullptr;
+    Shader* shader = nullptr;
+    Material* material = nullptr;
+
+    unsigned int VAO = 0;
+    unsigned int indexCount = 0;
+    unsigned int indexType = 0;     // GL_UNSIGNED_SHORT / GL_UNSIGNED_INT
+
+    glm::mat4 modelMatrix = glm::mat4(1.0f);
+    float depth = 0.0f;
+
+    // Can share an instanced draw (no skinning, no per-object stencil)
+    bool instanceable = false;
+};
+
+// Run of sorted packets submitted together. count > 1 means one instanced draw
+// whose model matrices start at baseInstance in the instance buffer.
+struct RenderBatch
+{
+    uint32_t first = 0;
+    uint32_t count = 0;
+    uint32_t baseInstance = 0;
+};
+
+// Flat packet array sorted by a 64-bit key with an LSD radix sort.
+// Storage is kept between frames, so once the scene has been seen at its largest
+// size building and sorting the queue does not touch the heap.
+class RenderQueue
+{
+public:
+    void Reserve(size_t count);
+    void Clear();
+
+    // Appends a packet and returns it to be filled in
+    RenderPacket& Push(uint64_t sortKey);
+
+    void Sort();
+
+    // Groups consecutive instanceable packets with the same shader, material and mesh.
+    // Runs shorter than minInstances are emitted one packet per batch; 0 disables merging.
+    // Valid after Sort.
+    void BuildBatches(std::vector<RenderBatch>& batches, uint32_t minInstances) const;
+
+    size_t Size() const { return packets.size(); }
+    bool Empty() const { return packets.empty(); }
+
+    // Packets in sorted order (valid after Sort)
+    const RenderPacket& operator[](size_t i) const { return packets[entries[i].index]; }
+
+    // Opaque: shader (8 bits) -> material (24) -> mesh (16) -> coarse front-to-back depth (16),
+    // so submission only changes state on transitions
+    static uint64_t MakeOpaqueKey(uint32_t shaderKey, uint32_t materialKey, uint32_t meshKey, float depth);
+    // Transparent: strictly back to front
+    static uint64_t MakeTransparentKey(float depth);
+
+    // Maps a non-negative float to an integer with the same ordering
+    static uint32_t DepthToBits(float depth);
+
+    struct SortEntry
+    {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    // LSD radix sort by key, stable. scratch is resized as needed and can be reused.
+    static void SortEntries(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch);
+
+private:
+    std::vector<RenderPacket> packets;
+    std::vector<SortEntry> entries;
+    std::vector<SortEntry> scratch;
+};
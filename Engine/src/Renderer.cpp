@@ -75,6 +75,22 @@ bool Renderer::Start()
         return false;
     }
 
+    defaultInstancedShader = make_unique<ShaderNoTexture>(true);
+    if (!defaultInstancedShader->CreateShader())
+    {
+        LOG_DEBUG("ERROR: Failed to create instanced default shader");
+        LOG_CONSOLE("ERROR: Failed to compile shaders");
+        return false;
+    }
+
+    standardInstancedShader = make_unique<ShaderStandard>(true);
+    if (!standardInstancedShader->CreateShader())
+    {
+        LOG_DEBUG("ERROR: Failed to create instanced standard shader");
+        LOG_CONSOLE("ERROR: Failed to compile shaders");
+        return false;
+    }
+
     lineShader = make_unique<ShaderLines>();
     if (!lineShader->CreateShader())
     {
@@ -146,6 +162,33 @@ bool Renderer::Start()
         return false;
     }
 
+    if (!particleRenderer.Init())
+        return false;
+
+    // Post processing sets every parameter each frame, resolve them once
+    postProcessUniforms.sceneTexture = postProcessShader->GetUniform<int>("sceneTexture");
+    postProcessUniforms.gradingEnabled = postProcessShader->GetUniform<bool>("gradingEnabled");
+    postProcessUniforms.exposure = postProcessShader->GetUniform<float>("exposure");
+    postProcessUniforms.contrast = postProcessShader->GetUniform<float>("contrast");
+    postProcessUniforms.saturation = postProcessShader->GetUniform<float>("saturation");
+    postProcessUniforms.toneMapper = postProcessShader->GetUniform<int>("toneMapper");
+    postProcessUniforms.gamma = postProcessShader->GetUniform<float>("gamma");
+    postProcessUniforms.temperature = postProcessShader->GetUniform<float>("temperature");
+    postProcessUniforms.tint = postProcessShader->GetUniform<float>("tint");
+    postProcessUniforms.colorFilter = postProcessShader->GetUniform<glm::vec3>("colorFilter");
+    postProcessUniforms.bloomEnabled = postProcessShader->GetUniform<bool>("bloomEnabled");
+    postProcessUniforms.bloomIntensity = postProcessShader->GetUniform<float>("bloomIntensity");
+    postProcessUniforms.bloomThreshold = postProcessShader->GetUniform<float>("bloomThreshold");
+    postProcessUniforms.bloomSoftKnee = postProcessShader->GetUniform<float>("bloomSoftKnee");
+    postProcessUniforms.bloomTint = postProcessShader->GetUniform<glm::vec3>("bloomTint");
+    postProcessUniforms.caEnabled = postProcessShader->GetUniform<bool>("caEnabled");
+    postProcessUniforms.caIntensity = postProcessShader->GetUniform<float>("caIntensity");
+    postProcessUniforms.vignetteEnabled = postProcessShader->GetUniform<bool>("vignetteEnabled");
+    postProcessUniforms.vignetteIntensity = postProcessShader->GetUniform<float>("vignetteIntensity");
+    postProcessUniforms.vignetteSmoothness = postProcessShader->GetUniform<float>("vignetteSmoothness");
+    postProcessUniforms.vignetteRoundness = postProcessShader->GetUniform<float>("vignetteRoundness");
+    postProcessUniforms.vignetteColor = postProcessShader->GetUniform<glm::vec4>("vignetteColor");
+
     lightManager = std::make_unique<LightManager>();
 
     // Fullscreen quad VAO for UI overlay
@@ -168,16 +211,11 @@ bool Renderer::Start()
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
     glBindVertexArray(0);
 
-    glGenBuffers(1, &ssboBones);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboBones);
-    glBufferData(GL_SHADER_STORAGE_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ssboBones);
-
-    glGenBuffers(1, &uboMatrices);
-    glBindBuffer(GL_UNIFORM_BUFFER, uboMatrices);
-    glBufferData(GL_UNIFORM_BUFFER, 2 * sizeof(glm::mat4), NULL, GL_STATIC_DRAW);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
-    glBindBufferBase(GL_UNIFORM_BUFFER, 0, uboMatrices);
+    if (!frameRing.Init(FRAME_RING_SIZE, FRAME_RING_FRAMES))
+    {
+        LOG_CONSOLE("ERROR: Failed to create frame ring buffer");
+        return false;
+    }
 
     defaultTexture = make_unique<Texture>();
     defaultTexture->CreateCheckerboard();
@@ -207,6 +245,12 @@ bool Renderer::PreUpdate()
     normalsList.clear();
     meshLinesList.clear();
 
+    lastFrameStats = frameStats;
+    frameStats = RenderStats();
+
+    frameRing.NextFrame();
+    frameIndex++;
+
     return ret;
 }
 
@@ -216,29 +260,18 @@ void Renderer::LoadMesh(Mesh& mesh)
     glGenVertexArrays(1, &mesh.VAO);
     glBindVertexArray(mesh.VAO);
 
+    // Meshes built in code upload their Vertex array as is, the packed formats come from the Library
+    mesh.vertexFormat = VertexFormat::FULL;
+    mesh.indexSize = sizeof(unsigned int);
+    const VertexLayout& layout = VertexLayout::Get(mesh.vertexFormat);
+
     // Upload vertex data to GPU
     glGenBuffers(1, &mesh.VBO);
     glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
-    glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(Vertex), &mesh.vertices[0], GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * layout.stride, &mesh.vertices[0], GL_STATIC_DRAW);
 
     // Configure vertex attributes
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
-
-    glEnableVertexAttribArray(3);
-    glVertexAttribIPointer(3, 4, GL_INT, sizeof(Vertex), (void*)offsetof(Vertex, boneIDs));
-
-    glEnableVertexAttribArray(4);
-    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, weights));
-
-    glEnableVertexAttribArray(5);
-    glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tangent));
+    layout.Apply();
 
     // Upload index data
     glGenBuffers(1, &mesh.EBO);
@@ -271,38 +304,35 @@ void Renderer::UnloadMesh(Mesh& mesh)
     }
 }
 
-void Renderer::DrawMesh(const ComponentMesh* meshComp)
+void Renderer::DrawMesh(const ComponentMesh* meshComp, const Shader* shader)
 {
-    if (meshComp->GetMesh().VAO == 0) return;
+    const Mesh& mesh = meshComp->GetMesh();
+    DrawMesh(meshComp, shader, mesh.VAO, mesh.GetIndexCount(), mesh.GetIndexType());
+}
 
-    GLint currentProgram;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+void Renderer::DrawMesh(const ComponentMesh* meshComp, const Shader* shader, unsigned int VAO, unsigned int indexCount, unsigned int indexType)
+{
+    if (VAO == 0) return;
 
     if (meshComp->HasSkinning())
     {
-        ComponentSkinnedMesh* skinnedComp = (ComponentSkinnedMesh*)meshComp;
-
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, skinnedComp->GetSSBOGlobal());
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, skinnedComp->GetSSBOOffset());
-
-        glUniform1i(glGetUniformLocation(currentProgram, "hasBones"), true);
-
-        glUniformMatrix4fv(glGetUniformLocation(currentProgram, "meshInverse"), 1, GL_FALSE,
-            glm::value_ptr(skinnedComp->GetMeshInverse()));
+        BindSkinningPalette(((const ComponentSkinnedMesh*)meshComp)->GetPaletteBuffer());
+        shader->Set(shader->GetHasBonesUniform(), true);
+        shader->Set(shader->GetBoneBaseUniform(), ((const ComponentSkinnedMesh*)meshComp)->GetPaletteBase());
     }
     else
     {
-        glUniform1i(glGetUniformLocation(currentProgram, "hasBones"), false);
+        shader->Set(shader->GetHasBonesUniform(), false);
     }
 
-    glBindVertexArray(meshComp->GetMesh().VAO);
-    glDrawElements(GL_TRIANGLES, (GLsizei)meshComp->GetNumIndices(), GL_UNSIGNED_INT, 0);
+    glBindVertexArray(VAO);
+    glDrawElements(GL_TRIANGLES, (GLsizei)indexCount, indexType, 0);
     glBindVertexArray(0);
+    frameStats.drawCalls++;
 
     if (meshComp->HasSkinning())
     {
         glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0);
     }
 }
 
@@ -388,6 +418,8 @@ bool Renderer::PostUpdate()
     int width = 0, height = 0;
     Application::GetInstance().window->GetWindowSize(width, height);
 
+    SimulateParticles();
+
     for (CameraLens* camera : activeCameras)
     {
         RenderScene(camera);
@@ -435,13 +467,11 @@ bool Renderer::RenderScene(CameraLens* camera)
     glClearStencil(0);
 
     //Camera Matrices
-    UpdateViewMatrix(camera->GetViewMatrix());
-    UpdateProjectionMatrix(camera->GetProjectionMatrix());
-    glBindBufferBase(GL_UNIFORM_BUFFER, 0, uboMatrices);
+    UploadCameraMatrices(camera->GetViewMatrix(), camera->GetProjectionMatrix());
 
     //Build Render List
-    opaqueList.clear();
-    transparentList.clear();
+    opaqueQueue.Clear();
+    transparentQueue.Clear();
     particlesList.clear();
     canvasList.clear();
     BuildRenderLists(camera);
@@ -462,11 +492,18 @@ bool Renderer::RenderScene(CameraLens* camera)
     glDepthMask(GL_TRUE);
     glDisable(GL_BLEND);
     glEnable(GL_CULL_FACE);
-    DrawRenderList(opaqueList, camera);
+
+    // Lights are shared by every lit draw of this camera
+    if (lightManager) {
+        lightManager->Upload(frameRing);
+        frameStats.bufferUploads += LightManager::BUFFERS_PER_UPLOAD;
+    }
+
+    DrawRenderList(opaqueQueue, camera, true);
 
     glEnable(GL_BLEND);
     glDepthMask(GL_FALSE);
-    DrawRenderList(transparentList, camera);
+    DrawRenderList(transparentQueue, camera, false);
     DrawParticlesList(camera);
 
     if (camera->GetDebugCamera()) {
@@ -506,38 +543,65 @@ bool Renderer::RenderScene(CameraLens* camera)
 
 void Renderer::BuildRenderLists(const CameraLens* camera)
 {
-    for (ComponentMesh* mesh : meshes)
+    // Frustum culling is done by the scene octree, so cost scales with visible objects
+    visibleObjects.clear();
+    Application::GetInstance().scene->CollectVisible(*camera->GetFrustum(), visibleObjects);
+
+    for (GameObject* gameObject : visibleObjects)
     {
-        if (!mesh || !mesh->owner || !mesh->owner->transform) continue;
-        if (!mesh->owner->IsActive()) continue;
+        if (!gameObject || !gameObject->transform) continue;
+        if (!gameObject->IsActive()) continue;
+
+        ComponentMesh* mesh = static_cast<ComponentMesh*>(gameObject->GetComponent(ComponentType::MESH));
+        if (!mesh) continue;
 
-        Mesh resMesh = mesh->GetMesh();
+        // Resolve the mesh resource once; the packet keeps what the draw needs
+        const Mesh& resMesh = mesh->GetMesh();
         if (!resMesh.IsValid()) continue;
 
-        glm::mat4 globalModelMatrix = mesh->owner->transform->GetGlobalMatrix();
+        mesh->UpdateSkinningMatrices();
 
         const AABB& globalAABB = mesh->GetGlobalAABB();
+        glm::vec3 aabbCenter = (globalAABB.min + globalAABB.max) * 0.5f;
+        float distanceToCamera = glm::distance(aabbCenter, camera->position);
 
-        if (camera->GetFrustum()->InFrustum(mesh->GetGlobalAABB()))
-        {
-            mesh->UpdateSkinningMatrices();
-
-            RenderObject renderObject = { mesh, globalModelMatrix };
+        ComponentMaterial* materialComp = mesh->GetAttachedMaterial();
+        Material* material = materialComp ? materialComp->GetMaterial() : nullptr;
 
-            glm::vec3 aabbCenter = (globalAABB.min + globalAABB.max) * 0.5f;
-            float distanceToCamera = glm::distance(aabbCenter, camera->position);
+        Shader* shader = defaultShader.get();
+        uint32_t shaderSlot = 0;
+        if (material && material->GetType() == MaterialType::STANDARD)
+        {
+            shader = standardShader.get();
+            shaderSlot = 1;
+        }
 
-            if (mesh->GetAttachedMaterial() && mesh->GetAttachedMaterial()->IsActive() && mesh->GetAttachedMaterial()->GetOpacity() != 1.0f)
-            {
-                transparentList.emplace(distanceToCamera, renderObject);
-            }
-            else
-            {
-                opaqueList.emplace(distanceToCamera, renderObject);
-            }
+        RenderPacket* packet = nullptr;
+        if (materialComp && materialComp->IsActive() && materialComp->GetOpacity() != 1.0f)
+        {
+            packet = &transparentQueue.Push(RenderQueue::MakeTransparentKey(distanceToCamera));
         }
+        else
+        {
+            UID materialUID = materialComp ? materialComp->GetMaterialUID() : 0;
+            uint32_t materialKey = (uint32_t)(materialUID ^ (materialUID >> 32));
+            packet = &opaqueQueue.Push(RenderQueue::MakeOpaqueKey(shaderSlot, materialKey, resMesh.VAO, distanceToCamera));
+        }
+
+        packet->mesh = mesh;
+        packet->shader = shader;
+        packet->material = material;
+        packet->VAO = resMesh.VAO;
+        packet->indexCount = resMesh.GetIndexCount();
+        packet->indexType = resMesh.GetIndexType();
+        packet->modelMatrix = gameObject->transform->GetGlobalMatrix();
+        packet->depth = distanceToCamera;
+        packet->instanceable = !mesh->HasSkinning() && !gameObject->IsSelected();
     }
 
+    opaqueQueue.Sort();
+    transparentQueue.Sort();
+
     for (ComponentParticleSystem* ps : particles)
     {
         if (!ps || !ps->owner || !ps->owner->transform) continue;
@@ -553,10 +617,7 @@ void Renderer::BuildRenderLists(const CameraLens* camera)
             pObj.modelMatrix = glm::mat4(1.0f);
         }
 
-        glm::vec3 pos = ps->owner->transform->GetGlobalPosition();
-        float distanceToCamera = glm::distance(pos, camera->position);
-
-        particlesList.emplace(distanceToCamera, pObj);
+        particlesList.push_back(pObj);
     }
 
     for (ComponentCanvas* canvas : activeCanvas)
@@ -598,36 +659,36 @@ void Renderer::DrawPostProcessing(const CameraLens* camera)
 
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, postProcessTexture);
-    postProcessShader->SetInt("sceneTexture", 0);
+    postProcessShader->Set(postProcessUniforms.sceneTexture, 0);
 
     // Color Grading
-    postProcessShader->SetBool("gradingEnabled", activePP->colorGrading.enabled);
-    postProcessShader->SetFloat("exposure", activePP->colorGrading.exposure);
-    postProcessShader->SetFloat("contrast", activePP->colorGrading.contrast);
-    postProcessShader->SetFloat("saturation", activePP->colorGrading.saturation);
-    postProcessShader->SetInt("toneMapper", activePP->colorGrading.toneMapper);
-    postProcessShader->SetFloat("gamma", activePP->colorGrading.gamma);
-    postProcessShader->SetFloat("temperature", activePP->colorGrading.temperature);
-    postProcessShader->SetFloat("tint", activePP->colorGrading.tint);
-    postProcessShader->SetVec3("colorFilter", activePP->colorGrading.colorFilter);
+    postProcessShader->Set(postProcessUniforms.gradingEnabled, activePP->colorGrading.enabled);
+    postProcessShader->Set(postProcessUniforms.exposure, activePP->colorGrading.exposure);
+    postProcessShader->Set(postProcessUniforms.contrast, activePP->colorGrading.contrast);
+    postProcessShader->Set(postProcessUniforms.saturation, activePP->colorGrading.saturation);
+    postProcessShader->Set(postProcessUniforms.toneMapper, activePP->colorGrading.toneMapper);
+    postProcessShader->Set(postProcessUniforms.gamma, activePP->colorGrading.gamma);
+    postProcessShader->Set(postProcessUniforms.temperature, activePP->colorGrading.temperature);
+    postProcessShader->Set(postProcessUniforms.tint, activePP->colorGrading.tint);
+    postProcessShader->Set(postProcessUniforms.colorFilter, activePP->colorGrading.colorFilter);
 
     // Bloom
-    postProcessShader->SetBool("bloomEnabled", activePP->bloom.enabled);
-    postProcessShader->SetFloat("bloomIntensity", activePP->bloom.intensity);
-    postProcessShader->SetFloat("bloomThreshold", activePP->bloom.threshold);
-    postProcessShader->SetFloat("bloomSoftKnee", activePP->bloom.softKnee);
-    postProcessShader->SetVec3("bloomTint", activePP->bloom.tint);
+    postProcessShader->Set(postProcessUniforms.bloomEnabled, activePP->bloom.enabled);
+    postProcessShader->Set(postProcessUniforms.bloomIntensity, activePP->bloom.intensity);
+    postProcessShader->Set(postProcessUniforms.bloomThreshold, activePP->bloom.threshold);
+    postProcessShader->Set(postProcessUniforms.bloomSoftKnee, activePP->bloom.softKnee);
+    postProcessShader->Set(postProcessUniforms.bloomTint, activePP->bloom.tint);
 
     // Chromatic Aberration
-    postProcessShader->SetBool("caEnabled", activePP->lens.chromaticAberrationEnabled);
-    postProcessShader->SetFloat("caIntensity", activePP->lens.chromaticAberrationIntensity);
+    postProcessShader->Set(postProcessUniforms.caEnabled, activePP->lens.chromaticAberrationEnabled);
+    postProcessShader->Set(postProcessUniforms.caIntensity, activePP->lens.chromaticAberrationIntensity);
 
     // Vignette
-    postProcessShader->SetBool("vignetteEnabled", activePP->lens.vignetteEnabled);
-    postProcessShader->SetFloat("vignetteIntensity", activePP->lens.vignetteIntensity);
-    postProcessShader->SetFloat("vignetteSmoothness", activePP->lens.vignetteSmoothness);
-    postProcessShader->SetFloat("vignetteRoundness", activePP->lens.vignetteRoundness);
-    postProcessShader->SetVec4("vignetteColor", activePP->lens.vignetteColor);
+    postProcessShader->Set(postProcessUniforms.vignetteEnabled, activePP->lens.vignetteEnabled);
+    postProcessShader->Set(postProcessUniforms.vignetteIntensity, activePP->lens.vignetteIntensity);
+    postProcessShader->Set(postProcessUniforms.vignetteSmoothness, activePP->lens.vignetteSmoothness);
+    postProcessShader->Set(postProcessUniforms.vignetteRoundness, activePP->lens.vignetteRoundness);
+    postProcessShader->Set(postProcessUniforms.vignetteColor, activePP->lens.vignetteColor);
 
     glDisable(GL_DEPTH_TEST);
     glDisable(GL_CULL_FACE);
@@ -637,91 +698,182 @@ void Renderer::DrawPostProcessing(const CameraLens* camera)
     glUseProgram(0);
 }
 
-void Renderer::DrawRenderList(const std::multimap<float, RenderObject>& map, const CameraLens* camera)
+void Renderer::DrawRenderList(const RenderQueue& queue, const CameraLens* camera, bool allowInstancing)
 {
-    for (auto pair = map.rbegin(); pair != map.rend(); ++pair)
+    queue.BuildBatches(renderBatches, (allowInstancing && instancingEnabled) ? INSTANCING_MIN_BATCH : 0);
+    if (!UploadInstanceMatrices(queue))
     {
-        RenderObject renderObject = pair->second;
-        ComponentMesh* meshComp = renderObject.mesh;
-        ComponentMaterial* materialComp = meshComp->GetAttachedMaterial();
-
-        if (meshComp->GetDrawNormals()) normalsList.push_back(renderObject);
-        if (meshComp->GetDrawMesh()) meshLinesList.push_back(renderObject);
-        if (meshComp->owner->IsSelected()) {
-            stencilList.push_back(renderObject);
-            glStencilFunc(GL_ALWAYS, 1, 0xFF);
-            glStencilMask(0xFF);
+        // Instanced draws would read an SSBO nobody wrote this frame: draw packet by packet
+        queue.BuildBatches(renderBatches, 0);
+    }
+
+    // Packets come sorted by state, so GL calls are only issued when something changes
+    Shader* boundShader = nullptr;
+    const Material* boundMaterial = nullptr;
+    bool materialBound = false;
+    unsigned int boundVAO = 0;
+    int boundHasBones = -1;
+    int boundStencil = -1;
+    unsigned int boundPalette = 0;
+
+    for (const RenderBatch& batch : renderBatches)
+    {
+        const RenderPacket& packet = queue[batch.first];
+        ComponentMesh* meshComp = packet.mesh;
+        bool instancedBatch = batch.count > 1;
+
+        for (uint32_t i = batch.first; i < batch.first + batch.count; ++i)
+        {
+            const RenderPacket& instance = queue[i];
+            if (instance.mesh->GetDrawNormals()) normalsList.push_back({ instance.mesh, instance.modelMatrix });
+            if (instance.mesh->GetDrawMesh()) meshLinesList.push_back({ instance.mesh, instance.modelMatrix });
         }
-        else {
-            glStencilFunc(GL_ALWAYS, 0, 0xFF);
-            glStencilMask(0x00);
+
+        int stencil = meshComp->owner->IsSelected() ? 1 : 0;
+        if (stencil) stencilList.push_back({ meshComp, packet.modelMatrix });
+        if (stencil != boundStencil) {
+            glStencilFunc(GL_ALWAYS, stencil, 0xFF);
+            glStencilMask(stencil ? 0xFF : 0x00);
+            boundStencil = stencil;
         }
 
-        Shader* currentShader = defaultShader.get();
+        Shader* shader = instancedBatch ? GetInstancedShader(packet.shader) : packet.shader;
+        if (shader != boundShader)
+        {
+            boundShader = shader;
+            boundShader->Use();
+            boundShader->Set(boundShader->GetSceneUniforms().viewPos, camera->position);
+            boundShader->Set(boundShader->GetSceneUniforms().lightDir, lightDir);
+            if (lightManager)
+                lightManager->ApplyToShader(boundShader);
+
+            // Uniform values are per program, so everything below must be set again
+            materialBound = false;
+            boundHasBones = -1;
+            frameStats.programBinds++;
+        }
+
+        if (!materialBound || packet.material != boundMaterial)
+        {
+            if (packet.material) {
+                packet.material->Bind(boundShader);
+                frameStats.textureBinds += packet.material->GetBoundTextureCount();
+            }
+            else
+            {
+                // The fallback checkerboard is not a material texture, it is not counted
+                glBindTexture(GL_TEXTURE_2D, defaultTexture->GetID());
+            }
 
-        if (materialComp && materialComp->GetMaterial()) {
-            Material* data = materialComp->GetMaterial();
+            boundMaterial = packet.material;
+            materialBound = true;
+            frameStats.materialBinds++;
+        }
 
-            switch (data->GetType()) {
-            case MaterialType::STANDARD: currentShader = standardShader.get(); 
-                break;
+        int hasBones = (!instancedBatch && meshComp->HasSkinning()) ? 1 : 0;
+        if (hasBones)
+        {
+            // Skinned meshes share the ring's palette binding, only their base changes per draw
+            const ComponentSkinnedMesh* skinned = (const ComponentSkinnedMesh*)meshComp;
+            if (skinned->GetPaletteBuffer() != boundPalette)
+            {
+                boundPalette = skinned->GetPaletteBuffer();
+                BindSkinningPalette(boundPalette);
             }
+            boundShader->Set(boundShader->GetBoneBaseUniform(), skinned->GetPaletteBase());
+        }
+        if (hasBones != boundHasBones)
+        {
+            boundShader->Set(boundShader->GetHasBonesUniform(), hasBones != 0);
+            boundHasBones = hasBones;
         }
 
-        currentShader->Use();
-        currentShader->SetMat4("model", renderObject.globalModelMatrix);
-        currentShader->SetVec3("viewPos", camera->position);
-        currentShader->SetVec3("lightDir", lightDir);
-        // Upload all scene lights 
-        if (lightManager)
-            lightManager->UploadToShader(currentShader);
+        if (packet.VAO != boundVAO)
+        {
+            glBindVertexArray(packet.VAO);
+            boundVAO = packet.VAO;
+        }
 
-        if (materialComp && materialComp->GetMaterial()) {
-            materialComp->GetMaterial()->Bind(currentShader);
+        if (instancedBatch)
+        {
+            glDrawElementsInstancedBaseInstance(GL_TRIANGLES, (GLsizei)packet.indexCount, packet.indexType, 0,
+                (GLsizei)batch.count, batch.baseInstance);
+            frameStats.instancedDrawCalls++;
+            frameStats.instances += batch.count;
         }
-        else 
+        else
         {
-            glBindTexture(GL_TEXTURE_2D, defaultTexture->GetID());
+            boundShader->Set(boundShader->GetModelUniform(), packet.modelMatrix);
+            glDrawElements(GL_TRIANGLES, (GLsizei)packet.indexCount, packet.indexType, 0);
         }
+        frameStats.drawCalls++;
+    }
+
+    glBindVertexArray(0);
 
-        DrawMesh(meshComp);
+    if (boundPalette != 0)
+    {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
     }
 }
 
-void Renderer::DrawParticlesList(const CameraLens* camera)
+bool Renderer::UploadInstanceMatrices(const RenderQueue& queue)
 {
-    if (particlesList.empty()) return;
+    uint32_t instanceCount = 0;
+    for (const RenderBatch& batch : renderBatches)
+    {
+        if (batch.count > 1) instanceCount += batch.count;
+    }
 
-    glUseProgram(0);
+    if (instanceCount == 0) return true;
 
-    glMatrixMode(GL_PROJECTION);
-    glPushMatrix();
-    glLoadMatrixf(glm::value_ptr(camera->GetProjectionMatrix()));
+    // Matrices are written straight into the mapped ring, in baseInstance order
+    FrameRingAllocation allocation;
+    glm::mat4* dst = (glm::mat4*)frameRing.Allocate(instanceCount * sizeof(glm::mat4), frameRing.GetStorageAlignment(), allocation);
+    if (!dst) return false;
 
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-    glLoadMatrixf(glm::value_ptr(camera->GetViewMatrix()));
+    for (const RenderBatch& batch : renderBatches)
+    {
+        if (batch.count < 2) continue;
 
-    ComponentCamera* mainCam = Application::GetInstance().camera->GetMainCamera();
-    glm::vec3 billboardPos = (mainCam && mainCam->GetLens())
-        ? mainCam->GetLens()->position
-        : camera->position;
+        for (uint32_t i = batch.first; i < batch.first + batch.count; ++i)
+            *dst++ = queue[i].modelMatrix;
+    }
 
-    for (const auto& pair : particlesList)
-    {
-        glMatrixMode(GL_MODELVIEW);
-        glPushMatrix();
-        glMultMatrixf(glm::value_ptr(pair.second.modelMatrix));
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 5, allocation.buffer, allocation.offset, allocation.size);
+    frameStats.bufferUploads++;
+    return true;
+}
 
-        pair.second.system->GetEmitter()->Draw(billboardPos);
+Shader* Renderer::GetInstancedShader(const Shader* shader) const
+{
+    if (shader == standardShader.get()) return standardInstancedShader.get();
+    return defaultInstancedShader.get();
+}
 
-        glPopMatrix();
-    }
+void Renderer::SimulateParticles()
+{
+    // Emitters are independent (own pool, modules and RNG), one job each.
+    // ParallelFor returns when all of them are done, before any camera draws them.
+    Application::GetInstance().jobs->ParallelFor((uint32_t)particles.size(), 1, [this](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; ++i)
+                particles[i]->Simulate();
+        });
+}
+
+void Renderer::DrawParticlesList(const CameraLens* camera)
+{
+    if (particlesList.empty()) return;
+
+    // Every emitter goes into one instance list, drawn once per blend mode / texture.
+    // Quads face the rendering camera; view and projection come from the Matrices UBO.
+    particleRenderer.Begin(camera->position);
 
-    glMatrixMode(GL_PROJECTION);
-    glPopMatrix();
-    glMatrixMode(GL_MODELVIEW);
-    glPopMatrix();
+    for (const ParticleObject& particleObject : particlesList)
+        particleRenderer.AddEmitter(*particleObject.system->GetEmitter(), particleObject.modelMatrix);
+
+    particleRenderer.Flush(frameRing, frameStats);
 }
 
 void Renderer::DrawCanvasList(const CameraLens* camera)
@@ -786,7 +938,7 @@ void Renderer::DrawStencilList(const CameraLens* camera)
     glEnable(GL_STENCIL_TEST);
     glDisable(GL_CULL_FACE);
 
-    for (RenderObject renderObject : stencilList)
+    for (const RenderObject& renderObject : stencilList)
     {
         ComponentMesh* meshComp = renderObject.mesh;
 
@@ -801,8 +953,8 @@ void Renderer::DrawStencilList(const CameraLens* camera)
         glDepthMask(GL_FALSE);
 
         defaultShader->Use();
-        glUniformMatrix4fv(glGetUniformLocation(defaultShader->GetProgramID(), "model"), 1, GL_FALSE, glm::value_ptr(renderObject.globalModelMatrix));
-        DrawMesh(meshComp);
+        defaultShader->Set(defaultShader->GetModelUniform(), renderObject.globalModelMatrix);
+        DrawMesh(meshComp, defaultShader.get());
 
         glStencilFunc(GL_NOTEQUAL, 1, 0xFF);
         glStencilMask(0x00);
@@ -818,7 +970,7 @@ void Renderer::DrawStencilList(const CameraLens* camera)
         outlineShader->SetVec3("outlineColor", glm::vec3(1.0f, 0.41f, 0.71f));
         outlineShader->SetFloat("outlineThickness", 0.04f);
 
-        DrawMesh(meshComp);
+        DrawMesh(meshComp, outlineShader.get());
     }
 
     glDepthMask(depthWriteEnabled);
@@ -837,28 +989,26 @@ void Renderer::DrawNormalsList(const CameraLens* camera)
     normalsShader->Use();
     normalsShader->SetVec4("lineColor", glm::vec4(0.0f, 1.0f, 1.0f, 1.0f));
 
-    for (RenderObject renderObject : normalsList)
+    for (const RenderObject& renderObject : normalsList)
     {
         ComponentMesh* meshComp = renderObject.mesh;
 
-        glUniformMatrix4fv(glGetUniformLocation(normalsShader->GetProgramID(), "model"),
-            1, GL_FALSE, glm::value_ptr(renderObject.globalModelMatrix));
+        normalsShader->Set(normalsShader->GetModelUniform(), renderObject.globalModelMatrix);
 
         if (meshComp->HasSkinning())
         {
             ComponentSkinnedMesh* skinned = (ComponentSkinnedMesh*)meshComp;
-            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, skinned->GetSSBOGlobal());
-            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, skinned->GetSSBOOffset());
-            normalsShader->SetBool("hasBones", true);
-            normalsShader->SetMat4("meshInverse", skinned->GetMeshInverse());
+            BindSkinningPalette(skinned->GetPaletteBuffer());
+            normalsShader->Set(normalsShader->GetHasBonesUniform(), true);
+            normalsShader->Set(normalsShader->GetBoneBaseUniform(), skinned->GetPaletteBase());
         }
         else
         {
-            normalsShader->SetBool("hasBones", false);
+            normalsShader->Set(normalsShader->GetHasBonesUniform(), false);
         }
 
         glBindVertexArray(meshComp->GetMesh().VAO);
-        glDrawArrays(GL_POINTS, 0, (GLsizei)meshComp->GetMesh().vertices.size());
+        glDrawArrays(GL_POINTS, 0, (GLsizei)meshComp->GetMesh().GetVertexCount());
 
         glBindVertexArray(0);
     }
@@ -875,25 +1025,24 @@ void Renderer::DrawMeshLinesList(const CameraLens* camera)
     glEnable(GL_POLYGON_OFFSET_LINE);
     glPolygonOffset(-1.0f, -1.0f);
 
-    for (RenderObject renderObject : meshLinesList)
+    for (const RenderObject& renderObject : meshLinesList)
     {
         ComponentMesh* meshComp = renderObject.mesh;
 
-        meshShader->SetMat4("model", renderObject.globalModelMatrix);
+        meshShader->Set(meshShader->GetModelUniform(), renderObject.globalModelMatrix);
 
         if (meshComp->HasSkinning()) {
             ComponentSkinnedMesh* skinned = (ComponentSkinnedMesh*)meshComp;
-            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, skinned->GetSSBOGlobal());
-            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, skinned->GetSSBOOffset());
-            meshShader->SetBool("hasBones", true);
-            meshShader->SetMat4("meshInverse", skinned->GetMeshInverse());
+            BindSkinningPalette(skinned->GetPaletteBuffer());
+            meshShader->Set(meshShader->GetHasBonesUniform(), true);
+            meshShader->Set(meshShader->GetBoneBaseUniform(), skinned->GetPaletteBase());
         }
         else {
-            meshShader->SetBool("hasBones", false);
+            meshShader->Set(meshShader->GetHasBonesUniform(), false);
         }
 
         glBindVertexArray(meshComp->GetMesh().VAO);
-        glDrawElements(GL_TRIANGLES, (GLsizei)meshComp->GetNumIndices(), GL_UNSIGNED_INT, 0);
+        glDrawElements(GL_TRIANGLES, (GLsizei)meshComp->GetNumIndices(), meshComp->GetMesh().GetIndexType(), 0);
     }
 
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
@@ -912,6 +1061,9 @@ bool Renderer::CleanUp()
     UnloadMesh(pyramid);
 
     if (defaultShader)  defaultShader->Delete();
+    if (standardShader) standardShader->Delete();
+    if (defaultInstancedShader)  defaultInstancedShader->Delete();
+    if (standardInstancedShader) standardInstancedShader->Delete();
     if (lineShader)     lineShader->Delete();
     if (outlineShader)  outlineShader->Delete();
     if (depthShader)    depthShader->Delete();
@@ -926,12 +1078,16 @@ bool Renderer::CleanUp()
         quadVBO = 0;
     }
 
-    if (normalLinesVAO != 0)
+    if (linesVAO != 0)
     {
-        glDeleteVertexArrays(1, &normalLinesVAO);
-        glDeleteBuffers(1, &normalLinesVBO);
+        glDeleteVertexArrays(1, &linesVAO);
+        linesVAO = 0;
     }
 
+    particleRenderer.CleanUp();
+    lightManager.reset();
+    frameRing.Destroy();
+
     if (postProcessFBO != 0) {
         glDeleteFramebuffers(1, &postProcessFBO);
         glDeleteTextures(1, &postProcessTexture);
@@ -947,8 +1103,8 @@ bool Renderer::CleanUp()
     meshes.clear();
     activeCameras.clear();
     postProcessingComponents.clear();
-    opaqueList.clear();
-    transparentList.clear();
+    opaqueQueue.Clear();
+    transparentQueue.Clear();
     stencilList.clear();
     normalsList.clear();
     meshLinesList.clear();
@@ -994,39 +1150,24 @@ void Renderer::ResizePostProcessingBuffer(int width, int height)
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-void Renderer::CreateSkinningSSBOs(unsigned int& ssboGlobal, unsigned int& ssboOffset, const std::vector<glm::mat4>& offsets)
+glm::mat4* Renderer::AllocateBoneMatrices(size_t count, FrameRingAllocation& outAllocation)
 {
-    size_t numBones = offsets.size();
-
-    if (ssboOffset == 0) glGenBuffers(1, &ssboOffset);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboOffset);
-    glBufferData(GL_SHADER_STORAGE_BUFFER, numBones * sizeof(glm::mat4), offsets.data(), GL_STATIC_DRAW);
-
-    if (ssboGlobal == 0) glGenBuffers(1, &ssboGlobal);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboGlobal);
+    // Bone matrices change every frame, so they live in the frame ring instead of a per-mesh SSBO.
+    // Aligned to a whole matrix so the shader can index them from the start of the ring.
+    size_t alignment = std::max(frameRing.GetStorageAlignment(), sizeof(glm::mat4));
+    void* data = frameRing.Allocate(count * sizeof(glm::mat4), alignment, outAllocation);
 
-    glBufferData(GL_SHADER_STORAGE_BUFFER, numBones * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+    if (data)
+        frameStats.bufferUploads++;
 
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    return static_cast<glm::mat4*>(data);
 }
 
-void Renderer::UploadGlobalMatricesToGPU(unsigned int ssbo, const std::vector<glm::mat4>& globalMatrices)
+void Renderer::BindSkinningPalette(unsigned int buffer)
 {
-    if (ssbo == 0) return;
-
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
-    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, globalMatrices.size() * sizeof(glm::mat4), globalMatrices.data());
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ssbo);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-}
-
-void Renderer::DeleteSSBO(unsigned int& ssbo)
-{
-    if (ssbo != 0)
-    {
-        glDeleteBuffers(1, &ssbo);
-        ssbo = 0;
-    }
+    // The palettes of all skinned meshes share the ring, one binding serves every draw.
+    // Only a frame that overflowed the ring has palettes in another buffer.
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buffer);
 }
 
 
@@ -1035,26 +1176,24 @@ void Renderer::DrawLinesList(const CameraLens* camera)
 {
     if (linesList.empty() || !camera) return;
 
-    GLuint lineVAO, lineVBO;
-    glGenVertexArrays(1, &lineVAO);
-    glGenBuffers(1, &lineVBO);
+    const size_t floatsPerVertex = 7;
+    const size_t vertexCount = linesList.size() * 2;
 
-    glBindVertexArray(lineVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, lineVBO);
-
-    std::vector<float> vertexData;
-    vertexData.reserve(linesList.size() * 2 * 7);
+    FrameRingAllocation allocation;
+    float* vertexData = (float*)frameRing.Allocate(vertexCount * floatsPerVertex * sizeof(float), sizeof(float) * 4, allocation);
+    if (!vertexData) return;
 
     for (const auto& line : linesList)
     {
         // Punto A
-        vertexData.push_back(line.start.x); vertexData.push_back(line.start.y); vertexData.push_back(line.start.z);
-        vertexData.push_back(line.color.r); vertexData.push_back(line.color.g); vertexData.push_back(line.color.b); vertexData.push_back(line.color.a);
+        *vertexData++ = line.start.x; *vertexData++ = line.start.y; *vertexData++ = line.start.z;
+        *vertexData++ = line.color.r; *vertexData++ = line.color.g; *vertexData++ = line.color.b; *vertexData++ = line.color.a;
 
         // Punto B
-        vertexData.push_back(line.end.x); vertexData.push_back(line.end.y); vertexData.push_back(line.end.z);
-        vertexData.push_back(line.color.r); vertexData.push_back(line.color.g); vertexData.push_back(line.color.b); vertexData.push_back(line.color.a);
+        *vertexData++ = line.end.x; *vertexData++ = line.end.y; *vertexData++ = line.end.z;
+        *vertexData++ = line.color.r; *vertexData++ = line.color.g; *vertexData++ = line.color.b; *vertexData++ = line.color.a;
     }
+    frameStats.bufferUploads++;
 
     glEnable(GL_DEPTH_TEST);
     glDepthMask(GL_TRUE);
@@ -1063,25 +1202,28 @@ void Renderer::DrawLinesList(const CameraLens* camera)
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     lineShader->Use();
-    GLuint shaderProgram = lineShader->GetProgramID();
 
-    glBindVertexArray(lineVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, lineVBO);
-    glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), GL_STREAM_DRAW);
+    if (linesVAO == 0)
+        glGenVertexArrays(1, &linesVAO);
+
+    glBindVertexArray(linesVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, allocation.buffer);
 
+    const GLsizei stride = (GLsizei)(floatsPerVertex * sizeof(float));
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(float), (void*)0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)allocation.offset);
 
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 7 * sizeof(float), (void*)(3 * sizeof(float)));
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (void*)(allocation.offset + 3 * sizeof(float)));
 
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(camera->GetProjectionMatrix()));
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(camera->GetViewMatrix()));
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(glm::mat4(1.0f)));
+    lineShader->SetMat4("projection", camera->GetProjectionMatrix());
+    lineShader->SetMat4("view", camera->GetViewMatrix());
+    lineShader->SetMat4("model", glm::mat4(1.0f));
 
-    glDrawArrays(GL_LINES, 0, (GLsizei)linesList.size() * 2);
+    glDrawArrays(GL_LINES, 0, (GLsizei)vertexCount);
 
     glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
     glUseProgram(0);
 }
 
@@ -1209,16 +1351,15 @@ void Renderer::DrawCircle(glm::vec3 center, glm::quat rotation, float r, int seg
     }
 }
 
-void Renderer::UpdateProjectionMatrix(glm::mat4 pm) {
-    glBindBuffer(GL_UNIFORM_BUFFER, uboMatrices);
-    glBufferSubData(GL_UNIFORM_BUFFER, sizeof(glm::mat4), sizeof(glm::mat4), glm::value_ptr(pm));
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
-}
+void Renderer::UploadCameraMatrices(const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix) {
+    // Same layout as the Matrices block: view, projection
+    glm::mat4 matrices[2] = { viewMatrix, projectionMatrix };
+
+    FrameRingAllocation allocation = frameRing.Upload(matrices, sizeof(matrices), frameRing.GetUniformAlignment());
+    if (!allocation.IsValid()) return;
 
-void Renderer::UpdateViewMatrix(glm::mat4 vm) {
-    glBindBuffer(GL_UNIFORM_BUFFER, uboMatrices);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::mat4), glm::value_ptr(vm));
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferRange(GL_UNIFORM_BUFFER, 0, allocation.buffer, allocation.offset, allocation.size);
+    frameStats.bufferUploads++;
 }
 
 UID Renderer::GetObjectInPixel(const CameraLens* camera, int x, int y)
@@ -1231,10 +1372,7 @@ UID Renderer::GetObjectInPixel(const CameraLens* camera, int x, int y)
     glBindFramebuffer(GL_FRAMEBUFFER, (camera->fboID != 0) ? camera->fboID : 0);
     glViewport(0, 0, camera->textureWidth, camera->textureHeight);
 
-    UpdateViewMatrix(camera->GetViewMatrix());
-    UpdateProjectionMatrix(camera->GetProjectionMatrix());
-
-    glBindBufferBase(GL_UNIFORM_BUFFER, 0, uboMatrices);
+    UploadCameraMatrices(camera->GetViewMatrix(), camera->GetProjectionMatrix());
 
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -1246,15 +1384,19 @@ UID Renderer::GetObjectInPixel(const CameraLens* camera, int x, int y)
     std::map<uint32_t, UID> pickingMap;
     uint32_t nextID = 1;
 
-    for (ComponentMesh* meshComponent : meshes)
+    visibleObjects.clear();
+    Application::GetInstance().scene->CollectVisible(*camera->GetFrustum(), visibleObjects);
+
+    for (GameObject* gameObject : visibleObjects)
     {
-        if (!meshComponent || !meshComponent->owner->IsActive()) continue;
+        if (!gameObject || !gameObject->IsActive()) continue;
+
+        ComponentMesh* meshComponent = static_cast<ComponentMesh*>(gameObject->GetComponent(ComponentType::MESH));
+        if (!meshComponent) continue;
 
         Mesh& mesh = meshComponent->GetMesh();
         if (mesh.VAO == 0) continue;
 
-        if (!camera->GetFrustum()->InFrustum(meshComponent->GetGlobalAABB())) continue;
-
         UID realUID = meshComponent->owner->GetUID();
         uint32_t currentPickingID = nextID++;
         pickingMap[currentPickingID] = realUID;
@@ -1272,14 +1414,16 @@ UID Renderer::GetObjectInPixel(const CameraLens* camera, int x, int y)
         pickingShader->SetMat4("model", model);
 
 
+        // Reuses this frame's palette when the mesh was already drawn
+        meshComponent->UpdateSkinningMatrices();
+
         if (meshComponent->HasSkinning())
         {
             ComponentSkinnedMesh* skinned = (ComponentSkinnedMesh*)meshComponent;
-            pickingShader->SetMat4("meshInverse", skinned->GetMeshInverse());
+            pickingShader->SetInt("boneBase", skinned->GetPaletteBase());
             pickingShader->SetBool("hasBones", true);
 
-            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, skinned->GetSSBOGlobal());
-            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, skinned->GetSSBOOffset());
+            BindSkinningPalette(skinned->GetPaletteBuffer());
         }
         else
         {
@@ -1288,7 +1432,7 @@ UID Renderer::GetObjectInPixel(const CameraLens* camera, int x, int y)
         }
 
         glBindVertexArray(mesh.VAO);
-        glDrawElements(GL_TRIANGLES, (GLsizei)mesh.indices.size(), GL_UNSIGNED_INT, 0);
+        glDrawElements(GL_TRIANGLES, (GLsizei)mesh.GetIndexCount(), mesh.GetIndexType(), 0);
     }
 
     int readX = x;
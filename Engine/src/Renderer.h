@@ -3,6 +3,10 @@
 #include "Module.h"
 #include "Frustum.h"
 #include "Primitives.h"
+#include "RenderQueue.h"
+#include "Shader.h"
+#include "FrameRingBuffer.h"
+#include "ParticleRenderer.h"
 #include "glad/glad.h"
 #include <memory>
 #include <map>
@@ -19,6 +23,20 @@ class Shader;
 class Texture;
 class ComponentLight;
 class LightManager;
+class ComponentSkinnedMesh;
+
+// Submission counters for one frame (all cameras)
+struct RenderStats
+{
+    unsigned int drawCalls = 0;
+    unsigned int instancedDrawCalls = 0;
+    unsigned int instances = 0;
+    unsigned int programBinds = 0;
+    unsigned int materialBinds = 0;
+    unsigned int textureBinds = 0;
+    unsigned int bufferUploads = 0;
+    unsigned int particles = 0;
+};
 
 class Renderer : public Module
 {
@@ -62,7 +80,8 @@ public:
     
     void AddMesh(ComponentMesh* mesh);
     void RemoveMesh(ComponentMesh* mesh);
-    void DrawMesh(const ComponentMesh* meshComp);
+    void DrawMesh(const ComponentMesh* meshComp, const Shader* shader);
+    void DrawMesh(const ComponentMesh* meshComp, const Shader* shader, unsigned int VAO, unsigned int indexCount, unsigned int indexType);
     
     // Particles management
     void AddParticle(ComponentParticleSystem* particle);
@@ -71,6 +90,7 @@ public:
     // Camera management
     void AddCamera(CameraLens* camera);
     void RemoveCamera(CameraLens* camera);
+    const std::vector<CameraLens*>& GetActiveCameras() const { return activeCameras; }
     
     // Canvas management
     void AddCanvas(ComponentCanvas* canvas);
@@ -83,9 +103,15 @@ public:
     // Scene Rendering
     bool RenderScene(CameraLens* renderCamera);
 
-    void CreateSkinningSSBOs(unsigned int& ssboGlobal, unsigned int& ssboOffset, const std::vector<glm::mat4>& offsets);
-    void UploadGlobalMatricesToGPU(unsigned int ssbo, const std::vector<glm::mat4>& globalMatrices);
-    void DeleteSSBO(unsigned int& ssbo);
+    // Room for count bone matrices in this frame's ring, for the caller to write in place.
+    // Comes from the ring's overflow when it is full; nullptr only if GL fails.
+    glm::mat4* AllocateBoneMatrices(size_t count, FrameRingAllocation& outAllocation);
+
+    // Frames rendered so far, for per-frame caches
+    uint64_t GetFrameIndex() const { return frameIndex; }
+
+    // Per-frame GPU data (camera, lights, bones, instances, debug lines)
+    FrameRingBuffer& GetFrameRing() { return frameRing; }
 
     // Shader access
     Shader* GetDefaultShader() const { return defaultShader.get(); }
@@ -115,6 +141,10 @@ public:
     void SetMSAA(bool enabled);
     bool IsMSAAEnabled() const { return msaaEnabled; }
 
+    // Merge repeated static meshes into instanced draws
+    void SetInstancing(bool enabled) { instancingEnabled = enabled; }
+    bool IsInstancingEnabled() const { return instancingEnabled; }
+
     // zBuffer visualization
     bool IsShowingZBuffer() const { return showZBuffer; }
     void SetShowZBuffer(bool show) { showZBuffer = show; }
@@ -127,8 +157,7 @@ public:
     void DrawFullscreenTexture(unsigned int textureID);
 
     // Cameras
-    void UpdateProjectionMatrix(glm::mat4 projectionMatrix);
-    void UpdateViewMatrix(glm::mat4 viewMatrix);
+    void UploadCameraMatrices(const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix);
 
     // Perfect Pixel Picking
     UID GetObjectInPixel(const CameraLens* camera, int x, int y);
@@ -138,12 +167,20 @@ public:
     void RemoveLight(ComponentLight* light);
     LightManager* GetLightManager() const { return lightManager.get(); }
 
+    // Counters of the last completed frame
+    const RenderStats& GetFrameStats() const { return lastFrameStats; }
+
 private:
 
     void ApplyRenderSettings();
 
     // Draw Functions
-    void DrawRenderList(const std::multimap<float, RenderObject>& map, const CameraLens* camera);
+    void DrawRenderList(const RenderQueue& queue, const CameraLens* camera, bool allowInstancing);
+    // False if the matrices could not be written: the batches can't be drawn instanced this frame
+    bool UploadInstanceMatrices(const RenderQueue& queue);
+    Shader* GetInstancedShader(const Shader* shader) const;
+    void BindSkinningPalette(unsigned int buffer);
+    void SimulateParticles();
     void DrawParticlesList(const CameraLens* camera);
     void DrawLinesList(const CameraLens* camera);
     void DrawStencilList(const CameraLens* camera);
@@ -157,6 +194,8 @@ private:
     std::unique_ptr<Shader> defaultShader;
     std::unique_ptr<Shader> postProcessShader;
     std::unique_ptr<Shader> standardShader;
+    std::unique_ptr<Shader> defaultInstancedShader;
+    std::unique_ptr<Shader> standardInstancedShader;
     std::unique_ptr<Shader> waterShader;
     std::unique_ptr<Shader> lineShader;
     std::unique_ptr<Shader> outlineShader;
@@ -182,10 +221,8 @@ private:
     int cullFaceMode = 0; // GL_BACK
     glm::vec3 lightDir = glm::vec3(1.0f, -1.0f, -1.0f);
 
-    // Normal visualization buffers (reused to avoid repeated allocations)
-    GLuint normalLinesVAO = 0;
-    GLuint normalLinesVBO = 0;
-    size_t normalLinesCapacity = 0;
+    // Debug lines read their vertices from the frame ring
+    GLuint linesVAO = 0;
 
     // Cached uniform locations to avoid repeated lookups
     struct ShaderUniforms {
@@ -194,9 +231,33 @@ private:
         GLint model = -1;
         GLint texture1 = -1;
         GLint hasBonesLoc = -1;
-        GLint meshInverseLoc = -1;
     } defaultUniforms, lineUniforms, outlineUniforms;
 
+    struct PostProcessUniforms {
+        UniformHandle<int> sceneTexture;
+        UniformHandle<bool> gradingEnabled;
+        UniformHandle<float> exposure;
+        UniformHandle<float> contrast;
+        UniformHandle<float> saturation;
+        UniformHandle<int> toneMapper;
+        UniformHandle<float> gamma;
+        UniformHandle<float> temperature;
+        UniformHandle<float> tint;
+        UniformHandle<glm::vec3> colorFilter;
+        UniformHandle<bool> bloomEnabled;
+        UniformHandle<float> bloomIntensity;
+        UniformHandle<float> bloomThreshold;
+        UniformHandle<float> bloomSoftKnee;
+        UniformHandle<glm::vec3> bloomTint;
+        UniformHandle<bool> caEnabled;
+        UniformHandle<float> caIntensity;
+        UniformHandle<bool> vignetteEnabled;
+        UniformHandle<float> vignetteIntensity;
+        UniformHandle<float> vignetteSmoothness;
+        UniformHandle<float> vignetteRoundness;
+        UniformHandle<glm::vec4> vignetteColor;
+    } postProcessUniforms;
+
     // UI overlay quad
     GLuint quadVAO = 0;
     GLuint quadVBO = 0;
@@ -204,9 +265,10 @@ private:
     // zBuffer visualization
     bool showZBuffer = false;
  
-    // SHADERS
-    unsigned int uboMatrices;
-    unsigned int ssboBones;
+    static const size_t FRAME_RING_SIZE = 8 * 1024 * 1024;
+    static const unsigned int FRAME_RING_FRAMES = 3;
+    FrameRingBuffer frameRing;
+    uint64_t frameIndex = 0;
 
     // LISTS
     std::vector<ComponentMesh*> meshes;
@@ -215,15 +277,25 @@ private:
     std::vector<CameraLens*> activeCameras;
     std::vector<ComponentPostProcessing*> postProcessingComponents;
 
-    std::multimap<float, RenderObject> opaqueList;
-    std::multimap<float, RenderObject> transparentList;
-    std::multimap<float, ParticleObject> particlesList;
+    RenderQueue opaqueQueue;
+    RenderQueue transparentQueue;
+    std::vector<ParticleObject> particlesList;
     std::vector<RenderObject> stencilList;
     std::vector<RenderObject> normalsList;
     std::vector<RenderObject> meshLinesList;
     std::vector<RenderLine> linesList;
     std::vector<CanvasObject> canvasList;
 
+    // Scratch buffer for the octree query, reused every camera
+    std::vector<GameObject*> visibleObjects;
+
+    // INSTANCING
+    static const unsigned int INSTANCING_MIN_BATCH = 2;
+    bool instancingEnabled = true;
+    std::vector<RenderBatch> renderBatches;
+
+    // PARTICLES
+    ParticleRenderer particleRenderer;
 
     // Post Processing
     int postProcessCurrentW = 0;
@@ -242,4 +314,7 @@ private:
 
     std::unique_ptr<LightManager> lightManager;
 
+    RenderStats frameStats;
+    RenderStats lastFrameStats;
+
 };
\ No newline at end of file
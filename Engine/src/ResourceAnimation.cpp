@@ -14,40 +14,51 @@ ResourceAnimation::~ResourceAnimation() {
 
 bool ResourceAnimation::LoadInMemory() {
     
-    Animation animation;
     if (IsLoadedToMemory())
         return true;
 
+    bool loaded = ReadFromDisk() && UploadToGPU();
+    ReleaseDiskData();
+    return loaded;
+}
+
+bool ResourceAnimation::ReadFromDisk() {
+
     if (libraryFile.empty()) {
         LOG_DEBUG("[ResourceAnimation] ERROR: No library file specified");
         return false;
     }
 
-    //Extract file name from path
-    std::string filename = libraryFile;
-    size_t lastSlash = filename.find_last_of("/\\");
-    if (lastSlash != std::string::npos) {
-        filename = filename.substr(lastSlash + 1);
-    }
+    //Extract data from Library, clip is only replaced on the main thread
+    diskClip = AnimationImporter::LoadFromCustomFormat(uid);
 
-    //Extract data from Library
-    animation = AnimationImporter::LoadFromCustomFormat(uid);
-
-    if (animation.IsValid())
+    if (diskClip.IsValid())
     {
-        this->animation = animation;
         return true;
     }
     else
     {
-        LOG_DEBUG("[ResourceAnimation] Failed to load resourece %s", libraryFile);
+        LOG_DEBUG("[ResourceAnimation] Failed to load resourece %s", libraryFile.c_str());
         return false;
     }
 }
 
+bool ResourceAnimation::UploadToGPU() {
+
+    // Keys stay on the CPU, the decoded clip only has to be published
+    if (!diskClip.IsValid()) {
+        return false;
+    }
+
+    clip = std::move(diskClip);
+    return true;
+}
+
+void ResourceAnimation::ReleaseDiskData() {
+    diskClip.Clear();
+}
+
 void ResourceAnimation::UnloadFromMemory() {
     
-    animation.duration = 0.0;
-    animation.ticksPerSecond = 0.0;
-    animation.channels.clear();
+    clip.Clear();
 }
\ No newline at end of file
@@ -1,26 +1,7 @@
 #pragma once
 #include "ModuleResources.h"
 #include "ModuleLoader.h"
-
-struct Channel
-{
-    std::string name;
-
-    std::vector<glm::vec3> positionKeys;
-    std::vector<glm::quat> rotationKeys;
-    std::vector<glm::vec3> scaleKeys;
-};
-
-struct Animation {
-    
-    double duration = 0.0;
-    double ticksPerSecond = 0.0;
-    std::vector<Channel> channels;
-
-    bool IsValid() const {
-        return !channels.empty();
-    }
-};
+#include "AnimationClip.h"
 
 class ResourceAnimation : public Resource {
 public:
@@ -30,12 +11,19 @@ public:
     bool LoadInMemory() override;
     void UnloadFromMemory() override;
 
-    const double GetDuration() const { return animation.duration; }
-    const double GetTicksPerSecond() const { return animation.ticksPerSecond; }
-    const std::vector<Channel>& GetChanels() const { return animation.channels; }
-    const bool GetAnimationIsValid() const { return animation.IsValid(); }
+    bool ReadFromDisk() override;
+    bool UploadToGPU() override;
+    void ReleaseDiskData() override;
+
+    const double GetDuration() const { return clip.GetDuration(); }
+    const double GetTicksPerSecond() const { return clip.GetTicksPerSecond(); }
+    const AnimationClip& GetClip() const { return clip; }
+    const bool GetAnimationIsValid() const { return clip.IsValid(); }
 
 private:
     
-    Animation animation;
+    AnimationClip clip;
+
+    // Kept from ReadFromDisk to UploadToGPU
+    AnimationClip diskClip;
 };
\ No newline at end of file
@@ -0,0 +1,243 @@
+#include "ResourceLoader.h"
+#include "ModuleResources.h"
+#include "Log.h"
+#include <algorithm>
+#include <chrono>
+
+ResourceLoader::~ResourceLoader()
+{
+    Stop();
+}
+
+void ResourceLoader::Start(unsigned int threadCount)
+{
+    Stop();
+
+    quitting = false;
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+        threads.emplace_back(&ResourceLoader::WorkerLoop, this);
+    }
+}
+
+void ResourceLoader::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quitting = true;
+    }
+    workCondition.notify_all();
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    threads.clear();
+
+    for (auto& pair : pending)
+    {
+        if (pair.second.readDone) pair.second.resource->ReleaseDiskData();
+    }
+
+    pending.clear();
+    readQueue.clear();
+    uploadQueue.clear();
+    completed.clear();
+}
+
+void ResourceLoader::Load(Resource* resource, const ResourceRequestPtr& request)
+{
+    UID uid = resource->GetUID();
+    bool newLoad = false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto it = pending.find(uid);
+        if (it == pending.end())
+        {
+            it = pending.emplace(uid, PendingLoad()).first;
+            it->second.resource = resource;
+            readQueue.push_back(uid);
+            newLoad = true;
+        }
+
+        it->second.requests.push_back(request);
+    }
+
+    if (newLoad) workCondition.notify_one();
+}
+
+void ResourceLoader::Complete(const ResourceRequestPtr& request)
+{
+    completed.push_back(request);
+}
+
+void ResourceLoader::Finalize(double budgetMs)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for (bool first = true; ; first = false)
+    {
+        if (!first)
+        {
+            double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (elapsedMs >= budgetMs) break;
+        }
+
+        UID uid = 0;
+        PendingLoad load;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (uploadQueue.empty()) break;
+
+            uid = uploadQueue.front();
+            uploadQueue.pop_front();
+
+            auto it = pending.find(uid);
+            load = std::move(it->second);
+            pending.erase(it);
+        }
+
+        CompleteLoad(uid, load);
+    }
+
+    RunCallbacks();
+}
+
+void ResourceLoader::FinishNow(UID uid)
+{
+    PendingLoad load;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        auto it = pending.find(uid);
+        if (it == pending.end()) return;
+
+        if (!it->second.reading && !it->second.readDone)
+        {
+            // Still queued: read it here instead of waiting for a thread to get to it
+            readQueue.erase(std::find(readQueue.begin(), readQueue.end(), uid));
+            Resource* resource = it->second.resource;
+
+            lock.unlock();
+            bool succeeded = resource->ReadFromDisk();
+            lock.lock();
+
+            it = pending.find(uid);
+            it->second.readDone = true;
+            it->second.readSucceeded = succeeded;
+        }
+        else
+        {
+            readDoneCondition.wait(lock, [&]() { return pending.find(uid)->second.readDone; });
+            uploadQueue.erase(std::find(uploadQueue.begin(), uploadQueue.end(), uid));
+            it = pending.find(uid);
+        }
+
+        load = std::move(it->second);
+        pending.erase(it);
+    }
+
+    // Callbacks wait for the next Finalize, the caller may be in the middle of anything
+    CompleteLoad(uid, load);
+}
+
+bool ResourceLoader::IsLoading(UID uid) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending.find(uid) != pending.end();
+}
+
+size_t ResourceLoader::GetPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending.size();
+}
+
+void ResourceLoader::WorkerLoop()
+{
+    while (true)
+    {
+        UID uid = 0;
+        Resource* resource = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workCondition.wait(lock, [this]() { return quitting || !readQueue.empty(); });
+            if (quitting) return;
+
+            uid = readQueue.front();
+            readQueue.pop_front();
+
+            PendingLoad& load = pending[uid];
+            load.reading = true;
+            resource = load.resource;
+        }
+
+        bool succeeded = resource->ReadFromDisk();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            PendingLoad& load = pending[uid];
+            load.reading = false;
+            load.readDone = true;
+            load.readSucceeded = succeeded;
+            uploadQueue.push_back(uid);
+        }
+        readDoneCondition.notify_all();
+    }
+}
+
+void ResourceLoader::CompleteLoad(UID uid, PendingLoad& load)
+{
+    Resource* resource = load.resource;
+
+    // Nobody is waiting for it anymore: skip the upload, it would be left with no reference
+    bool wanted = std::any_of(load.requests.begin(), load.requests.end(),
+        [](const ResourceRequestPtr& request) { return request->state != ResourceRequest::State::CANCELLED; });
+
+    bool succeeded = wanted && load.readSucceeded && resource->UploadToGPU();
+    resource->ReleaseDiskData();
+
+    if (wanted && !succeeded)
+    {
+        LOG_CONSOLE("ERROR: Failed to load resource %llu into memory", uid);
+    }
+
+    for (const ResourceRequestPtr& request : load.requests)
+    {
+        if (request->state == ResourceRequest::State::CANCELLED) continue;
+
+        request->resource = resource;
+        if (succeeded)
+        {
+            resource->referenceCount++;
+            request->state = ResourceRequest::State::READY;
+        }
+        else
+        {
+            request->state = ResourceRequest::State::FAILED;
+        }
+
+        completed.push_back(request);
+    }
+}
+
+void ResourceLoader::RunCallbacks()
+{
+    // Callbacks may request more resources, which can add to completed
+    while (!completed.empty())
+    {
+        std::vector<ResourceRequestPtr> finished;
+        finished.swap(completed);
+
+        for (const ResourceRequestPtr& request : finished)
+        {
+            if (request->state == ResourceRequest::State::CANCELLED || !request->callback) continue;
+
+            std::function<void(Resource*)> callback = std::move(request->callback);
+            request->callback = nullptr;
+            callback(request->GetResource());
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Globals.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class Resource;
+
+// Handle returned by ModuleResources::RequestResourceAsync. Only touched on the main thread.
+class ResourceRequest
+{
+public:
+    enum class State
+    {
+        LOADING,
+        READY,
+        FAILED,
+        CANCELLED
+    };
+
+    UID GetUID() const { return uid; }
+    State GetState() const { return state; }
+    bool IsDone() const { return state != State::LOADING; }
+
+    // Null until READY. A ready request holds one reference, given back with ModuleResources::ReleaseRequest.
+    Resource* GetResource() const { return state == State::READY ? resource : nullptr; }
+
+private:
+    friend class ResourceLoader;
+    friend class ModuleResources;
+
+    UID uid = 0;
+    Resource* resource = nullptr;
+    State state = State::LOADING;
+    std::function<void(Resource*)> callback;
+};
+
+typedef std::shared_ptr<ResourceRequest> ResourceRequestPtr;
+
+// Loads resources in two steps: Resource::ReadFromDisk on a few I/O threads, then
+// Resource::UploadToGPU on the main thread, a few per frame within a time budget.
+// Separate from the JobSystem on purpose: its workers are for frame work, and a
+// thread waiting on a counter would end up running a blocking read.
+class ResourceLoader
+{
+public:
+    ResourceLoader() = default;
+    ~ResourceLoader();
+
+    ResourceLoader(const ResourceLoader&) = delete;
+    ResourceLoader& operator=(const ResourceLoader&) = delete;
+
+    void Start(unsigned int threadCount);
+    // Loads not finished yet are dropped, their requests never complete
+    void Stop();
+
+    // Requests for a resource already being loaded join that load
+    void Load(Resource* resource, const ResourceRequestPtr& request);
+    // For requests that are already READY or FAILED: their callback runs on the next Finalize
+    void Complete(const ResourceRequestPtr& request);
+
+    // Main thread. Uploads finished reads until budgetMs is spent (always at least one)
+    // and runs the callbacks of the requests that finished.
+    void Finalize(double budgetMs);
+    // Main thread. Finishes uid's load right now, reading it on this thread if no I/O
+    // thread has started it yet. For code that cannot wait (synchronous requests, removal).
+    void FinishNow(UID uid);
+
+    bool IsLoading(UID uid) const;
+    size_t GetPendingCount() const;
+
+private:
+    struct PendingLoad
+    {
+        Resource* resource = nullptr;
+        std::vector<ResourceRequestPtr> requests;
+        bool reading = false;
+        bool readDone = false;
+        bool readSucceeded = false;
+    };
+
+    void WorkerLoop();
+    void CompleteLoad(UID uid, PendingLoad& load);
+    void RunCallbacks();
+
+    std::vector<std::thread> threads;
+
+    mutable std::mutex mutex;
+    std::condition_variable workCondition;
+    std::condition_variable readDoneCondition;
+    std::unordered_map<UID, PendingLoad> pending;
+    std::deque<UID> readQueue;
+    std::deque<UID> uploadQueue;
+    bool quitting = false;
+
+    // Main thread only
+    std::vector<ResourceRequestPtr> completed;
+};
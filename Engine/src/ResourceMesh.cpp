@@ -1,7 +1,10 @@
 #include "ResourceMesh.h"
 #include "MeshImporter.h"
+#include "LibraryManager.h"
+#include "MappedFile.h"
 #include "Log.h"
 #include <glad/glad.h>
+#include <cfloat>
 
 ResourceMesh::ResourceMesh(UID uid)
     : Resource(uid, Resource::MESH) {
@@ -17,6 +20,13 @@ bool ResourceMesh::LoadInMemory() {
         return true;
     }
 
+    bool loaded = ReadFromDisk() && UploadToGPU();
+    ReleaseDiskData();
+    return loaded;
+}
+
+bool ResourceMesh::ReadFromDisk() {
+
     if (libraryFile.empty()) {
         LOG_DEBUG("[ResourceMesh] ERROR: No library file specified");
         return false;
@@ -29,63 +39,68 @@ bool ResourceMesh::LoadInMemory() {
         filename = filename.substr(lastSlash + 1);
     }
 
-    // load using meshimporter
-    mesh = MeshImporter::LoadFromCustomFormat(uid);
+    // map the file, the GPU upload reads the arrays straight from it
+    diskData = std::make_unique<MappedFile>();
+    MeshFileView view;
 
-    if (mesh.vertices.empty() || mesh.indices.empty()) {
+    if (!diskData->Open(LibraryManager::GetLibraryPath(uid)) ||
+        !MeshImporter::ReadCustomFormatView(diskData->GetData(), diskData->GetSize(), view) ||
+        view.numVertices == 0 || view.numIndices == 0) {
         LOG_DEBUG("[ResourceMesh] ERROR: Failed to load mesh data");
         return false;
     }
 
+    mesh.vertices.clear();
+    mesh.indices.clear();
+    mesh.bones = std::move(view.bones);
+    mesh.vertexCount = view.numVertices;
+    mesh.indexCount = view.numIndices;
+    mesh.vertexFormat = view.vertexFormat;
+    mesh.indexSize = view.indexSize;
+    diskVertices = view.vertexData;
+    diskIndices = view.indexData;
+
+    // Bounds for the AABBs, the vertices will not be around later
+    mesh.boundsMin = glm::vec3(FLT_MAX);
+    mesh.boundsMax = glm::vec3(-FLT_MAX);
+    for (unsigned int i = 0; i < view.numVertices; i++) {
+        glm::vec3 position = view.GetPosition(i);
+        mesh.boundsMin = glm::min(mesh.boundsMin, position);
+        mesh.boundsMax = glm::max(mesh.boundsMax, position);
+    }
+
+    return true;
+}
+
+bool ResourceMesh::UploadToGPU() {
+
+    if (!diskVertices || !diskIndices) {
+        return false;
+    }
+
     glGenVertexArrays(1, &mesh.VAO);
     glGenBuffers(1, &mesh.VBO);
     glGenBuffers(1, &mesh.EBO);
 
     glBindVertexArray(mesh.VAO);
 
+    const VertexLayout& layout = VertexLayout::Get(mesh.vertexFormat);
+
     // VBO
     glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
     glBufferData(GL_ARRAY_BUFFER,
-        mesh.vertices.size() * sizeof(Vertex),
-        mesh.vertices.data(),
+        (size_t)mesh.vertexCount * layout.stride,
+        diskVertices,
         GL_STATIC_DRAW);
 
     // EBO
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-        mesh.indices.size() * sizeof(unsigned int),
-        mesh.indices.data(),
+        (size_t)mesh.indexCount * mesh.indexSize,
+        diskIndices,
         GL_STATIC_DRAW);
 
-    // Atributos de vrtice
-    // Position
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-
-    // Normal
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-        (void*)offsetof(Vertex, normal));
-
-    // TexCoords
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-        (void*)offsetof(Vertex, texCoords));
-
-    // Bones
-    glEnableVertexAttribArray(3);
-    glVertexAttribIPointer(3, 4, GL_INT, sizeof(Vertex),
-        (void*)offsetof(Vertex, boneIDs));
-
-    // Weights
-    glEnableVertexAttribArray(4);
-    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-        (void*)offsetof(Vertex, weights));
-
-    // Tangents
-    glEnableVertexAttribArray(5);
-    glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-        (void*)offsetof(Vertex, tangent));
+    layout.Apply();
 
     glBindVertexArray(0);
 
@@ -116,4 +131,50 @@ void ResourceMesh::UnloadFromMemory() {
     mesh.indices.clear();
     mesh.textures.clear();
     mesh.bones.clear();
+    mesh.vertexCount = 0;
+    mesh.indexCount = 0;
+}
+
+void ResourceMesh::ReleaseDiskData() {
+    diskVertices = nullptr;
+    diskIndices = nullptr;
+    diskData.reset();
+}
+
+bool ResourceMesh::ReadCPUData(std::vector<Vertex>& outVertices, std::vector<unsigned int>& outIndices) const {
+
+    MappedFile file;
+    MeshFileView view;
+
+    if (!file.Open(LibraryManager::GetLibraryPath(uid)) ||
+        !MeshImporter::ReadCustomFormatView(file.GetData(), file.GetSize(), view)) {
+        LOG_DEBUG("[ResourceMesh] ERROR: Failed to read mesh data for %llu", uid);
+        return false;
+    }
+
+    view.ReadVertices(outVertices);
+    view.ReadIndices(outIndices);
+    return true;
+}
+
+size_t ResourceMesh::GetCPUBytes() const {
+    size_t bytes = mesh.vertices.capacity() * sizeof(Vertex) + mesh.indices.capacity() * sizeof(unsigned int);
+
+    for (const Bone& bone : mesh.bones) {
+        bytes += sizeof(Bone) + bone.name.capacity();
+    }
+
+    return bytes;
+}
+
+size_t ResourceMesh::GetGPUBytes() const {
+    if (mesh.VAO == 0) {
+        return 0;
+    }
+
+    return (size_t)mesh.vertexCount * VertexLayout::Get(mesh.vertexFormat).stride + (size_t)mesh.indexCount * mesh.indexSize;
+}
+
+unsigned int Mesh::GetIndexType() const {
+    return indexSize == sizeof(uint16_t) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
 }
\ No newline at end of file
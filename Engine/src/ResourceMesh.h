@@ -1,7 +1,11 @@
 #pragma once
 
 #include "ModuleResources.h"
+#include "VertexLayout.h"
 #include "glm/glm.hpp"
+#include <memory>
+
+class MappedFile;
 
 // Vertex data structure
 struct Vertex {
@@ -88,10 +92,29 @@ struct Mesh {
     unsigned int VBO = 0;
     unsigned int EBO = 0;
 
+    // What was uploaded. Resource meshes drop vertices / indices once they are on the GPU,
+    // so use these (through the getters) for draw counts and bounds.
+    unsigned int vertexCount = 0;
+    unsigned int indexCount = 0;
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+
+    // Layout of the VBO / EBO contents. Meshes built in code upload vertices as they are.
+    VertexFormat vertexFormat = VertexFormat::FULL;
+    unsigned int indexSize = sizeof(unsigned int);
+
     bool IsValid() const { return VAO != 0; }
     bool IsSkinned() { return bones.size() != 0; }
+
+    unsigned int GetVertexCount() const { return vertices.empty() ? vertexCount : (unsigned int)vertices.size(); }
+    unsigned int GetIndexCount() const { return indices.empty() ? indexCount : (unsigned int)indices.size(); }
+    // GL type for glDrawElements
+    unsigned int GetIndexType() const;
 };
 
+// The Library file is mapped and uploaded straight from the mapping; no vertex or index
+// array stays in memory afterwards. Colliders, navmesh baking and other CPU users read
+// them back with ReadCPUData when they need them.
 class ResourceMesh : public Resource {
 public:
     ResourceMesh(UID uid);
@@ -100,12 +123,28 @@ public:
     bool LoadInMemory() override;
     void UnloadFromMemory() override;
 
+    bool ReadFromDisk() override;
+    bool UploadToGPU() override;
+    void ReleaseDiskData() override;
+
     // getters
     const Mesh& GetMesh() const { return mesh; }
-    unsigned int GetNumVertices() const { return mesh.vertices.size(); }
-    unsigned int GetNumIndices() const { return mesh.indices.size(); }
-    unsigned int GetNumTriangles() const { return mesh.indices.size() / 3; }
+    unsigned int GetNumVertices() const { return mesh.GetVertexCount(); }
+    unsigned int GetNumIndices() const { return mesh.GetIndexCount(); }
+    unsigned int GetNumTriangles() const { return mesh.GetIndexCount() / 3; }
+
+    // Copies of the vertex / index data, read from the Library file
+    bool ReadCPUData(std::vector<Vertex>& outVertices, std::vector<unsigned int>& outIndices) const;
+
+    // Bytes resident for this mesh on each side
+    size_t GetCPUBytes() const;
+    size_t GetGPUBytes() const;
 
 private:
     Mesh mesh;  
+
+    // Kept from ReadFromDisk to UploadToGPU
+    std::unique_ptr<MappedFile> diskData;
+    const unsigned char* diskVertices = nullptr;
+    const unsigned char* diskIndices = nullptr;
 };
\ No newline at end of file
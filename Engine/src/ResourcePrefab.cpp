@@ -47,6 +47,7 @@ bool ResourcePrefab::LoadInMemory()
     }
 
     prefab = modelData;
+    compiled.Compile(prefab.prefabJson);
 
     return true;
 }
@@ -54,4 +55,5 @@ bool ResourcePrefab::LoadInMemory()
 void ResourcePrefab::UnloadFromMemory()
 {
     prefab.prefabJson.clear();
+    compiled.Clear();
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ModuleResources.h"
+#include "PrefabTemplate.h"
 #include <nlohmann/json.hpp>
 
 struct Prefab {
@@ -27,7 +28,11 @@ public:
         return prefab.IsValid() ? prefab.prefabJson : nlohmann::json();
     }
 
+    // Compiled from the hierarchy when loaded into memory
+    const PrefabTemplate& GetTemplate() const { return compiled; }
+
 
 private:
     Prefab prefab;
+    PrefabTemplate compiled;
 };
\ No newline at end of file
@@ -18,6 +18,12 @@ bool ResourceTexture::LoadInMemory() {
         return true;
     }
 
+    bool loaded = ReadFromDisk() && UploadToGPU();
+    ReleaseDiskData();
+    return loaded;
+}
+
+bool ResourceTexture::ReadFromDisk() {
     if (libraryFile.empty()) {
         LOG_DEBUG("[ResourceTexture] ERROR: No library file specified");
         return false;
@@ -33,57 +39,58 @@ bool ResourceTexture::LoadInMemory() {
     LOG_DEBUG("[ResourceTexture] Loading from Library: %s", filename.c_str());
 
     // Load texture data from custom format
-    TextureData textureData = TextureImporter::LoadFromCustomFormat(uid);
+    diskData = std::make_unique<TextureData>(TextureImporter::LoadFromCustomFormat(uid));
 
-    if (!textureData.IsValid()) {
+    if (!diskData->IsValid()) {
         LOG_DEBUG("[ResourceTexture] ERROR: Failed to load texture data");
         return false;
     }
 
     LOG_DEBUG("[ResourceTexture] Loaded texture data: %dx%d, %d channels",
-        textureData.width, textureData.height, textureData.channels);
-
-    // Create OpenGL texture
-    glGenTextures(1, &gpu_id);
-    glBindTexture(GL_TEXTURE_2D, gpu_id);
+        diskData->width, diskData->height, diskData->channels);
 
     // Load .meta to get import settings
     MetaFile meta = MetaFileManager::LoadMeta(assetsFile);
 
-    if (meta.uid != 0) {
-        LOG_DEBUG("[ResourceTexture] Applying import settings from .meta");
+    hasImportSettings = meta.uid != 0;
+    if (hasImportSettings) {
+        generateMipmaps = meta.importSettings.generateMipmaps;
+        minFilter = meta.importSettings.GetGLFilterMode(generateMipmaps);
+        magFilter = meta.importSettings.GetGLFilterMode(false);
+    }
+    else {
+        generateMipmaps = false;
+        minFilter = GL_LINEAR_MIPMAP_LINEAR;
+        magFilter = GL_LINEAR;
+    }
 
-        // Wrap mode always REPEAT (default)
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    return true;
+}
 
-        // Apply filter mode
-        if (meta.importSettings.generateMipmaps) {
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
-                meta.importSettings.GetGLFilterMode(true));
-        }
-        else {
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
-                meta.importSettings.GetGLFilterMode(false));
-        }
+bool ResourceTexture::UploadToGPU() {
+    if (!diskData || !diskData->IsValid()) {
+        return false;
+    }
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
-            meta.importSettings.GetGLFilterMode(false));
+    const TextureData& textureData = *diskData;
 
-        LOG_DEBUG("[ResourceTexture] Settings: filter=%d, mipmaps=%d",
-            meta.importSettings.filterMode,
-            meta.importSettings.generateMipmaps);
+    // Create OpenGL texture
+    glGenTextures(1, &gpu_id);
+    glBindTexture(GL_TEXTURE_2D, gpu_id);
+
+    if (hasImportSettings) {
+        LOG_DEBUG("[ResourceTexture] Applying import settings from .meta");
     }
     else {
         LOG_DEBUG("[ResourceTexture] No .meta found, using defaults");
-
-        // Default settings
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     }
 
+    // Wrap mode always REPEAT (default)
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
+
     // Upload texture data to GPU
     GLenum format = (textureData.channels == 4) ? GL_RGBA : GL_RGB;
     glTexImage2D(GL_TEXTURE_2D, 0, format, textureData.width, textureData.height,0, format, GL_UNSIGNED_BYTE, textureData.pixels);
@@ -99,7 +106,7 @@ bool ResourceTexture::LoadInMemory() {
     }
 
     // Generate mipmaps if enabled
-    if (meta.uid != 0 && meta.importSettings.generateMipmaps) {
+    if (generateMipmaps) {
         glGenerateMipmap(GL_TEXTURE_2D);
 
         error = glGetError();
@@ -125,6 +132,11 @@ bool ResourceTexture::LoadInMemory() {
     return true;
 }
 
+void ResourceTexture::ReleaseDiskData() {
+    // The pixels live on the GPU from now on
+    diskData.reset();
+}
+
 void ResourceTexture::UnloadFromMemory() {
     if (!IsLoadedToMemory()) {
         return;
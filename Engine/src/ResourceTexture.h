@@ -1,6 +1,9 @@
 #pragma once
 
 #include "ModuleResources.h"
+#include <memory>
+
+struct TextureData;
 
 class ResourceTexture : public Resource {
 public:
@@ -21,6 +24,10 @@ public:
     bool LoadInMemory() override;
     void UnloadFromMemory() override;
 
+    bool ReadFromDisk() override;
+    bool UploadToGPU() override;
+    void ReleaseDiskData() override;
+
     // Texture-specific getters
     unsigned int GetWidth() const { return width; }
     unsigned int GetHeight() const { return height; }
@@ -37,4 +44,12 @@ public:
     unsigned int bytes = 0;
     unsigned int gpu_id = 0;  // OpenGL texture ID
     Format format = UNKNOWN;
+
+private:
+    // Read from Library and .meta by ReadFromDisk, until UploadToGPU is done with them
+    std::unique_ptr<TextureData> diskData;
+    bool hasImportSettings = false;
+    bool generateMipmaps = false;
+    unsigned int minFilter = 0;
+    unsigned int magFilter = 0;
 };
\ No newline at end of file
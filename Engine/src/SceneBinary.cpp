@@ -0,0 +1,316 @@
+#include "SceneBinary.h"
+#include "GameObject.h"
+#include "Transform.h"
+#include "Log.h"
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+
+namespace
+{
+    const char MAGIC[4] = { 'W', 'S', 'C', 'N' };
+    const uint32_t OBJECT_ACTIVE = 1 << 0;
+    const uint32_t COMPONENT_ACTIVE = 1 << 0;
+    const int32_t NO_PARENT = -1;
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t objectCount;
+        uint32_t componentCount;
+        uint32_t stringCount;
+        uint32_t reserved;
+        uint64_t uidTableOffset;
+        uint64_t objectTableOffset;
+        uint64_t componentTableOffset;
+        uint64_t stringTableOffset;
+        uint64_t stringDataOffset;
+        uint64_t stringDataSize;
+        uint64_t blobOffset;
+        uint64_t blobSize;
+    };
+
+    struct ObjectRecord
+    {
+        int32_t parent;         // index in the object table, NO_PARENT for children of root
+        uint32_t name;          // index in the string table
+        uint32_t tag;
+        uint32_t flags;
+        float position[3];
+        float rotation[3];      // Euler angles, as Transform serializes them
+        float scale[3];
+        uint32_t firstComponent;
+        uint32_t componentCount;
+    };
+
+    struct ComponentRecord
+    {
+        uint32_t type;
+        uint32_t flags;
+        uint64_t blobOffset;    // from the start of the blob section
+        uint64_t blobSize;
+    };
+
+    struct StringEntry
+    {
+        uint32_t offset;        // from the start of the string data
+        uint32_t length;
+    };
+
+    class Writer
+    {
+    public:
+        void AddSubtree(const GameObject* obj, int32_t parent)
+        {
+            int32_t index = (int32_t)objects.size();
+
+            ObjectRecord record = {};
+            record.parent = parent;
+            record.name = Intern(obj->GetName());
+            record.tag = Intern(obj->GetTag());
+            record.flags = obj->IsActive() ? OBJECT_ACTIVE : 0;
+            record.firstComponent = (uint32_t)components.size();
+
+            if (const Transform* transform = obj->transform)
+            {
+                const glm::vec3& position = transform->GetPosition();
+                const glm::vec3& rotation = transform->GetRotation();
+                const glm::vec3& scale = transform->GetScale();
+                for (int i = 0; i < 3; ++i)
+                {
+                    record.position[i] = position[i];
+                    record.rotation[i] = rotation[i];
+                    record.scale[i] = scale[i];
+                }
+            }
+
+            for (const Component* component : obj->GetComponents())
+            {
+                // Written in the object record, every GameObject creates its own
+                if (component->GetType() == ComponentType::TRANSFORM) continue;
+
+                nlohmann::json componentObj = nlohmann::json::object();
+                component->Serialize(componentObj);
+
+                ComponentRecord componentRecord;
+                componentRecord.type = (uint32_t)component->GetType();
+                componentRecord.flags = component->IsActive() ? COMPONENT_ACTIVE : 0;
+                componentRecord.blobOffset = blobs.size();
+                nlohmann::json::to_msgpack(componentObj, blobs);
+                componentRecord.blobSize = blobs.size() - componentRecord.blobOffset;
+
+                components.push_back(componentRecord);
+            }
+
+            record.componentCount = (uint32_t)components.size() - record.firstComponent;
+            objects.push_back(record);
+            uids.push_back(obj->objectUID);
+
+            for (const GameObject* child : obj->GetChildren())
+            {
+                AddSubtree(child, index);
+            }
+        }
+
+        void Finish(std::vector<unsigned char>& outData) const
+        {
+            Header header = {};
+            memcpy(header.magic, MAGIC, sizeof(MAGIC));
+            header.version = SceneBinary::VERSION;
+            header.objectCount = (uint32_t)objects.size();
+            header.componentCount = (uint32_t)components.size();
+            header.stringCount = (uint32_t)strings.size();
+
+            uint64_t offset = sizeof(Header);
+            header.uidTableOffset = offset;         offset += uids.size() * sizeof(UID);
+            header.objectTableOffset = offset;      offset += objects.size() * sizeof(ObjectRecord);
+            header.componentTableOffset = offset;   offset += components.size() * sizeof(ComponentRecord);
+            header.stringTableOffset = offset;      offset += strings.size() * sizeof(StringEntry);
+            header.stringDataOffset = offset;       offset += stringData.size();
+            header.stringDataSize = stringData.size();
+            header.blobOffset = offset;             offset += blobs.size();
+            header.blobSize = blobs.size();
+
+            outData.clear();
+            outData.reserve((size_t)offset);
+            Append(outData, &header, sizeof(Header));
+            Append(outData, uids.data(), uids.size() * sizeof(UID));
+            Append(outData, objects.data(), objects.size() * sizeof(ObjectRecord));
+            Append(outData, components.data(), components.size() * sizeof(ComponentRecord));
+            Append(outData, strings.data(), strings.size() * sizeof(StringEntry));
+            Append(outData, stringData.data(), stringData.size());
+            Append(outData, blobs.data(), blobs.size());
+        }
+
+    private:
+        uint32_t Intern(const std::string& value)
+        {
+            auto it = stringIndices.find(value);
+            if (it != stringIndices.end()) return it->second;
+
+            StringEntry entry;
+            entry.offset = (uint32_t)stringData.size();
+            entry.length = (uint32_t)value.size();
+            stringData.insert(stringData.end(), value.begin(), value.end());
+
+            uint32_t index = (uint32_t)strings.size();
+            strings.push_back(entry);
+            stringIndices.emplace(value, index);
+            return index;
+        }
+
+        static void Append(std::vector<unsigned char>& outData, const void* source, size_t bytes)
+        {
+            if (bytes == 0) return;
+
+            const unsigned char* begin = static_cast<const unsigned char*>(source);
+            outData.insert(outData.end(), begin, begin + bytes);
+        }
+
+        std::vector<UID> uids;
+        std::vector<ObjectRecord> objects;
+        std::vector<ComponentRecord> components;
+        std::vector<StringEntry> strings;
+        std::vector<char> stringData;
+        std::vector<uint8_t> blobs;
+        std::unordered_map<std::string, uint32_t> stringIndices;
+    };
+
+    bool SectionFits(uint64_t offset, uint64_t count, uint64_t elementSize, size_t size)
+    {
+        return offset <= size && count <= (size - offset) / elementSize;
+    }
+
+    // Records are copied out, the data may come from a mapping with no alignment guarantees
+    template<typename T>
+    T ReadRecord(const unsigned char* data, uint64_t sectionOffset, uint32_t index)
+    {
+        T record;
+        memcpy(&record, data + sectionOffset + (uint64_t)index * sizeof(T), sizeof(T));
+        return record;
+    }
+}
+
+void SceneBinary::Write(const GameObject* root, std::vector<unsigned char>& outData)
+{
+    Writer writer;
+
+    if (root)
+    {
+        for (const GameObject* child : root->GetChildren())
+        {
+            writer.AddSubtree(child, NO_PARENT);
+        }
+    }
+
+    writer.Finish(outData);
+}
+
+bool SceneBinary::IsBinaryScene(const unsigned char* data, size_t size)
+{
+    return data && size >= sizeof(Header) && memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool SceneBinary::Read(const unsigned char* data, size_t size, GameObject* root)
+{
+    if (!IsBinaryScene(data, size))
+    {
+        LOG_CONSOLE("[SceneBinary] ERROR: Not a binary scene");
+        return false;
+    }
+
+    Header header;
+    memcpy(&header, data, sizeof(Header));
+
+    if (header.version != VERSION)
+    {
+        LOG_CONSOLE("[SceneBinary] ERROR: Unsupported version %u (expected %u)", header.version, VERSION);
+        return false;
+    }
+
+    if (!SectionFits(header.uidTableOffset, header.objectCount, sizeof(UID), size) ||
+        !SectionFits(header.objectTableOffset, header.objectCount, sizeof(ObjectRecord), size) ||
+        !SectionFits(header.componentTableOffset, header.componentCount, sizeof(ComponentRecord), size) ||
+        !SectionFits(header.stringTableOffset, header.stringCount, sizeof(StringEntry), size) ||
+        !SectionFits(header.stringDataOffset, header.stringDataSize, 1, size) ||
+        !SectionFits(header.blobOffset, header.blobSize, 1, size))
+    {
+        LOG_CONSOLE("[SceneBinary] ERROR: Truncated scene data");
+        return false;
+    }
+
+    const char* stringData = reinterpret_cast<const char*>(data + header.stringDataOffset);
+    auto readString = [&](uint32_t index, std::string& outValue)
+        {
+            if (index >= header.stringCount) return false;
+
+            StringEntry entry = ReadRecord<StringEntry>(data, header.stringTableOffset, index);
+            if ((uint64_t)entry.offset + entry.length > header.stringDataSize) return false;
+
+            outValue.assign(stringData + entry.offset, entry.length);
+            return true;
+        };
+
+    std::vector<GameObject*> created(header.objectCount, nullptr);
+    std::string name;
+    std::string tag;
+
+    for (uint32_t i = 0; i < header.objectCount; ++i)
+    {
+        ObjectRecord record = ReadRecord<ObjectRecord>(data, header.objectTableOffset, i);
+
+        if (record.parent >= (int32_t)i || record.parent < NO_PARENT ||
+            (uint64_t)record.firstComponent + record.componentCount > header.componentCount ||
+            !readString(record.name, name) || !readString(record.tag, tag))
+        {
+            LOG_CONSOLE("[SceneBinary] ERROR: Corrupt object record %u", i);
+            return false;
+        }
+
+        GameObject* obj = new GameObject(name);
+        UID uid = ReadRecord<UID>(data, header.uidTableOffset, i);
+        if (uid != 0) obj->SetUID(uid);
+        obj->SetActive((record.flags & OBJECT_ACTIVE) != 0);
+
+        GameObject* parent = record.parent == NO_PARENT ? root : created[record.parent];
+        if (parent) parent->AddChild(obj);
+
+        obj->SetTag(tag);
+        obj->transform->SetLocalTRS(
+            glm::vec3(record.position[0], record.position[1], record.position[2]),
+            glm::vec3(record.rotation[0], record.rotation[1], record.rotation[2]),
+            glm::vec3(record.scale[0], record.scale[1], record.scale[2]));
+
+        created[i] = obj;
+
+        for (uint32_t c = 0; c < record.componentCount; ++c)
+        {
+            ComponentRecord componentRecord = ReadRecord<ComponentRecord>(data, header.componentTableOffset, record.firstComponent + c);
+            if (componentRecord.blobOffset > header.blobSize ||
+                componentRecord.blobSize > header.blobSize - componentRecord.blobOffset)
+            {
+                LOG_CONSOLE("[SceneBinary] ERROR: Corrupt component record in %s", name.c_str());
+                continue;
+            }
+
+            Component* component = obj->CreateComponent((ComponentType)componentRecord.type);
+            if (!component) continue;
+
+            component->SetActive((componentRecord.flags & COMPONENT_ACTIVE) != 0);
+
+            const unsigned char* blob = data + header.blobOffset + componentRecord.blobOffset;
+            nlohmann::json componentObj = nlohmann::json::from_msgpack(blob, blob + componentRecord.blobSize, true, false);
+            if (componentObj.is_discarded())
+            {
+                LOG_CONSOLE("[SceneBinary] WARNING: Unreadable component data in %s", name.c_str());
+                continue;
+            }
+
+            component->Deserialize(componentObj);
+        }
+    }
+
+    return true;
+}
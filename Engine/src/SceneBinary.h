@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class GameObject;
+
+// Versioned binary scene, for backups and anything else that does not need to be diffed
+// (JSON stays the format of the scene assets). Little endian:
+//
+//   Header
+//   UID table          one UID per object
+//   Object table       ObjectRecord per object, pre-order, parents before children
+//   Component table    ComponentRecord per component, grouped by object
+//   String table       StringEntry per string, then the characters (names and tags)
+//   Blobs              component data, what Component::Serialize writes, as MessagePack
+//
+// Hierarchy, names, tags, UIDs and transforms are read straight from the tables. Only
+// each component's own blob is decoded into a (small) JSON object for its Deserialize.
+namespace SceneBinary
+{
+    static constexpr uint32_t VERSION = 1;
+
+    // Children of root, not root itself
+    void Write(const GameObject* root, std::vector<unsigned char>& outData);
+    // Adds the stored objects as children of root. False if the data is not a valid scene.
+    bool Read(const unsigned char* data, size_t size, GameObject* root);
+
+    bool IsBinaryScene(const unsigned char* data, size_t size);
+}
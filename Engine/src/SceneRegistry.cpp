@@ -0,0 +1,203 @@
+#include "SceneRegistry.h"
+#include "GameObject.h"
+#include <algorithm>
+
+const std::vector<GameObject*> SceneRegistry::empty;
+
+// True if a comes before b in a pre-order walk from the root, the order the old
+// recursive FindChild search visited them in
+static bool PrecedesInTree(GameObject* a, GameObject* b)
+{
+    std::vector<GameObject*> pathA;
+    std::vector<GameObject*> pathB;
+    for (GameObject* node = a; node; node = node->GetParent()) pathA.push_back(node);
+    for (GameObject* node = b; node; node = node->GetParent()) pathB.push_back(node);
+
+    // Walk down from the root until the paths split
+    size_t depth = 0;
+    while (depth < pathA.size() && depth < pathB.size() &&
+        pathA[pathA.size() - 1 - depth] == pathB[pathB.size() - 1 - depth])
+    {
+        ++depth;
+    }
+
+    // An ancestor is visited before its descendants
+    if (depth == pathA.size()) return true;
+    if (depth == pathB.size()) return false;
+    if (depth == 0) return false;
+
+    const GameObject* parent = pathA[pathA.size() - depth];
+    const std::vector<GameObject*>& siblings = parent->GetChildren();
+    auto itA = std::find(siblings.begin(), siblings.end(), pathA[pathA.size() - 1 - depth]);
+    auto itB = std::find(siblings.begin(), siblings.end(), pathB[pathB.size() - 1 - depth]);
+    return itA < itB;
+}
+
+void SceneRegistry::Add(GameObject* obj)
+{
+    if (!obj || obj->IsInScene()) return;
+
+    obj->SetInScene(true);
+    AddUID(obj->GetUID(), obj);
+    AddTo(byName, obj->GetName(), obj);
+    if (!obj->GetTag().empty())
+    {
+        AddTo(byTag, obj->GetTag(), obj);
+    }
+}
+
+void SceneRegistry::Remove(GameObject* obj)
+{
+    if (!obj || !obj->IsInScene()) return;
+
+    obj->SetInScene(false);
+    RemoveUID(obj->GetUID(), obj);
+    RemoveFrom(byName, obj->GetName(), obj);
+    if (!obj->GetTag().empty())
+    {
+        RemoveFrom(byTag, obj->GetTag(), obj);
+    }
+}
+
+void SceneRegistry::AddSubtree(GameObject* obj)
+{
+    if (!obj) return;
+
+    Add(obj);
+    for (GameObject* child : obj->GetChildren())
+    {
+        AddSubtree(child);
+    }
+}
+
+void SceneRegistry::RemoveSubtree(GameObject* obj)
+{
+    if (!obj) return;
+
+    Remove(obj);
+    for (GameObject* child : obj->GetChildren())
+    {
+        RemoveSubtree(child);
+    }
+}
+
+void SceneRegistry::OnUIDChanged(GameObject* obj, UID oldUID)
+{
+    RemoveUID(oldUID, obj);
+    AddUID(obj->GetUID(), obj);
+}
+
+void SceneRegistry::OnNameChanged(GameObject* obj, const std::string& oldName)
+{
+    RemoveFrom(byName, oldName, obj);
+    AddTo(byName, obj->GetName(), obj);
+}
+
+void SceneRegistry::OnTagChanged(GameObject* obj, const std::string& oldTag)
+{
+    if (!oldTag.empty())
+    {
+        RemoveFrom(byTag, oldTag, obj);
+    }
+    if (!obj->GetTag().empty())
+    {
+        AddTo(byTag, obj->GetTag(), obj);
+    }
+}
+
+GameObject* SceneRegistry::Find(UID uid) const
+{
+    GameObject* first = nullptr;
+    auto range = byUID.equal_range(uid);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (!first || PrecedesInTree(it->second, first))
+        {
+            first = it->second;
+        }
+    }
+    return first;
+}
+
+GameObject* SceneRegistry::Find(const std::string& name) const
+{
+    const std::vector<GameObject*>& objects = FindAll(name);
+    if (objects.empty()) return nullptr;
+
+    // Names are usually unique, only duplicates pay for the tree comparison
+    GameObject* first = objects.front();
+    for (size_t i = 1; i < objects.size(); ++i)
+    {
+        if (PrecedesInTree(objects[i], first))
+        {
+            first = objects[i];
+        }
+    }
+    return first;
+}
+
+const std::vector<GameObject*>& SceneRegistry::FindAll(const std::string& name) const
+{
+    auto it = byName.find(name);
+    return it != byName.end() ? it->second : empty;
+}
+
+const std::vector<GameObject*>& SceneRegistry::FindWithTag(const std::string& tag) const
+{
+    auto it = byTag.find(tag);
+    return it != byTag.end() ? it->second : empty;
+}
+
+void SceneRegistry::Clear()
+{
+    for (auto& pair : byUID)
+    {
+        pair.second->SetInScene(false);
+    }
+
+    byUID.clear();
+    byName.clear();
+    byTag.clear();
+}
+
+void SceneRegistry::AddTo(NameTable& table, const std::string& key, GameObject* obj)
+{
+    table[key].push_back(obj);
+}
+
+void SceneRegistry::RemoveFrom(NameTable& table, const std::string& key, GameObject* obj)
+{
+    auto it = table.find(key);
+    if (it == table.end()) return;
+
+    // Keeps the order, FindAll and FindWithTag list objects in registration order
+    std::vector<GameObject*>& objects = it->second;
+    auto found = std::find(objects.begin(), objects.end(), obj);
+    if (found != objects.end())
+    {
+        objects.erase(found);
+    }
+
+    if (objects.empty())
+    {
+        table.erase(it);
+    }
+}
+
+void SceneRegistry::AddUID(UID uid, GameObject* obj)
+{
+    byUID.emplace(uid, obj);
+}
+
+void SceneRegistry::RemoveUID(UID uid, GameObject* obj)
+{
+    auto range = byUID.equal_range(uid);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second == obj)
+        {
+            byUID.erase(it);
+            return;
+        }
+    }
+}
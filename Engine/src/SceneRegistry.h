@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Globals.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class GameObject;
+
+// Lookup tables for every GameObject attached to the scene root: UID, name and tag.
+// GameObject keeps it current when it is attached / detached / destroyed and when its
+// UID, name or tag change, so ModuleScene::FindObject no longer walks the tree.
+// Objects in detached trees (importer output, undo buffers) are never indexed.
+class SceneRegistry
+{
+public:
+    // Object alone / object and all its descendants
+    void Add(GameObject* obj);
+    void Remove(GameObject* obj);
+    void AddSubtree(GameObject* obj);
+    void RemoveSubtree(GameObject* obj);
+
+    void OnUIDChanged(GameObject* obj, UID oldUID);
+    void OnNameChanged(GameObject* obj, const std::string& oldName);
+    void OnTagChanged(GameObject* obj, const std::string& oldTag);
+
+    // When several objects match, both return the first one in a pre-order walk
+    // from the root, same as the old FindChild search
+    GameObject* Find(UID uid) const;
+    GameObject* Find(const std::string& name) const;
+    // Registration order, not tree order
+    const std::vector<GameObject*>& FindAll(const std::string& name) const;
+    const std::vector<GameObject*>& FindWithTag(const std::string& tag) const;
+
+    size_t GetCount() const { return byUID.size(); }
+    void Clear();
+
+private:
+    typedef std::unordered_map<std::string, std::vector<GameObject*>> NameTable;
+
+    static void AddTo(NameTable& table, const std::string& key, GameObject* obj);
+    static void RemoveFrom(NameTable& table, const std::string& key, GameObject* obj);
+
+    void AddUID(UID uid, GameObject* obj);
+    void RemoveUID(UID uid, GameObject* obj);
+
+    // UIDs are unique in a saved scene, but two instances of the same prefab can share them
+    std::unordered_multimap<UID, GameObject*> byUID;
+    NameTable byName;
+    NameTable byTag;
+
+    static const std::vector<GameObject*> empty;
+};
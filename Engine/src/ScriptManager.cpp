@@ -106,6 +106,8 @@ bool ScriptManager::CleanUp() {
 
     loadedScripts.clear();
     pendingOperations.clear();
+    // Prefabs keep their resources requested, give them back while ModuleResources is alive
+    PrefabManager::GetInstance().Clear();
     LOG_CONSOLE("[ScriptManager] Cleaned up");
     return true;
 }
@@ -1058,6 +1060,93 @@ static int Lua_Animation_IsPlayingAnimation(lua_State* L)
     return 1;
 }
 
+// Needed by scripts that read bone transforms while the animation plays
+static int Lua_Animation_SetSyncBones(lua_State* L)
+{
+    ComponentAnimation* anim = *static_cast<ComponentAnimation**>(lua_touserdata(L, 1));
+    bool sync = lua_toboolean(L, 2);
+
+    if (anim)
+    {
+        anim->SetSyncBones(sync);
+    }
+
+    return 0;
+}
+
+// Blend space parameters
+static int Lua_Animation_SetFloat(lua_State* L)
+{
+    ComponentAnimation* anim = *static_cast<ComponentAnimation**>(lua_touserdata(L, 1));
+    const char* paramName = luaL_checkstring(L, 2);
+    float value = static_cast<float>(luaL_checknumber(L, 3));
+
+    if (anim)
+    {
+        anim->SetParameter(paramName, value);
+    }
+
+    return 0;
+}
+
+static int Lua_Animation_GetFloat(lua_State* L)
+{
+    ComponentAnimation* anim = *static_cast<ComponentAnimation**>(lua_touserdata(L, 1));
+    const char* paramName = luaL_checkstring(L, 2);
+
+    float value = 0.0f;
+    if (anim)
+    {
+        value = anim->GetParameter(paramName);
+    }
+
+    lua_pushnumber(L, value);
+    return 1;
+}
+
+static int Lua_Animation_PlayOnLayer(lua_State* L)
+{
+    ComponentAnimation* anim = *static_cast<ComponentAnimation**>(lua_touserdata(L, 1));
+    const char* layerName = luaL_checkstring(L, 2);
+    const char* animName = luaL_checkstring(L, 3);
+    float blendTime = static_cast<float>(luaL_optnumber(L, 4, 0.2));
+
+    if (anim)
+    {
+        anim->PlayOnLayer(layerName, animName, blendTime);
+    }
+
+    return 0;
+}
+
+static int Lua_Animation_StopLayer(lua_State* L)
+{
+    ComponentAnimation* anim = *static_cast<ComponentAnimation**>(lua_touserdata(L, 1));
+    const char* layerName = luaL_checkstring(L, 2);
+    float blendTime = static_cast<float>(luaL_optnumber(L, 3, 0.2));
+
+    if (anim)
+    {
+        anim->StopLayer(layerName, blendTime);
+    }
+
+    return 0;
+}
+
+static int Lua_Animation_SetLayerWeight(lua_State* L)
+{
+    ComponentAnimation* anim = *static_cast<ComponentAnimation**>(lua_touserdata(L, 1));
+    const char* layerName = luaL_checkstring(L, 2);
+    float weight = static_cast<float>(luaL_checknumber(L, 3));
+
+    if (anim)
+    {
+        anim->SetLayerWeight(layerName, weight);
+    }
+
+    return 0;
+}
+
 // GameObject.Create(name) - Deferred operation
 static int Lua_GameObject_Create(lua_State* L) {
     const char* name = luaL_checkstring(L, 1);
@@ -1127,27 +1216,7 @@ static int Lua_GameObject_SetPersistency(lua_State* L)
 static int Lua_GameObject_Find(lua_State* L) {
     const char* name = luaL_checkstring(L, 1);
 
-    GameObject* root = Application::GetInstance().scene->GetRoot();
-    if (!root) {
-        lua_pushnil(L);
-        return 1;
-    }
-
-    std::function<GameObject* (GameObject*, const std::string&)> findByName;
-    findByName = [&](GameObject* node, const std::string& targetName) -> GameObject* {
-        if (node->GetName() == targetName) {
-            return node;
-        }
-
-        for (GameObject* child : node->GetChildren()) {
-            GameObject* result = findByName(child, targetName);
-            if (result) return result;
-        }
-
-        return nullptr;
-        };
-
-    GameObject* found = findByName(root, name);
+    GameObject* found = Application::GetInstance().scene->FindObject(std::string(name));
 
     if (!found) {
         lua_pushnil(L);
@@ -2115,6 +2184,18 @@ void ScriptManager::RegisterComponentAPI() {
     lua_setfield(L, -2, "IsPlaying");
     lua_pushcfunction(L, Lua_Animation_IsPlayingAnimation);
     lua_setfield(L, -2, "IsPlayingAnimation");
+    lua_pushcfunction(L, Lua_Animation_SetSyncBones);
+    lua_setfield(L, -2, "SetSyncBones");
+    lua_pushcfunction(L, Lua_Animation_SetFloat);
+    lua_setfield(L, -2, "SetFloat");
+    lua_pushcfunction(L, Lua_Animation_GetFloat);
+    lua_setfield(L, -2, "GetFloat");
+    lua_pushcfunction(L, Lua_Animation_PlayOnLayer);
+    lua_setfield(L, -2, "PlayOnLayer");
+    lua_pushcfunction(L, Lua_Animation_StopLayer);
+    lua_setfield(L, -2, "StopLayer");
+    lua_pushcfunction(L, Lua_Animation_SetLayerWeight);
+    lua_setfield(L, -2, "SetLayerWeight");
     lua_pop(L, 1); 
 
     luaL_newmetatable(L, "ParticleSystem");
@@ -2164,12 +2245,12 @@ static int Lua_Prefab_Instantiate(lua_State* L) {
     luaL_getmetatable(L, "GameObject");
     lua_setmetatable(L, -2);
 
-    // Enqueue instantiation for PostUpdate
+    // Enqueue instantiation for PostUpdate. The name is copied, Lua may collect its string first.
     auto& app = Application::GetInstance();
-    app.scripts->EnqueueOperation([name, udata]() {
+    app.scripts->EnqueueOperation([name = std::string(name), udata]() {
         GameObject* instance = nullptr;
 
-        // First check if prefab is already loaded in PrefabManager
+        // First check if prefab is already loaded in PrefabManager. Reuses a released instance if any.
         if (PrefabManager::GetInstance().HasPrefab(name)) {
             instance = PrefabManager::GetInstance().InstantiatePrefab(name);
         }
@@ -2239,13 +2320,30 @@ static int Lua_Prefab_Instantiate(lua_State* L) {
             *udata = instance;
         }
         else {
-            LOG_CONSOLE("[Lua] ERROR: Failed to instantiate prefab: %s", name);
+            LOG_CONSOLE("[Lua] ERROR: Failed to instantiate prefab: %s", name.c_str());
         }
         });
 
     return 1;
 }
 
+// Prefab.Release(name, gameObject) - Deactivates the instance and pools it for Prefab.Instantiate
+static int Lua_Prefab_Release(lua_State* L) {
+    const char* name = luaL_checkstring(L, 1);
+    GameObject** udata = static_cast<GameObject**>(luaL_checkudata(L, 2, "GameObject"));
+
+    if (!udata || !*udata) {
+        LOG_CONSOLE("[Lua] ERROR: Invalid GameObject in Prefab.Release()");
+        lua_pushboolean(L, false);
+        return 1;
+    }
+
+    bool success = PrefabManager::GetInstance().ReleaseInstance(name, *udata);
+
+    lua_pushboolean(L, success);
+    return 1;
+}
+
 
 void ScriptManager::RegisterPrefabAPI() {
     lua_newtable(L);
@@ -2256,6 +2354,9 @@ void ScriptManager::RegisterPrefabAPI() {
     lua_pushcfunction(L, Lua_Prefab_Instantiate);
     lua_setfield(L, -2, "Instantiate");
 
+    lua_pushcfunction(L, Lua_Prefab_Release);
+    lua_setfield(L, -2, "Release");
+
     lua_setglobal(L, "Prefab");
 
 }
@@ -13,10 +13,11 @@ Shader::Shader() : shaderProgram(0)
         "    mat4 projection;\n"
         "};\n";
 
+    // gBones is the skinning palette of every skinned mesh this frame, already in mesh space
+    // (meshInverse * bone * offset). boneBase is where the drawn mesh's palette starts.
     skinningDeclarations =
         "layout(std430, binding = 0) readonly buffer BoneMatrices { mat4 gBones[]; };\n"
-        "layout(std430, binding = 1) readonly buffer OffsetMatrices { mat4 gOffsets[]; };\n"
-        "uniform mat4 meshInverse;\n"
+        "uniform int boneBase;\n"
         "uniform bool hasBones;\n"
         "uniform mat4 model;\n";
 
@@ -28,11 +29,17 @@ Shader::Shader() : shaderProgram(0)
         "    if (weightSum < 0.001) return mat4(1.0);\n"
         "    for(int i = 0; i < 4; i++) {\n"
         "        if(ids[i] == -1) continue;\n"
-        "        mat4 boneTransform = meshInverse * gBones[ids[i]] * gOffsets[ids[i]];\n"
-        "        skinMat += boneTransform * (weights[i] / weightSum);\n"
+        "        skinMat += gBones[boneBase + ids[i]] * (weights[i] / weightSum);\n"
         "    }\n"
         "    return skinMat;\n"
         "}\n";
+
+    modelFunction =
+        "mat4 GetModelMatrix() { return model; }\n";
+
+    instancedModelFunction =
+        "layout(std430, binding = 5) readonly buffer InstanceMatrices { mat4 gInstanceModels[]; };\n"
+        "mat4 GetModelMatrix() { return gInstanceModels[gl_BaseInstance + gl_InstanceID]; }\n";
 }
 
 Shader::~Shader()
@@ -96,6 +103,8 @@ bool Shader::LoadFromSource(const char* vSource, const char* fSource, const char
     }
 
     shaderProgram = newProgram;
+    BuildUniformCache();
+
     return true;
 }
 
@@ -124,46 +133,153 @@ unsigned int Shader::CompileShader(unsigned int type, const char* source)
     return shader;
 }
 
+void Shader::BuildUniformCache()
+{
+    uniformLocations.clear();
+
+    int uniformCount = 0;
+    glGetProgramiv(shaderProgram, GL_ACTIVE_UNIFORMS, &uniformCount);
+
+    char name[256];
+    for (int i = 0; i < uniformCount; ++i)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(shaderProgram, (GLuint)i, sizeof(name), &length, &size, &type, name);
+
+        // Uniform block members report -1 and are set through their buffer
+        int location = glGetUniformLocation(shaderProgram, name);
+        if (location < 0) continue;
+
+        std::string uniformName(name, length);
+        uniformLocations[uniformName] = location;
+
+        // Arrays are reported as "name[0]", make the plain name resolve too
+        size_t bracket = uniformName.find('[');
+        if (bracket != std::string::npos)
+            uniformLocations[uniformName.substr(0, bracket)] = location;
+    }
+
+    modelUniform = GetUniform<glm::mat4>("model");
+    hasBonesUniform = GetUniform<bool>("hasBones");
+    boneBaseUniform = GetUniform<int>("boneBase");
+
+    materialUniforms.color = GetUniform<glm::vec4>("uColor");
+    materialUniforms.metallic = GetUniform<float>("uMetallic");
+    materialUniforms.roughness = GetUniform<float>("uRoughness");
+    materialUniforms.heightScale = GetUniform<float>("uHeightScale");
+    materialUniforms.tiling = GetUniform<glm::vec2>("uTiling");
+    materialUniforms.offset = GetUniform<glm::vec2>("uOffset");
+    materialUniforms.albedoMap = GetUniform<int>("uAlbedoMap");
+    materialUniforms.metallicMap = GetUniform<int>("uMetallicMap");
+    materialUniforms.normalMap = GetUniform<int>("uNormalMap");
+    materialUniforms.occlusionMap = GetUniform<int>("uOcclusionMap");
+    materialUniforms.heightMap = GetUniform<int>("uHeightMap");
+    materialUniforms.useMetallicMap = GetUniform<bool>("uUseMetallicMap");
+    materialUniforms.useNormalMap = GetUniform<bool>("uUseNormalMap");
+    materialUniforms.useOcclusionMap = GetUniform<bool>("uUseOcclusionMap");
+    materialUniforms.useHeightMap = GetUniform<bool>("uUseHeightMap");
+
+    sceneUniforms.viewPos = GetUniform<glm::vec3>("viewPos");
+    sceneUniforms.lightDir = GetUniform<glm::vec3>("lightDir");
+    sceneUniforms.numDirLights = GetUniform<int>("numDirLights");
+    sceneUniforms.numPointLights = GetUniform<int>("numPointLights");
+    sceneUniforms.numSpotLights = GetUniform<int>("numSpotLights");
+}
+
+int Shader::GetUniformLocation(const std::string& name) const
+{
+    auto it = uniformLocations.find(name);
+    if (it != uniformLocations.end())
+        return it->second;
+
+    int location = glGetUniformLocation(shaderProgram, name.c_str());
+    uniformLocations.emplace(name, location);
+    return location;
+}
+
 void Shader::Delete()
 {
     if (shaderProgram != 0)
     {
         glDeleteProgram(shaderProgram);
         shaderProgram = 0;
+        uniformLocations.clear();
+        modelUniform = {};
+        hasBonesUniform = {};
+        boneBaseUniform = {};
+        materialUniforms = {};
+        sceneUniforms = {};
     }
 }
 
 void Shader::SetVec3(const std::string& name, const glm::vec3& value) const
 {
-    glUniform3fv(glGetUniformLocation(shaderProgram, name.c_str()), 1, &value[0]);
+    glUniform3fv(GetUniformLocation(name), 1, &value[0]);
 }
 
 void Shader::SetFloat(const std::string& name, float value) const
 {
-    glUniform1f(glGetUniformLocation(shaderProgram, name.c_str()), value);
+    glUniform1f(GetUniformLocation(name), value);
 }
 
 void Shader::SetMat4(const std::string& name, const glm::mat4& mat) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 }
 
 void Shader::SetInt(const std::string& name, int value) const
 {
-    glUniform1i(glGetUniformLocation(shaderProgram, name.c_str()), value);
+    glUniform1i(GetUniformLocation(name), value);
 }
 
 void Shader::SetVec4(const std::string& name, const glm::vec4& value) const
 {
-    glUniform4fv(glGetUniformLocation(shaderProgram, name.c_str()), 1, &value[0]);
+    glUniform4fv(GetUniformLocation(name), 1, &value[0]);
 }
 
 void Shader::SetVec2(const std::string& name, const glm::vec2& value) const
 {
-    glUniform2fv(glGetUniformLocation(shaderProgram, name.c_str()), 1, &value[0]);
+    glUniform2fv(GetUniformLocation(name), 1, &value[0]);
 }
 
 void Shader::SetBool(const std::string& name, bool value) const
 {
-    glUniform1i(glGetUniformLocation(shaderProgram, name.c_str()), (int)value);
+    glUniform1i(GetUniformLocation(name), (int)value);
+}
+
+void Shader::Set(UniformHandle<float> handle, float value) const
+{
+    glUniform1f(handle.location, value);
+}
+
+void Shader::Set(UniformHandle<int> handle, int value) const
+{
+    glUniform1i(handle.location, value);
+}
+
+void Shader::Set(UniformHandle<bool> handle, bool value) const
+{
+    glUniform1i(handle.location, (int)value);
+}
+
+void Shader::Set(UniformHandle<glm::vec2> handle, const glm::vec2& value) const
+{
+    glUniform2fv(handle.location, 1, &value[0]);
+}
+
+void Shader::Set(UniformHandle<glm::vec3> handle, const glm::vec3& value) const
+{
+    glUniform3fv(handle.location, 1, &value[0]);
+}
+
+void Shader::Set(UniformHandle<glm::vec4> handle, const glm::vec4& value) const
+{
+    glUniform4fv(handle.location, 1, &value[0]);
+}
+
+void Shader::Set(UniformHandle<glm::mat4> handle, const glm::mat4& value) const
+{
+    glUniformMatrix4fv(handle.location, 1, GL_FALSE, &value[0][0]);
 }
\ No newline at end of file
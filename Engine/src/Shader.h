@@ -1,8 +1,51 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <glm/glm.hpp>
 
+// Uniform location resolved once from the shader cache. The type only selects
+// the Shader::Set overload, so a handle cannot be uploaded with the wrong glUniform call.
+template<typename T>
+struct UniformHandle
+{
+    int location = -1;
+
+    bool IsValid() const { return location >= 0; }
+};
+
+// Uniforms MaterialStandard::Bind sets on every material change
+struct MaterialUniforms
+{
+    UniformHandle<glm::vec4> color;
+    UniformHandle<float> metallic;
+    UniformHandle<float> roughness;
+    UniformHandle<float> heightScale;
+    UniformHandle<glm::vec2> tiling;
+    UniformHandle<glm::vec2> offset;
+
+    UniformHandle<int> albedoMap;
+    UniformHandle<int> metallicMap;
+    UniformHandle<int> normalMap;
+    UniformHandle<int> occlusionMap;
+    UniformHandle<int> heightMap;
+
+    UniformHandle<bool> useMetallicMap;
+    UniformHandle<bool> useNormalMap;
+    UniformHandle<bool> useOcclusionMap;
+    UniformHandle<bool> useHeightMap;
+};
+
+// Camera and light uniforms the renderer sets every time it switches program
+struct SceneUniforms
+{
+    UniformHandle<glm::vec3> viewPos;
+    UniformHandle<glm::vec3> lightDir;
+    UniformHandle<int> numDirLights;
+    UniformHandle<int> numPointLights;
+    UniformHandle<int> numSpotLights;
+};
+
 class Shader
 {
 public:
@@ -18,6 +61,31 @@ public:
 
     unsigned int GetProgramID() const { return shaderProgram; }
 
+    // Instanced variants read the model matrix from the instance SSBO instead of the uniform
+    bool IsInstanced() const { return instanced; }
+
+    // Location from the reflection cache built at link time (-1 if the program does not use it)
+    int GetUniformLocation(const std::string& name) const;
+
+    template<typename T>
+    UniformHandle<T> GetUniform(const std::string& name) const { return UniformHandle<T>{ GetUniformLocation(name) }; }
+
+    // Per-draw uniforms shared by every mesh shader
+    UniformHandle<glm::mat4> GetModelUniform() const { return modelUniform; }
+    UniformHandle<bool> GetHasBonesUniform() const { return hasBonesUniform; }
+    UniformHandle<int> GetBoneBaseUniform() const { return boneBaseUniform; }
+    const MaterialUniforms& GetMaterialUniforms() const { return materialUniforms; }
+    const SceneUniforms& GetSceneUniforms() const { return sceneUniforms; }
+
+    // Typed setters for pre-resolved handles, the shader must be bound
+    void Set(UniformHandle<float> handle, float value) const;
+    void Set(UniformHandle<int> handle, int value) const;
+    void Set(UniformHandle<bool> handle, bool value) const;
+    void Set(UniformHandle<glm::vec2> handle, const glm::vec2& value) const;
+    void Set(UniformHandle<glm::vec3> handle, const glm::vec3& value) const;
+    void Set(UniformHandle<glm::vec4> handle, const glm::vec4& value) const;
+    void Set(UniformHandle<glm::mat4> handle, const glm::mat4& value) const;
+
     void SetVec3(const std::string& name, const glm::vec3& value) const;
     void SetFloat(const std::string& name, float value) const;
     void SetMat4(const std::string& name, const glm::mat4& mat) const;
@@ -29,10 +97,26 @@ public:
 
 protected:
     unsigned int CompileShader(unsigned int type, const char* source);
+    void BuildUniformCache();
 
     unsigned int shaderProgram;
+    bool instanced = false;
+
+    // name -> location, filled with glGetActiveUniform after linking. Names the driver did
+    // not report (array elements, typos) are resolved once and stored as well.
+    mutable std::unordered_map<std::string, int> uniformLocations;
+
+    UniformHandle<glm::mat4> modelUniform;
+    UniformHandle<bool> hasBonesUniform;
+    UniformHandle<int> boneBaseUniform;
+    MaterialUniforms materialUniforms;
+    SceneUniforms sceneUniforms;
 
     const char* shaderHeader;
     const char* skinningDeclarations;
     const char* skinningFunction;
+
+    // GetModelMatrix() for the vertex stage, picked by the instanced flag
+    const char* modelFunction;
+    const char* instancedModelFunction;
 };
\ No newline at end of file
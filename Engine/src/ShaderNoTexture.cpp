@@ -3,6 +3,7 @@
 bool ShaderNoTexture::CreateShader()
 {
     std::string vert = std::string(shaderHeader) + skinningDeclarations + skinningFunction +
+        (instanced ? instancedModelFunction : modelFunction) +
         "layout(location = 0) in vec3 aPos;\n"
         "layout(location = 1) in vec3 aNormal;\n"
         "layout(location = 2) in vec2 aTexCoord;\n"
@@ -13,10 +14,11 @@ bool ShaderNoTexture::CreateShader()
         "out vec2 TexCoord;\n"
         "void main() {\n"
         "    mat4 skinMat = GetSkinMatrix(boneIDs, weights);\n"
+        "    mat4 modelMatrix = GetModelMatrix();\n"
         "    vec4 skinnedPos = skinMat * vec4(aPos, 1.0);\n"
         "    vec3 skinnedNormal = mat3(skinMat) * aNormal;\n"
-        "    FragPos = vec3(model * skinnedPos);\n"
-        "    Normal = mat3(transpose(inverse(model))) * skinnedNormal;\n"
+        "    FragPos = vec3(modelMatrix * skinnedPos);\n"
+        "    Normal = mat3(transpose(inverse(modelMatrix))) * skinnedNormal;\n"
         "    TexCoord = aTexCoord;\n"
         "    gl_Position = projection * view * vec4(FragPos, 1.0);\n"
         "}\n";
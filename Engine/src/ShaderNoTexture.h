@@ -7,5 +7,7 @@ class ShaderNoTexture : public Shader
 {
 public:
 
+    ShaderNoTexture(bool instanced = false) { this->instanced = instanced; }
+
     bool CreateShader();
 };
\ No newline at end of file
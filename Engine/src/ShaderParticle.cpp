@@ -0,0 +1,40 @@
+#include "ShaderParticle.h"
+
+bool ShaderParticle::CreateShader()
+{
+    std::string vert = std::string(shaderHeader) +
+        "layout(location = 0) in vec4 aPositionSize;\n"
+        "layout(location = 1) in vec4 aColor;\n"
+        "layout(location = 2) in vec4 aUVRect;\n"
+        "layout(location = 3) in float aRotation;\n"
+        "out vec4 vColor;\n"
+        "out vec2 vUV;\n"
+        "const vec2 corners[4] = vec2[](vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(-0.5, 0.5), vec2(0.5, 0.5));\n"
+        "void main() {\n"
+        "    vec2 corner = corners[gl_VertexID];\n"
+        "    float c = cos(aRotation);\n"
+        "    float s = sin(aRotation);\n"
+        "    vec2 offset = vec2(corner.x * c - corner.y * s, corner.x * s + corner.y * c) * aPositionSize.w;\n"
+        // Expanding in view space keeps the quad parallel to the image plane
+        "    vec4 viewPos = view * vec4(aPositionSize.xyz, 1.0);\n"
+        "    viewPos.xy += offset;\n"
+        "    gl_Position = projection * viewPos;\n"
+        "    vUV = mix(aUVRect.xy, aUVRect.zw, corner + 0.5);\n"
+        "    vColor = aColor;\n"
+        "}\n";
+
+    std::string frag =
+        "#version 460 core\n"
+        "in vec4 vColor;\n"
+        "in vec2 vUV;\n"
+        "out vec4 FragColor;\n"
+        "uniform sampler2D particleTexture;\n"
+        "uniform bool hasTexture;\n"
+        "void main() {\n"
+        "    vec4 color = vColor;\n"
+        "    if (hasTexture) color *= texture(particleTexture, vUV);\n"
+        "    FragColor = color;\n"
+        "}\n";
+
+    return LoadFromSource(vert.c_str(), frag.c_str());
+}
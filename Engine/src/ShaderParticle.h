@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+#include "Shader.h"
+
+// Camera-facing particle quads. Every instance is one particle; the four corners
+// are generated from gl_VertexID, so no vertex buffer is bound.
+class ShaderParticle : public Shader
+{
+public:
+
+    bool CreateShader();
+};
@@ -3,6 +3,7 @@
 bool ShaderStandard::CreateShader()
 {
     std::string vert = std::string(shaderHeader) + skinningDeclarations + skinningFunction +
+        (instanced ? instancedModelFunction : modelFunction) +
         "layout(location = 0) in vec3 aPos;\n"
         "layout(location = 1) in vec3 aNormal;\n"
         "layout(location = 2) in vec2 aTexCoord;\n"
@@ -19,12 +20,13 @@ bool ShaderStandard::CreateShader()
         "\n"
         "void main() {\n"
         "    mat4 skinMat = GetSkinMatrix(boneIDs, weights);\n"
-        "    vec4 worldPos = model * skinMat * vec4(aPos, 1.0);\n"
+        "    mat4 modelMatrix = GetModelMatrix();\n"
+        "    vec4 worldPos = modelMatrix * skinMat * vec4(aPos, 1.0);\n"
         "    \n"
         "    vs_out.FragPos = worldPos.xyz;\n"
         "    vs_out.TexCoord = aTexCoord;\n"
         "    \n"
-        "    mat3 normalMatrix = transpose(inverse(mat3(model * skinMat)));\n"
+        "    mat3 normalMatrix = transpose(inverse(mat3(modelMatrix * skinMat)));\n"
         "    vec3 N = normalize(normalMatrix * aNormal);\n"
         "    vec3 T = normalize(normalMatrix * aTangent);\n"
         "    T = normalize(T - dot(T, N) * N);\n"
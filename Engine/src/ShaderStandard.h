@@ -7,5 +7,7 @@ class ShaderStandard : public Shader
 {
 public:
 
+    ShaderStandard(bool instanced = false) { this->instanced = instanced; }
+
     bool CreateShader();
 };
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Transform.h"
 #include "GameObject.h"
+#include "Application.h"
+#include "ModuleScene.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <glm/gtx/euler_angles.hpp>
@@ -13,12 +15,15 @@ Transform::Transform(GameObject* owner)
     position(0.0f, 0.0f, 0.0f),
     rotation(0.0f, 0.0f, 0.0f),
     rotationQuat(1.0f, 0.0f, 0.0f, 0.0f),
-    scale(1.0f, 1.0f, 1.0f),
-    localMatrix(1.0f),
-    globalMatrix(1.0f),
-    localDirty(true),
-    globalDirty(true)
+    scale(1.0f, 1.0f, 1.0f)
 {
+    store = &Application::GetInstance().scene->GetTransformStore();
+    slot = store->Allocate(this);
+}
+
+Transform::~Transform()
+{
+    store->Free(slot);
 }
 
 void Transform::Update()
@@ -34,9 +39,8 @@ void Transform::SetPosition(const glm::vec3& pos)
     if (position != pos)
     {
         position = pos;
-        localDirty = true;
-        globalDirty = true;
-        MarkChildrenGlobalDirty();
+        SyncToStore();
+        owner->PublishGameObjectEvent(GameObjectEvent::TRANSFORM_CHANGED);
     }
 }
 
@@ -62,9 +66,8 @@ void Transform::SetRotation(const glm::vec3& rot)
     {
         rotation = rot;
         UpdateQuaternionFromEuler();
-        localDirty = true;
-        globalDirty = true;
-        MarkChildrenGlobalDirty();
+        SyncToStore();
+        owner->PublishGameObjectEvent(GameObjectEvent::TRANSFORM_CHANGED);
     }
 }
 
@@ -83,9 +86,8 @@ void Transform::SetRotationQuat(const glm::quat& quat)
     {
         rotationQuat = quat;
         UpdateEulerFromQuaternion();
-        localDirty = true;
-        globalDirty = true;
-        MarkChildrenGlobalDirty();
+        SyncToStore();
+        owner->PublishGameObjectEvent(GameObjectEvent::TRANSFORM_CHANGED);
     }
 }
 
@@ -110,11 +112,46 @@ void Transform::SetScale(const glm::vec3& scl)
     if (scale != scl)
     {
         scale = scl;
-        localDirty = true;
-        globalDirty = true;
+        SyncToStore();
         owner->PublishGameObjectEvent(GameObjectEvent::TRANSFORM_SCALED);
-        MarkChildrenGlobalDirty();
+        owner->PublishGameObjectEvent(GameObjectEvent::TRANSFORM_CHANGED);
+    }
+}
+
+void Transform::SetLocalTRS(const glm::vec3& pos, const glm::vec3& rot, const glm::vec3& scl)
+{
+    bool scaled = scale != scl;
+    if (position == pos && rotation == rot && !scaled) return;
+
+    position = pos;
+    if (rotation != rot)
+    {
+        rotation = rot;
+        UpdateQuaternionFromEuler();
     }
+    scale = scl;
+    SyncToStore();
+
+    if (scaled) owner->PublishGameObjectEvent(GameObjectEvent::TRANSFORM_SCALED);
+    owner->PublishGameObjectEvent(GameObjectEvent::TRANSFORM_CHANGED);
+}
+
+void Transform::SetLocalTRS(const glm::vec3& pos, const glm::quat& rot, const glm::vec3& scl)
+{
+    bool scaled = scale != scl;
+    if (position == pos && rotationQuat == rot && !scaled) return;
+
+    position = pos;
+    if (rotationQuat != rot)
+    {
+        rotationQuat = rot;
+        UpdateEulerFromQuaternion();
+    }
+    scale = scl;
+    SyncToStore();
+
+    if (scaled) owner->PublishGameObjectEvent(GameObjectEvent::TRANSFORM_SCALED);
+    owner->PublishGameObjectEvent(GameObjectEvent::TRANSFORM_CHANGED);
 }
 
 void Transform::SetGlobalScale(const glm::vec3& targetScale)
@@ -176,99 +213,39 @@ const glm::quat Transform::GetGlobalRotationQuat()
 
 const glm::mat4& Transform::GetLocalMatrix()
 {
-    if (localDirty)
-    {
-        UpdateLocalMatrix();
-    }
-    return localMatrix;
+    return store->GetLocalMatrix(slot);
 }
 
 const glm::mat4& Transform::GetGlobalMatrix()
 {
-    if (globalDirty)
-    {
-        UpdateGlobalMatrix();
-    }
-    return globalMatrix;
+    return store->GetWorldMatrix(slot);
 }
 
 glm::mat4 Transform::GetWorldMatrixRecursive() {
-    //Force this local matrix to update if dirty
-    if (localDirty) {
-        UpdateLocalMatrix();
-    }
-
-    GameObject* parent = owner->GetParent();
-    if (parent != nullptr) {
-        Transform* parentTransform = static_cast<Transform*>(parent->GetComponent(ComponentType::TRANSFORM));
-        if (parentTransform != nullptr) {
-            // Recursively get the parent's world matrix
-            //bypasses the 'globalDirty' flag and forces a fresh calculation
-            return parentTransform->GetWorldMatrixRecursive() * localMatrix;
-        }
-    }
-
-    // If no parent, local is world
-    return localMatrix;
-}
-
-void Transform::UpdateLocalMatrix()
-{
-    glm::mat4 translationMatrix = glm::translate(glm::mat4(1.0f), position);
-    glm::mat4 rotationMatrix = glm::mat4_cast(rotationQuat);
-    glm::mat4 scaleMatrix = glm::scale(glm::mat4(1.0f), scale);
-
-    localMatrix = translationMatrix * rotationMatrix * scaleMatrix;
-    localDirty = false;
+    // The store revalidates the whole parent chain, so this is always fresh
+    return store->GetWorldMatrix(slot);
 }
 
-void Transform::UpdateGlobalMatrix()
+void Transform::OnParentChanged()
 {
-    if (localDirty)
-    {
-        UpdateLocalMatrix();
-    }
-
     GameObject* parent = owner->GetParent();
+    TransformStore::Slot parentSlot = TransformStore::INVALID_SLOT;
 
-    if (parent != nullptr)
+    if (parent != nullptr && parent->transform != nullptr)
     {
-        Transform* parentTransform = static_cast<Transform*>(parent->GetComponent(ComponentType::TRANSFORM));
-
-        if (parentTransform != nullptr)
-        {
-            globalMatrix = parentTransform->GetGlobalMatrix() * localMatrix;
-        }
-        else
-        {
-            globalMatrix = localMatrix;
-        }
-    }
-    else
-    {
-        globalMatrix = localMatrix;
+        parentSlot = parent->transform->slot;
     }
 
-    globalDirty = false;
+    store->SetParent(slot, parentSlot);
+
+    // Local values are kept, so the world pose of the subtree changes. Descendants are
+    // notified by the store's per-frame pass.
+    owner->PublishGameObjectEvent(GameObjectEvent::TRANSFORM_CHANGED);
 }
 
-void Transform::MarkChildrenGlobalDirty()
+void Transform::SyncToStore()
 {
-    
-    const std::vector<GameObject*>& children = owner->GetChildren();
-
-    for (GameObject* child : children)
-    {
-        Transform* childTransform = static_cast<Transform*>(child->GetComponent(ComponentType::TRANSFORM));
-
-        if (childTransform != nullptr)
-        {
-            childTransform->globalDirty = true;
-            childTransform->MarkChildrenGlobalDirty();
-        }
-    }
-    
-    owner->PublishGameObjectEvent(GameObjectEvent::TRANSFORM_CHANGED);
+    store->SetLocal(slot, position, rotationQuat, scale);
 }
 
 void Transform::UpdateQuaternionFromEuler()
@@ -305,8 +282,6 @@ void Transform::Deserialize(const nlohmann::json& componentObj)
                 posArray[1].get<float>(),
                 posArray[2].get<float>()
             );
-            localDirty = true;
-            globalDirty = true;
         }
     }
 
@@ -320,8 +295,6 @@ void Transform::Deserialize(const nlohmann::json& componentObj)
                 rotArray[2].get<float>()
             );
             UpdateQuaternionFromEuler();
-            localDirty = true;
-            globalDirty = true;
         }
     }
 
@@ -334,8 +307,8 @@ void Transform::Deserialize(const nlohmann::json& componentObj)
                 scaleArray[1].get<float>(),
                 scaleArray[2].get<float>()
             );
-            localDirty = true;
-            globalDirty = true;
         }
     }
+
+    SyncToStore();
 }
\ No newline at end of file
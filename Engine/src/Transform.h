@@ -3,13 +3,16 @@
 #define GLM_ENABLE_EXPERIMENTAL
 
 #include "Component.h"
+#include "TransformStore.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+// Facade over a slot of the scene's TransformStore. Local TRS is mirrored here so the
+// getters can keep returning references; matrices and the hierarchy live in the store.
 class Transform : public Component {
 public:
     Transform(GameObject* owner);
-    ~Transform() = default;
+    ~Transform();
 
     void Update() override;
     void OnEditor() override;
@@ -35,6 +38,9 @@ public:
     void SetRotation(const glm::vec3& rot);
     void SetRotationQuat(const glm::quat& quat);
     void SetScale(const glm::vec3& scl);
+    // All three at once (rotation as Euler angles), one store sync and one event
+    void SetLocalTRS(const glm::vec3& pos, const glm::vec3& rot, const glm::vec3& scl);
+    void SetLocalTRS(const glm::vec3& pos, const glm::quat& rot, const glm::vec3& scl);
 
     void SetGlobalPosition(const glm::vec3& pos);
     void SetGlobalRotation(const glm::vec3& rot);
@@ -47,8 +53,8 @@ public:
     //for audio coords
     glm::mat4 GetWorldMatrixRecursive();
 
-    void UpdateLocalMatrix();
-    void UpdateGlobalMatrix();
+    // Called by GameObject whenever the owner is attached to / detached from a parent
+    void OnParentChanged();
 
 
     // Getter para el GameObject propietario (necesario para validaciones en Lua)
@@ -65,15 +71,10 @@ private:
     glm::quat rotationQuat; // Quaternions
     glm::vec3 scale;
 
-    // Matrixs
-    glm::mat4 localMatrix;
-    glm::mat4 globalMatrix;
-
-    // Dirty flags
-    bool localDirty = true;
-    bool globalDirty = true;
+    TransformStore* store = nullptr;
+    TransformStore::Slot slot = TransformStore::INVALID_SLOT;
 
     void UpdateQuaternionFromEuler();
     void UpdateEulerFromQuaternion();
-    void MarkChildrenGlobalDirty();
+    void SyncToStore();
 };
\ No newline at end of file
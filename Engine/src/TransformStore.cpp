@@ -0,0 +1,274 @@
+#include "TransformStore.h"
+#include "Transform.h"
+#include "GameObject.h"
+#include "MatrixMath.h"
+#include <algorithm>
+
+static const uint32_t UNKNOWN_DEPTH = 0xFFFFFFFF;
+
+TransformStore::Slot TransformStore::Allocate(Transform* owner)
+{
+    Slot slot;
+    if (!freeSlots.empty())
+    {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        slot = (Slot)parents.size();
+        parents.push_back(INVALID_SLOT);
+        owners.push_back(nullptr);
+        positions.emplace_back(0.0f);
+        rotations.emplace_back(1.0f, 0.0f, 0.0f, 0.0f);
+        scales.emplace_back(1.0f);
+        localMatrices.emplace_back(1.0f);
+        worldMatrices.emplace_back(1.0f);
+        changedEpochs.push_back(0);
+        worldEpochs.push_back(0);
+        localDirty.push_back(0);
+        depths.push_back(UNKNOWN_DEPTH);
+    }
+
+    parents[slot] = INVALID_SLOT;
+    owners[slot] = owner;
+    positions[slot] = glm::vec3(0.0f);
+    rotations[slot] = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    scales[slot] = glm::vec3(1.0f);
+    localMatrices[slot] = glm::mat4(1.0f);
+    worldMatrices[slot] = glm::mat4(1.0f);
+    changedEpochs[slot] = ++epoch;
+    worldEpochs[slot] = 0;
+    localDirty[slot] = 0;
+
+    orderDirty = true;
+    return slot;
+}
+
+void TransformStore::Free(Slot slot)
+{
+    if (slot == INVALID_SLOT || slot >= parents.size() || owners[slot] == nullptr)
+    {
+        return;
+    }
+
+    owners[slot] = nullptr;
+    parents[slot] = INVALID_SLOT;
+    freeSlots.push_back(slot);
+    orderDirty = true;
+}
+
+void TransformStore::SetParent(Slot slot, Slot parent)
+{
+    if (parents[slot] == parent)
+    {
+        return;
+    }
+
+    parents[slot] = parent;
+    changedEpochs[slot] = ++epoch;
+    orderDirty = true;
+}
+
+void TransformStore::SetLocal(Slot slot, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+{
+    positions[slot] = position;
+    rotations[slot] = rotation;
+    scales[slot] = scale;
+    localDirty[slot] = 1;
+    changedEpochs[slot] = ++epoch;
+
+    if (!orderDirty)
+    {
+        minDirtyDepth = std::min(minDirtyDepth, depths[slot]);
+    }
+}
+
+const glm::mat4& TransformStore::GetLocalMatrix(Slot slot)
+{
+    if (localDirty[slot])
+    {
+        ComposeLocal(slot);
+    }
+    return localMatrices[slot];
+}
+
+const glm::mat4& TransformStore::GetWorldMatrix(Slot slot)
+{
+    chain.clear();
+    for (Slot current = slot; current != INVALID_SLOT; current = parents[current])
+    {
+        chain.push_back(current);
+    }
+
+    // Walk root -> slot carrying the newest change seen so far; everything computed
+    // before that change is stale
+    uint64_t newestChange = 0;
+    for (size_t i = chain.size(); i-- > 0;)
+    {
+        const Slot current = chain[i];
+        newestChange = std::max(newestChange, changedEpochs[current]);
+
+        if (worldEpochs[current] >= newestChange)
+        {
+            continue;
+        }
+
+        if (localDirty[current])
+        {
+            ComposeLocal(current);
+        }
+
+        const Slot parent = parents[current];
+        if (parent != INVALID_SLOT)
+        {
+            MultiplyMatrices(worldMatrices[parent], localMatrices[current], worldMatrices[current]);
+        }
+        else
+        {
+            worldMatrices[current] = localMatrices[current];
+        }
+        worldEpochs[current] = epoch;
+    }
+
+    return worldMatrices[slot];
+}
+
+void TransformStore::UpdateWorldMatrices()
+{
+    if (orderDirty)
+    {
+        RebuildOrder();
+        minDirtyDepth = 0;
+    }
+
+    const uint64_t passEpoch = epoch;
+    if (passEpoch == lastPassEpoch)
+    {
+        return;
+    }
+
+    // Levels above the shallowest change cannot have moved
+    size_t first = order.size();
+    if ((size_t)minDirtyDepth + 1 < levelStarts.size())
+    {
+        first = levelStarts[minDirtyDepth];
+    }
+    minDirtyDepth = UNKNOWN_DEPTH;
+
+    moved.assign(parents.size(), 0);
+
+    for (size_t i = first; i < order.size(); ++i)
+    {
+        const Slot slot = order[i];
+        if (owners[slot] == nullptr)
+        {
+            continue;
+        }
+
+        const Slot parent = parents[slot];
+        const bool parentMoved = parent != INVALID_SLOT && moved[parent];
+
+        if (!parentMoved && changedEpochs[slot] <= lastPassEpoch)
+        {
+            continue;
+        }
+
+        if (localDirty[slot])
+        {
+            ComposeLocal(slot);
+        }
+
+        if (parent != INVALID_SLOT)
+        {
+            MultiplyMatrices(worldMatrices[parent], localMatrices[slot], worldMatrices[slot]);
+        }
+        else
+        {
+            worldMatrices[slot] = localMatrices[slot];
+        }
+        worldEpochs[slot] = passEpoch;
+        moved[slot] = 1;
+
+        // The node itself already published when it was set
+        if (parentMoved)
+        {
+            owners[slot]->GetOwner()->PublishGameObjectEvent(GameObjectEvent::TRANSFORM_CHANGED);
+        }
+    }
+
+    // Anything set by the event handlers above is left for the next pass
+    lastPassEpoch = passEpoch;
+}
+
+void TransformStore::RebuildOrder()
+{
+    const size_t count = parents.size();
+    std::fill(depths.begin(), depths.end(), UNKNOWN_DEPTH);
+
+    uint32_t maxDepth = 0;
+    for (Slot slot = 0; slot < count; ++slot)
+    {
+        if (owners[slot] == nullptr || depths[slot] != UNKNOWN_DEPTH)
+        {
+            continue;
+        }
+
+        // Climb until a node with a known depth (or a root), then assign on the way back
+        chain.clear();
+        Slot current = slot;
+        while (current != INVALID_SLOT && depths[current] == UNKNOWN_DEPTH)
+        {
+            chain.push_back(current);
+            current = parents[current];
+        }
+
+        uint32_t depth = current == INVALID_SLOT ? 0 : depths[current] + 1;
+        for (size_t i = chain.size(); i-- > 0;)
+        {
+            depths[chain[i]] = depth++;
+        }
+        maxDepth = std::max(maxDepth, depth - 1);
+    }
+
+    // Counting sort by depth
+    levelStarts.assign(maxDepth + 2, 0);
+    for (Slot slot = 0; slot < count; ++slot)
+    {
+        if (owners[slot] != nullptr)
+        {
+            ++levelStarts[depths[slot] + 1];
+        }
+    }
+    for (size_t level = 1; level < levelStarts.size(); ++level)
+    {
+        levelStarts[level] += levelStarts[level - 1];
+    }
+
+    order.resize(levelStarts.back());
+    std::vector<uint32_t> cursor(levelStarts.begin(), levelStarts.end() - 1);
+    for (Slot slot = 0; slot < count; ++slot)
+    {
+        if (owners[slot] != nullptr)
+        {
+            order[cursor[depths[slot]]++] = slot;
+        }
+    }
+
+    orderDirty = false;
+}
+
+void TransformStore::ComposeLocal(Slot slot)
+{
+    // T * R * S without the three full matrix products
+    const glm::mat3 rotation = glm::mat3_cast(rotations[slot]);
+    const glm::vec3& scale = scales[slot];
+
+    glm::mat4& local = localMatrices[slot];
+    local[0] = glm::vec4(rotation[0] * scale.x, 0.0f);
+    local[1] = glm::vec4(rotation[1] * scale.y, 0.0f);
+    local[2] = glm::vec4(rotation[2] * scale.z, 0.0f);
+    local[3] = glm::vec4(positions[slot], 1.0f);
+
+    localDirty[slot] = 0;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <cstdint>
+#include <vector>
+
+class Transform;
+
+// Contiguous storage for every Transform in the scene. Components only keep a slot
+// index; local/world matrices and the hierarchy (as parent indices) live here in flat
+// arrays so the per-frame update is a single linear pass over parents-before-children.
+//
+// Invalidation works with a global epoch instead of recursive dirty flags: every
+// change stamps its slot with a new epoch, and a cached world matrix is valid while
+// no ancestor (or the node itself) carries a newer stamp than the matrix.
+class TransformStore
+{
+public:
+    typedef uint32_t Slot;
+    static constexpr Slot INVALID_SLOT = 0xFFFFFFFF;
+
+    Slot Allocate(Transform* owner);
+    void Free(Slot slot);
+
+    // parent may be INVALID_SLOT (root / detached object)
+    void SetParent(Slot slot, Slot parent);
+    Slot GetParent(Slot slot) const { return parents[slot]; }
+
+    void SetLocal(Slot slot, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+
+    const glm::mat4& GetLocalMatrix(Slot slot);
+    // Up to date at any point of the frame; recomputes only the stale part of the
+    // parent chain
+    const glm::mat4& GetWorldMatrix(Slot slot);
+
+    // Recomputes every world matrix touched since the last call, parents first, and
+    // publishes TRANSFORM_CHANGED on the descendants that moved with their parent
+    void UpdateWorldMatrices();
+
+    size_t GetCount() const { return parents.size() - freeSlots.size(); }
+
+private:
+    void RebuildOrder();
+    void ComposeLocal(Slot slot);
+
+    // Per slot
+    std::vector<Slot> parents;
+    std::vector<Transform*> owners;
+    std::vector<glm::vec3> positions;
+    std::vector<glm::quat> rotations;
+    std::vector<glm::vec3> scales;
+    std::vector<glm::mat4> localMatrices;
+    std::vector<glm::mat4> worldMatrices;
+    std::vector<uint64_t> changedEpochs;    // last local or parent change
+    std::vector<uint64_t> worldEpochs;      // when worldMatrices[slot] was computed
+    std::vector<uint8_t> localDirty;
+    std::vector<uint32_t> depths;
+
+    std::vector<Slot> freeSlots;
+
+    // Live slots sorted by depth; levelStarts[d] is the first entry of depth d
+    std::vector<Slot> order;
+    std::vector<uint32_t> levelStarts;
+    bool orderDirty = true;
+
+    // Shallowest depth changed since the last pass, the pass starts at that level
+    uint32_t minDirtyDepth = 0;
+
+    uint64_t epoch = 1;
+    uint64_t lastPassEpoch = 0;
+
+    // Scratch
+    std::vector<uint8_t> moved;
+    std::vector<Slot> chain;
+};
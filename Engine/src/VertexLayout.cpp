@@ -0,0 +1,254 @@
+#include "VertexLayout.h"
+#include "ResourceMesh.h"
+#include <glad/glad.h>
+#include <glm/gtc/packing.hpp>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    // Past this half floats step more than 1/512 between UVs, visible on a tiled texture
+    const float MAX_HALF_UV = 4.0f;
+    const size_t MAX_PACKED_BONES = 256;
+    const unsigned int ATTRIBUTE_LOCATIONS = 6;
+
+    struct StaticPackedVertex
+    {
+        float position[3];
+        uint32_t normal;        // snorm 10:10:10:2
+        uint32_t texCoords;     // half2
+        uint32_t tangent;       // snorm 10:10:10:2
+    };
+
+    struct SkinnedPackedVertex
+    {
+        float position[3];
+        uint32_t normal;
+        uint32_t texCoords;
+        uint32_t tangent;
+        uint8_t boneIDs[4];
+        uint8_t weights[4];     // unorm8, summing 255
+    };
+
+    static_assert(sizeof(StaticPackedVertex) == 24, "Unexpected padding in StaticPackedVertex");
+    static_assert(sizeof(SkinnedPackedVertex) == 32, "Unexpected padding in SkinnedPackedVertex");
+
+    VertexLayout MakeFullLayout()
+    {
+        VertexLayout layout;
+        layout.format = VertexFormat::FULL;
+        layout.stride = sizeof(Vertex);
+        layout.attributes = {
+            { 0, 3, GL_FLOAT, false, false, (unsigned int)offsetof(Vertex, position) },
+            { 1, 3, GL_FLOAT, false, false, (unsigned int)offsetof(Vertex, normal) },
+            { 2, 2, GL_FLOAT, false, false, (unsigned int)offsetof(Vertex, texCoords) },
+            { 3, 4, GL_INT, false, true, (unsigned int)offsetof(Vertex, boneIDs) },
+            { 4, 4, GL_FLOAT, false, false, (unsigned int)offsetof(Vertex, weights) },
+            { 5, 3, GL_FLOAT, false, false, (unsigned int)offsetof(Vertex, tangent) }
+        };
+        return layout;
+    }
+
+    template<typename T>
+    void AddPackedAttributes(VertexLayout& layout)
+    {
+        // Packed 10:10:10:2 types always have 4 components, the shader just ignores w
+        layout.attributes.push_back({ 0, 3, GL_FLOAT, false, false, (unsigned int)offsetof(T, position) });
+        layout.attributes.push_back({ 1, 4, GL_INT_2_10_10_10_REV, true, false, (unsigned int)offsetof(T, normal) });
+        layout.attributes.push_back({ 2, 2, GL_HALF_FLOAT, false, false, (unsigned int)offsetof(T, texCoords) });
+        layout.attributes.push_back({ 5, 4, GL_INT_2_10_10_10_REV, true, false, (unsigned int)offsetof(T, tangent) });
+    }
+
+    VertexLayout MakeStaticPackedLayout()
+    {
+        VertexLayout layout;
+        layout.format = VertexFormat::STATIC_PACKED;
+        layout.stride = sizeof(StaticPackedVertex);
+        AddPackedAttributes<StaticPackedVertex>(layout);
+        return layout;
+    }
+
+    VertexLayout MakeSkinnedPackedLayout()
+    {
+        VertexLayout layout;
+        layout.format = VertexFormat::SKINNED_PACKED;
+        layout.stride = sizeof(SkinnedPackedVertex);
+        AddPackedAttributes<SkinnedPackedVertex>(layout);
+        layout.attributes.push_back({ 3, 4, GL_UNSIGNED_BYTE, false, true, (unsigned int)offsetof(SkinnedPackedVertex, boneIDs) });
+        layout.attributes.push_back({ 4, 4, GL_UNSIGNED_BYTE, true, false, (unsigned int)offsetof(SkinnedPackedVertex, weights) });
+        return layout;
+    }
+
+    template<typename T>
+    void PackCommon(const Vertex& vertex, T& packed)
+    {
+        packed.position[0] = vertex.position.x;
+        packed.position[1] = vertex.position.y;
+        packed.position[2] = vertex.position.z;
+        packed.normal = glm::packSnorm3x10_1x2(glm::vec4(vertex.normal, 0.0f));
+        packed.texCoords = glm::packHalf2x16(vertex.texCoords);
+        packed.tangent = glm::packSnorm3x10_1x2(glm::vec4(vertex.tangent, 0.0f));
+    }
+
+    template<typename T>
+    void UnpackCommon(const T& packed, Vertex& vertex)
+    {
+        vertex.position = glm::vec3(packed.position[0], packed.position[1], packed.position[2]);
+        vertex.normal = glm::vec3(glm::unpackSnorm3x10_1x2(packed.normal));
+        vertex.texCoords = glm::unpackHalf2x16(packed.texCoords);
+        vertex.tangent = glm::vec3(glm::unpackSnorm3x10_1x2(packed.tangent));
+    }
+
+    // Unused slots get id 0 and weight 0, they add nothing to the skin matrix
+    void PackSkin(const Vertex& vertex, SkinnedPackedVertex& packed)
+    {
+        int sum = 0;
+        int largest = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            bool used = vertex.boneIDs[i] >= 0 && vertex.weights[i] > 0.0f;
+            packed.boneIDs[i] = used ? (uint8_t)vertex.boneIDs[i] : 0;
+            packed.weights[i] = used ? (uint8_t)std::lround(glm::clamp(vertex.weights[i], 0.0f, 1.0f) * 255.0f) : 0;
+
+            sum += packed.weights[i];
+            if (packed.weights[i] > packed.weights[largest]) largest = i;
+        }
+
+        // Rounding error goes to the main influence so the weights still add up to one
+        if (sum > 0)
+        {
+            packed.weights[largest] = (uint8_t)glm::clamp(packed.weights[largest] + 255 - sum, 0, 255);
+        }
+    }
+
+    void UnpackSkin(const SkinnedPackedVertex& packed, Vertex& vertex)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            bool used = packed.weights[i] != 0;
+            vertex.boneIDs[i] = used ? packed.boneIDs[i] : -1;
+            vertex.weights[i] = packed.weights[i] / 255.0f;
+        }
+    }
+}
+
+void VertexLayout::Apply() const
+{
+    bool enabled[ATTRIBUTE_LOCATIONS] = {};
+
+    for (const VertexAttribute& attribute : attributes)
+    {
+        glEnableVertexAttribArray(attribute.location);
+        if (attribute.integer)
+        {
+            glVertexAttribIPointer(attribute.location, attribute.components, attribute.type, stride,
+                (void*)(uintptr_t)attribute.offset);
+        }
+        else
+        {
+            glVertexAttribPointer(attribute.location, attribute.components, attribute.type,
+                attribute.normalized ? GL_TRUE : GL_FALSE, stride, (void*)(uintptr_t)attribute.offset);
+        }
+        enabled[attribute.location] = true;
+    }
+
+    // Static layouts have no skinning stream, those meshes are drawn with hasBones off
+    for (unsigned int location = 0; location < ATTRIBUTE_LOCATIONS; ++location)
+    {
+        if (!enabled[location]) glDisableVertexAttribArray(location);
+    }
+}
+
+const VertexLayout& VertexLayout::Get(VertexFormat format)
+{
+    static const VertexLayout layouts[] = {
+        MakeFullLayout(),
+        MakeStaticPackedLayout(),
+        MakeSkinnedPackedLayout()
+    };
+
+    return layouts[IsValidFormat((uint32_t)format) ? (uint32_t)format : 0];
+}
+
+bool VertexLayout::IsValidFormat(uint32_t format)
+{
+    return format <= (uint32_t)VertexFormat::SKINNED_PACKED;
+}
+
+VertexFormat VertexLayout::ChooseFormat(const std::vector<Vertex>& vertices, size_t boneCount)
+{
+    if (boneCount > MAX_PACKED_BONES) return VertexFormat::FULL;
+
+    for (const Vertex& vertex : vertices)
+    {
+        if (std::abs(vertex.texCoords.x) > MAX_HALF_UV || std::abs(vertex.texCoords.y) > MAX_HALF_UV)
+        {
+            return VertexFormat::FULL;
+        }
+    }
+
+    return boneCount > 0 ? VertexFormat::SKINNED_PACKED : VertexFormat::STATIC_PACKED;
+}
+
+void VertexLayout::Pack(const Vertex* vertices, size_t count, VertexFormat format, std::vector<unsigned char>& outData)
+{
+    outData.resize(count * Get(format).stride);
+    unsigned char* out = outData.data();
+
+    switch (format)
+    {
+    case VertexFormat::STATIC_PACKED:
+        for (size_t i = 0; i < count; ++i)
+        {
+            StaticPackedVertex packed;
+            PackCommon(vertices[i], packed);
+            memcpy(out + i * sizeof(packed), &packed, sizeof(packed));
+        }
+        break;
+
+    case VertexFormat::SKINNED_PACKED:
+        for (size_t i = 0; i < count; ++i)
+        {
+            SkinnedPackedVertex packed;
+            PackCommon(vertices[i], packed);
+            PackSkin(vertices[i], packed);
+            memcpy(out + i * sizeof(packed), &packed, sizeof(packed));
+        }
+        break;
+
+    default:
+        if (count > 0) memcpy(out, vertices, count * sizeof(Vertex));
+        break;
+    }
+}
+
+void VertexLayout::Unpack(const unsigned char* data, size_t count, VertexFormat format, std::vector<Vertex>& outVertices)
+{
+    outVertices.resize(count);
+
+    switch (format)
+    {
+    case VertexFormat::STATIC_PACKED:
+        for (size_t i = 0; i < count; ++i)
+        {
+            StaticPackedVertex packed;
+            memcpy(&packed, data + i * sizeof(packed), sizeof(packed));
+            UnpackCommon(packed, outVertices[i]);
+        }
+        break;
+
+    case VertexFormat::SKINNED_PACKED:
+        for (size_t i = 0; i < count; ++i)
+        {
+            SkinnedPackedVertex packed;
+            memcpy(&packed, data + i * sizeof(packed), sizeof(packed));
+            UnpackCommon(packed, outVertices[i]);
+            UnpackSkin(packed, outVertices[i]);
+        }
+        break;
+
+    default:
+        if (count > 0) memcpy(outVertices.data(), data, count * sizeof(Vertex));
+        break;
+    }
+}
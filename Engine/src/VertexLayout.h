@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct Vertex;
+
+// How vertices are laid out in a Library mesh file and in its VBO. The value is stored in the file.
+// Attribute locations are the same in every format (0 position, 1 normal, 2 uv, 3 bone ids,
+// 4 weights, 5 tangent) and the packed types are all normalized / integer GL formats, so the
+// shaders read vec3 / vec2 / ivec4 / vec4 whatever the format is.
+enum class VertexFormat : uint32_t
+{
+    FULL = 0,           // Vertex as is, 80 bytes
+    STATIC_PACKED,      // float3 position, snorm 10:10:10:2 normal and tangent, half2 uv: 24 bytes
+    SKINNED_PACKED      // STATIC_PACKED + uint8x4 bone ids and unorm8x4 weights: 32 bytes
+};
+
+struct VertexAttribute
+{
+    unsigned int location;
+    int components;
+    unsigned int type;          // GL type
+    bool normalized;
+    bool integer;               // read as ivec in the shader (glVertexAttribIPointer)
+    unsigned int offset;
+};
+
+struct VertexLayout
+{
+    VertexFormat format = VertexFormat::FULL;
+    unsigned int stride = 0;
+    std::vector<VertexAttribute> attributes;
+
+    // Sets up the attributes of the bound VAO over the buffer bound to GL_ARRAY_BUFFER
+    void Apply() const;
+
+    static const VertexLayout& Get(VertexFormat format);
+    static bool IsValidFormat(uint32_t format);
+
+    // Smallest format that keeps the data: packed unless there are more bones than a
+    // uint8 can index or UVs too far out for half floats
+    static VertexFormat ChooseFormat(const std::vector<Vertex>& vertices, size_t boneCount);
+
+    static void Pack(const Vertex* vertices, size_t count, VertexFormat format, std::vector<unsigned char>& outData);
+    // data holds count vertices of the given format, with no alignment requirement
+    static void Unpack(const unsigned char* data, size_t count, VertexFormat format, std::vector<Vertex>& outVertices);
+};
@@ -0,0 +1,517 @@
+// 500 skinned characters animated the way a frame does it, with every one forced to each LOD
+// level in turn: ComponentAnimation's UpdateAsync step (LOD interval, advancing the motions,
+// AnimationEvaluator) spread over the job system like ComponentScheduler does, then the
+// skinning palette of every character that is not culled written into a frame ring like
+// ComponentSkinnedMesh::UpdateSkinningMatrices. Skeletons and clips are built here, no scene.
+// Checks that poses are the same at every thread count, that LOW / CULLED leave deep bones in
+// their bind pose, that skipped frames still advance the motions by the whole interval.
+
+#include "HeadlessTest.h"
+#include "AnimationEvaluator.h"
+#include "AnimationClip.h"
+#include "FrameRingBuffer.h"
+#include "JobSystem.h"
+#include "MatrixMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+// Same as ComponentScheduler's
+static const uint32_t PARALLEL_GRAIN = 4;
+// Same ring as the renderer's
+static const size_t FRAME_RING_SIZE = 8 * 1024 * 1024;
+static const unsigned int FRAME_RING_FRAMES = 3;
+static const size_t STORAGE_ALIGNMENT = 256;
+
+static const float FRAME_TIME = 1.0f / 60.0f;
+
+// The GPU is always done by the time the fence is waited on
+class ImmediateFences : public FenceBackend
+{
+public:
+    FenceHandle Insert() override { return (FenceHandle)(uintptr_t)++inserted; }
+    void Wait(FenceHandle) override {}
+    void Release(FenceHandle) override {}
+
+private:
+    uintptr_t inserted = 0;
+};
+
+struct Skeleton
+{
+    std::vector<BoneLink> bones;
+    std::vector<int> evaluationOrder;
+    std::vector<glm::mat4> offsets;     // inverse bind matrices, as the mesh's bones hold them
+    std::vector<float> upperBodyMask;
+};
+
+struct Character
+{
+    std::vector<AnimationLayer> layers;
+    std::unordered_map<std::string, float> parameters;
+    AnimationEvaluator evaluator;
+    uint32_t lodFrame = 0;
+    float lodElapsed = 0.0f;
+    int updates = 0;
+    glm::mat4 world = glm::mat4(1.0f);
+};
+
+static int AddBone(Skeleton& skeleton, const std::string& name, int parent, const glm::vec3& offset)
+{
+    BoneLink link;
+    link.boneName = name;
+    link.parent = parent;
+    link.depth = parent >= 0 ? skeleton.bones[parent].depth + 1 : 0;
+    link.originalPos = offset;
+    link.originalRot = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    link.originalScl = glm::vec3(1.0f);
+    skeleton.bones.push_back(link);
+    return (int)skeleton.bones.size() - 1;
+}
+
+// A 60 bone humanoid: spine, head with face bones, arms down to three joint fingers, legs
+static Skeleton BuildSkeleton()
+{
+    Skeleton skeleton;
+
+    int hips = AddBone(skeleton, "hips", -1, glm::vec3(0.0f, 1.0f, 0.0f));
+    int spine = hips;
+    for (int i = 0; i < 3; ++i) spine = AddBone(skeleton, "spine" + std::to_string(i), spine, glm::vec3(0.0f, 0.15f, 0.0f));
+    int neck = AddBone(skeleton, "neck", spine, glm::vec3(0.0f, 0.1f, 0.0f));
+    int head = AddBone(skeleton, "head", neck, glm::vec3(0.0f, 0.1f, 0.0f));
+    for (int i = 0; i < 8; ++i) AddBone(skeleton, "face" + std::to_string(i), head, glm::vec3((i - 3.5f) * 0.02f, 0.08f, 0.08f));
+
+    size_t upperBodyStart = skeleton.bones.size();
+    for (int side = 0; side < 2; ++side)
+    {
+        const std::string prefix = side == 0 ? "left_" : "right_";
+        const float x = side == 0 ? 1.0f : -1.0f;
+
+        int bone = AddBone(skeleton, prefix + "clavicle", spine, glm::vec3(x * 0.08f, 0.05f, 0.0f));
+        bone = AddBone(skeleton, prefix + "upperarm", bone, glm::vec3(x * 0.12f, 0.0f, 0.0f));
+        bone = AddBone(skeleton, prefix + "forearm", bone, glm::vec3(x * 0.28f, 0.0f, 0.0f));
+        int hand = AddBone(skeleton, prefix + "hand", bone, glm::vec3(x * 0.25f, 0.0f, 0.0f));
+        for (int finger = 0; finger < 5; ++finger)
+        {
+            bone = hand;
+            for (int joint = 0; joint < 3; ++joint)
+            {
+                bone = AddBone(skeleton, prefix + "finger" + std::to_string(finger) + "_" + std::to_string(joint), bone,
+                    glm::vec3(x * 0.03f, 0.0f, (finger - 2) * 0.015f * (joint == 0 ? 1.0f : 0.0f)));
+            }
+        }
+    }
+    size_t upperBodyEnd = skeleton.bones.size();
+
+    for (int side = 0; side < 2; ++side)
+    {
+        const std::string prefix = side == 0 ? "left_" : "right_";
+        const float x = side == 0 ? 1.0f : -1.0f;
+
+        int bone = AddBone(skeleton, prefix + "thigh", hips, glm::vec3(x * 0.1f, -0.05f, 0.0f));
+        bone = AddBone(skeleton, prefix + "calf", bone, glm::vec3(0.0f, -0.45f, 0.0f));
+        bone = AddBone(skeleton, prefix + "foot", bone, glm::vec3(0.0f, -0.45f, 0.0f));
+        AddBone(skeleton, prefix + "toe", bone, glm::vec3(0.0f, -0.05f, 0.12f));
+    }
+
+    // Parents before children, as RebuildSkeletonOrder sorts them
+    const std::vector<BoneLink>& bones = skeleton.bones;
+    skeleton.evaluationOrder.resize(bones.size());
+    std::iota(skeleton.evaluationOrder.begin(), skeleton.evaluationOrder.end(), 0);
+    std::stable_sort(skeleton.evaluationOrder.begin(), skeleton.evaluationOrder.end(),
+        [&bones](int a, int b) { return bones[a].depth < bones[b].depth; });
+
+    // Inverse bind matrices from the bind pose
+    std::vector<glm::mat4> bind(bones.size());
+    skeleton.offsets.resize(bones.size());
+    for (int index : skeleton.evaluationOrder)
+    {
+        glm::mat4 local = glm::mat4_cast(bones[index].originalRot);
+        local[3] = glm::vec4(bones[index].originalPos, 1.0f);
+        bind[index] = bones[index].parent >= 0 ? bind[bones[index].parent] * local : local;
+        skeleton.offsets[index] = glm::inverse(bind[index]);
+    }
+
+    skeleton.upperBodyMask.assign(bones.size(), 0.0f);
+    for (size_t i = upperBodyStart; i < upperBodyEnd; ++i) skeleton.upperBodyMask[i] = 1.0f;
+
+    return skeleton;
+}
+
+// Per-tick keys for every bone, compressed like the importer does
+static AnimationClip BuildClip(const Skeleton& skeleton, float cycleSeconds, float amplitude, int frames)
+{
+    Animation animation;
+    animation.duration = frames - 1;
+    animation.ticksPerSecond = 30.0;
+
+    for (size_t bone = 0; bone < skeleton.bones.size(); ++bone)
+    {
+        const BoneLink& link = skeleton.bones[bone];
+
+        Channel channel;
+        channel.name = link.boneName;
+
+        const glm::vec3 axis = glm::normalize(glm::vec3(std::sin(bone * 1.3f), 1.0f, std::cos(bone * 0.7f)));
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            const float t = frame / (float)animation.ticksPerSecond;
+            const float angle = amplitude * std::sin(t * 6.2831853f / cycleSeconds + bone * 0.4f);
+
+            glm::vec3 position = link.originalPos;
+            if (bone == 0) position.y += 0.05f * amplitude * std::sin(t * 12.566371f / cycleSeconds);
+
+            channel.positionKeys.push_back(position);
+            channel.rotationKeys.push_back(link.originalRot * glm::angleAxis(angle, axis));
+            channel.scaleKeys.push_back(link.originalScl);
+        }
+
+        animation.channels.push_back(std::move(channel));
+    }
+
+    return AnimationClip::Compress(animation);
+}
+
+static ClipPlayback MakePlayback(const Skeleton& skeleton, const AnimationClip& clip, float position)
+{
+    // What ComponentAnimation::RemapChannels builds
+    ClipPlayback playback;
+    playback.clip = &clip;
+    playback.position = position;
+    for (const BoneLink& link : skeleton.bones) playback.channels.push_back(clip.FindChannel(link.boneName));
+    return playback;
+}
+
+struct Clips
+{
+    AnimationClip idle;
+    AnimationClip walk;
+    AnimationClip run;
+    AnimationClip wave;
+};
+
+// A mix of what a crowd plays: single clips, a walk / run blend space, an upper body layer
+static std::vector<Character> BuildCrowd(const Skeleton& skeleton, const Clips& clips, int count)
+{
+    std::vector<Character> crowd(count);
+
+    for (int i = 0; i < count; ++i)
+    {
+        Character& character = crowd[i];
+        character.lodFrame = (uint32_t)i;
+        character.world[3] = glm::vec4((i % 25) * 2.0f, 0.0f, (i / 25) * 2.0f, 1.0f);
+
+        AnimationMotion motion;
+        motion.phase = (i * 0.137f) - std::floor(i * 0.137f);
+        if (i % 3 == 0)
+        {
+            motion.name = "locomotion";
+            motion.parameter = "speed";
+            motion.clips.push_back(MakePlayback(skeleton, clips.walk, 0.0f));
+            motion.clips.push_back(MakePlayback(skeleton, clips.run, 1.0f));
+            character.parameters["speed"] = (i % 7) / 6.0f;
+        }
+        else
+        {
+            motion.name = i % 3 == 1 ? "walk" : "idle";
+            motion.clips.push_back(MakePlayback(skeleton, i % 3 == 1 ? clips.walk : clips.idle, 0.0f));
+        }
+
+        AnimationLayer base;
+        base.name = "Base";
+        base.motions.push_back(std::move(motion));
+        character.layers.push_back(std::move(base));
+
+        if (i % 5 == 0)
+        {
+            AnimationMotion wave;
+            wave.name = "wave";
+            wave.clips.push_back(MakePlayback(skeleton, clips.wave, 0.0f));
+
+            AnimationLayer upperBody;
+            upperBody.name = "UpperBody";
+            upperBody.boneWeights = skeleton.upperBodyMask;
+            upperBody.motions.push_back(std::move(wave));
+            character.layers.push_back(std::move(upperBody));
+        }
+    }
+
+    return crowd;
+}
+
+// ComponentAnimation::UpdateAsync with the level forced instead of picked by UpdateLod
+static void UpdateCharacter(const Skeleton& skeleton, const AnimationLodPolicy& policy, AnimationLodLevel level, Character& character)
+{
+    character.lodElapsed += FRAME_TIME;
+    int interval = policy.GetInterval(level);
+    if (interval > 1 && ++character.lodFrame % interval != 0) return;
+
+    float dt = character.lodElapsed;
+    character.lodElapsed = 0.0f;
+
+    AnimationGraph::AdvanceLayers(character.layers, character.parameters, dt);
+    character.evaluator.Evaluate(skeleton.bones, skeleton.evaluationOrder, -1, character.layers, policy.GetMaxBoneDepth(level));
+    character.updates++;
+}
+
+// ComponentSkinnedMesh::UpdateSkinningMatrices for a mesh at the character's origin: pose
+// matrices straight from the animation, premultiplied by the bone offsets into the ring
+static bool WritePalette(const Skeleton& skeleton, const Character& character, FrameRingAllocator& ring, std::vector<unsigned char>& storage)
+{
+    const std::vector<glm::mat4>& pose = character.evaluator.GetModelPose();
+    if (pose.size() != skeleton.bones.size()) return false;
+
+    size_t offset = 0;
+    size_t alignment = std::max(STORAGE_ALIGNMENT, sizeof(glm::mat4));
+    if (!ring.Allocate(pose.size() * sizeof(glm::mat4), alignment, offset)) return false;
+    glm::mat4* palette = (glm::mat4*)(storage.data() + offset);
+
+    glm::mat4 meshInverse = glm::inverse(character.world);
+    glm::mat4 poseToMesh, bonePose;
+    MultiplyMatrices(meshInverse, character.world, poseToMesh);
+
+    for (size_t i = 0; i < pose.size(); ++i)
+    {
+        MultiplyMatrices(poseToMesh, pose[i], bonePose);
+        MultiplyMatrices(bonePose, skeleton.offsets[i], palette[i]);
+    }
+    return true;
+}
+
+struct RunResult
+{
+    double animationMs = 0.0;
+    double skinningMs = 0.0;
+    size_t paletteBytes = 0;
+    std::vector<Character> crowd;
+};
+
+static RunResult Run(JobSystem& jobs, const Skeleton& skeleton, const Clips& clips, const AnimationLodPolicy& policy,
+    AnimationLodLevel level, int characters, int frames)
+{
+    RunResult result;
+    result.crowd = BuildCrowd(skeleton, clips, characters);
+    std::vector<Character>& crowd = result.crowd;
+
+    ImmediateFences fences;
+    FrameRingAllocator ring(FRAME_RING_SIZE, FRAME_RING_FRAMES, &fences);
+    std::vector<unsigned char> storage(FRAME_RING_SIZE);
+
+    // Every character starts with a pose, as after its first frame in play mode
+    for (Character& character : crowd) UpdateCharacter(skeleton, policy, AnimationLodLevel::FULL, character);
+
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        HeadlessTest::Timer animationTimer;
+        jobs.ParallelFor((uint32_t)crowd.size(), PARALLEL_GRAIN, [&](uint32_t begin, uint32_t end)
+            {
+                for (uint32_t i = begin; i < end; ++i) UpdateCharacter(skeleton, policy, level, crowd[i]);
+            });
+        result.animationMs += animationTimer.Ms();
+
+        // Culled characters are not drawn, so nothing is skinned for them
+        HeadlessTest::Timer skinningTimer;
+        ring.BeginFrame();
+        if (level != AnimationLodLevel::CULLED)
+        {
+            for (const Character& character : crowd)
+            {
+                CHECK(WritePalette(skeleton, character, ring, storage));
+            }
+        }
+        result.paletteBytes = std::max(result.paletteBytes, ring.GetFrameBytes());
+        ring.EndFrame();
+        result.skinningMs += skinningTimer.Ms();
+    }
+    ring.WaitIdle();
+
+    result.animationMs /= frames;
+    result.skinningMs /= frames;
+    return result;
+}
+
+static double PoseChecksum(const std::vector<Character>& crowd)
+{
+    double sum = 0.0;
+    for (const Character& character : crowd)
+    {
+        for (const glm::mat4& matrix : character.evaluator.GetModelPose())
+        {
+            sum += matrix[3][0] + matrix[3][1] * 3.0 + matrix[3][2] * 7.0 + matrix[0][1];
+        }
+    }
+    return sum;
+}
+
+static bool PosesFinite(const std::vector<Character>& crowd)
+{
+    for (const Character& character : crowd)
+    {
+        for (const glm::mat4& matrix : character.evaluator.GetModelPose())
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                for (int r = 0; r < 4; ++r)
+                {
+                    if (!std::isfinite(matrix[c][r])) return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Bones past the depth limit keep their bind transform, every other animated bone may move
+static bool DeepBonesInBindPose(const Skeleton& skeleton, const std::vector<Character>& crowd, int maxDepth)
+{
+    for (const Character& character : crowd)
+    {
+        const AnimationPose& pose = character.evaluator.GetLocalPose();
+        for (size_t i = 0; i < skeleton.bones.size(); ++i)
+        {
+            const BoneLink& link = skeleton.bones[i];
+            if (link.depth <= maxDepth) continue;
+
+            glm::vec3 position, scale;
+            glm::quat rotation;
+            pose.GetBone(i, position, rotation, scale);
+            if (glm::distance(position, link.originalPos) > 1e-5f) return false;
+            if (std::fabs(std::fabs(glm::dot(rotation, link.originalRot)) - 1.0f) > 1e-5f) return false;
+        }
+    }
+    return true;
+}
+
+static bool AnyDeepBoneMoved(const Skeleton& skeleton, const std::vector<Character>& crowd, int maxDepth)
+{
+    for (const Character& character : crowd)
+    {
+        const AnimationPose& pose = character.evaluator.GetLocalPose();
+        for (size_t i = 0; i < skeleton.bones.size(); ++i)
+        {
+            const BoneLink& link = skeleton.bones[i];
+            if (link.depth <= maxDepth) continue;
+
+            glm::vec3 position, scale;
+            glm::quat rotation;
+            pose.GetBone(i, position, rotation, scale);
+            if (std::fabs(std::fabs(glm::dot(rotation, link.originalRot)) - 1.0f) > 1e-4f) return true;
+        }
+    }
+    return false;
+}
+
+static const char* LevelName(AnimationLodLevel level)
+{
+    switch (level)
+    {
+    case AnimationLodLevel::FULL:       return "full";
+    case AnimationLodLevel::REDUCED:    return "reduced";
+    case AnimationLodLevel::LOW:        return "low";
+    case AnimationLodLevel::CULLED:     return "culled";
+    }
+    return "?";
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = HeadlessTest::IsQuick(argc, argv);
+    const int characters = quick ? 50 : 500;
+    const int frames = quick ? 16 : 120;
+
+    Skeleton skeleton = BuildSkeleton();
+    Clips clips;
+    clips.idle = BuildClip(skeleton, 3.0f, 0.05f, 90);
+    clips.walk = BuildClip(skeleton, 1.0f, 0.5f, 30);
+    clips.run = BuildClip(skeleton, 0.6f, 0.8f, 18);
+    clips.wave = BuildClip(skeleton, 1.5f, 0.9f, 45);
+
+    AnimationLodPolicy policy;
+    const AnimationLodLevel levels[] = { AnimationLodLevel::FULL, AnimationLodLevel::REDUCED, AnimationLodLevel::LOW, AnimationLodLevel::CULLED };
+
+    int maxDepth = 0;
+    for (const BoneLink& link : skeleton.bones) maxDepth = std::max(maxDepth, link.depth);
+
+    printf("%d characters x %zu bones (depth %d), %d frames, hardware threads: %u\n",
+        characters, skeleton.bones.size(), maxDepth, frames, std::thread::hardware_concurrency());
+    printf("LOD intervals: reduced %d, low %d, culled %d; low / culled max bone depth %d\n",
+        policy.reducedInterval, policy.lowInterval, policy.culledInterval, policy.lowMaxBoneDepth);
+    printf("%8s %8s %12s %12s %12s %10s\n", "level", "threads", "anim ms", "skin ms", "total ms", "palette KB");
+
+    std::vector<unsigned int> threadCounts = { 1, 2, 4, 8 };
+    if (quick) threadCounts = { 1, 2 };
+
+    JobSystem jobs;
+    std::vector<float> fullPhases;
+
+    for (AnimationLodLevel level : levels)
+    {
+        double referenceChecksum = 0.0;
+
+        for (size_t t = 0; t < threadCounts.size(); ++t)
+        {
+            jobs.SetWorkerCount(threadCounts[t] - 1);
+
+            RunResult result = Run(jobs, skeleton, clips, policy, level, characters, frames);
+            printf("%8s %8u %12.3f %12.3f %12.3f %10.1f\n", LevelName(level), threadCounts[t],
+                result.animationMs, result.skinningMs, result.animationMs + result.skinningMs, result.paletteBytes / 1024.0);
+
+            CHECK(PosesFinite(result.crowd));
+
+            double checksum = PoseChecksum(result.crowd);
+            if (t == 0) referenceChecksum = checksum;
+            CHECK(checksum == referenceChecksum);
+
+            if (t != 0) continue;
+
+            // Skipped frames: one update per interval (plus the initial one), staggered by lodFrame
+            int interval = policy.GetInterval(level);
+            for (size_t i = 0; i < result.crowd.size(); ++i)
+            {
+                int expected = 1;
+                for (int frame = 1; frame <= frames; ++frame)
+                {
+                    if (interval == 1 || (i + frame) % interval == 0) ++expected;
+                }
+                CHECK(result.crowd[i].updates == expected);
+            }
+
+            // Motions still advance by the whole time: a character that just updated is where
+            // it would be at full rate
+            if (level == AnimationLodLevel::FULL)
+            {
+                for (const Character& character : result.crowd) fullPhases.push_back(character.layers[0].motions[0].phase);
+            }
+            else
+            {
+                for (size_t i = 0; i < result.crowd.size(); ++i)
+                {
+                    const Character& character = result.crowd[i];
+                    if (character.lodElapsed > 0.0f) continue;
+
+                    float difference = std::fabs(character.layers[0].motions[0].phase - fullPhases[i]);
+                    CHECK(std::min(difference, 1.0f - difference) < 1e-3f);
+                }
+            }
+
+            const int depthLimit = policy.GetMaxBoneDepth(level);
+            if (depthLimit < maxDepth)
+            {
+                CHECK(DeepBonesInBindPose(skeleton, result.crowd, depthLimit));
+            }
+            else
+            {
+                CHECK(AnyDeepBoneMoved(skeleton, result.crowd, policy.lowMaxBoneDepth));
+            }
+
+            CHECK((result.paletteBytes == 0) == (level == AnimationLodLevel::CULLED));
+        }
+    }
+
+    jobs.SetWorkerCount(0);
+    return HeadlessTest::Finish("AnimationBenchmark");
+}
@@ -0,0 +1,142 @@
+// Compression report for AnimationClip: per clip, the size of the raw per-tick keys against
+// the compressed clip, how many keys survive key reduction, and the largest position /
+// rotation / scale error when sampling the clip at every source key. The clips are generated
+// to cover what imports produce: constant poses, smooth motion, wide root motion and noisy
+// capture data. Checks that every error stays within the compression settings and that the
+// clip reads back from its Library bytes.
+
+#include "HeadlessTest.h"
+#include "AnimationClip.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+
+static const int BONES = 60;
+
+enum class Motion
+{
+    STATIC,         // bind pose held, every track constant
+    IDLE,           // slow breathing on a few bones
+    WALK,           // every bone swinging, root moving forward
+    ROOT_MOTION,    // long run, root covers hundreds of units
+    SCALE_PULSE,    // squash and stretch
+    MOCAP           // walk with per-frame capture noise
+};
+
+static Animation MakeClip(Motion motion, int frames)
+{
+    Animation animation;
+    animation.duration = frames - 1;
+    animation.ticksPerSecond = 30.0;
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+
+    for (int bone = 0; bone < BONES; ++bone)
+    {
+        Channel channel;
+        channel.name = "bone" + std::to_string(bone);
+
+        const glm::vec3 bindPosition = bone == 0 ? glm::vec3(0.0f, 90.0f, 0.0f) : glm::vec3(0.0f, 10.0f + bone * 0.5f, 0.0f);
+        const glm::vec3 axis = glm::normalize(glm::vec3(std::sin(bone * 1.7f), 0.6f, std::cos(bone * 0.9f)));
+        const float phase = bone * 0.37f;
+
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            const float t = frame / (float)animation.ticksPerSecond;
+
+            glm::vec3 position = bindPosition;
+            float angle = 0.0f;
+            glm::vec3 scale(1.0f);
+
+            switch (motion)
+            {
+            case Motion::STATIC:
+                break;
+            case Motion::IDLE:
+                if (bone < 8) angle = 0.05f * std::sin(t * 1.5f + phase);
+                break;
+            case Motion::WALK:
+            case Motion::MOCAP:
+                angle = 0.6f * std::sin(t * 6.0f + phase);
+                if (bone == 0) position += glm::vec3(0.0f, 2.0f * std::sin(t * 12.0f), t * 140.0f);
+                break;
+            case Motion::ROOT_MOTION:
+                angle = 0.4f * std::sin(t * 8.0f + phase);
+                if (bone == 0) position += glm::vec3(std::sin(t * 0.5f) * 300.0f, 0.0f, t * 600.0f);
+                break;
+            case Motion::SCALE_PULSE:
+                angle = 0.2f * std::sin(t * 3.0f + phase);
+                scale = glm::vec3(1.0f + 0.3f * std::sin(t * 4.0f + phase), 1.0f - 0.15f * std::sin(t * 4.0f + phase), 1.0f);
+                break;
+            }
+
+            if (motion == Motion::MOCAP)
+            {
+                angle += 0.004f * noise(rng);
+                position += glm::vec3(noise(rng), noise(rng), noise(rng)) * 0.003f;
+            }
+
+            channel.positionKeys.push_back(position);
+            channel.rotationKeys.push_back(glm::angleAxis(angle, axis));
+            channel.scaleKeys.push_back(scale);
+        }
+
+        animation.channels.push_back(std::move(channel));
+    }
+
+    return animation;
+}
+
+static void ReportClip(const char* name, const Animation& animation, const AnimationClip::Settings& settings)
+{
+    AnimationClip clip = AnimationClip::Compress(animation, settings);
+
+    // What the Library file holds and ResourceAnimation loads
+    std::vector<unsigned char> data;
+    clip.Write(data);
+    AnimationClip loaded;
+    CHECK(loaded.Read(data.data(), data.size()));
+
+    AnimationClip::Report report = AnimationClip::Measure(animation, loaded);
+
+    printf("%-12s %8.1f %8.1f %6.1fx %7u %7u %6.1fx %10.5f %10.5f %10.6f %7.1f %7.1f\n", name,
+        report.rawBytes / 1024.0, report.compressedBytes / 1024.0,
+        (double)report.rawBytes / std::max<size_t>(report.compressedBytes, 1),
+        report.rawKeys, report.keptKeys,
+        (double)report.rawKeys / std::max<uint32_t>(report.keptKeys, 1),
+        report.maxPositionError, report.maxRotationError, report.maxScaleError,
+        report.rawSampleNs, report.compressedSampleNs);
+
+    CHECK(report.channels == animation.channels.size());
+    CHECK(report.keptKeys <= report.rawKeys);
+    CHECK(report.compressedBytes < report.rawBytes);
+
+    // Small slack for the float math of sampling and measuring
+    CHECK(report.maxPositionError <= settings.positionError * 1.01f);
+    CHECK(report.maxRotationError <= settings.rotationError * 1.01f);
+    CHECK(report.maxScaleError <= settings.scaleError * 1.01f);
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = HeadlessTest::IsQuick(argc, argv);
+    const int frames = quick ? 60 : 300;
+
+    AnimationClip::Settings settings;
+    printf("%d bones, %d frames, error bounds: position %g, rotation %g rad, scale %g\n",
+        BONES, frames, settings.positionError, settings.rotationError, settings.scaleError);
+    printf("%-12s %8s %8s %7s %7s %7s %7s %10s %10s %10s %7s %7s\n", "clip",
+        "raw KB", "clip KB", "size", "keys", "kept", "keys", "pos err", "rot err", "scale err", "raw ns", "clip ns");
+
+    ReportClip("static", MakeClip(Motion::STATIC, frames), settings);
+    ReportClip("idle", MakeClip(Motion::IDLE, frames), settings);
+    ReportClip("walk", MakeClip(Motion::WALK, frames), settings);
+    ReportClip("root motion", MakeClip(Motion::ROOT_MOTION, frames), settings);
+    ReportClip("scale pulse", MakeClip(Motion::SCALE_PULSE, frames), settings);
+    ReportClip("mocap", MakeClip(Motion::MOCAP, frames), settings);
+
+    return HeadlessTest::Finish("AnimationClipReport");
+}
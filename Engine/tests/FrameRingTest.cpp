@@ -0,0 +1,221 @@
+// FrameRingAllocator driven across frames with a fake fence backend. The fake GPU
+// only lets go of a frame once its fence has been waited on, so any range handed
+// out while an older, unwaited frame still owns those bytes is a bug.
+
+#include "HeadlessTest.h"
+#include "FrameRingBuffer.h"
+
+#include <cstdint>
+#include <vector>
+
+class FakeFences : public FenceBackend
+{
+public:
+    FenceHandle Insert() override
+    {
+        signalled.push_back(false);
+        live++;
+        inserted++;
+        return (FenceHandle)(uintptr_t)signalled.size();
+    }
+
+    void Wait(FenceHandle fence) override
+    {
+        signalled[Index(fence)] = true;
+        waits++;
+    }
+
+    void Release(FenceHandle) override
+    {
+        live--;
+    }
+
+    bool IsSignalled(size_t fenceIndex) const { return signalled[fenceIndex]; }
+    size_t Count() const { return signalled.size(); }
+
+    int live = 0;
+    int inserted = 0;
+    int waits = 0;
+
+private:
+    static size_t Index(FenceHandle fence) { return (size_t)(uintptr_t)fence - 1; }
+
+    std::vector<bool> signalled;
+};
+
+// A range written by a frame, readable by the GPU until that frame's fence signals
+struct LiveRange
+{
+    size_t offset;
+    size_t size;
+    size_t fence;   // index of the frame's fence, the open frame uses FakeFences::Count()
+};
+
+static bool Overlaps(size_t aOffset, size_t aSize, size_t bOffset, size_t bSize)
+{
+    return aOffset < bOffset + bSize && bOffset < aOffset + aSize;
+}
+
+static void TestAlignmentAndWrap()
+{
+    FakeFences fences;
+    {
+        FrameRingAllocator ring(1024, 2, &fences);
+        size_t offset = 0;
+
+        ring.BeginFrame();
+        CHECK(ring.Allocate(100, 16, offset) && offset == 0);
+        CHECK(ring.Allocate(10, 16, offset) && offset == 112);
+        ring.EndFrame();
+
+        ring.BeginFrame();
+        CHECK(ring.Allocate(500, 16, offset) && offset == 128);
+        ring.EndFrame();
+
+        // Two frames in flight already: opening a third waits for the first
+        ring.BeginFrame();
+        CHECK(fences.waits == 1);
+
+        // Does not fit before the end, so it starts over at 0 instead of straddling it
+        CHECK(ring.Allocate(400, 16, offset) && offset == 0);
+        ring.EndFrame();
+
+        // Larger than the whole ring: refused without waiting
+        ring.BeginFrame();
+        int waitsBefore = fences.waits;
+        CHECK(!ring.Allocate(2000, 16, offset));
+        CHECK(fences.waits == waitsBefore);
+
+        // The whole ring for one frame waits for every other frame first
+        CHECK(ring.Allocate(1024, 16, offset) && offset == 0);
+        CHECK(ring.GetFramesInFlight() == 0);
+        // The frame alone fills the ring, nothing else fits
+        CHECK(!ring.Allocate(1, 1, offset));
+        ring.EndFrame();
+
+        ring.WaitIdle();
+        CHECK(ring.GetFramesInFlight() == 0);
+    }
+    CHECK(fences.live == 0);
+}
+
+static void TestEmptyFramesAreNotFenced()
+{
+    FakeFences fences;
+    FrameRingAllocator ring(256, 3, &fences);
+    for (int frame = 0; frame < 10; ++frame)
+    {
+        ring.BeginFrame();
+        ring.EndFrame();
+    }
+    CHECK(fences.inserted == 0);
+    CHECK(fences.waits == 0);
+}
+
+static void TestFramesInFlightLimit()
+{
+    FakeFences fences;
+    FrameRingAllocator ring(1 << 20, 3, &fences);
+    size_t offset = 0;
+
+    for (int frame = 0; frame < 20; ++frame)
+    {
+        ring.BeginFrame();
+        // Never more than framesInFlight frames queued once a new one opens
+        CHECK(ring.GetFramesInFlight() < 3);
+        CHECK(ring.Allocate(64, 16, offset));
+        ring.EndFrame();
+        CHECK(ring.GetFramesInFlight() <= 3);
+    }
+
+    // Small frames never force a wait earlier than the frame limit does
+    CHECK(fences.waits == 20 - 3);
+}
+
+static void TestLiveRangesAreNeverReused()
+{
+    const size_t capacity = 64 * 1024;
+    const unsigned int framesInFlight = 3;
+    const size_t alignments[] = { 4, 16, 64, 256 };
+
+    FakeFences fences;
+    {
+        FrameRingAllocator ring(capacity, framesInFlight, &fences);
+        std::vector<LiveRange> live;
+
+        uint32_t seed = 99;
+        auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+
+        int allocations = 0;
+        int refused = 0;
+        for (int frame = 0; frame < 2000; ++frame)
+        {
+            ring.BeginFrame();
+            size_t openFence = fences.Count();
+
+            // Every few frames a heavy one, so the ring keeps wrapping under pressure.
+            // A frame never needs more than the whole ring, so nothing may be refused.
+            int count = (frame % 7 == 0) ? 12 : 1 + next() % 8;
+            for (int i = 0; i < count; ++i)
+            {
+                size_t size = 1 + next() % 4096;
+                size_t alignment = alignments[next() % 4];
+
+                size_t offset = 0;
+                if (!ring.Allocate(size, alignment, offset))
+                {
+                    refused++;
+                    continue;
+                }
+                allocations++;
+
+                CHECK(offset % alignment == 0);
+                CHECK(offset + size <= capacity);
+
+                // Forget ranges whose frame the GPU has finished with
+                for (size_t r = 0; r < live.size(); )
+                {
+                    if (live[r].fence != openFence && fences.IsSignalled(live[r].fence))
+                    {
+                        live[r] = live.back();
+                        live.pop_back();
+                    }
+                    else
+                    {
+                        ++r;
+                    }
+                }
+
+                for (const LiveRange& range : live)
+                {
+                    if (Overlaps(offset, size, range.offset, range.size))
+                    {
+                        HeadlessTest::Fail(__FILE__, __LINE__, "range handed out while still in use");
+                        break;
+                    }
+                }
+
+                live.push_back({ offset, size, openFence });
+            }
+            ring.EndFrame();
+        }
+
+        CHECK(refused == 0);
+        CHECK(allocations > 5000);
+        // Far more bytes went through the ring than it holds, so it wrapped and reclaimed
+        CHECK(fences.waits > 0);
+
+        ring.WaitIdle();
+    }
+    CHECK(fences.live == 0);
+}
+
+int main()
+{
+    TestAlignmentAndWrap();
+    TestEmptyFramesAreNotFenced();
+    TestFramesInFlightLimit();
+    TestLiveRangesAreNeverReused();
+
+    return HeadlessTest::Finish("FrameRingTest");
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+// Minimal helpers shared by the headless tests and benchmarks.
+// Each target is a plain executable: it prints its results and returns non-zero on failure.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace HeadlessTest
+{
+    inline int& Failures()
+    {
+        static int failures = 0;
+        return failures;
+    }
+
+    inline void Fail(const char* file, int line, const char* expression)
+    {
+        printf("FAILED %s(%d): %s\n", file, line, expression);
+        Failures()++;
+    }
+
+    inline int Finish(const char* name)
+    {
+        if (Failures() == 0)
+            printf("%s: all checks passed\n", name);
+        else
+            printf("%s: %d check(s) failed\n", name, Failures());
+        return Failures() == 0 ? 0 : 1;
+    }
+
+    // ctest runs benchmarks with --quick: smallest sizes only, still checking the results
+    inline bool IsQuick(int argc, char** argv)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            if (strcmp(argv[i], "--quick") == 0) return true;
+        }
+        return false;
+    }
+
+    class Timer
+    {
+    public:
+        Timer() : start(std::chrono::steady_clock::now()) {}
+
+        double Ms() const
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+    private:
+        std::chrono::steady_clock::time_point start;
+    };
+}
+
+#define CHECK(expression) do { if (!(expression)) HeadlessTest::Fail(__FILE__, __LINE__, #expression); } while (0)
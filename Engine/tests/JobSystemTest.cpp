@@ -0,0 +1,166 @@
+// JobSystem correctness (ParallelFor coverage, counters, nested jobs, waiting from
+// workers, no workers at all) at several worker counts, then ParallelFor scaling
+// on a compute-bound loop from 1 to 16 threads.
+
+#include "HeadlessTest.h"
+#include "JobSystem.h"
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+static void TestParallelForCoversEveryIndexOnce(JobSystem& jobs)
+{
+    const uint32_t counts[] = { 0, 1, 7, 64, 1000, 4099 };
+    const uint32_t grains[] = { 0, 1, 3, 64, 5000 };
+
+    for (uint32_t count : counts)
+    {
+        for (uint32_t grain : grains)
+        {
+            std::vector<std::atomic<int>> hits(count);
+            for (auto& hit : hits) hit = 0;
+
+            std::atomic<uint32_t> ranges{ 0 };
+            bool rangesValid = true;
+            jobs.ParallelFor(count, grain, [&](uint32_t begin, uint32_t end)
+                {
+                    if (begin >= end || end > count) rangesValid = false;
+                    for (uint32_t i = begin; i < end; ++i) hits[i]++;
+                    ranges++;
+                });
+
+            CHECK(rangesValid);
+            bool once = true;
+            for (auto& hit : hits) once = once && hit == 1;
+            CHECK(once);
+        }
+    }
+}
+
+static void TestCounterWaitsForEveryJob(JobSystem& jobs)
+{
+    JobCounter counter;
+    std::atomic<int> done{ 0 };
+    for (int i = 0; i < 1000; ++i)
+    {
+        jobs.Run([&done]() { done++; }, &counter);
+    }
+    jobs.Wait(counter);
+
+    CHECK(counter.IsDone());
+    CHECK(done == 1000);
+}
+
+static void TestChildrenOnTheSameCounter(JobSystem& jobs)
+{
+    // A job keeps its counter pending while it runs, so children it starts on the
+    // same counter are covered by the same Wait
+    JobCounter counter;
+    std::atomic<int> leaves{ 0 };
+    for (int i = 0; i < 16; ++i)
+    {
+        jobs.Run([&jobs, &counter, &leaves]()
+            {
+                for (int j = 0; j < 16; ++j)
+                {
+                    jobs.Run([&jobs, &counter, &leaves]()
+                        {
+                            for (int k = 0; k < 4; ++k)
+                                jobs.Run([&leaves]() { leaves++; }, &counter);
+                        }, &counter);
+                }
+            }, &counter);
+    }
+    jobs.Wait(counter);
+
+    CHECK(counter.IsDone());
+    CHECK(leaves == 16 * 16 * 4);
+}
+
+static void TestNestedParallelFor(JobSystem& jobs)
+{
+    // Waiting inside a job must run other jobs instead of blocking the worker
+    std::atomic<int64_t> sum{ 0 };
+    jobs.ParallelFor(32, 1, [&jobs, &sum](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                jobs.ParallelFor(100, 10, [&sum](uint32_t innerBegin, uint32_t innerEnd)
+                    {
+                        int64_t local = 0;
+                        for (uint32_t j = innerBegin; j < innerEnd; ++j) local += j;
+                        sum += local;
+                    });
+            }
+        });
+
+    CHECK(sum == 32 * (99 * 100 / 2));
+}
+
+static void RunCorrectness(JobSystem& jobs)
+{
+    TestParallelForCoversEveryIndexOnce(jobs);
+    TestCounterWaitsForEveryJob(jobs);
+    TestChildrenOnTheSameCounter(jobs);
+    TestNestedParallelFor(jobs);
+}
+
+// Independent per-item work, roughly what an emitter or skeleton update costs
+static double RunScaling(JobSystem& jobs, std::vector<float>& values, int frames)
+{
+    HeadlessTest::Timer timer;
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        jobs.ParallelFor((uint32_t)values.size(), 256, [&values](uint32_t begin, uint32_t end)
+            {
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    float v = values[i];
+                    for (int k = 0; k < 64; ++k) v = std::sin(v) * 0.5f + std::cos(v * 1.3f) * 0.5f;
+                    values[i] = v;
+                }
+            });
+    }
+    return timer.Ms() / frames;
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = HeadlessTest::IsQuick(argc, argv);
+
+    JobSystem jobs;
+
+    // Before the pool starts every call runs inline
+    RunCorrectness(jobs);
+
+    const unsigned int workerCounts[] = { 0, 1, 3, 7, 15 };
+    for (unsigned int workers : workerCounts)
+    {
+        jobs.SetWorkerCount(workers);
+        CHECK(jobs.GetWorkerCount() == workers);
+        RunCorrectness(jobs);
+    }
+
+    // Scaling: "threads" counts the calling thread, which runs jobs while it waits
+    printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+    printf("%8s %12s %9s\n", "threads", "ms", "speedup");
+
+    std::vector<float> values(quick ? 4096 : 65536);
+    const int frames = quick ? 3 : 20;
+    const unsigned int threadCounts[] = { 1, 2, 4, 8, 16 };
+    double baseMs = 0.0;
+    for (unsigned int threads : threadCounts)
+    {
+        jobs.SetWorkerCount(threads - 1);
+        for (size_t i = 0; i < values.size(); ++i) values[i] = (float)i * 0.001f;
+
+        double ms = RunScaling(jobs, values, frames);
+        if (threads == 1) baseMs = ms;
+        printf("%8u %12.3f %8.2fx\n", threads, ms, baseMs / ms);
+    }
+
+    jobs.SetWorkerCount(0);
+    return HeadlessTest::Finish("JobSystemTest");
+}
@@ -0,0 +1,415 @@
+// Prefab spawn benchmark: what one Prefab::Instantiate reads before it builds anything.
+// The JSON path walks the prefab tree the way GameObject::Deserialize does, looking every
+// key up and parsing the Transform arrays on each spawn. The compiled path walks the
+// PrefabHierarchy decoded once at load. Both fill the same spawn records, which are checked
+// to match, so the template hands the GameObjects exactly what Deserialize would.
+// Building the GameObjects and running each component's Deserialize is the same on both
+// paths and needs the engine's modules, so it is not part of the numbers.
+
+#include "HeadlessTest.h"
+#include "PrefabHierarchy.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+struct SpawnedObject
+{
+    int parent;
+    std::string name;
+    std::string tag;
+    UID uid;            // 0 keeps the generated one
+    bool active;
+    glm::vec3 position;
+    glm::vec3 rotation;
+    glm::vec3 scale;
+    uint32_t firstComponent;
+    uint32_t componentCount;
+};
+
+struct SpawnedComponent
+{
+    ComponentType type;
+    bool active;
+    const nlohmann::json* data;     // what the component's Deserialize gets
+};
+
+// Reused between spawns, like the engine reuses its pools
+struct Spawn
+{
+    std::vector<SpawnedObject> objects;
+    std::vector<SpawnedComponent> components;
+
+    void Clear()
+    {
+        objects.clear();
+        components.clear();
+    }
+};
+
+// ---------------------------------------------------------------------------------------
+// Prefabs, in the format Prefab::SaveFromGameObject writes
+
+static UID nextUID = 1000;
+
+static nlohmann::json MakeComponent(ComponentType type)
+{
+    nlohmann::json component;
+    component["type"] = (int)type;
+    component["active"] = true;
+    return component;
+}
+
+static nlohmann::json MakeTransform(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale)
+{
+    nlohmann::json transform = MakeComponent(ComponentType::TRANSFORM);
+    transform["position"] = { position.x, position.y, position.z };
+    transform["rotation"] = { rotation.x, rotation.y, rotation.z };
+    transform["scale"] = { scale.x, scale.y, scale.z };
+    return transform;
+}
+
+static nlohmann::json MakeObject(const std::string& name, const glm::vec3& position)
+{
+    nlohmann::json obj;
+    obj["name"] = name;
+    obj["uid"] = nextUID++;
+    obj["active"] = true;
+    obj["components"] = nlohmann::json::array();
+    obj["components"].push_back(MakeTransform(position, glm::vec3(0.0f, 15.0f, 0.0f), glm::vec3(1.0f)));
+    obj["children"] = nlohmann::json::array();
+    return obj;
+}
+
+static nlohmann::json MakeMeshObject(const std::string& name, const glm::vec3& position, UID mesh, UID material)
+{
+    nlohmann::json obj = MakeObject(name, position);
+
+    nlohmann::json meshComponent = MakeComponent(ComponentType::MESH);
+    meshComponent["meshUID"] = mesh;
+    meshComponent["drawNormals"] = false;
+    obj["components"].push_back(meshComponent);
+
+    nlohmann::json materialComponent = MakeComponent(ComponentType::MATERIAL);
+    materialComponent["materialUID"] = material;
+    materialComponent["color"] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    obj["components"].push_back(materialComponent);
+    return obj;
+}
+
+// Crate with a lid and a handle
+static nlohmann::json MakeProp()
+{
+    nlohmann::json root = MakeMeshObject("Crate", glm::vec3(0.0f), 1, 2);
+    root["tag"] = "Pickup";
+    root["components"].push_back(MakeComponent(ComponentType::BOX_COLLIDER));
+
+    root["children"].push_back(MakeMeshObject("Lid", glm::vec3(0.0f, 1.0f, 0.0f), 3, 2));
+    root["children"].push_back(MakeMeshObject("Handle", glm::vec3(0.5f, 0.5f, 0.0f), 4, 2));
+    return nlohmann::json::array({ root });
+}
+
+static void AddBoneChain(nlohmann::json& parent, const std::string& prefix, int length)
+{
+    nlohmann::json* current = &parent;
+    for (int i = 0; i < length; ++i)
+    {
+        current->at("children").push_back(MakeObject(prefix + std::to_string(i), glm::vec3(0.0f, 0.2f, 0.0f)));
+        current = &current->at("children").back();
+    }
+}
+
+// Rigged character: script, physics, animation, a 40 bone skeleton and two skinned meshes
+static nlohmann::json MakeCharacter()
+{
+    nlohmann::json root = MakeObject("Enemy", glm::vec3(0.0f));
+    root["tag"] = "Enemy";
+
+    nlohmann::json script = MakeComponent(ComponentType::SCRIPT);
+    script["scriptUID"] = (UID)10;
+    script["scriptPath"] = "Assets/Scripts/Enemy.lua";
+    root["components"].push_back(script);
+    root["components"].push_back(MakeComponent(ComponentType::RIGIDBODY));
+    root["components"].push_back(MakeComponent(ComponentType::CAPSULE_COLLIDER));
+
+    nlohmann::json animation = MakeComponent(ComponentType::ANIMATION);
+    animation["Animations"] = nlohmann::json::array();
+    for (UID uid : { 20, 21, 22, 21 })
+    {
+        animation["Animations"].push_back({ { "Name", "clip" + std::to_string(uid) }, { "UID", uid } });
+    }
+    root["components"].push_back(animation);
+
+    nlohmann::json hips = MakeObject("Hips", glm::vec3(0.0f, 1.0f, 0.0f));
+    AddBoneChain(hips, "Spine", 6);
+    AddBoneChain(hips, "LeftLeg", 5);
+    AddBoneChain(hips, "RightLeg", 5);
+    for (int arm = 0; arm < 2; ++arm)
+    {
+        nlohmann::json shoulder = MakeObject(arm == 0 ? "LeftShoulder" : "RightShoulder", glm::vec3(0.2f, 1.4f, 0.0f));
+        for (int finger = 0; finger < 4; ++finger)
+        {
+            AddBoneChain(shoulder, "Finger" + std::to_string(finger) + "_", 2);
+        }
+        AddBoneChain(shoulder, "Arm", 3);
+        hips["children"].push_back(shoulder);
+    }
+    root["children"].push_back(hips);
+
+    nlohmann::json body = MakeMeshObject("Body", glm::vec3(0.0f), 30, 31);
+    body["components"][1]["type"] = (int)ComponentType::SKINNED_MESH;
+    root["children"].push_back(body);
+    root["children"].push_back(MakeMeshObject("Weapon", glm::vec3(0.3f, 1.2f, 0.1f), 32, 31));
+
+    return nlohmann::json::array({ root });
+}
+
+// Level chunk: 120 static pieces in rows, each with its collider
+static nlohmann::json MakeChunk()
+{
+    nlohmann::json root = MakeObject("Chunk", glm::vec3(0.0f));
+    for (int row = 0; row < 12; ++row)
+    {
+        nlohmann::json rowObj = MakeObject("Row" + std::to_string(row), glm::vec3(0.0f, 0.0f, row * 4.0f));
+        for (int i = 0; i < 9; ++i)
+        {
+            nlohmann::json piece = MakeMeshObject("Piece" + std::to_string(i), glm::vec3(i * 4.0f, 0.0f, 0.0f), 40 + i % 5, 50 + i % 3);
+            piece["components"].push_back(MakeComponent(ComponentType::MESH_COLLIDER));
+            rowObj["children"].push_back(piece);
+        }
+        root["children"].push_back(rowObj);
+    }
+    return nlohmann::json::array({ root });
+}
+
+// ---------------------------------------------------------------------------------------
+// The two spawn paths
+
+static bool ReadVec3(const nlohmann::json& obj, const char* key, glm::vec3& out)
+{
+    if (!obj.contains(key) || !obj[key].is_array() || obj[key].size() < 3) return false;
+
+    const nlohmann::json& values = obj[key];
+    out = glm::vec3(values[0].get<float>(), values[1].get<float>(), values[2].get<float>());
+    return true;
+}
+
+// Same lookups, in the same order, as GameObject::Deserialize and Transform::Deserialize
+static void DeserializeObject(const nlohmann::json& gameObjectObj, int parent, Spawn& out)
+{
+    if (!gameObjectObj.is_object()) return;
+
+    int index = (int)out.objects.size();
+    out.objects.emplace_back();
+    SpawnedObject& obj = out.objects.back();
+
+    obj.parent = parent;
+    obj.name = gameObjectObj.contains("name") ? gameObjectObj["name"].get<std::string>() : "GameObject";
+    obj.uid = gameObjectObj.contains("uid") ? gameObjectObj["uid"].get<UID>() : 0;
+    obj.active = gameObjectObj.contains("active") ? gameObjectObj["active"].get<bool>() : true;
+    obj.tag = gameObjectObj.contains("tag") ? gameObjectObj["tag"].get<std::string>() : "";
+    obj.position = glm::vec3(0.0f);
+    obj.rotation = glm::vec3(0.0f);
+    obj.scale = glm::vec3(1.0f);
+    obj.firstComponent = (uint32_t)out.components.size();
+    obj.componentCount = 0;
+
+    if (gameObjectObj.contains("components") && gameObjectObj["components"].is_array())
+    {
+        for (const auto& componentObj : gameObjectObj["components"])
+        {
+            if (!componentObj.contains("type")) continue;
+
+            ComponentType type = static_cast<ComponentType>(componentObj["type"].get<int>());
+            if (type == ComponentType::TRANSFORM)
+            {
+                ReadVec3(componentObj, "position", out.objects[index].position);
+                ReadVec3(componentObj, "rotation", out.objects[index].rotation);
+                ReadVec3(componentObj, "scale", out.objects[index].scale);
+                continue;
+            }
+
+            bool active = componentObj.contains("active") ? componentObj["active"].get<bool>() : true;
+            out.components.push_back({ type, active, &componentObj });
+            ++out.objects[index].componentCount;
+        }
+    }
+
+    if (gameObjectObj.contains("children") && gameObjectObj["children"].is_array())
+    {
+        for (const auto& childObj : gameObjectObj["children"])
+        {
+            DeserializeObject(childObj, index, out);
+        }
+    }
+}
+
+static void SpawnFromJson(const nlohmann::json& prefab, Spawn& out)
+{
+    out.Clear();
+    DeserializeObject(prefab.is_array() ? prefab[0] : prefab, -1, out);
+}
+
+// What PrefabTemplate::Instantiate hands each GameObject
+static void SpawnFromHierarchy(const PrefabHierarchy& hierarchy, Spawn& out)
+{
+    out.Clear();
+
+    const std::vector<PrefabHierarchy::ComponentRecord>& records = hierarchy.GetComponents();
+    for (const PrefabHierarchy::Node& node : hierarchy.GetNodes())
+    {
+        out.objects.push_back({ node.parent, node.name, node.tag, node.uid, node.active,
+            node.position, node.rotation, node.scale, (uint32_t)out.components.size(), node.componentCount });
+
+        for (uint32_t c = 0; c < node.componentCount; ++c)
+        {
+            const PrefabHierarchy::ComponentRecord& record = records[node.firstComponent + c];
+            out.components.push_back({ record.type, record.active, &record.data });
+        }
+    }
+}
+
+static bool SameSpawn(const Spawn& a, const Spawn& b)
+{
+    if (a.objects.size() != b.objects.size() || a.components.size() != b.components.size()) return false;
+
+    for (size_t i = 0; i < a.objects.size(); ++i)
+    {
+        const SpawnedObject& x = a.objects[i];
+        const SpawnedObject& y = b.objects[i];
+        if (x.parent != y.parent || x.name != y.name || x.tag != y.tag || x.uid != y.uid || x.active != y.active) return false;
+        if (x.position != y.position || x.rotation != y.rotation || x.scale != y.scale) return false;
+        if (x.firstComponent != y.firstComponent || x.componentCount != y.componentCount) return false;
+    }
+
+    for (size_t i = 0; i < a.components.size(); ++i)
+    {
+        const SpawnedComponent& x = a.components[i];
+        const SpawnedComponent& y = b.components[i];
+        if (x.type != y.type || x.active != y.active || *x.data != *y.data) return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------
+
+static void TestHierarchy()
+{
+    nlohmann::json character = MakeCharacter();
+
+    PrefabHierarchy hierarchy;
+    CHECK(hierarchy.Compile(character));
+
+    Spawn fromJson, fromHierarchy;
+    SpawnFromJson(character, fromJson);
+    SpawnFromHierarchy(hierarchy, fromHierarchy);
+    CHECK(SameSpawn(fromJson, fromHierarchy));
+
+    // Pre-order: every parent comes before its children
+    const std::vector<PrefabHierarchy::Node>& nodes = hierarchy.GetNodes();
+    CHECK(nodes[0].parent == -1);
+    for (size_t i = 1; i < nodes.size(); ++i)
+    {
+        CHECK(nodes[i].parent >= 0 && nodes[i].parent < (int)i);
+    }
+    CHECK(hierarchy.GetInstanceNodeCount() == nodes.size());
+
+    // The Transform never becomes a record, its values are in the node
+    for (const PrefabHierarchy::ComponentRecord& record : hierarchy.GetComponents())
+    {
+        CHECK(record.type != ComponentType::TRANSFORM);
+    }
+    CHECK(nodes[1].position == glm::vec3(0.0f, 1.0f, 0.0f));
+    CHECK(nodes[1].rotation == glm::vec3(0.0f, 15.0f, 0.0f));
+
+    // Script, clips (one repeated), meshes and material, sorted and unique
+    const std::vector<UID> expected = { 10, 20, 21, 22, 30, 31, 32 };
+    CHECK(hierarchy.GetResourceUIDs() == expected);
+
+    // Old single object format
+    PrefabHierarchy single;
+    CHECK(single.Compile(character[0]));
+    CHECK(single.GetNodes().size() == nodes.size());
+
+    // Several roots: an instance is the first root's subtree
+    nlohmann::json twoRoots = MakeProp();
+    twoRoots.push_back(MakeObject("Extra", glm::vec3(0.0f)));
+    PrefabHierarchy multi;
+    CHECK(multi.Compile(twoRoots));
+    CHECK(multi.GetNodes().size() == 4);
+    CHECK(multi.GetInstanceNodeCount() == 3);
+    CHECK(multi.GetNodes()[3].parent == -1);
+
+    // Missing keys get GameObject's defaults
+    PrefabHierarchy bare;
+    CHECK(bare.Compile(nlohmann::json::array({ nlohmann::json::object() })));
+    CHECK(bare.GetNodes()[0].name == "GameObject" && bare.GetNodes()[0].active && bare.GetNodes()[0].scale == glm::vec3(1.0f));
+
+    PrefabHierarchy invalid;
+    CHECK(!invalid.Compile(nlohmann::json::array({ 1, "not an object" })));
+    CHECK(!invalid.IsValid());
+
+    hierarchy.Clear();
+    CHECK(!hierarchy.IsValid() && hierarchy.GetComponents().empty() && hierarchy.GetResourceUIDs().empty());
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = HeadlessTest::IsQuick(argc, argv);
+
+    TestHierarchy();
+
+    struct Case
+    {
+        const char* name;
+        nlohmann::json prefab;
+        int spawns;
+    };
+    Case cases[] =
+    {
+        { "prop", MakeProp(), quick ? 200 : 50000 },
+        { "character", MakeCharacter(), quick ? 50 : 10000 },
+        { "chunk", MakeChunk(), quick ? 10 : 1000 },
+    };
+
+    printf("%10s %6s %7s %11s %14s %14s %8s\n", "prefab", "nodes", "spawns", "compile ms", "JSON spawn/s", "tmpl spawn/s", "speedup");
+
+    size_t checksum = 0;
+    for (Case& c : cases)
+    {
+        PrefabHierarchy hierarchy;
+        HeadlessTest::Timer compileTimer;
+        hierarchy.Compile(c.prefab);
+        double compileMs = compileTimer.Ms();
+
+        Spawn spawn;
+        Spawn reference;
+        SpawnFromJson(c.prefab, reference);
+
+        HeadlessTest::Timer jsonTimer;
+        for (int i = 0; i < c.spawns; ++i)
+        {
+            SpawnFromJson(c.prefab, spawn);
+            checksum += spawn.objects.size() + spawn.components.size();
+        }
+        double jsonMs = jsonTimer.Ms();
+
+        HeadlessTest::Timer templateTimer;
+        for (int i = 0; i < c.spawns; ++i)
+        {
+            SpawnFromHierarchy(hierarchy, spawn);
+            checksum += spawn.objects.size() + spawn.components.size();
+        }
+        double templateMs = templateTimer.Ms();
+
+        CHECK(SameSpawn(reference, spawn));
+
+        double jsonRate = c.spawns / std::max(jsonMs, 1e-6) * 1000.0;
+        double templateRate = c.spawns / std::max(templateMs, 1e-6) * 1000.0;
+        printf("%10s %6zu %7d %11.3f %14.0f %14.0f %7.1fx\n", c.name, hierarchy.GetNodes().size(), c.spawns,
+            compileMs, jsonRate, templateRate, templateRate / std::max(jsonRate, 1e-6));
+    }
+
+    CHECK(checksum > 0);
+    return HeadlessTest::Finish("PrefabBenchmark");
+}
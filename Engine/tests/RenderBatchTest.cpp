@@ -0,0 +1,192 @@
+// Instancing batches built from the sorted render queue: known keys in, expected
+// batch boundaries, instance counts and instance buffer offsets out.
+
+#include "HeadlessTest.h"
+#include "RenderQueue.h"
+
+#include <vector>
+
+// Only compared by address, never dereferenced
+static Shader* const shaderA = reinterpret_cast<Shader*>(0x100);
+static Shader* const shaderB = reinterpret_cast<Shader*>(0x200);
+static Material* const materialA = reinterpret_cast<Material*>(0x1000);
+static Material* const materialB = reinterpret_cast<Material*>(0x2000);
+
+static void PushMesh(RenderQueue& queue, Shader* shader, uint32_t shaderKey, Material* material, uint32_t materialKey,
+    unsigned int vao, float depth, bool instanceable = true, unsigned int indexCount = 36)
+{
+    RenderPacket& packet = queue.Push(RenderQueue::MakeOpaqueKey(shaderKey, materialKey, vao, depth));
+    packet.shader = shader;
+    packet.material = material;
+    packet.VAO = vao;
+    packet.indexCount = indexCount;
+    packet.depth = depth;
+    packet.instanceable = instanceable;
+}
+
+static bool SameBatch(const RenderBatch& batch, uint32_t first, uint32_t count, uint32_t baseInstance)
+{
+    return batch.first == first && batch.count == count && batch.baseInstance == baseInstance;
+}
+
+static void TestInterleavedSubmissionIsGrouped()
+{
+    // Submitted interleaved, the sort brings each mesh/material pair together
+    RenderQueue queue;
+    for (int i = 0; i < 4; ++i)
+    {
+        PushMesh(queue, shaderA, 1, materialA, 1, 10, 1.0f + i);
+        PushMesh(queue, shaderA, 1, materialA, 1, 20, 1.0f + i);
+    }
+    queue.Sort();
+
+    std::vector<RenderBatch> batches;
+    queue.BuildBatches(batches, 2);
+
+    CHECK(batches.size() == 2);
+    if (batches.size() != 2) return;
+    CHECK(SameBatch(batches[0], 0, 4, 0));
+    CHECK(SameBatch(batches[1], 4, 4, 4));
+    CHECK(queue[0].VAO == 10 && queue[3].VAO == 10);
+    CHECK(queue[4].VAO == 20 && queue[7].VAO == 20);
+}
+
+static void TestStateChangesSplitRuns()
+{
+    RenderQueue queue;
+    PushMesh(queue, shaderA, 1, materialA, 1, 10, 1.0f);
+    PushMesh(queue, shaderA, 1, materialA, 1, 10, 2.0f);
+    PushMesh(queue, shaderA, 1, materialA, 1, 10, 3.0f);
+    // Same mesh, other material
+    PushMesh(queue, shaderA, 1, materialB, 2, 10, 1.0f);
+    PushMesh(queue, shaderA, 1, materialB, 2, 10, 2.0f);
+    // Same mesh and material, other shader
+    PushMesh(queue, shaderB, 2, materialB, 2, 10, 1.0f);
+    PushMesh(queue, shaderB, 2, materialB, 2, 10, 2.0f);
+    queue.Sort();
+
+    std::vector<RenderBatch> batches;
+    queue.BuildBatches(batches, 2);
+
+    CHECK(batches.size() == 3);
+    if (batches.size() != 3) return;
+    CHECK(SameBatch(batches[0], 0, 3, 0));
+    CHECK(SameBatch(batches[1], 3, 2, 3));
+    CHECK(SameBatch(batches[2], 5, 2, 5));
+}
+
+static void TestNonInstanceablePacketsBreakRuns()
+{
+    // A selected or skinned packet in the middle of a run is drawn alone and splits it
+    RenderQueue queue;
+    PushMesh(queue, shaderA, 1, materialA, 1, 10, 1.0f);
+    PushMesh(queue, shaderA, 1, materialA, 1, 10, 2.0f);
+    PushMesh(queue, shaderA, 1, materialA, 1, 10, 3.0f, false);
+    PushMesh(queue, shaderA, 1, materialA, 1, 10, 4.0f);
+    PushMesh(queue, shaderA, 1, materialA, 1, 10, 5.0f);
+    PushMesh(queue, shaderA, 1, materialA, 1, 10, 6.0f);
+    queue.Sort();
+
+    std::vector<RenderBatch> batches;
+    queue.BuildBatches(batches, 2);
+
+    CHECK(batches.size() == 3);
+    if (batches.size() != 3) return;
+    CHECK(SameBatch(batches[0], 0, 2, 0));
+    CHECK(batches[1].first == 2 && batches[1].count == 1);
+    CHECK(!queue[2].instanceable);
+    CHECK(SameBatch(batches[2], 3, 3, 2));
+}
+
+static void TestMeshesWithOtherIndexCountsAreNotMerged()
+{
+    RenderQueue queue;
+    PushMesh(queue, shaderA, 1, materialA, 1, 10, 1.0f, true, 36);
+    PushMesh(queue, shaderA, 1, materialA, 1, 10, 2.0f, true, 36);
+    PushMesh(queue, shaderA, 1, materialA, 1, 10, 3.0f, true, 72);
+    queue.Sort();
+
+    std::vector<RenderBatch> batches;
+    queue.BuildBatches(batches, 2);
+
+    CHECK(batches.size() == 2);
+    if (batches.size() != 2) return;
+    CHECK(SameBatch(batches[0], 0, 2, 0));
+    CHECK(batches[1].first == 2 && batches[1].count == 1);
+}
+
+static void TestShortRunsAndDisabledMerging()
+{
+    RenderQueue queue;
+    for (int i = 0; i < 3; ++i) PushMesh(queue, shaderA, 1, materialA, 1, 10, 1.0f + i);
+    for (int i = 0; i < 5; ++i) PushMesh(queue, shaderA, 1, materialA, 1, 20, 1.0f + i);
+    queue.Sort();
+
+    std::vector<RenderBatch> batches;
+
+    // Runs shorter than the minimum are emitted one packet per batch
+    queue.BuildBatches(batches, 4);
+    CHECK(batches.size() == 4);
+    if (batches.size() == 4)
+    {
+        for (uint32_t i = 0; i < 3; ++i) CHECK(batches[i].first == i && batches[i].count == 1);
+        CHECK(SameBatch(batches[3], 3, 5, 0));
+    }
+
+    // 0 disables merging altogether
+    queue.BuildBatches(batches, 0);
+    CHECK(batches.size() == queue.Size());
+    for (uint32_t i = 0; i < batches.size(); ++i) CHECK(batches[i].first == i && batches[i].count == 1);
+}
+
+static void TestBatchesCoverTheQueueOnce()
+{
+    RenderQueue queue;
+    uint32_t seed = 7;
+    for (int i = 0; i < 1000; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        bool useB = (seed >> 16) & 1;
+        unsigned int vao = 1 + ((seed >> 8) % 6);
+        bool instanceable = ((seed >> 20) % 5) != 0;
+        PushMesh(queue, shaderA, 1, useB ? materialB : materialA, useB ? 2 : 1, vao, (float)(seed % 100), instanceable);
+    }
+    queue.Sort();
+
+    std::vector<RenderBatch> batches;
+    queue.BuildBatches(batches, 2);
+
+    uint32_t next = 0;
+    uint32_t instances = 0;
+    for (const RenderBatch& batch : batches)
+    {
+        CHECK(batch.first == next);
+        next += batch.count;
+        if (batch.count > 1)
+        {
+            // Instance ranges are packed back to back in the instance buffer
+            CHECK(batch.baseInstance == instances);
+            instances += batch.count;
+
+            const RenderPacket& first = queue[batch.first];
+            for (uint32_t i = batch.first; i < batch.first + batch.count; ++i)
+            {
+                CHECK(queue[i].instanceable);
+                CHECK(queue[i].material == first.material && queue[i].VAO == first.VAO);
+            }
+        }
+    }
+    CHECK(next == queue.Size());
+}
+
+int main()
+{
+    TestInterleavedSubmissionIsGrouped();
+    TestStateChangesSplitRuns();
+    TestNonInstanceablePacketsBreakRuns();
+    TestMeshesWithOtherIndexCountsAreNotMerged();
+    TestShortRunsAndDisabledMerging();
+    TestBatchesCoverTheQueueOnce();
+
+    return HeadlessTest::Finish("RenderBatchTest");
+}
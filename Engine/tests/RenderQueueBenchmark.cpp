@@ -0,0 +1,107 @@
+// Build and sort cost of the render queue at 10k/50k/100k packets, against std::stable_sort
+// on the same keys. Keys mimic a scene: few shaders, some hundred materials and meshes.
+
+#include "HeadlessTest.h"
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+struct SceneKeys
+{
+    std::vector<uint64_t> keys;
+};
+
+static SceneKeys MakeScene(size_t count)
+{
+    SceneKeys scene;
+    scene.keys.resize(count);
+
+    uint32_t seed = 12345;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t shader = next() % 4;
+        uint32_t material = next() % 300;
+        uint32_t mesh = next() % 500;
+        float depth = 0.5f + (next() % 100000) * 0.01f;
+        scene.keys[i] = RenderQueue::MakeOpaqueKey(shader, material, mesh, depth);
+    }
+    return scene;
+}
+
+static void BuildQueue(RenderQueue& queue, const SceneKeys& scene)
+{
+    queue.Clear();
+    for (size_t i = 0; i < scene.keys.size(); ++i)
+    {
+        // indexCount carries the source index so the order can be checked afterwards
+        RenderPacket& packet = queue.Push(scene.keys[i]);
+        packet.indexCount = (unsigned int)i;
+    }
+}
+
+static bool IsSorted(const RenderQueue& queue, const SceneKeys& scene)
+{
+    for (size_t i = 1; i < queue.Size(); ++i)
+    {
+        uint32_t previous = queue[i - 1].indexCount;
+        uint32_t current = queue[i].indexCount;
+        if (scene.keys[previous] > scene.keys[current]) return false;
+        // Stable: equal keys keep submission order
+        if (scene.keys[previous] == scene.keys[current] && previous > current) return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = HeadlessTest::IsQuick(argc, argv);
+    const size_t counts[] = { 10000, 50000, 100000 };
+    const int frames = quick ? 3 : 100;
+
+    printf("%10s %12s %12s %16s\n", "packets", "build ms", "sort ms", "stable_sort ms");
+
+    RenderQueue queue;
+    for (size_t count : counts)
+    {
+        if (quick && count > 10000) break;
+
+        SceneKeys scene = MakeScene(count);
+        queue.Reserve(count);
+
+        double buildMs = 0.0;
+        double sortMs = 0.0;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            HeadlessTest::Timer build;
+            BuildQueue(queue, scene);
+            buildMs += build.Ms();
+
+            HeadlessTest::Timer sort;
+            queue.Sort();
+            sortMs += sort.Ms();
+        }
+        CHECK(queue.Size() == count);
+        CHECK(IsSorted(queue, scene));
+
+        // Reference: comparison sort of the same entries
+        std::vector<RenderQueue::SortEntry> entries(count);
+        double referenceMs = 0.0;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            for (size_t i = 0; i < count; ++i) entries[i] = { scene.keys[i], (uint32_t)i };
+
+            HeadlessTest::Timer reference;
+            std::stable_sort(entries.begin(), entries.end(),
+                [](const RenderQueue::SortEntry& a, const RenderQueue::SortEntry& b) { return a.key < b.key; });
+            referenceMs += reference.Ms();
+        }
+
+        printf("%10zu %12.3f %12.3f %16.3f\n", count, buildMs / frames, sortMs / frames, referenceMs / frames);
+    }
+
+    return HeadlessTest::Finish("RenderQueueBenchmark");
+}
@@ -0,0 +1,179 @@
+// Scaling of the parallel particle and physics updates from 1 to 16 threads.
+// Particles run every emitter through JobSystem::ParallelFor exactly like
+// Renderer::SimulateParticles; physics steps a PhysX scene whose tasks go through
+// PhysicsJobDispatcher. "threads" counts the calling thread, which also runs jobs.
+
+#include "HeadlessTest.h"
+#include "JobSystem.h"
+#include "ParticleSystem.h"
+#include "PhysicsJobDispatcher.h"
+
+#include <PxPhysicsAPI.h>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace physx;
+
+static const float FRAME_TIME = 1.0f / 60.0f;
+
+// Particles
+
+struct ParticleResult
+{
+    double ms = 0.0;
+    size_t particles = 0;
+    double checksum = 0.0;
+};
+
+static ParticleResult RunParticles(JobSystem& jobs, int emitterCount, int frames)
+{
+    std::vector<std::unique_ptr<EmitterInstance>> emitters;
+    for (int i = 0; i < emitterCount; ++i)
+    {
+        auto emitter = std::make_unique<EmitterInstance>();
+        emitter->Init();
+        emitter->randomSeed = 1000u + (uint32_t)i;
+        emitter->maxParticles = 5000;
+        emitter->emissionRate = 2500.0f;
+        emitter->particles.Reserve(emitter->maxParticles);
+        emitter->GetSpawner()->lifetimeMin = 1.5f;
+        emitter->GetSpawner()->lifetimeMax = 2.0f;
+        emitter->Reset();
+        emitters.push_back(std::move(emitter));
+    }
+
+    // Warm up to a steady particle count, not timed
+    for (int frame = 0; frame < 120; ++frame)
+    {
+        for (auto& emitter : emitters) emitter->Update(FRAME_TIME);
+    }
+
+    ParticleResult result;
+    HeadlessTest::Timer timer;
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        jobs.ParallelFor((uint32_t)emitters.size(), 1, [&emitters](uint32_t begin, uint32_t end)
+            {
+                for (uint32_t i = begin; i < end; ++i)
+                    emitters[i]->Update(FRAME_TIME);
+            });
+    }
+    result.ms = timer.Ms() / frames;
+
+    // Every emitter owns its generator, so the outcome must not depend on the thread count
+    for (auto& emitter : emitters)
+    {
+        result.particles += emitter->particles.Size();
+        for (size_t i = 0; i < emitter->particles.Size(); ++i)
+            result.checksum += emitter->particles.posY[i];
+    }
+    return result;
+}
+
+// Physics
+
+struct PhysicsResult
+{
+    double ms = 0.0;
+    bool settled = true;
+};
+
+static PhysicsResult RunPhysics(JobSystem& jobs, PxPhysics& physics, int boxCount, int frames)
+{
+    PhysicsJobDispatcher dispatcher(jobs);
+
+    PxSceneDesc sceneDesc(physics.getTolerancesScale());
+    sceneDesc.gravity = PxVec3(0.0f, -9.81f, 0.0f);
+    sceneDesc.cpuDispatcher = &dispatcher;
+    sceneDesc.filterShader = PxDefaultSimulationFilterShader;
+    PxScene* scene = physics.createScene(sceneDesc);
+
+    PxMaterial* material = physics.createMaterial(0.5f, 0.5f, 0.1f);
+    scene->addActor(*PxCreatePlane(physics, PxPlane(0.0f, 1.0f, 0.0f, 0.0f), *material));
+
+    // Boxes dropped in columns over a grid, so they keep colliding while measured
+    std::vector<PxRigidDynamic*> boxes;
+    const int side = (int)std::ceil(std::sqrt(boxCount / 10.0f));
+    for (int i = 0; i < boxCount; ++i)
+    {
+        int column = i % (side * side);
+        int level = i / (side * side);
+        PxVec3 position((column % side) * 1.5f, 1.0f + level * 1.2f, (column / side) * 1.5f);
+        PxRigidDynamic* box = PxCreateDynamic(physics, PxTransform(position), PxBoxGeometry(0.5f, 0.5f, 0.5f), *material, 1.0f);
+        scene->addActor(*box);
+        boxes.push_back(box);
+    }
+
+    PhysicsResult result;
+    HeadlessTest::Timer timer;
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        scene->simulate(FRAME_TIME);
+        scene->fetchResults(true);
+    }
+    result.ms = timer.Ms() / frames;
+
+    for (PxRigidDynamic* box : boxes)
+    {
+        if (box->getGlobalPose().p.y < -1.0f) result.settled = false;
+    }
+
+    scene->release();
+    material->release();
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = HeadlessTest::IsQuick(argc, argv);
+    const unsigned int threadCounts[] = { 1, 2, 4, 8, 12, 16 };
+    const int frames = quick ? 5 : 120;
+    const int emitterCount = quick ? 8 : 64;
+    const int boxCount = quick ? 200 : 3000;
+
+    PxDefaultAllocator allocator;
+    PxDefaultErrorCallback errorCallback;
+    PxFoundation* foundation = PxCreateFoundation(PX_PHYSICS_VERSION, allocator, errorCallback);
+    PxPhysics* physics = foundation ? PxCreatePhysics(PX_PHYSICS_VERSION, *foundation, PxTolerancesScale(), false) : nullptr;
+    CHECK(physics != nullptr);
+
+    JobSystem jobs;
+    // Speedups flatten past this, the extra threads only share cores
+    printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+    printf("%8s %14s %9s %14s %9s\n", "threads", "particles ms", "speedup", "physics ms", "speedup");
+
+    ParticleResult particleBase;
+    PhysicsResult physicsBase;
+    for (unsigned int threads : threadCounts)
+    {
+        if (quick && threads > 2) break;
+
+        jobs.SetWorkerCount(threads - 1);
+
+        ParticleResult particles = RunParticles(jobs, emitterCount, frames);
+        PhysicsResult physicsStep;
+        if (physics) physicsStep = RunPhysics(jobs, *physics, boxCount, frames);
+
+        if (threads == 1)
+        {
+            particleBase = particles;
+            physicsBase = physicsStep;
+        }
+
+        CHECK(particles.particles > 0);
+        CHECK(particles.particles == particleBase.particles);
+        CHECK(particles.checksum == particleBase.checksum);
+        CHECK(physicsStep.settled);
+
+        printf("%8u %14.3f %8.2fx %14.3f %8.2fx\n", threads,
+            particles.ms, particleBase.ms / particles.ms,
+            physicsStep.ms, physicsStep.ms > 0.0 ? physicsBase.ms / physicsStep.ms : 0.0);
+    }
+
+    jobs.SetWorkerCount(0);
+    if (physics) physics->release();
+    if (foundation) foundation->release();
+
+    return HeadlessTest::Finish("UpdateScalingBenchmark");
+}